@@ -28,6 +28,7 @@
 
 #include <stdio.h>
 #include <cmath>
+#include <algorithm>
 
 #include "object.h"
 #include "complex.h"
@@ -48,6 +49,7 @@ acsolver::acsolver () : nasolver<nr_complex_t> () {
   setDescription ("AC");
   xn = NULL;
   noise = 0;
+  noiseProbes = 0;
 }
 
 // Constructor creates a named instance of the acsolver class.
@@ -57,6 +59,7 @@ acsolver::acsolver (char * n) : nasolver<nr_complex_t> (n) {
   setDescription ("AC");
   xn = NULL;
   noise = 0;
+  noiseProbes = 0;
 }
 
 // Destructor deletes the acsolver class object.
@@ -71,6 +74,10 @@ acsolver::acsolver (acsolver & o) : nasolver<nr_complex_t> (o) {
   swp = o.swp ? new sweep (*(o.swp)) : NULL;
   xn = o.xn ? new tvector<nr_double_t> (*(o.xn)) : NULL;
   noise = o.noise;
+  noiseProbes = o.noiseProbes;
+  probes = o.probes;
+  outPos = o.outPos;
+  outNeg = o.outNeg;
 }
 
 /* This is the AC netlist solver.  It prepares the circuit list for
@@ -80,6 +87,22 @@ int acsolver::solve (void) {
 
   // run additional noise analysis ?
   noise = !strcmp (getPropertyString ("Noise"), "yes") ? 1 : 0;
+  noiseProbes = !strcmp (getPropertyString ("NoiseOutputs"), "probes") ? 1 : 0;
+
+  // choose a solver
+  const char * const solver = getPropertyString ("Solver");
+  int algo = ALGO_LU_DECOMPOSITION;
+  if (!strcmp (solver, "DoolittleLU"))
+    algo = ALGO_LU_DECOMPOSITION_DOOLITTLE;
+  else if (!strcmp (solver, "HouseholderQR"))
+    algo = ALGO_QR_DECOMPOSITION;
+  else if (!strcmp (solver, "HouseholderLQ"))
+    algo = ALGO_QR_DECOMPOSITION_LS;
+  else if (!strcmp (solver, "GolubSVD"))
+    algo = ALGO_SV_DECOMPOSITION;
+  else if (!strcmp (solver, "SparseLU"))
+    algo = ALGO_SPARSE_LU_DECOMPOSITION;
+  eqnAlgo = algo;
 
   // create frequency sweep if necessary
   if (swp == NULL) {
@@ -91,30 +114,76 @@ int acsolver::solve (void) {
   init ();
   setCalculation ((calculate_func_t) &calc);
   solve_pre ();
+  if (noise) createNoiseOutputs ();
+
+  int err = 0;
+  // solve a sparse set of frequencies and interpolate the rest
+  if (!strcmp (getPropertyString ("Adaptive"), "yes")) {
+    if (runs == 1) saveFrequencies ();
+    err = solveAdaptive (swp, [this, algo] (nr_double_t f) {
+	solveFrequency (f, algo);
+      });
+    solve_post ();
+    return err;
+  }
+
+#if HAVE_FORK
+  // solve the frequency points in parallel worker processes
+  int workers = countWorkers (swp->getSize ());
+  if (workers > 1) {
+    // save the frequencies before the results of the workers
+    if (runs == 1) saveFrequencies ();
+    err = solveWorkers (workers, swp->getSize (),
+			[this, algo] (int first, int last) {
+	for (int i = first; i < last; i++) solveFrequency (swp->get (i), algo);
+	return 0;
+      });
+    solve_post ();
+    return err;
+  }
+#endif
 
   swp->reset ();
   for (int i = 0; i < swp->getSize (); i++) {
     freq = swp->next ();
     if (progress) logprogressbar (i, swp->getSize (), 40);
+    solveFrequency (freq, algo);
+  }
+  solve_post ();
+  if (progress) logprogressclear (40);
+  return err;
+}
+
+/* Solves the netlist for the given frequency using the given linear
+   equation solver and saves the results. */
+void acsolver::solveFrequency (nr_double_t f, int algo) {
+  freq = f;
 
 #if DEBUG && 0
-    logprint (LOG_STATUS, "NOTIFY: %s: solving netlist for f = %e\n",
-	      getName (), (double) freq);
+  logprint (LOG_STATUS, "NOTIFY: %s: solving netlist for f = %e\n",
+	    getName (), (double) freq);
 #endif
 
-    // start the linear solver
-    eqnAlgo = ALGO_LU_DECOMPOSITION;
-    solve_linear ();
+  // start the linear solver
+  eqnAlgo = algo;
+  solve_linear ();
 
-    // compute noise if requested
-    if (noise) solve_noise ();
+  // compute noise if requested
+  if (noise) solve_noise ();
 
-    // save results
-    saveAllResults (freq);
+  // save results
+  saveAllResults (freq);
+}
+
+/* Saves all frequencies of the sweep into the dependency of the output
+   dataset at once. */
+void acsolver::saveFrequencies (void) {
+  qucs::vector * f;
+  if ((f = data->findDependency ("acfrequency")) == NULL) {
+    f = new qucs::vector ("acfrequency");
+    data->addDependency (f);
   }
-  solve_post ();
-  if (progress) logprogressclear (40);
-  return 0;
+  for (int i = 0; i < swp->getSize (); i++) f->add (swp->get (i));
 }
 
 /* Goes through the list of circuit objects and runs its calcAC()
@@ -159,6 +228,19 @@ void acsolver::saveAllResults (nr_double_t freq) {
 /* The function computes the final noise results and puts them into
    the output dataset. */
 void acsolver::saveNoiseResults (qucs::vector * f) {
+  // only the voltage probes have been requested
+  if (noiseProbes) {
+    for (int i = 0; i < (int) probes.size (); i++) {
+      circuit * c = probes[i];
+      if (!c->getSubcircuit ().empty ()) continue;
+      c->setOperatingPoint ("Vr", xn->get (i) * sqrt (kB * T0));
+      c->setOperatingPoint ("Vi", 0.0);
+      saveVariable (std::string (c->getName ()) + ".vn",
+		    nr_complex_t (c->getOperatingPoint ("Vr"), 0.0), f);
+    }
+    return;
+  }
+
   int N = countNodes ();
   int M = countVoltageSources ();
   for (int r = 0; r < N + M; r++) {
@@ -167,9 +249,7 @@ void acsolver::saveNoiseResults (qucs::vector * f) {
   }
 
   // apply probe data
-  circuit * root = subnet->getRoot ();
-  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
-    if (!c->isProbe ()) continue;
+  for (circuit * c : probes) {
     int np, nn;
     nr_double_t vp, vn;
     np = getNodeNr (c->getNode (NODE_1)->getName ());
@@ -183,42 +263,100 @@ void acsolver::saveNoiseResults (qucs::vector * f) {
   saveResults ("vn", "in", 0, f);
 }
 
+/* The function determines the outputs of the noise analysis.  Each
+   output is the voltage between a positive and a negative MNA row (or
+   the ground node if the row is negative).  By default these are all
+   the node voltages and branch currents.  If only the voltage probes
+   have been requested the noise voltage across each probe is computed
+   directly. */
+void acsolver::createNoiseOutputs (void) {
+  int N = countNodes ();
+  int M = countVoltageSources ();
+
+  probes.clear ();
+  outPos.clear ();
+  outNeg.clear ();
+  circuit * root = subnet->getRoot ();
+  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+    if (!c->isProbe ()) continue;
+    probes.push_back (c);
+    if (noiseProbes) {
+      outPos.push_back (getNodeNr (c->getNode (NODE_1)->getName ()) - 1);
+      outNeg.push_back (getNodeNr (c->getNode (NODE_2)->getName ()) - 1);
+    }
+  }
+  if (!noiseProbes) {
+    for (int i = 0; i < N + M; i++) {
+      outPos.push_back (i);
+      outNeg.push_back (-1);
+    }
+  }
+
+  // create noise result vector
+  delete xn;
+  xn = new tvector<nr_double_t> (outPos.size ());
+}
+
+/* Number of adjoint systems solved at once during the noise analysis. */
+#define NOISE_BLOCK 32
+
 /* This function runs the AC noise analysis.  It saves its results in
-   the 'xn' vector. */
+   the 'xn' vector.  The transimpedances from all the noise sources to
+   the requested outputs are the solutions of the adjoint system.  They
+   are computed blockwise for several outputs at once using a single
+   LU decomposition.  The resulting noise powers are quadratic forms
+   in the correlation matrix which is usually very sparse. */
 void acsolver::solve_noise (void) {
   int N = countNodes ();
   int M = countVoltageSources ();
+  int outputs = outPos.size ();
 
   // save usual AC results
   tvector<nr_complex_t> xsave = *x;
 
-  // create the Cy matrix
+  // create the sparse Cy matrix
   createNoiseMatrix ();
-  // create noise result vector if necessary
-  if (xn == NULL) xn = new tvector<nr_double_t> (N + M);
-
-  // temporary result vector for transimpedances
-  tvector<nr_complex_t> zn = tvector<nr_complex_t> (N + M);
+  int * Cp = C->getColPtr (), * Ci = C->getRowIdx ();
+  nr_complex_t * Cx = C->getData ();
 
   // create the MNA matrix once again and LU decompose the adjoint matrix
+  int sparse = ALGO_IS_SPARSE (eqnAlgo);
   createMatrix ();
-  A->transpose ();
-  eqnAlgo = ALGO_LU_FACTORIZATION_CROUT;
+  if (sparse)
+    As->transpose ();
+  else
+    A->transpose ();
+  eqnAlgo = sparse ? ALGO_SPARSE_LU_FACTORIZATION : ALGO_LU_FACTORIZATION_CROUT;
   runMNA ();
 
   // ensure skipping LU decomposition
   updateMatrix = 0;
   convHelper = CONV_None;
-  eqnAlgo = ALGO_LU_SUBSTITUTION_CROUT;
-
-  // compute noise voltage for each node (and voltage source)
-  for (int i = 0; i < N + M; i++) {
-    z->set (0); z->set (i, -1); // modify right hand side appropriately
-    runMNA ();                  // solve
-    zn = *x;                    // save transimpedance vector
-
-    // compute actual noise voltage
-    xn->set (i, sqrt (real (scalar (zn * (*C), conj (zn)))));
+  eqnAlgo = sparse ? ALGO_SPARSE_LU_SUBSTITUTION : ALGO_LU_SUBSTITUTION_CROUT;
+
+  // compute noise voltages for a block of outputs at once
+  for (int b = 0; b < outputs; b += NOISE_BLOCK) {
+    int K = std::min (NOISE_BLOCK, outputs - b);
+    tmatrix<nr_complex_t> zn (N + M, K);
+    for (int k = 0; k < K; k++) {
+      // modify right hand sides appropriately
+      if (outPos[b + k] >= 0) zn (outPos[b + k], k) = -1;
+      if (outNeg[b + k] >= 0) zn (outNeg[b + k], k) = +1;
+    }
+    runMNA (zn); // solve for transimpedances
+
+    // compute actual noise voltages: zn^T * Cy * conj (zn)
+    std::vector<nr_complex_t> v (K);
+    nr_complex_t * z = zn.getData ();
+    for (int c = 0; c < N + M; c++) {
+      nr_complex_t * zc = z + c * K;
+      for (int p = Cp[c]; p < Cp[c + 1]; p++) {
+	nr_complex_t * zr = z + Ci[p] * K;
+	if (Cx[p] == 0.0) continue;
+	for (int k = 0; k < K; k++) v[k] += zr[k] * Cx[p] * conj (zc[k]);
+      }
+    }
+    for (int k = 0; k < K; k++) xn->set (b + k, sqrt (real (v[k])));
   }
 
   // restore usual AC results
@@ -235,6 +373,12 @@ PROP_OPT [] = {
   { "Stop", PROP_REAL, { 10e9, PROP_NO_STR }, PROP_POS_RANGE },
   { "Points", PROP_INT, { 10, PROP_NO_STR }, PROP_MIN_VAL (2) },
   { "Values", PROP_LIST, { 10, PROP_NO_STR }, PROP_POS_RANGE },
+  { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" }, PROP_RNG_SOL },
+  { "Workers", PROP_INT, { 1, PROP_NO_STR }, PROP_RNGII (0, 256) },
+  { "NoiseOutputs", PROP_STR, { PROP_NO_VAL, "all" },
+    PROP_RNG_STR2 ("all", "probes") },
+  { "Adaptive", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+  { "AdaptTol", PROP_REAL, { 1e-3, PROP_NO_STR }, PROP_RNGXI (0, 1) },
   PROP_NO_PROP };
 struct define_t acsolver::anadef =
   { "AC", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
@@ -46,11 +46,20 @@ class acsolver : public nasolver<nr_complex_t>
   void saveAllResults (nr_double_t);
   void saveNoiseResults (qucs::vector *);
 
+ private:
+  void solveFrequency (nr_double_t, int);
+  void saveFrequencies (void);
+  void createNoiseOutputs (void);
+
  private:
   sweep * swp;
   nr_double_t freq;
   int noise;
+  int noiseProbes;
   tvector<nr_double_t> * xn;
+  std::vector<circuit *> probes;
+  std::vector<int> outPos;
+  std::vector<int> outNeg;
 };
 
 } // namespace qucs
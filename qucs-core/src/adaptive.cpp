@@ -0,0 +1,198 @@
+/*
+ * adaptive.cpp - adaptive frequency sampling class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "complex.h"
+#include "adaptive.h"
+
+// number of samples each rational model is built from
+#define ADAPT_ORDER 6
+// one initial sample for this number of grid points
+#define ADAPT_RATIO 32
+// gaps in between samples are probed at this many subdivisions
+#define ADAPT_PROBES 8
+
+namespace qucs {
+
+/* Evaluates the diagonal rational function through the given points
+   at the abscissa x using the Bulirsch-Stoer recurrence.  The last
+   correction, i.e. the difference to the rational function through
+   one point less, is returned in dy. */
+static nr_complex_t rational (nr_double_t * xa, nr_complex_t * ya, int n,
+			      nr_double_t x, nr_complex_t & dy) {
+  const nr_double_t tiny = 1e-25;
+  nr_complex_t c[ADAPT_ORDER], d[ADAPT_ORDER];
+  int ns = 0;
+  nr_double_t hh = std::fabs (x - xa[0]);
+  for (int i = 0; i < n; i++) {
+    nr_double_t h = std::fabs (x - xa[i]);
+    if (h == 0) {
+      dy = 0;
+      return ya[i];
+    }
+    if (h < hh) { ns = i; hh = h; }
+    c[i] = ya[i];
+    d[i] = ya[i] + tiny;
+  }
+  nr_complex_t y = ya[ns--];
+  dy = 0;
+  for (int m = 1; m < n; m++) {
+    for (int i = 0; i < n - m; i++) {
+      nr_complex_t w = c[i + 1] - d[i];
+      nr_double_t h = xa[i + m] - x;
+      nr_complex_t t = (xa[i] - x) * d[i] / h;
+      nr_complex_t dd = t - c[i + 1];
+      // a pole at x, keep going with a huge value
+      if (dd == 0.0) dd = tiny;
+      dd = w / dd;
+      d[i] = c[i + 1] * dd;
+      c[i] = t * dd;
+    }
+    dy = 2 * (ns + 1) < n - m ? c[ns + 1] : d[ns--];
+    y += dy;
+  }
+  return y;
+}
+
+/* Constructor creates an adaptive sampler for the given frequency
+   grid and relative tolerance.  The grid must be monotonic. */
+adaptive::adaptive (const std::vector<nr_double_t> & f, nr_double_t tol) :
+  tolerance (tol), grid (f), sample (f.size (), -1) {
+}
+
+// Destructor deletes an adaptive sampler.
+adaptive::~adaptive () {
+}
+
+/* The function puts the grid points to be solved next into the given
+   list and returns their number.  The first call returns equidistant
+   points.  Later calls probe the gaps in between the samples at
+   several points and return the worst point of each gap whose error
+   estimate exceeds the tolerance.  Zero is returned once all gaps are resolved. */
+int adaptive::select (std::vector<int> & points) {
+  int n = grid.size ();
+  points.clear ();
+  if (solved.empty ()) {
+    int k = std::min (n, std::max (ADAPT_ORDER + 1, n / ADAPT_RATIO));
+    for (int i = 0; i < k; i++) {
+      int p = k > 1 ? (int) ((long) i * (n - 1) / (k - 1)) : 0;
+      if (points.empty () || points.back () != p) points.push_back (p);
+    }
+    return points.size ();
+  }
+  for (size_t s = 1; s < solved.size (); s++) {
+    int a = solved[s - 1], b = solved[s];
+    if (b - a < 2) continue;
+    int worst = -1, last = a;
+    nr_double_t emax = tolerance;
+    for (int j = 1; j < ADAPT_PROBES; j++) {
+      int p = a + (int) ((long) j * (b - a) / ADAPT_PROBES);
+      if (p == last) continue;
+      nr_double_t err = estimate (last = p, NULL);
+      if (err > emax) {
+	emax = err;
+	worst = p;
+      }
+    }
+    if (worst >= 0) points.push_back (worst);
+  }
+  return points.size ();
+}
+
+/* Saves the responses at the given grid point.  Responses missing in
+   some of the samples are taken as zero. */
+void adaptive::setSample (int i, const std::vector<nr_complex_t> & y) {
+  sample[i] = rows.size ();
+  rows.push_back (y);
+  solved.insert (std::lower_bound (solved.begin (), solved.end (), i), i);
+  if (scale.size () < y.size ()) scale.resize (y.size (), 0);
+  for (size_t k = 0; k < y.size (); k++)
+    scale[k] = std::max (scale[k], abs (y[k]));
+}
+
+/* Returns the responses at the given grid point, either the solved
+   values or the rational interpolation of the nearest samples. */
+void adaptive::interpolate (int i, std::vector<nr_complex_t> & y) {
+  if (sample[i] >= 0) {
+    y = rows[sample[i]];
+    y.resize (scale.size (), 0);
+  }
+  else
+    estimate (i, &y);
+}
+
+/* Puts the solved grid points closest to the given grid point into
+   the list, nearest first. */
+void adaptive::nearest (int i, std::vector<int> & idx) {
+  int n = solved.size ();
+  int r = std::lower_bound (solved.begin (), solved.end (), i) -
+    solved.begin ();
+  int l = r - 1;
+  int m = std::min (ADAPT_ORDER, n);
+  idx.clear ();
+  while ((int) idx.size () < m) {
+    if (l < 0)
+      idx.push_back (solved[r++]);
+    else if (r >= n)
+      idx.push_back (solved[l--]);
+    else if (std::fabs (grid[i] - grid[solved[l]]) <=
+	     std::fabs (grid[solved[r]] - grid[i]))
+      idx.push_back (solved[l--]);
+    else
+      idx.push_back (solved[r++]);
+  }
+}
+
+/* Evaluates the rational models of all responses at the given grid
+   point and returns the largest error estimate relative to the
+   magnitude of the response.  The values are saved into the given
+   list if it is not NULL. */
+nr_double_t adaptive::estimate (int i, std::vector<nr_complex_t> * y) {
+  std::vector<int> idx;
+  nearest (i, idx);
+  int m = idx.size ();
+  int responses = scale.size ();
+  nr_double_t x[ADAPT_ORDER], err = 0;
+  nr_complex_t ya[ADAPT_ORDER], dy;
+  if (y) y->assign (responses, 0);
+  for (int j = 0; j < m; j++) x[j] = grid[idx[j]];
+  for (int k = 0; k < responses; k++) {
+    for (int j = 0; j < m; j++) {
+      std::vector<nr_complex_t> & row = rows[sample[idx[j]]];
+      ya[j] = k < (int) row.size () ? row[k] : 0;
+    }
+    nr_complex_t val = rational (x, ya, m, grid[i], dy);
+    if (y) (*y)[k] = val;
+    if (scale[k] > 0) err = std::max (err, abs (dy) / scale[k]);
+  }
+  return err;
+}
+
+} // namespace qucs
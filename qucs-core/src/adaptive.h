@@ -0,0 +1,63 @@
+/*
+ * adaptive.h - adaptive frequency sampling class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef __ADAPTIVE_H__
+#define __ADAPTIVE_H__
+
+#include <vector>
+
+namespace qucs {
+
+/* The adaptive class chooses the points of a dense frequency grid
+   which actually need to be solved.  The responses in between the
+   solved points are modelled by rational functions through the
+   nearest samples.  The difference between rational models of
+   successive order serves as error estimate, new samples are placed
+   where it exceeds the tolerance. */
+class adaptive
+{
+ public:
+  adaptive (const std::vector<nr_double_t> &, nr_double_t);
+  ~adaptive ();
+  int select (std::vector<int> &);
+  void setSample (int, const std::vector<nr_complex_t> &);
+  void interpolate (int, std::vector<nr_complex_t> &);
+  int getSamples (void) const { return rows.size (); }
+
+ private:
+  void nearest (int, std::vector<int> &);
+  nr_double_t estimate (int, std::vector<nr_complex_t> *);
+
+ private:
+  nr_double_t tolerance;
+  std::vector<nr_double_t> grid;
+  std::vector<int> sample;
+  std::vector<int> solved;
+  std::vector<nr_double_t> scale;
+  std::vector<std::vector<nr_complex_t> > rows;
+};
+
+} // namespace qucs
+
+#endif /* __ADAPTIVE_H__ */
@@ -34,10 +34,19 @@
 # include <config.h>
 #endif
 
-//#include <stdio.h>
-//#include <stdlib.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if HAVE_FORK
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <map>
+#include <vector>
+#endif
+
+#include "logging.h"
 #include "object.h"
 #include "complex.h"
 #include "sweep.h"
@@ -46,9 +55,15 @@
 #include "dataset.h"
 #include "ptrlist.h"
 #include "analysis.h"
+#include "threadpool.h"
+#include "adaptive.h"
 
 namespace qucs {
 
+/* This flag is set in worker processes.  Analyses inside a worker are
+   solved sequentially. */
+bool analysis::worker = false;
+
 //Constructor. Creates an unnamed instance of the analysis class.
 analysis::analysis () : object () {
   data = NULL;
@@ -164,4 +179,303 @@ sweep * analysis::createSweep (const std::string& n) {
   d->add (z);
 }
 
+/* Returns the number of worker processes given by the "Workers"
+   property for solving the given number of points, where zero means
+   all processors.  Inside worker processes and on platforms without
+   fork() the function returns one. */
+int analysis::countWorkers (int points) {
+#if HAVE_FORK
+  int workers = getPropertyInteger ("Workers");
+  if (workers == 0) workers = threadpool::hardwareThreads ();
+  if (workers > points) workers = points;
+  return worker || workers < 1 ? 1 : workers;
+#else
+  (void) points;
+  return 1;
+#endif
+}
+
+/* The function solves the points of the given frequency sweep
+   adaptively.  The solve function is run for the frequencies chosen by
+   the adaptive sampler only and saves its results into a scratch
+   dataset.  The variables of the output dataset then receive the
+   solved values and the rational interpolation in between for all the
+   points of the sweep.  The frequency dependency must be saved
+   completely before.  Sweeps which are not monotonic are solved at
+   all points, also into the scratch dataset. */
+int analysis::solveAdaptive (sweep * swp,
+			     const std::function<void (nr_double_t)> & solve) {
+  int points = swp->getSize ();
+  std::vector<nr_double_t> grid (points);
+  for (int i = 0; i < points; i++) grid[i] = swp->get (i);
+
+  // the rational models need the frequencies in order
+  bool monotonic = true;
+  for (int i = 2; i < points && monotonic; i++)
+    monotonic = (grid[i] - grid[i - 1]) * (grid[1] - grid[0]) > 0;
+  if (!monotonic)
+    logprint (LOG_ERROR, "WARNING: %s: adaptive sweep requires monotonic "
+	      "frequencies, solving all points\n", getName ());
+
+  adaptive fit (grid, getPropertyDouble ("AdaptTol"));
+  dataset * output = data;
+  data = new dataset ();
+  std::vector<qucs::vector *> vars;
+  std::vector<int> first, next;
+  std::vector<nr_complex_t> row;
+  std::vector<std::vector<nr_complex_t> > rows;
+  int samples = 0;
+
+  // solves the given grid point and collects all results in 'row'
+  auto sample = [&] (int i) {
+    int s = samples++;
+    solve (grid[i]);
+    // new variables have been prepended to the scratch dataset
+    std::vector<qucs::vector *> fresh;
+    int count = 0;
+    for (qucs::vector * v = data->getVariables (); v != NULL;
+	 v = v->getNext ())
+      count++;
+    qucs::vector * v = data->getVariables ();
+    for (int n = vars.size (); n < count; n++, v = v->getNext ())
+      fresh.push_back (v);
+    for (auto f = fresh.rbegin (); f != fresh.rend (); f++) {
+      vars.push_back (*f);
+      first.push_back (s);
+    }
+    row.resize (vars.size ());
+    for (size_t k = 0; k < vars.size (); k++) {
+      int n = s - first[k];
+      row[k] = n < vars[k]->getSize () ? vars[k]->get (n) : 0.0;
+    }
+  };
+
+  if (!monotonic) {
+    for (int i = 0; i < points; i++) {
+      sample (i);
+      rows.push_back (row);
+      if (progress) logprogressbar (i, points, 40);
+    }
+  }
+  else {
+    while (fit.select (next) > 0) {
+      for (int i : next) {
+	sample (i);
+	fit.setSample (i, row);
+      }
+      if (progress) logprogressbar (samples, points, 40);
+    }
+  }
+  if (progress) logprogressclear (40);
+#if DEBUG
+  logprint (LOG_STATUS, "NOTIFY: %s: adaptive sweep solved %d of %d "
+	    "points\n", getName (), samples, points);
+#endif
+
+  // save all points of the sweep into the output dataset
+  dataset * scratch = data;
+  data = output;
+  std::vector<qucs::vector *> out;
+  for (qucs::vector * v : vars) {
+    qucs::vector * d;
+    if ((d = data->findVariable (v->getName ())) == NULL) {
+      d = new qucs::vector (v->getName ());
+      if (v->getDependencies ())
+	d->setDependencies (new strlist (*v->getDependencies ()));
+      d->setOrigin (v->getOrigin ());
+      data->addVariable (d);
+    }
+    out.push_back (d);
+  }
+  for (int i = 0; i < points; i++) {
+    if (monotonic)
+      fit.interpolate (i, row);
+    else
+      row = rows[i];
+    for (size_t k = 0; k < out.size (); k++)
+      out[k]->add (k < row.size () ? row[k] : 0.0);
+  }
+  delete scratch;
+  return 0;
+}
+
+#if HAVE_FORK
+// Writes a possibly unset string into a worker result file.
+static void writeString (FILE * f, const char * s) {
+  int len = s ? strlen (s) : -1;
+  fwrite (&len, sizeof (len), 1, f);
+  if (len > 0) fwrite (s, 1, len, f);
+}
+
+/* Reads a string from a worker result file.  Returns zero on failure,
+   unset strings are returned as NULL. */
+static int readString (FILE * f, char ** s) {
+  int len;
+  *s = NULL;
+  if (fread (&len, sizeof (len), 1, f) != 1) return 0;
+  if (len < 0) return 1;
+  *s = (char *) malloc (len + 1);
+  (*s)[len] = '\0';
+  return len == 0 || fread (*s, 1, len, f) == (size_t) len;
+}
+
+/* Writes the given list of dataset vectors into a worker result file.
+   Vectors already known when the worker started are written with the
+   values added by the worker only.  The list is written backwards
+   since vectors get prepended to the dataset, thus new vectors appear
+   in their order of creation. */
+static void writeVectors (FILE * f, qucs::vector * list, int kind,
+			  std::map<qucs::vector *, int> & known) {
+  std::vector<qucs::vector *> order;
+  for (qucs::vector * v = list; v != NULL; v = v->getNext ())
+    order.push_back (v);
+  for (auto i = order.rbegin (); i != order.rend (); i++) {
+    qucs::vector * v = *i;
+    auto k = known.find (v);
+    int fresh = k == known.end ();
+    int first = fresh ? 0 : k->second;
+    int count = v->getSize () - first;
+    if (!fresh && count <= 0) continue;
+    fwrite (&kind, sizeof (kind), 1, f);
+    fwrite (&fresh, sizeof (fresh), 1, f);
+    writeString (f, v->getName ());
+    writeString (f, v->getOrigin ());
+    strlist * deps = v->getDependencies ();
+    int ndeps = deps ? deps->length () : 0;
+    fwrite (&ndeps, sizeof (ndeps), 1, f);
+    for (int d = 0; d < ndeps; d++) writeString (f, deps->get (d));
+    std::vector<nr_double_t> values (2 * count);
+    for (int n = 0; n < count; n++) {
+      nr_complex_t z = v->get (first + n);
+      values[2 * n + 0] = real (z);
+      values[2 * n + 1] = imag (z);
+    }
+    fwrite (&count, sizeof (count), 1, f);
+    fwrite (values.data (), sizeof (nr_double_t), 2 * count, f);
+  }
+}
+
+/* Merges the vectors of a worker result file into the given dataset.
+   Dependency vectors are filled completely by the analysis run which
+   created them, thus they are taken from the first worker only.  The
+   values of variable vectors are appended.  Returns zero on failure. */
+static int readVectors (FILE * f, dataset * data) {
+  int kind, fresh, ndeps, count;
+  char * name, * origin, * dep;
+  while (fread (&kind, sizeof (kind), 1, f) == 1 && kind >= 0) {
+    if (fread (&fresh, sizeof (fresh), 1, f) != 1) return 0;
+    if (!readString (f, &name) || name == NULL) return 0;
+    if (!readString (f, &origin)) { free (name); return 0; }
+    strlist * deps = new strlist ();
+    int ok = fread (&ndeps, sizeof (ndeps), 1, f) == 1;
+    for (int d = 0; ok && d < ndeps; d++) {
+      if ((ok = readString (f, &dep)) && dep != NULL) deps->append (dep);
+      free (dep);
+    }
+    ok = ok && fread (&count, sizeof (count), 1, f) == 1 && count >= 0;
+    std::vector<nr_double_t> values (ok ? 2 * count : 0);
+    ok = ok && fread (values.data (), sizeof (nr_double_t), 2 * count, f) ==
+      (size_t) 2 * count;
+    qucs::vector * v = NULL;
+    bool created = false;
+    if (ok && kind == 0) {
+      if (fresh && data->findDependency (name) == NULL) {
+	v = new qucs::vector (name);
+	data->addDependency (v);
+	created = true;
+      }
+    }
+    else if (ok && (v = data->findVariable (name)) == NULL) {
+      v = new qucs::vector (name);
+      data->addVariable (v);
+      created = true;
+    }
+    if (created) {
+      if (origin) v->setOrigin (origin);
+      if (ndeps > 0) {
+	v->setDependencies (deps);
+	deps = NULL;
+      }
+    }
+    delete deps;
+    for (int n = 0; v != NULL && n < count; n++)
+      v->add (nr_complex_t (values[2 * n], values[2 * n + 1]));
+    free (name);
+    free (origin);
+    if (!ok) return 0;
+  }
+  return 1;
+}
+
+/* The function solves the given number of points in the given number
+   of worker processes.  Each worker runs the solve function for a
+   contiguous chunk of points on its own copy of the netlist, the
+   environment and the dataset, and writes the values it added to the
+   dataset into a temporary file.  The results are merged back into the
+   dataset in the order of the points, thus the output equals the
+   output of solving the points sequentially.  Dependency vectors which
+   the workers would fill point by point must be saved completely
+   before. */
+int analysis::solveWorkers (int workers, int points,
+			    const std::function<int (int, int)> & solve) {
+  int err = 0;
+  std::vector<pid_t> pids (workers, -1);
+  std::vector<FILE *> files (workers, (FILE *) NULL);
+
+  // start the worker processes
+  for (int w = 0; w < workers; w++) {
+    if ((files[w] = tmpfile ()) == NULL) break;
+    fflush (NULL);
+    if ((pids[w] = fork ()) == 0) {
+      worker = true;
+      data->setStream (0);
+      std::map<qucs::vector *, int> known;
+      qucs::vector * v;
+      for (v = data->getDependencies (); v != NULL; v = v->getNext ())
+	known[v] = v->getSize ();
+      for (v = data->getVariables (); v != NULL; v = v->getNext ())
+	known[v] = v->getSize ();
+      err = solve (w * points / workers, (w + 1) * points / workers);
+      int end = -1;
+      writeVectors (files[w], data->getDependencies (), 0, known);
+      writeVectors (files[w], data->getVariables (), 1, known);
+      fwrite (&end, sizeof (end), 1, files[w]);
+      if (fflush (files[w]) != 0) err = 2;
+      fflush (NULL);
+      _exit (err ? (err == 2 ? 2 : 1) : 0);
+    }
+    if (pids[w] < 0) break;
+  }
+
+  // collect the results of the workers in order
+  for (int w = 0; w < workers; w++) {
+    int status = 0;
+    if (pids[w] < 0) {
+      logprint (LOG_ERROR, "ERROR: %s: cannot start worker process\n",
+		getName ());
+      err |= 1;
+    }
+    else if (waitpid (pids[w], &status, 0) != pids[w] ||
+	     !WIFEXITED (status) || WEXITSTATUS (status) > 1) {
+      logprint (LOG_ERROR, "ERROR: %s: worker process failed\n",
+		getName ());
+      err |= 1;
+    }
+    else {
+      err |= WEXITSTATUS (status);
+      rewind (files[w]);
+      if (!readVectors (files[w], data)) {
+	logprint (LOG_ERROR, "ERROR: %s: cannot read worker results\n",
+		  getName ());
+	err |= 1;
+      }
+    }
+    if (files[w]) fclose (files[w]);
+    if (progress) logprogressbar (w + 1, workers, 40);
+  }
+  if (progress) logprogressclear (40);
+  return err;
+}
+#endif /* HAVE_FORK */
+
 } // namespace qucs
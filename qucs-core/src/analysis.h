@@ -31,6 +31,8 @@
 #ifndef __ANALYSIS_H__
 #define __ANALYSIS_H__
 
+#include <functional>
+
 #include "object.h"
 #include "ptrlist.h"
 
@@ -38,6 +40,10 @@
 #define SAVE_ALL 2 // also save subcircuit nodes and operating points
 #define SAVE_CVS 4 // save characteristic values
 
+#define CONT_None        0 // solve each sweep point from scratch
+#define CONT_Previous    1 // start from the previous sweep point
+#define CONT_Extrapolate 2 // extrapolate from the last two sweep points
+
 #define ACREATOR(val) \
   val (); \
   static analysis * create (void) { return new val (); } \
@@ -267,7 +273,64 @@ public:
         progress = p;
     }
 
+    /*! \fn countWorkers
+     * \brief Number of worker processes
+     * \param points number of points to be solved
+     *
+     * Returns the number of worker processes for solving the given
+     * number of points as given by the "Workers" property.
+     */
+    int countWorkers (int);
+
+    /*! \fn setContinuation
+     * \brief Seed the next solution from previous sweep points
+     * \param mode continuation mode
+     * \param p value of the swept parameter at the next point
+     *
+     * Called by a parameter sweep before each point.  Analyses
+     * supporting continuation start the next solve() from the
+     * solutions of the previous points.  CONT_None forgets them.
+     */
+    virtual void setContinuation (int, nr_double_t) { }
+
+    /*! \fn getStatistics
+     * \brief Iteration statistics of the last solve()
+     * \param iterations number of Newton iterations of all attempts
+     * \param fallbacks number of fallbacks after failed attempts
+     *
+     * Returns false if the analysis does not iterate.
+     */
+    virtual bool getStatistics (int &, int &)
+    {
+        return false;
+    }
+
+    /*! \fn solveAdaptive
+     * \brief Solve a frequency sweep adaptively
+     * \param swp the dense frequency sweep
+     * \param solve function solving and saving a single frequency
+     *
+     * Solves the frequencies chosen by an adaptive sampler only and
+     * saves the rational interpolation of the results for all points
+     * of the sweep as given by the "AdaptTol" property.
+     */
+    int solveAdaptive (sweep *, const std::function<void (nr_double_t)> &);
+
+#if HAVE_FORK
+    /*! \fn solveWorkers
+     * \brief Solve points in parallel worker processes
+     * \param workers number of worker processes
+     * \param points number of points
+     * \param solve function solving the points from first to last
+     *
+     * Solves contiguous chunks of points in forked worker processes
+     * and merges their results into the dataset in order.
+     */
+    int solveWorkers (int, int, const std::function<int (int, int)> &);
+#endif
+
 protected:
+    static bool worker;
     int runs;
     int type;
     net * subnet;
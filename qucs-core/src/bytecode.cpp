@@ -0,0 +1,408 @@
+/*
+ * bytecode.cpp - compiled equation kernel class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include <algorithm>
+
+#include "complex.h"
+#include "object.h"
+#include "equation.h"
+#include "evaluate.h"
+#include "bytecode.h"
+
+using namespace qucs;
+using namespace qucs::eqn;
+
+// Short helper macros.
+#define C(con) ((constant *) (con))
+#define A(con) ((assignment *) (con))
+
+// Operations of the register program.
+enum {
+  OP_LOAD,    // result of an equation not compiled
+  OP_ADD,
+  OP_SUB,
+  OP_MUL,
+  OP_DIV,
+  OP_NEG,
+  OP_LESS,
+  OP_GREATER,
+  OP_LESSOREQUAL,
+  OP_GREATEROREQUAL,
+  OP_EQUAL,
+  OP_NOTEQUAL,
+  OP_NOT,
+  OP_AND,
+  OP_OR,
+  OP_SELECT,  // conditional
+  OP_FUNC1,   // unary function
+  OP_FUNC2    // binary function
+};
+
+static nr_double_t modulo (const nr_double_t d1, const nr_double_t d2) {
+  return std::fmod (d1, d2);
+}
+static nr_double_t maximum (const nr_double_t d1, const nr_double_t d2) {
+  return std::max (d1, d2);
+}
+static nr_double_t minimum (const nr_double_t d1, const nr_double_t d2) {
+  return std::min (d1, d2);
+}
+
+/* Evaluation functions of real valued applications mapped to the
+   operations they perform. */
+static struct {
+  evaluator_t eval;
+  int op;
+} operators[] = {
+  { evaluate::plus_d_d,            OP_ADD            },
+  { evaluate::minus_d_d,           OP_SUB            },
+  { evaluate::times_d_d,           OP_MUL            },
+  { evaluate::over_d_d,            OP_DIV            },
+  { evaluate::minus_d,             OP_NEG            },
+  { evaluate::less_d_d,            OP_LESS           },
+  { evaluate::greater_d_d,         OP_GREATER        },
+  { evaluate::lessorequal_d_d,     OP_LESSOREQUAL    },
+  { evaluate::greaterorequal_d_d,  OP_GREATEROREQUAL },
+  { evaluate::equal_d_d,           OP_EQUAL          },
+  { evaluate::notequal_d_d,        OP_NOTEQUAL       },
+  { evaluate::not_b,               OP_NOT            },
+  { evaluate::and_b_b,             OP_AND            },
+  { evaluate::or_b_b,              OP_OR             },
+  { evaluate::ifthenelse_d_d,      OP_SELECT         },
+  { evaluate::ifthenelse_b_b,      OP_SELECT         },
+  { evaluate::ifthenelse_b_d,      OP_SELECT         },
+  { evaluate::ifthenelse_d_b,      OP_SELECT         },
+  { NULL, -1 }
+};
+
+static struct {
+  evaluator_t eval;
+  unary_t func;
+} unaries[] = {
+  { evaluate::exp_d,     qucs::exp     },
+  { evaluate::limexp_d,  qucs::limexp  },
+  { evaluate::sin_d,     qucs::sin     },
+  { evaluate::cos_d,     qucs::cos     },
+  { evaluate::tan_d,     qucs::tan     },
+  { evaluate::sinh_d,    qucs::sinh    },
+  { evaluate::cosh_d,    qucs::cosh    },
+  { evaluate::tanh_d,    qucs::tanh    },
+  { evaluate::coth_d,    qucs::coth    },
+  { evaluate::sech_d,    qucs::sech    },
+  { evaluate::cosech_d,  qucs::cosech  },
+  { evaluate::arcsin_d,  qucs::asin    },
+  { evaluate::arccos_d,  qucs::acos    },
+  { evaluate::arctan_d,  qucs::atan    },
+  { evaluate::signum_d,  qucs::signum  },
+  { evaluate::sign_d,    qucs::sign    },
+  { evaluate::sinc_d,    qucs::sinc    },
+  { evaluate::sqr_d,     qucs::sqr     },
+  { evaluate::abs_d,     qucs::abs     },
+  { evaluate::step_d,    qucs::step    },
+  { NULL, NULL }
+};
+
+static struct {
+  evaluator_t eval;
+  binary_t func;
+} binaries[] = {
+  { evaluate::power_d_d,   qucs::pow    },
+  { evaluate::xhypot_d_d,  qucs::xhypot },
+  { evaluate::modulo_d_d,  modulo       },
+  { evaluate::max_d_d,     maximum      },
+  { evaluate::min_d_d,     minimum      },
+  { NULL, NULL }
+};
+
+// Constructor creates an empty bytecode program.
+bytecode::bytecode () {
+}
+
+// Destructor deletes a bytecode program.
+bytecode::~bytecode () {
+}
+
+/* Adds an input to the program.  The given equation is not compiled,
+   its value is rather set by the caller using the returned
+   register. */
+int bytecode::addInput (node * eqn) {
+  int r = regs.size ();
+  regs.push_back (0.0);
+  lits.push_back (0);
+  vars[eqn] = r;
+  varying[eqn] = 1;
+  return r;
+}
+
+// Returns the register holding the given constant value.
+int bytecode::literal (nr_double_t val) {
+  if (val == val) {
+    std::map<nr_double_t, int>::iterator it = literals.find (val);
+    if (it != literals.end ()) return it->second;
+  }
+  int r = regs.size ();
+  regs.push_back (val);
+  lits.push_back (1);
+  if (val == val) literals[val] = r;
+  return r;
+}
+
+/* Appends an operation to the program and returns the register
+   holding its result.  Operations already computed before are not
+   repeated, operations on constants are computed right away. */
+int bytecode::emit (int op, int a, int b, int c, void * f) {
+  // normalize commutative operations
+  switch (op) {
+  case OP_ADD: case OP_MUL: case OP_EQUAL: case OP_NOTEQUAL:
+  case OP_AND: case OP_OR:
+    if (a > b) std::swap (a, b);
+    break;
+  }
+
+  // apply some simplifications
+  switch (op) {
+  case OP_ADD:
+    if (isLiteral (a) && regs[a] == 0.0) return b;
+    if (isLiteral (b) && regs[b] == 0.0) return a;
+    break;
+  case OP_SUB:
+    if (isLiteral (b) && regs[b] == 0.0) return a;
+    break;
+  case OP_MUL:
+    if (isLiteral (a) && regs[a] == 1.0) return b;
+    if (isLiteral (b) && regs[b] == 1.0) return a;
+    break;
+  case OP_DIV:
+    if (isLiteral (b) && regs[b] == 1.0) return a;
+    break;
+  }
+
+  // look for common subexpressions
+  key_t key (op, a, b, c, f);
+  std::map<key_t, int>::iterator it = exprs.find (key);
+  if (it != exprs.end ()) return it->second;
+
+  instruction i;
+  i.op = op;
+  i.a = a; i.b = b; i.c = c;
+  i.f1 = op == OP_FUNC1 ? (unary_t) f : NULL;
+  i.f2 = op == OP_FUNC2 ? (binary_t) f : NULL;
+  i.ext = op == OP_LOAD ? (node *) f : NULL;
+  i.dst = regs.size ();
+  regs.push_back (0.0);
+  lits.push_back (0);
+
+  // fold constant operations
+  if (op != OP_LOAD && isLiteral (a) &&
+      (b < 0 || isLiteral (b)) && (c < 0 || isLiteral (c))) {
+    execute (i);
+    nr_double_t val = regs[i.dst];
+    if (std::isfinite (val)) {
+      regs.pop_back ();
+      lits.pop_back ();
+      return literal (val);
+    }
+  }
+
+  code.push_back (i);
+  exprs[key] = i.dst;
+  return i.dst;
+}
+
+/* Checks whether the value of the given expression can change during
+   a simulation.  This is the case if it depends on inputs or on
+   equations evaluated on demand only. */
+int bytecode::isVarying (node * n) {
+  switch (n->getTag ()) {
+  case REFERENCE: {
+    reference * r = (reference *) n;
+    r->findVariable ();
+    node * ref = r->ref;
+    if (ref == NULL) return 0;
+    std::map<node *, int>::iterator it = varying.find (ref);
+    if (it != varying.end ()) return it->second;
+    int v = ref->skip ? 1 : isVarying (A(ref)->body);
+    varying[ref] = v;
+    return v;
+  }
+  case APPLICATION:
+    for (node * arg = ((application *) n)->args; arg; arg = arg->getNext ())
+      if (isVarying (arg)) return 1;
+    return 0;
+  case ASSIGNMENT:
+    return isVarying (A(n)->body);
+  }
+  return 0;
+}
+
+/* Compiles the given equation or expression and returns the register
+   holding its value or -1 if the expression cannot be compiled. */
+int bytecode::compile (node * n) {
+  if (n == NULL) return -1;
+  switch (n->getTag ()) {
+  case CONSTANT:
+    if (C(n)->getType () == TAG_DOUBLE) return literal (C(n)->d);
+    if (C(n)->getType () == TAG_BOOLEAN) return literal (C(n)->b ? 1 : 0);
+    break;
+  case REFERENCE:
+    return compileReference ((reference *) n);
+  case APPLICATION:
+    return compileApplication ((application *) n);
+  case ASSIGNMENT: {
+    std::map<node *, int>::iterator it = vars.find (n);
+    if (it != vars.end ()) return it->second;
+    int r = compile (A(n)->body);
+    if (r >= 0) vars[n] = r;
+    return r;
+  }
+  }
+  return -1;
+}
+
+/* Variables which depend on the inputs are compiled in place, all
+   others are loaded from the equation solver. */
+int bytecode::compileReference (reference * n) {
+  if (!(n->getType () & (TAG_DOUBLE | TAG_BOOLEAN))) return -1;
+  n->findVariable ();
+  node * ref = n->ref;
+  if (ref == NULL) return -1;
+  std::map<node *, int>::iterator it = vars.find (ref);
+  if (it != vars.end ()) return it->second;
+  int r;
+  if (ref->skip && A(ref)->body->getTag () == CONSTANT)
+    r = emit (OP_LOAD, -1, -1, -1, ref);
+  else if (isVarying (ref))
+    r = compile (A(ref)->body);
+  else
+    r = emit (OP_LOAD, -1, -1, -1, ref);
+  if (r >= 0) vars[ref] = r;
+  return r;
+}
+
+// Compiles an application with real valued arguments.
+int bytecode::compileApplication (application * n) {
+  if (!(n->getType () & (TAG_DOUBLE | TAG_BOOLEAN))) return -1;
+  if (n->nargs < 1 || n->nargs > 3 || !strcmp (n->n, "ddx")) return -1;
+
+  // compile arguments first
+  int i, r[3] = { -1, -1, -1 };
+  node * arg = n->args;
+  for (i = 0; i < n->nargs && arg != NULL; i++, arg = arg->getNext ()) {
+    if ((r[i] = compile (arg)) < 0) return -1;
+  }
+
+  if (n->eval == eqn::evaluate::plus_d && n->nargs == 1) return r[0];
+  for (i = 0; operators[i].eval != NULL; i++) {
+    if (n->eval == operators[i].eval)
+      return emit (operators[i].op, r[0], r[1], r[2]);
+  }
+  if (n->nargs == 1) {
+    for (i = 0; unaries[i].eval != NULL; i++) {
+      if (n->eval == unaries[i].eval)
+	return emit (OP_FUNC1, r[0], -1, -1, (void *) unaries[i].func);
+    }
+  }
+  if (n->nargs == 2) {
+    for (i = 0; binaries[i].eval != NULL; i++) {
+      if (n->eval == binaries[i].eval)
+	return emit (OP_FUNC2, r[0], r[1], -1, (void *) binaries[i].func);
+    }
+  }
+  return -1;
+}
+
+// Executes a single instruction.
+inline void bytecode::execute (instruction & i) {
+  nr_double_t * r = regs.data ();
+  switch (i.op) {
+  case OP_LOAD:
+    r[i.dst] = A(i.ext)->body->getResultDouble ();
+    break;
+  case OP_ADD:
+    r[i.dst] = r[i.a] + r[i.b];
+    break;
+  case OP_SUB:
+    r[i.dst] = r[i.a] - r[i.b];
+    break;
+  case OP_MUL:
+    r[i.dst] = r[i.a] * r[i.b];
+    break;
+  case OP_DIV:
+    r[i.dst] = r[i.a] / r[i.b];
+    break;
+  case OP_NEG:
+    r[i.dst] = -r[i.a];
+    break;
+  case OP_LESS:
+    r[i.dst] = r[i.a] < r[i.b];
+    break;
+  case OP_GREATER:
+    r[i.dst] = r[i.a] > r[i.b];
+    break;
+  case OP_LESSOREQUAL:
+    r[i.dst] = r[i.a] <= r[i.b];
+    break;
+  case OP_GREATEROREQUAL:
+    r[i.dst] = r[i.a] >= r[i.b];
+    break;
+  case OP_EQUAL:
+    r[i.dst] = r[i.a] == r[i.b];
+    break;
+  case OP_NOTEQUAL:
+    r[i.dst] = r[i.a] != r[i.b];
+    break;
+  case OP_NOT:
+    r[i.dst] = r[i.a] == 0.0;
+    break;
+  case OP_AND:
+    r[i.dst] = r[i.a] != 0.0 && r[i.b] != 0.0;
+    break;
+  case OP_OR:
+    r[i.dst] = r[i.a] != 0.0 || r[i.b] != 0.0;
+    break;
+  case OP_SELECT:
+    r[i.dst] = r[i.a] != 0.0 ? r[i.b] : r[i.c];
+    break;
+  case OP_FUNC1:
+    r[i.dst] = i.f1 (r[i.a]);
+    break;
+  case OP_FUNC2:
+    r[i.dst] = i.f2 (r[i.a], r[i.b]);
+    break;
+  }
+}
+
+/* Runs the given range of instructions of the program.  By default
+   the whole program is run. */
+void bytecode::evaluate (int first, int last) {
+  if (last < 0) last = code.size ();
+  for (int i = first; i < last; i++) execute (code[i]);
+}
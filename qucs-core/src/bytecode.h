@@ -0,0 +1,93 @@
+/*
+ * bytecode.h - compiled equation kernel class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef __BYTECODE_H__
+#define __BYTECODE_H__
+
+#include <vector>
+#include <map>
+#include <tuple>
+
+namespace qucs {
+
+namespace eqn {
+
+class node;
+class application;
+class reference;
+
+// Type of functions called by the compiled equations.
+typedef nr_double_t (* unary_t) (const nr_double_t);
+typedef nr_double_t (* binary_t) (const nr_double_t, const nr_double_t);
+
+/* The bytecode class lowers the trees of real valued equations into a
+   flat register program.  Equal subexpressions of all the compiled
+   equations are computed once only, constant subexpressions are
+   folded during compilation.  Evaluating the program neither
+   allocates memory nor walks the equation trees. */
+class bytecode
+{
+ public:
+  bytecode ();
+  ~bytecode ();
+  int addInput (node *);
+  int compile (node *);
+  int size (void) { return code.size (); }
+  void set (int r, nr_double_t val) { regs[r] = val; }
+  nr_double_t get (int r) const { return regs[r]; }
+  void evaluate (int first = 0, int last = -1);
+
+ private:
+  struct instruction {
+    int op;
+    int a, b, c;
+    int dst;
+    unary_t f1;
+    binary_t f2;
+    node * ext;
+  };
+  typedef std::tuple<int, int, int, int, void *> key_t;
+
+  int literal (nr_double_t);
+  int emit (int, int, int b = -1, int c = -1, void * f = NULL);
+  int compileApplication (application *);
+  int compileReference (reference *);
+  int isVarying (node *);
+  int isLiteral (int r) { return lits[r]; }
+  void execute (instruction &);
+
+  std::vector<nr_double_t> regs;
+  std::vector<char> lits;
+  std::vector<instruction> code;
+  std::map<key_t, int> exprs;
+  std::map<nr_double_t, int> literals;
+  std::map<node *, int> vars;
+  std::map<node *, int> varying;
+};
+
+} /* namespace eqn */
+
+} // namespace qucs
+
+#endif /* __BYTECODE_H__ */
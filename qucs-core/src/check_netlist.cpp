@@ -33,6 +33,12 @@
 #include <assert.h>
 #include <float.h>
 
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "logging.h"
 #include "strlist.h"
 #include "netdefs.h"
@@ -51,6 +57,92 @@ struct definition_t * definition_root = NULL;
 struct definition_t * subcircuit_root = NULL;
 environment * env_root = NULL;
 
+/* Environments of the subcircuit instances created during the expansion
+   of the netlist indexed by their parent environment, the subcircuit
+   type and the instance parameters. */
+static std::unordered_map<std::string, environment *> instance_envs;
+
+/* Hash indices of the definition list currently being checked and of
+   the subcircuit definitions.  They replace the repeated walks through
+   these lists which made checking large netlists quadratic. */
+static std::unordered_map<std::string, int> definition_counts;
+static std::unordered_map<std::string, struct value_t *> definition_idents;
+static std::unordered_map<std::string, struct definition_t *> subcircuit_index;
+
+/* The definitions, node lists, pairs and values of the parse tree are
+   allocated in large blocks and the strings therein are interned, thus
+   the scanner and the parser do not call malloc() for each token and
+   identical identifiers (node names, property keys, component types)
+   are stored once.  Everything is released at once by
+   netlist_destroy(). */
+#define NETLIST_BLOCK_SIZE 65536
+
+struct netlist_string_hash
+{
+    size_t operator() (const char * str) const
+    {
+        size_t h = 2166136261u;
+        for (; *str; str++) h = (h ^ (unsigned char) *str) * 16777619u;
+        return h;
+    }
+};
+
+struct netlist_string_equal
+{
+    bool operator() (const char * a, const char * b) const
+    {
+        return !strcmp (a, b);
+    }
+};
+
+static std::vector<char *> netlist_blocks;
+static char * netlist_block = NULL;
+static size_t netlist_block_free = 0;
+static std::unordered_set<const char *, netlist_string_hash,
+       netlist_string_equal> netlist_strings;
+
+/* The function returns zeroed memory of the given size which is valid
+   until the parse tree gets destroyed. */
+void * netlist_alloc (size_t size)
+{
+    // keep the structures aligned
+    size = (size + sizeof (double) - 1) & ~(sizeof (double) - 1);
+    if (size > netlist_block_free)
+    {
+        netlist_block_free = std::max (size, (size_t) NETLIST_BLOCK_SIZE);
+        netlist_block = (char *) calloc (netlist_block_free, 1);
+        netlist_blocks.push_back (netlist_block);
+    }
+    void * ptr = netlist_block;
+    netlist_block += size;
+    netlist_block_free -= size;
+    return ptr;
+}
+
+/* The function returns the single copy of the given string within the
+   parse tree.  Interned strings must not be modified or free()'d. */
+char * netlist_intern (const char * str)
+{
+    auto it = netlist_strings.find (str);
+    if (it != netlist_strings.end ())
+        return (char *) *it;
+    size_t len = strlen (str) + 1;
+    char * copy = (char *) memcpy (netlist_alloc (len), str, len);
+    netlist_strings.insert (copy);
+    return copy;
+}
+
+// Releases the memory of the parse tree.
+static void netlist_free_blocks (void)
+{
+    netlist_strings.clear ();
+    for (char * block : netlist_blocks)
+        free (block);
+    netlist_blocks.clear ();
+    netlist_block = NULL;
+    netlist_block_free = 0;
+}
+
 /* The function counts the nodes in a definition line. */
 static int checker_count_nodes (struct definition_t * def)
 {
@@ -103,46 +195,47 @@ static int checker_is_property (struct define_t * available,
     return PROP_NONE;
 }
 
-/* Counts the number of definitions given by the specified type and
-   instance name in the definition list. */
-static int checker_count_definition (struct definition_t * root,
-                                     const char * type, char * instance)
+/* The function builds the indices of the given definition list.  It
+   counts the definitions of each type and instance name and marks all
+   but the first of them as duplicates.  Also the first identifier value
+   of each definition type and property key is saved. */
+static void checker_index_definitions (struct definition_t * root)
 {
-    int count = 0;
+    definition_counts.clear ();
+    definition_idents.clear ();
     for (struct definition_t * def = root; def != NULL; def = def->next)
     {
-        if (!strcmp (def->type, type) && !strcmp (def->instance, instance))
+        std::string type = std::string (def->type) + '\n';
+        if (++definition_counts[type + def->instance] > 1)
+            def->duplicate = 1;
+        for (struct pair_t * pair = def->pairs; pair != NULL; pair = pair->next)
         {
-            if (++count > 1)
-                def->duplicate = 1;
+            if (pair->value != NULL && pair->value->ident != NULL)
+                definition_idents.emplace (type + pair->key + '\n' +
+                                           pair->value->ident, pair->value);
         }
     }
-    return count;
+}
+
+/* Counts the number of definitions given by the specified type and
+   instance name in the indexed definition list. */
+static int checker_count_definition (const char * type, char * instance)
+{
+    auto it = definition_counts.find (std::string (type) + '\n' + instance);
+    return it != definition_counts.end () ? it->second : 0;
 }
 
 /* Returns the value for a given definition type, key and variable
-   identifier if it is in the list of definitions.  Otherwise the
-   function returns NULL. */
-static struct value_t * checker_find_variable (struct definition_t * root,
-        const char * type,
+   identifier if it is in the indexed list of definitions.  Otherwise
+   the function returns NULL. */
+static struct value_t * checker_find_variable (const char * type,
         const char * key,
         char * ident)
 {
-    struct pair_t * pair;
-    for (struct definition_t * def = root; def != NULL; def = def->next)
-    {
-        if (!strcmp (def->type, type))
-        {
-            for (pair = def->pairs; pair != NULL; pair = pair->next)
-            {
-                if (!strcmp (pair->key, key))
-                    if (pair->value->ident != NULL && ident != NULL &&
-                            strcmp (pair->value->ident, ident) == 0)
-                        return pair->value;
-            }
-        }
-    }
-    return NULL;
+    if (ident == NULL) return NULL;
+    auto it = definition_idents.find (std::string (type) + '\n' + key + '\n' +
+                                      ident);
+    return it != definition_idents.end () ? it->second : NULL;
 }
 
 /* The function returns the appropriate value for a given key within
@@ -253,7 +346,7 @@ static int checker_resolve_variable (struct definition_t * root,
     {
         int found = 0;
         /* 1. find variable in parameter sweeps */
-        if ((val = checker_find_variable (root, "SW", "Param", value->ident)))
+        if ((val = checker_find_variable ("SW", "Param", value->ident)))
         {
             /* add parameter sweep variable to environment */
             if (!strcmp (def->type, "SW") && !strcmp (pair->key, "Param"))
@@ -267,7 +360,7 @@ static int checker_resolve_variable (struct definition_t * root,
             found++;
         }
         /* 2. find analysis in parameter sweeps */
-        if ((val = checker_find_variable (root, "SW", "Sim", value->ident)))
+        if ((val = checker_find_variable ("SW", "Sim", value->ident)))
         {
             found++;
         }
@@ -278,7 +371,7 @@ static int checker_resolve_variable (struct definition_t * root,
             found++;
         }
         /* 4. find subcircuit definition in subcircuit components */
-        if ((val = checker_find_variable (root, "Sub", "Type", value->ident)))
+        if ((val = checker_find_variable ("Sub", "Type", value->ident)))
         {
             found++;
         }
@@ -288,12 +381,12 @@ static int checker_resolve_variable (struct definition_t * root,
             found++;
         }
         /* 6. find file reference in S-parameter file components */
-        if ((val = checker_find_variable (root, "SPfile", "File", value->ident)))
+        if ((val = checker_find_variable ("SPfile", "File", value->ident)))
         {
             found++;
         }
         /* 6a. find file reference in S-parameter de-embedding file components */
-        if ((val = checker_find_variable (root, "SPDfile", "File", value->ident)))
+        if ((val = checker_find_variable ("SPDfile", "File", value->ident)))
         {
             found++;
         }
@@ -313,11 +406,11 @@ static int checker_resolve_variable (struct definition_t * root,
             }
         }
         /* 8. find file reference in file based sources */
-        if ((val = checker_find_variable (root, "Vfile", "File", value->ident)))
+        if ((val = checker_find_variable ("Vfile", "File", value->ident)))
         {
             found++;
         }
-        if ((val = checker_find_variable (root, "Ifile", "File", value->ident)))
+        if ((val = checker_find_variable ("Ifile", "File", value->ident)))
         {
             found++;
         }
@@ -337,8 +430,7 @@ static int checker_resolve_variable (struct definition_t * root,
                 sprintf (ref, "%s.%s.ref", def->instance, value->ident);
 
                 // replace property string
-                free (value->ident);
-                value->ident = strdup (ref);
+                value->ident = netlist_intern (ref);
                 value->var = TAG_DOUBLE;
 
                 // already done previously?
@@ -482,9 +574,8 @@ static int checker_evaluate_scale (struct value_t * value)
         }
         if (*scale != '\0')
         {
-            value->unit = strdup (scale);
+            value->unit = netlist_intern (scale);
         }
-        free (value->scale);
         value->scale = NULL;
     }
     value->value = val * factor;
@@ -515,10 +606,19 @@ static int checker_count_definitions (struct definition_t * root,
    no such subcircuit the function returns NULL: */
 static struct definition_t * checker_find_subcircuit (char * n)
 {
-    struct definition_t * def;
-    for (def = subcircuit_root; def != NULL; def = def->next)
-        if (n != NULL && !strcmp (def->instance, n)) return def;
-    return NULL;
+    if (n == NULL) return NULL;
+    auto it = subcircuit_index.find (n);
+    return it != subcircuit_index.end () ? it->second : NULL;
+}
+
+/* The function builds the index of the subcircuit definitions.  Like a
+   search through the list it yields the first one of equally named
+   subcircuits. */
+static void checker_index_subcircuits (void)
+{
+    subcircuit_index.clear ();
+    for (struct definition_t * def = subcircuit_root; def != NULL; def = def->next)
+        subcircuit_index.emplace (def->instance, def);
 }
 
 /* The function returns the subcircuit definition for the given
@@ -909,7 +1009,7 @@ static int checker_validate_strips (struct definition_t * root)
                 }
                 else
                 {
-                    if (checker_count_definition (root, "SUBST", val->ident) != 1)
+                    if (checker_count_definition ("SUBST", val->ident) != 1)
                     {
                         logprint (LOG_ERROR, "line %d: checker error, no such substrate "
                                   "`%s' found as specified in `%s:%s'\n", def->line,
@@ -1260,13 +1360,14 @@ checker_build_subcircuits (struct definition_t * root)
 }
 
 /* The function produces a copy of the given circuit definition and
-   marks it as a copy.  The node definition are not included within
-   the copy. */
+   marks it as a copy.  The copy shares the node list, the pairs and
+   the names with the subcircuit element, the actual instance name and
+   nodes are resolved through the subcircuit instance 'inst'. */
 static struct definition_t *
-checker_copy_subcircuit (struct definition_t * sub)
+checker_copy_subcircuit (struct definition_t * sub, struct instance_t * inst)
 {
     struct definition_t * copy;
-    copy = (struct definition_t *) calloc (sizeof (struct definition_t), 1);
+    copy = (struct definition_t *) netlist_alloc (sizeof (struct definition_t));
     copy->action = sub->action;
     copy->nonlinear = sub->nonlinear;
     copy->substrate = sub->substrate;
@@ -1274,190 +1375,116 @@ checker_copy_subcircuit (struct definition_t * sub)
     copy->define = sub->define;
     copy->pairs = sub->pairs;
     copy->ncount = sub->ncount;
-    copy->type = strdup (sub->type);
+    copy->type = sub->type;
+    copy->instance = sub->instance;
+    copy->nodes = sub->nodes;
+    copy->overlay = inst;
     copy->copy = 1;
     return copy;
 }
 
-/* This function translates the node definitions of the given
-   subcircuit element 'sub'.  The translation is based upon the node
-   definitions of the subcircuit 'type' and the instance 'inst' of
-   such a subcircuit.  The translated nodes are saved in an extra
-   'xlate' field of each node of the subcircuit element 'sub'. */
-static void checker_xlat_subcircuit_nodes (struct definition_t * type,
-        struct definition_t * inst,
-        struct definition_t * sub)
+/* This function numbers the nodes of the elements of the subcircuit
+   'type' which are connected to the ports of the subcircuit.  The port
+   number is saved in the 'xlatenr' field of each node, it is used to
+   look up the node of a subcircuit instance. */
+static void checker_xlat_subcircuit_nodes (struct definition_t * type)
 {
-    struct node_t * n, * ninst, * ntype;
+    struct node_t * n, * ntype;
     int i;
-    // go through nodes of the subcircuit 'type' and 'inst'
-    for (i = 1, ntype = type->nodes, ninst = inst->nodes; ntype != NULL;
-            ntype = ntype->next, ninst = ninst->next, i++)
+    for (struct definition_t * def = type->sub; def != NULL; def = def->next)
     {
-        for (n = sub->nodes; n != NULL; n = n->next)
+        for (i = 1, ntype = type->nodes; ntype != NULL;
+                ntype = ntype->next, i++)
         {
-            /* check whether a node in the subcircuit element 'sub' corresponds
-            with the 'type', then assign the 'inst's node name */
-            if (!strcmp (n->node, ntype->node))
+            for (n = def->nodes; n != NULL; n = n->next)
             {
-                n->xlate = strdup (ninst->node);
-                n->xlatenr = i;
+                if (!strcmp (n->node, ntype->node)) n->xlatenr = i;
             }
         }
     }
 }
 
-/* The function creates a subcircuit node name consisting of the given
-   arguments.  If the given 'instances' is NULL it is left out.  The
-   caller is responsible to free() the returned string. */
-static char * checker_subcircuit_node (char * type, char * instances,
-                                       char * instance, char * node)
+/* The function creates a subcircuit element or node name consisting of
+   the given instance name and the base name. */
+static char * checker_subcircuit_name (char * instance, char * base)
 {
-    char * txt = (char *)
-                 calloc (1, strlen (type) + strlen (instance) + strlen (node) +
-                         (instances ? strlen (instances) : 0) + 4);
-    if (instances)
-        sprintf (txt, "%s.%s.%s.%s", type, instances, instance, node);
-    else
-        sprintf (txt, "%s.%s.%s", type, instance, node);
-    return txt;
+    std::string txt = std::string (instance) + "." + base;
+    return netlist_intern (txt.c_str ());
 }
 
-/* The function reverses the order of the given node list and returns
-   the reversed list. */
-struct node_t * netlist_reverse_nodes (struct node_t * nodes)
+/* The function returns the name of the given node of a subcircuit
+   element within the subcircuit instance 'inst'.  Nodes connected to
+   the ports are replaced by the nodes of the instance, the global
+   'gnd' and other global nodes are kept and any other node is an
+   internal node of the instance.  Without an instance, i.e. in the
+   root circuit, the node name is returned unchanged. */
+static char * checker_instance_node (struct instance_t * inst,
+                                     struct node_t * n)
 {
-    struct node_t * root, * next;
-    for (root = NULL; nodes != NULL; nodes = next)
-    {
-        next = nodes->next;
-        nodes->next = root;
-        root = nodes;
-    }
-    return root;
+    if (inst == NULL)   // root circuit
+        return n->node;
+    if (n->xlatenr)   // translated node
+        return inst->ports[n->xlatenr - 1];
+    if (!strcmp (n->node, "gnd"))   // ground node
+        return n->node;
+    if (n->node[strlen (n->node) - 1] == '!')   // global node
+        return n->node;
+    // internal subcircuit element node
+    return checker_subcircuit_name (inst->name, n->node);
 }
 
-/* This function assigns new node names to the subcircuit element
-   'copy' based upon the previous node translation between the
-   subcircuit 'type' and the instance 'inst' of this type.  The global
-   'gnd' node is not touched. */
-static void
-checker_copy_subcircuit_nodes (struct definition_t * type,
-                               struct definition_t * inst,
-                               struct definition_t * sub,
-                               struct definition_t * copy,
-                               char * instances)
+/* This function creates the instance 'inst' of the subcircuit 'type'
+   located in the subcircuit instance 'parent'.  The instance name
+   consists of the subcircuit type, the given 'instances' list (if not
+   NULL) and the instance name.  The nodes of the instance are
+   resolved once, all elements of the instance share them. */
+static struct instance_t *
+checker_create_instance (struct definition_t * type,
+                         struct definition_t * inst, char * instances,
+                         struct instance_t * parent)
 {
-    struct node_t * n, * ncopy, * root = NULL;
-
-    // go through the list of the subcircuit element's 'sub' nodes
-    for (n = sub->nodes; n != NULL; n = n->next)
-    {
-
-        // create new node based upon the node translation
-        ncopy = (struct node_t *) calloc (sizeof (struct node_t), 1);
-        ncopy->xlatenr = n->xlatenr;
-        if (n->xlate)   // translated node
-        {
-            if (instances == NULL)
-                ncopy->node = strdup (n->xlate);
-            else
-                ncopy->node = NULL; // leave it blank yet, indicates translation
-        }
-        else if (!strcmp (n->node, "gnd"))   // ground node
-        {
-            ncopy->node = strdup (n->node);
-        }
-        else if (n->node[strlen (n->node) - 1] == '!')   // global node
-        {
-            ncopy->node = strdup (n->node);
-        }
-        else   // internal subcircuit element node
-        {
-            ncopy->node = checker_subcircuit_node (type->instance, instances,
-                                                   inst->instance, n->node);
-        }
-        // chain the new node list
-        ncopy->next = root;
-        root = ncopy;
-    }
+    struct instance_t * i;
+    i = (struct instance_t *) netlist_alloc (sizeof (struct instance_t));
+    std::string name = std::string (type->instance) + ".";
+    if (instances)
+        name = name + instances + ".";
+    name += inst->instance;
+    i->name = netlist_intern (name.c_str ());
 
-    /* and finally reverse the created node list and assign it to the
-       subcircuit element's 'copy' */
-    copy->nodes = netlist_reverse_nodes (root);
+    int ports = checker_count_nodes (type), k = 0;
+    i->ports = (char **) netlist_alloc (sizeof (char *) * ports);
+    for (struct node_t * n = inst->nodes; n && k < ports; n = n->next, k++)
+        i->ports[k] = checker_instance_node (parent, n);
+    return i;
 }
 
-// Returns the node at the given position.
-static struct node_t * checker_get_circuit_node (struct node_t * root, int n)
+/* The function returns the instance name of the given definition.
+   Elements of subcircuits are named after their subcircuit instance. */
+char * netlist_instance_name (struct definition_t * def)
 {
-    for (int i = 1; i < n; i++)
-    {
-        root = root->next;
-        assert (root != NULL);
-    }
-    return root;
+    if (def->overlay == NULL)
+        return def->instance;
+    return checker_subcircuit_name (def->overlay->name, def->instance);
 }
 
-// The function cleans the translated nodes of a subcircuit template.
-static void checker_cleanup_xlat_nodes (struct definition_t * sub)
+/* The function returns the name of the given node of the definition. */
+char * netlist_node_name (struct definition_t * def, struct node_t * node)
 {
-    for (struct node_t * n = sub->nodes; n != NULL; n = n->next)
-    {
-        free (n->xlate);
-        n->xlate = NULL;
-        n->xlatenr = 0;
-    }
+    return checker_instance_node (def->overlay, node);
 }
 
-/* The function is used to assign the nodes of the 'copy' subcircuit
-   element which were left blank intentionally by the element copy in
-   order to indicate that it is an external node.  Again, if the
-   current node translation indicates an external node it is blanked
-   again, otherwise the node gets a unique internal name.  If the
-   'instances' list is NULL, then this indicates the root circuit list
-   and node translations are done though they are 'external'. */
-static void
-checker_copy_circuit_nodes (struct definition_t * type,
-                            struct definition_t * inst,
-                            struct definition_t * sub,
-                            struct definition_t * copy,
-                            char * instances)
-{
-    struct node_t * n, * ncopy;
-
-    // go through the list of the subcircuit element's 'copy' nodes
-    for (ncopy = copy->nodes; ncopy != NULL; ncopy = ncopy->next)
+/* The function reverses the order of the given node list and returns
+   the reversed list. */
+struct node_t * netlist_reverse_nodes (struct node_t * nodes)
+{
+    struct node_t * root, * next;
+    for (root = NULL; nodes != NULL; nodes = next)
     {
-        // these NULL nodes have intentionally been blanked
-        if (ncopy->node == NULL)
-        {
-            assert (ncopy->xlatenr != 0);
-            // get translated node
-            n = checker_get_circuit_node (sub->nodes, ncopy->xlatenr);
-            ncopy->xlatenr = n->xlatenr;
-            if (n->xlate)   // translated node
-            {
-                if (instances == NULL)
-                    // external node indicated by no instances given
-                    ncopy->node = strdup (n->xlate);
-                else
-                    ncopy->node = NULL; // keep blank
-            }
-            else if (!strcmp (n->node, "gnd"))   // global ground node
-            {
-                ncopy->node = strdup (n->node);
-            }
-            else if (n->node[strlen (n->node) - 1] == '!')   // other global node
-            {
-                ncopy->node = strdup (n->node);
-            }
-            else   // internal subcircuit element node
-            {
-                ncopy->node = checker_subcircuit_node (type->instance, instances,
-                                                       inst->instance, n->node);
-            }
-        }
+        next = nodes->next;
+        nodes->next = root;
+        root = nodes;
     }
+    return root;
 }
 
 /* This function returns the last entry of the given list of
@@ -1479,40 +1506,36 @@ static char * checker_subcircuit_instance_list (strlist * instances)
     return NULL;
 }
 
-/* The function creates a subcircuit instance name consisting of the
-   given arguments.  If the given 'instances' is NULL it is left out.
-   The caller is responsible to free() the returned string. */
-static char * checker_subcircuit_instance (char * type, char * instances,
-        char * instance, char * base)
-{
-    char * txt = (char *)
-                 calloc (1, strlen (type) + strlen (instance) + strlen (base) +
-                         (instances ? strlen (instances) : 0) + 4);
-    if (instances)
-        sprintf (txt, "%s.%s.%s.%s", type, instances, instance, base);
-    else
-        sprintf (txt, "%s.%s.%s", type, instance, base);
-    return txt;
-}
+/* The function returns the environment for the given subcircuit
+   instance 'inst' of the subcircuit 'type'.  The environment only
+   depends on the parent environment and the instance parameters, thus
+   all instances of a subcircuit with the same parameters in the same
+   parent environment share a single environment.  Otherwise a new
+   environment is created holding the instance parameters. */
+static environment *
+checker_instance_env (struct definition_t * type,
+                      struct definition_t * inst, strlist * instances,
+                      environment * parent)
+{
+    char txt[64];
+    snprintf (txt, sizeof (txt), "%p", (void *) parent);
+    std::string key = std::string (txt) + ":" + type->instance;
+    for (struct pair_t * pair = inst->pairs; pair != NULL; pair = pair->next)
+    {
+        if (pair->value->ident == NULL)
+            snprintf (txt, sizeof (txt), "%.17g", pair->value->value);
+        key += std::string (":") + pair->key + "=" +
+               (pair->value->ident ? pair->value->ident : txt);
+    }
 
-/* This function produces a copy of the given subcircuit 'type'
-   containing the subcircuit elements.  Based upon the instance 'inst'
-   definitions (node names and instance name) it assign new element
-   instances and node names.  The function returns a NULL terminated
-   circuit element list in reverse order. */
-static struct definition_t *
-checker_copy_subcircuits (struct definition_t * type,
-                          struct definition_t * inst, strlist * * instances,
-                          environment * parent)
-{
-    struct definition_t * def, * copy;
-    struct definition_t * root = NULL;
-    strlist * instcopy;
-    char * list;
+    auto it = instance_envs.find (key);
+    if (it != instance_envs.end ())
+        return it->second;
 
     // create environment for subcircuit instance
     environment * child = new environment (*(type->env));
     parent->push_front_Child (child);
+    instance_envs[key] = child;
 
     // put instance properties into subcircuit environment
     for (struct pair_t * pair = inst->pairs; pair != NULL; pair = pair->next)
@@ -1534,13 +1557,42 @@ checker_copy_subcircuits (struct definition_t * type,
         }
     }
 
+    // try giving child environment a unique name
+    strlist * icopy = new strlist ();
+    icopy->append (type->instance);
+    icopy->append (instances);
+    icopy->append (inst->instance);
+    child->setName (std::string (icopy->toString (".")));
+    delete icopy;
+
+    return child;
+}
+
+/* This function produces a copy of the given subcircuit 'type'
+   containing the subcircuit elements.  The instance 'inst' located in
+   the subcircuit instance 'parent' (NULL for the root circuit) defines
+   the names and nodes of the copies.  The function returns a NULL
+   terminated circuit element list in reverse order. */
+static struct definition_t *
+checker_copy_subcircuits (struct definition_t * type,
+                          struct definition_t * inst, strlist * * instances,
+                          struct instance_t * parent, environment * penv)
+{
+    struct definition_t * def, * copy;
+    struct definition_t * root = NULL;
+    strlist * instcopy;
+
+    // create the subcircuit instance and get its environment
+    struct instance_t * overlay =
+        checker_create_instance (type, inst,
+                                 checker_subcircuit_instance_list (*instances),
+                                 parent);
+    environment * child = checker_instance_env (type, inst, *instances, penv);
+
     // go through element list of subcircuit
     for (def = type->sub; def != NULL; def = def->next)
     {
 
-        // translate the node list
-        checker_xlat_subcircuit_nodes (type, inst, def);
-
         // allow recursive subcircuits
         if (!strcmp (def->type, "Sub"))
         {
@@ -1551,17 +1603,11 @@ checker_copy_subcircuits (struct definition_t * type,
             instcopy = new strlist (*(*instances));
             // append instance name to recursive instance list
             (*instances)->append (inst->instance);
-            copy = checker_copy_subcircuits (sub, def, instances, child);
-            // put the expanded definitions into the sublist
+            copy = checker_copy_subcircuits (sub, def, instances, overlay,
+                                             child);
+            // append the copies to the subcircuit list
             if (copy)
             {
-                list = checker_subcircuit_instance_list (instcopy);
-                // assign blanked node names to each subcircuit
-                for (struct definition_t * c = copy; c != NULL; c = c->next)
-                {
-                    checker_copy_circuit_nodes (type, inst, def, c, list);
-                }
-                // append the copies to the subcircuit list
                 struct definition_t * last = checker_find_last_definition (copy);
                 last->next = root;
                 root = copy;
@@ -1573,34 +1619,16 @@ checker_copy_subcircuits (struct definition_t * type,
         else
         {
             // element copy
-            copy = checker_copy_subcircuit (def);
-            // assign new instance name to the element
-            list = checker_subcircuit_instance_list (*instances);
-            copy->instance =
-                checker_subcircuit_instance (type->instance, list,
-                                             inst->instance, def->instance);
-            copy->subcircuit = strdup (type->instance);
-            // assign node list
-            checker_copy_subcircuit_nodes (type, inst, def, copy, list);
+            copy = checker_copy_subcircuit (def, overlay);
+            copy->subcircuit = type->instance;
             // apply environment
             copy->env = child;
             // chain definition (circuit) list
             copy->next = root;
             root = copy;
         }
-
-        // cleanup translated nodes
-        checker_cleanup_xlat_nodes (def);
     }
 
-    // try giving child environment a unique name
-    strlist * icopy = new strlist ();
-    icopy->append (type->instance);
-    icopy->append (*(instances));
-    icopy->append (inst->instance);
-    child->setName (std::string(icopy->toString (".")));
-    delete icopy;
-
     return root;
 }
 
@@ -1892,58 +1920,9 @@ static int checker_validate_subcircuits (struct definition_t * root)
     return errors;
 }
 
-/* Deletes node list of a definition. */
-static void netlist_free_nodes (struct node_t * node)
-{
-    struct node_t * n;
-    for (; node != NULL; node = n)
-    {
-        n = node->next;
-        free (node->node);
-        free (node);
-    }
-}
-
-/* The following function free()'s the given value. */
-static void netlist_free_value (struct value_t * value)
-{
-    free (value->ident);
-    if (value->unit)  free (value->unit);
-    free (value->scale);
-    free (value);
-}
-
-/* Deletes pair list of a definition. */
-static void netlist_free_pairs (struct pair_t * pp)
-{
-    struct pair_t * np;
-    for (; pp != NULL; pp = np)
-    {
-        np = pp->next;
-        struct value_t * nv, * value;
-        for (value = pp->value; value != NULL; value = nv)
-        {
-            nv = value->next;
-            netlist_free_value (value);
-        }
-        free (pp->key);
-        free (pp);
-    }
-}
-
-/* Deletes the given definition. */
-static void netlist_free_definition (struct definition_t * def)
-{
-    netlist_free_nodes (def->nodes);
-    if (!def->copy) netlist_free_pairs (def->pairs);
-    free (def->subcircuit);
-    free (def->type);
-    free (def->instance);
-    free (def);
-}
-
 /* The function removes the given definition 'cand' from the
-   definition root.  It returns the new definition root. */
+   definition root.  It returns the new definition root.  The memory of
+   the definition is released with the parse tree. */
 struct definition_t *
 netlist_unchain_definition (struct definition_t * root,
                             struct definition_t * cand)
@@ -1952,7 +1931,6 @@ netlist_unchain_definition (struct definition_t * root,
     if (cand == root)
     {
         root = cand->next;
-        netlist_free_definition (cand);
     }
     else
     {
@@ -1961,7 +1939,6 @@ netlist_unchain_definition (struct definition_t * root,
         if (prev != NULL)
         {
             prev->next = cand->next;
-            netlist_free_definition (cand);
         }
     }
     return root;
@@ -1986,7 +1963,8 @@ checker_expand_subcircuits (struct definition_t * root, environment * parent)
             // get the subcircuit type definition
             sub = checker_get_subcircuit (def);
             // and make a copy of it
-            copy = checker_copy_subcircuits (sub, def, &instances, parent);
+            copy = checker_copy_subcircuits (sub, def, &instances, NULL,
+                                             parent);
             if (instances)
             {
                 delete instances;
@@ -2001,7 +1979,6 @@ checker_expand_subcircuits (struct definition_t * root, environment * parent)
             {
                 root = next;
             }
-            netlist_free_definition (def);
             // put the expanded definitions into the netlist
             if (copy)
             {
@@ -2018,6 +1995,7 @@ checker_expand_subcircuits (struct definition_t * root, environment * parent)
             def->env = parent;
         }
     }
+    instance_envs.clear ();
     return root;
 }
 
@@ -2030,6 +2008,9 @@ static int netlist_checker_intern (struct definition_t * root)
     struct define_t * available;
     int n, errors = 0;
 
+    /* index the definitions */
+    checker_index_definitions (root);
+
     /* go through all definitions */
     for (def = root; def != NULL; def = def->next)
     {
@@ -2081,7 +2062,7 @@ static int netlist_checker_intern (struct definition_t * root)
             }
         }
         /* check the number of definitions */
-        n = checker_count_definition (root, def->type, def->instance);
+        n = checker_count_definition (def->type, def->instance);
         if (n != 1 && def->duplicate == 0)
         {
             logprint (LOG_ERROR, "checker error, found %d definitions of `%s:%s'\n",
@@ -2131,10 +2112,11 @@ static void netlist_lister (struct definition_t * root, const char * prefix)
     struct pair_t * pair;
     for (def = root; def != NULL; def = def->next)
     {
-        logprint (LOG_STATUS, "%s%s:%s", prefix, def->type, def->instance);
+        logprint (LOG_STATUS, "%s%s:%s", prefix, def->type,
+                  netlist_instance_name (def));
         for (node = def->nodes; node != NULL; node = node->next)
         {
-            logprint (LOG_STATUS, " %s", node->node);
+            logprint (LOG_STATUS, " %s", netlist_node_name (def, node));
         }
         for (pair = def->pairs; pair != NULL; pair = pair->next)
         {
@@ -2212,8 +2194,6 @@ checker_build_equations (struct definition_t * root, eqn::node ** eroot)
             last = eqn::checker::lastEquation (eqns);
             last->setNext (*eroot);
             *eroot = eqns;
-            // free this definition
-            netlist_free_definition (def);
         }
         else prev = def;
     }
@@ -2273,6 +2253,7 @@ int netlist_checker (environment * env)
     env_root = new environment (env->getName ());
     // create the subcircuit list
     definition_root = checker_build_subcircuits (definition_root);
+    checker_index_subcircuits ();
     // get equation list
     definition_root = checker_build_equations (definition_root, &eqns);
     // setup the root environment
@@ -2314,34 +2295,24 @@ int netlist_checker (environment * env)
         // create actual root environment
         env->copy (*env_root);
         // and finally expand the subcircuits into the global netlist
+        for (def = subcircuit_root; def != NULL; def = def->next)
+            checker_xlat_subcircuit_nodes (def);
         definition_root = checker_expand_subcircuits (definition_root, env);
     }
 
     return errors ? -1 : 0;
 }
 
-/* The function deletes the given definition list. */
-static void netlist_destroy_intern (struct definition_t * root)
-{
-    struct definition_t * def, * next;
-    for (def = root; def != NULL; def = next)
-    {
-        next = def->next;
-        netlist_free_definition (def);
-    }
-}
-
 /* Deletes all available definition lists. */
 void netlist_destroy (void)
 {
-    netlist_destroy_intern (definition_root);
-    for (struct definition_t * def = subcircuit_root; def; def = def->next)
-    {
-        netlist_destroy_intern (def->sub);
-    }
-    netlist_destroy_intern (subcircuit_root);
     definition_root = subcircuit_root = NULL;
+    definition_counts.clear ();
+    definition_idents.clear ();
+    subcircuit_index.clear ();
+    netlist_free_blocks ();
     netlist_lex_destroy ();
+    netlist_lex_unmap ();
 }
 
 /* Delete root environment(s) if necessary. */
@@ -51,11 +51,19 @@ int  netlist_parse (void);
 int  netlist_error (const char *);
 int  netlist_lex (void);
 int  netlist_lex_destroy (void);
+void netlist_lex_file (FILE *);
+void netlist_lex_unmap (void);
 int  netlist_checker_variables (qucs::environment *);
 
 /* Some more functionality. */
 struct definition_t *
 netlist_unchain_definition (struct definition_t *, struct definition_t *);
+char * netlist_instance_name (struct definition_t *);
+char * netlist_node_name (struct definition_t *, struct node_t *);
+
+/* Memory of the parse tree, released by netlist_destroy(). */
+void * netlist_alloc (size_t);
+char * netlist_intern (const char *);
 
 __END_DECLS
 
@@ -73,6 +73,7 @@ enum circuit_flag {
   CIRCUIT_VARSIZE     = 64,
   CIRCUIT_PROBE       = 128,
   CIRCUIT_HISTORY     = 256,
+  CIRCUIT_CONCURRENT  = 512,
 };
 
 class node;
@@ -182,6 +183,8 @@ class circuit : public object, public integrator
   void   setVariableSized (bool v) { MODFLAG (v, CIRCUIT_VARSIZE); }
   bool   isProbe (void) { return RETFLAG (CIRCUIT_PROBE); }
   void   setProbe (bool p) { MODFLAG (p, CIRCUIT_PROBE); }
+  bool   isConcurrent (void) { return RETFLAG (CIRCUIT_CONCURRENT); }
+  void   setConcurrent (bool c) { MODFLAG (c, CIRCUIT_CONCURRENT); }
   void   setNet (net * n) { subnet = n; }
   net *  getNet (void) { return subnet; }
 
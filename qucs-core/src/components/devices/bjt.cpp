@@ -43,6 +43,7 @@ using namespace qucs::device;
 bjt::bjt () : circuit (4) {
   cbcx = rb = re = rc = NULL;
   type = CIR_BJT;
+  setConcurrent (true);
 }
 
 void bjt::calcSP (nr_double_t frequency) {
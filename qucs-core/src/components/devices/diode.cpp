@@ -49,6 +49,7 @@ using namespace qucs::device;
 diode::diode () : circuit (2) {
   rs = NULL;
   type = CIR_DIODE;
+  setConcurrent (true);
 }
 
 // Callback for S-parameter analysis.
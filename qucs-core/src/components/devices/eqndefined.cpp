@@ -30,6 +30,7 @@
 #include "equation.h"
 #include "environment.h"
 #include "device.h"
+#include "bytecode.h"
 #include "eqndefined.h"
 
 using namespace qucs;
@@ -47,6 +48,8 @@ eqndefined::eqndefined () : circuit () {
   _jstat = NULL;
   _jdyna = NULL;
   _charges = NULL;
+  code = NULL;
+  vreg = NULL;
 }
 
 // Destructor deletes equation defined device object from memory.
@@ -59,6 +62,8 @@ eqndefined::~eqndefined () {
   free (_jstat);
   free (_jdyna);
   free (_charges);
+  delete code;
+  free (vreg);
 }
 
 // Callback for initializing the DC analysis.
@@ -72,6 +77,7 @@ void eqndefined::initDC (void) {
 #define A(a)  ((assignment *) (a))
 #define C(c)  ((constant *) (c))
 #define BP(n) real (getV (n * 2 + 0) - getV (n * 2 + 1))
+#define RES(eqn,reg) (code ? code->get (reg) : getResult (eqn))
 
 // Creates a variable name from the given arguments.
 char * eqndefined::createVariable (const char * base, int n, bool pfx) {
@@ -206,11 +212,11 @@ void eqndefined::initModel (void) {
 	gn = createVariable ("G", i + 1, j + 1);
 	if ((geqn[k] = getEnv()->getChecker()->findEquation (gn)) == NULL) {
 	  diff = ivalue->differentiate (vn);
+	  A(diff)->rename (gn);
 	  getEnv()->getChecker()->addEquation (diff);
 	  diff->evalType ();
 	  diff->skip = 1;
 	  geqn[k] = diff;
-	  A(diff)->rename (gn);
 	}
 	free (gn);
 #if DEBUG
@@ -236,10 +242,10 @@ void eqndefined::initModel (void) {
 	cn = createVariable ("C", i + 1, j + 1);
 	if ((ceqn[k] = getEnv()->getChecker()->findEquation (cn)) == NULL) {
 	  diff = qvalue->differentiate (vn);
+	  A(diff)->rename (cn);
 	  getEnv()->getChecker()->addEquation (diff);
 	  diff->evalType ();
 	  ceqn[k] = diff;
-	  A(diff)->rename (cn);
 
 	  // apply dQ/dI * dI/dV => dQ/dV derivatives
 	  for (int l = 0; l < branches; l++) {
@@ -263,6 +269,48 @@ void eqndefined::initModel (void) {
       free (vn);
     }
   }
+
+  // lower the equations into a register program
+  compileModel ();
+}
+
+/* The function compiles the current, charge and derivative equations
+   of the device into a single bytecode program.  Subexpressions shared
+   by the currents and their derivatives are computed once only.  The
+   currents and conductances come first in the program, the charges
+   and capacitances are computed only when needed.  If any of the
+   equations cannot be compiled the equations are interpreted. */
+void eqndefined::compileModel (void) {
+  int i, k, branches = getSize () / 2;
+  int n = branches * branches;
+  bool ok = true;
+
+  code = new bytecode ();
+  vreg = (int *) malloc (sizeof (int) * (3 * branches + 2 * n));
+  ireg = vreg + branches;
+  qreg = ireg + branches;
+  greg = qreg + branches;
+  creg = greg + n;
+
+  for (i = 0; i < branches; i++) vreg[i] = code->addInput (A(veqn[i]));
+  for (i = 0; i < branches && ok; i++)
+    ok = (ireg[i] = code->compile (A(ieqn[i]))) >= 0;
+  for (k = 0; k < n && ok; k++)
+    ok = (greg[k] = code->compile (A(geqn[k]))) >= 0;
+  dynamic = code->size ();
+  for (i = 0; i < branches && ok; i++)
+    ok = (qreg[i] = code->compile (A(qeqn[i]))) >= 0;
+  for (k = 0; k < n && ok; k++)
+    ok = (creg[k] = code->compile (A(ceqn[k]))) >= 0;
+
+  if (!ok) {
+#if DEBUG
+    logprint (LOG_STATUS, "DEBUG: EDD `%s' equations interpreted\n",
+	      getName ());
+#endif
+    delete code;
+    code = NULL;
+  }
 }
 
 // Update local variable equations.
@@ -273,6 +321,12 @@ void eqndefined::updateLocals (void) {
   for (i = 0; i < branches; i++) {
     setResult (veqn[i], BP (i));
   }
+  // run the compiled currents and conductances
+  if (code) {
+    for (i = 0; i < branches; i++) code->set (vreg[i], BP (i));
+    code->evaluate (0, dynamic);
+    return;
+  }
   // get local subcircuit values
   getEnv()->passConstants ();
   getEnv()->equationSolver ();
@@ -287,7 +341,7 @@ void eqndefined::calcDC (void) {
 
   // calculate currents and put into right-hand side
   for (i = 0; i < branches; i++) {
-    nr_double_t c = getResult (ieqn[i]);
+    nr_double_t c = RES (ieqn[i], ireg[i]);
     setI (i * 2 + 0, -c);
     setI (i * 2 + 1, +c);
   }
@@ -297,7 +351,7 @@ void eqndefined::calcDC (void) {
     nr_double_t gv = 0;
     // usual G (dI/dV) entries
     for (j = 0; j < branches; j++, k++) {
-      nr_double_t g = getResult (geqn[k]);
+      nr_double_t g = RES (geqn[k], greg[k]);
       setY (i * 2 + 0, j * 2 + 0, +g);
       setY (i * 2 + 1, j * 2 + 1, +g);
       setY (i * 2 + 0, j * 2 + 1, -g);
@@ -321,14 +375,17 @@ void eqndefined::calcDC (void) {
 void eqndefined::evalOperatingPoints (void) {
   int i, j, k, branches = getSize () / 2;
 
+  // run the compiled charges and capacitances
+  if (code) code->evaluate (dynamic);
+
   // save values for charges, conductances and capacitances
   for (k = 0, i = 0; i < branches; i++) {
-    nr_double_t q = getResult (qeqn[i]);
+    nr_double_t q = RES (qeqn[i], qreg[i]);
     _charges[i] = q;
     for (j = 0; j < branches; j++, k++) {
-      nr_double_t g = getResult (geqn[k]);
+      nr_double_t g = RES (geqn[k], greg[k]);
       _jstat[k] = g;
-      nr_double_t c = getResult (ceqn[k]);
+      nr_double_t c = RES (ceqn[k], creg[k]);
       _jdyna[k] = c;
     }
   }
@@ -25,6 +25,8 @@
 #ifndef __EQNDEFINED_H__
 #define __EQNDEFINED_H__
 
+namespace qucs { namespace eqn { class bytecode; } }
+
 class eqndefined : public qucs::circuit
 {
  public:
@@ -51,6 +53,7 @@ class eqndefined : public qucs::circuit
   qucs::matrix calcMatrixY (nr_double_t);
   void evalOperatingPoints (void);
   void updateLocals (void);
+  void compileModel (void);
 
  private:
   void ** veqn;
@@ -62,6 +65,13 @@ class eqndefined : public qucs::circuit
   nr_double_t * _jdyna;
   nr_double_t * _charges;
   bool doHB;
+  qucs::eqn::bytecode * code;
+  int * vreg;
+  int * ireg;
+  int * greg;
+  int * qreg;
+  int * creg;
+  int dynamic;
 };
 
 #endif /* __EQNDEFINED_H__ */
@@ -40,6 +40,7 @@ using namespace qucs::device;
 jfet::jfet () : circuit (3) {
   rs = rd = NULL;
   type = CIR_JFET;
+  setConcurrent (true);
 }
 
 void jfet::calcSP (nr_double_t frequency) {
@@ -42,6 +42,7 @@ mosfet::mosfet () : circuit (4) {
   transientMode = 0;
   rg = rs = rd = NULL;
   type = CIR_MOSFET;
+  setConcurrent (true);
 }
 
 void mosfet::calcSP (nr_double_t frequency) {
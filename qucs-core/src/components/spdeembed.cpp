@@ -70,22 +70,15 @@ void spdeembed::initSP (void) {
 
   // load S-parameter file
   const char * file = getPropertyString ("File");
-  if (data == NULL) data = dataset::load_touchstone (file);
-  if (data != NULL) {
-    // determine the number of ports defined by that file
-    nPorts = (int) std::sqrt ((double) data->countVariables ());
-  }
+  if (model == NULL) loadModel (file);
   if (nPorts == getSize () - 1) { // size includes Ref port
-    if (spara == NULL) {
-      // find matrix vector entries in touchstone dataset
-      createIndex ();
-    }
     if (sfreq == NULL) {
       logprint (LOG_ERROR, "ERROR: file `%s' contains no `frequency' "
                 "vector\n", file);
     }
   }
   else {
+    releaseModel ();
     logprint (LOG_ERROR, "ERROR: file `%s' specifies a %d-port, `%s' "
               "requires a %d-port\n", file, nPorts, getName (),
               getSize () - 1);
@@ -95,7 +88,7 @@ void spdeembed::initSP (void) {
 void spdeembed::calcSP (nr_double_t frequency) {
 
   // nothing to do if the given file type had errors
-  if (spara == NULL || sfreq == NULL) return;
+  if (model == NULL || sfreq == NULL) return;
 
   // set interpolated S-parameters
   matrix st = getInterpolMatrixS (frequency);
@@ -204,7 +197,7 @@ void spdeembed::initAC (void) {
 
 void spdeembed::calcAC (nr_double_t frequency) {
   // nothing to do if the given file type had errors
-  if (spara == NULL || sfreq == NULL) return;
+  if (model == NULL || sfreq == NULL) return;
   // calculate interpolated S-parameters
   calcSP (frequency);
   // convert S-parameters to Y-parameters
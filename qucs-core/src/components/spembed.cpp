@@ -71,22 +71,15 @@ void spembed::initSP (void) {
 
   // load S-parameter file
   const char * file = getPropertyString ("File");
-  if (data == NULL) data = dataset::load_touchstone (file);
-  if (data != NULL) {
-    // determine the number of ports defined by that file
-    nPorts = (int) std::sqrt ((double) data->countVariables ());
-  }
+  if (model == NULL) loadModel (file);
   if (nPorts == getSize () - 1) {
-    if (spara == NULL) {
-      // find matrix vector entries in touchstone dataset
-      createIndex ();
-    }
     if (sfreq == NULL) {
       logprint (LOG_ERROR, "ERROR: file `%s' contains no `frequency' "
                 "vector\n", file);
     }
   }
   else {
+    releaseModel ();
     logprint (LOG_ERROR, "ERROR: file `%s' specifies a %d-port, `%s' "
               "requires a %d-port\n", file, nPorts, getName (),
               getSize () - 1);
@@ -96,7 +89,7 @@ void spembed::initSP (void) {
 void spembed::calcSP (nr_double_t frequency) {
 
   // nothing to do if the given file type had errors
-  if (spara == NULL || sfreq == NULL) return;
+  if (model == NULL || sfreq == NULL) return;
 
   // set interpolated S-parameters
   setMatrixS (expandSParaMatrix (getInterpolMatrixS (frequency)));
@@ -104,7 +97,7 @@ void spembed::calcSP (nr_double_t frequency) {
 
 void spembed::calcNoiseSP (nr_double_t frequency) {
   // nothing to do if the given file type had errors
-  if (spara == NULL || nfreq == NULL) return;
+  if (model == NULL || nfreq == NULL) return;
   setMatrixN (calcMatrixCs (frequency));
 }
 
@@ -239,7 +232,7 @@ nr_double_t spembed::noiseFigure (matrix s, matrix c, nr_double_t& Fmin,
 
 void spembed::calcNoiseAC (nr_double_t frequency) {
   // nothing to do if the given file type had errors
-  if (spara == NULL || nfreq == NULL) return;
+  if (model == NULL || nfreq == NULL) return;
   setMatrixN (cstocy (calcMatrixCs (frequency), getMatrixY () * z0) / z0);
 }
 
@@ -290,7 +283,7 @@ void spembed::initAC (void) {
 
 void spembed::calcAC (nr_double_t frequency) {
   // nothing to do if the given file type had errors
-  if (spara == NULL || sfreq == NULL) return;
+  if (model == NULL || sfreq == NULL) return;
   // calculate interpolated S-parameters
   calcSP (frequency);
   // convert S-parameters to Y-parameters
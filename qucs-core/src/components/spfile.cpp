@@ -37,6 +37,12 @@
 #include "interpolator.h"
 #include "spfile.h"
 
+#include <map>
+#include <mutex>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
 using namespace qucs;
 
 // Constructor for S-parameter file vector.
@@ -77,43 +83,258 @@ nr_complex_t spfile_vector::interpolate (nr_double_t x) {
     return inter->cinterpolate (x);
 }
 
-// Constructor creates an empty and unnamed instance of the spfile class.
-spfile::spfile () {
-  data = NULL;
+/* The spmodel class holds the data of a touchstone file prepared for
+   interpolation.  The matrix entries are stored frequency by frequency
+   so that a single index lookup gives all entries of a frequency. */
+class spmodel
+{
+ public:
+  spmodel (dataset *, int, int);
+  ~spmodel ();
+  matrix getMatrixS (nr_double_t);
+  static std::shared_ptr<spmodel> load (const char *, int, int);
+
+ private:
+  void createIndex (void);
+  matrix interpolate (nr_double_t);
+
+ public:
+  int nPorts;
+  dataset * data;
+  qucs::vector * sfreq;
+  qucs::vector * nfreq;
+  spfile_vector * RN;
+  spfile_vector * FMIN;
+  spfile_vector * SOPT;
+  char paraType;
+
+ private:
+  int interpolType;
+  int dataType;
+  int length;
+  nr_double_t * freq;
+  nr_complex_t * values;
+  spline * rsp;
+  spline * isp;
+  std::mutex lock;
+  bool cached;
+  nr_double_t lastFrequency;
+  matrix lastMatrix;
+};
+
+// Models currently in use, indexed by file name and interpolation settings.
+static std::map<std::string, std::weak_ptr<spmodel> > models;
+static std::mutex modelsLock;
+
+// Constructor creates the model for the given touchstone dataset.
+spmodel::spmodel (dataset * d, int it, int dt) {
+  data = d;
   sfreq = nfreq = NULL;
-  spara = FMIN = SOPT = RN = NULL;
-  interpolType = dataType = 0;
+  RN = FMIN = SOPT = NULL;
+  paraType = 'S';
+  interpolType = it;
+  dataType = dt;
+  length = 0;
+  freq = NULL;
+  values = NULL;
+  rsp = isp = NULL;
+  cached = false;
+  lastFrequency = 0;
+  // determine the number of ports defined by that file
+  nPorts = (int) std::sqrt ((double) data->countVariables ());
+  createIndex ();
 }
 
-// Destructor deletes spfile object from memory.
-spfile::~spfile () {
-  delete[] spara;
+// Destructor deletes the model and its dataset.
+spmodel::~spmodel () {
+  delete[] freq;
+  delete[] values;
+  delete[] rsp;
+  delete[] isp;
   delete RN;
   delete FMIN;
   delete SOPT;
-#if DEBUG && 0
-  if (data) {
-    data->setFile ("spfile.dat");
-    data->print ();
-  }
-#endif
   delete data;
 }
 
-/* This function returns the S-parameter matrix of the circuit for the
-   given frequency.  It uses interpolation for frequency points which
-   are not part of the original touchstone file. */
-matrix spfile::getInterpolMatrixS (nr_double_t frequency) {
+/* Returns the model of the given touchstone file.  The model is loaded
+   only if no other instance uses the file with the same interpolation
+   settings.  Returns NULL if the file cannot be loaded. */
+std::shared_ptr<spmodel> spmodel::load (const char * file, int it, int dt) {
+  std::ostringstream key;
+  key << file << ':' << it << ':' << dt;
+  std::lock_guard<std::mutex> guard (modelsLock);
+  std::weak_ptr<spmodel> & entry = models[key.str ()];
+  std::shared_ptr<spmodel> m = entry.lock ();
+  if (m == NULL) {
+    dataset * d = dataset::load_touchstone (file);
+    if (d == NULL) {
+      models.erase (key.str ());
+      return m;
+    }
+    m = std::make_shared<spmodel> (d, it, dt);
+    entry = m;
+  }
+  return m;
+}
 
-  // first interpolate the matrix values
-  matrix s (nPorts);
-  for (int r = 0; r < nPorts; r++) {
-    for (int c = 0; c < nPorts; c++) {
-      int i = r * (nPorts + 1) + c;
-      s.set (r, c, spara[i].interpolate (frequency));
+/* This function goes through the dataset stored within the original
+   touchstone file and looks for the S-parameter matrices and
+   frequency vector.  It also tries to find the noise parameter
+   data. */
+void spmodel::createIndex (void) {
+  qucs::vector * v;
+  char * n;
+  const char *name;
+  int r, c, i, k, s = nPorts * nPorts;
+
+  // go through list of dependency vectors and find frequency vectors
+  for (v = data->getDependencies (); v != NULL; v = (::vector *) v->getNext ()) {
+    if ((name = v->getName ()) != NULL) {
+      if (!strcmp (name, "frequency")) sfreq = v;
+      else if (!strcmp (name, "nfreq")) nfreq = v;
+    }
+  }
+  if (sfreq == NULL || s == 0) return;
+
+  // create table of matrix entries
+  length = sfreq->getSize ();
+  freq = new nr_double_t[length];
+  values = new nr_complex_t[length * s] ();
+  for (k = 0; k < length; k++) freq[k] = real (sfreq->get (k));
+
+  // go through list of variable vectors and find matrix entries
+  for (v = data->getVariables (); v != NULL; v = (::vector *) v->getNext ()) {
+    if ((n = matvec::isMatrixVector (v->getName (), r, c)) != NULL) {
+      if (r < nPorts && c < nPorts) {
+	i = r * nPorts + c;
+	int len = std::min (v->getSize (), length);
+	for (k = 0; k < len; k++) values[k * s + i] = v->get (k);
+      }
+      paraType = n[0];  // save type of touchstone data
+      free (n);
+    }
+    if ((name = v->getName ()) != NULL) {
+      // find noise parameter vectors
+      if (!strcmp (name, "Rn")) {
+	RN = new spfile_vector ();
+	RN->prepare (v, nfreq, true, interpolType, dataType);
+      }
+      else if (!strcmp (name, "Fmin")) {
+	FMIN = new spfile_vector ();
+	FMIN->prepare (v, nfreq, true, interpolType, dataType);
+      }
+      else if (!strcmp (name, "Sopt")) {
+	SOPT = new spfile_vector ();
+	SOPT->prepare (v, nfreq, false, interpolType, dataType);
+      }
+    }
+  }
+
+  // unwrap the phases of polar data, entries become (magnitude, phase)
+  if ((dataType & DATA_POLAR) && length > 1) {
+    qucs::vector ang (length);
+    for (i = 0; i < s; i++) {
+      for (k = 0; k < length; k++) ang (k) = arg (values[k * s + i]);
+      ang = unwrap (ang);
+      for (k = 0; k < length; k++) {
+	nr_complex_t & y = values[k * s + i];
+	y = nr_complex_t (abs (y), real (ang (k)));
+      }
+    }
+  }
+
+  // construct splines for the real and imaginary parts of the entries
+  if ((interpolType & INTERPOL_CUBIC) && length > 1) {
+    rsp = new spline[s];
+    isp = new spline[s];
+    nr_double_t * y = new nr_double_t[length];
+    for (i = 0; i < s; i++) {
+      for (k = 0; k < length; k++) y[k] = real (values[k * s + i]);
+      rsp[i].setBoundary (SPLINE_BC_NATURAL);
+      rsp[i].vectors (y, freq, length);
+      rsp[i].construct ();
+      for (k = 0; k < length; k++) y[k] = imag (values[k * s + i]);
+      isp[i].setBoundary (SPLINE_BC_NATURAL);
+      isp[i].vectors (y, freq, length);
+      isp[i].construct ();
+    }
+    delete[] y;
+  }
+}
+
+/* The function interpolates all matrix entries at the given frequency.
+   The position within the frequency vector is determined once for all
+   entries. */
+matrix spmodel::interpolate (nr_double_t f) {
+  int i, s = nPorts * nPorts;
+  matrix m (nPorts);
+  nr_complex_t * res = m.getData ();
+
+  // no chance to interpolate
+  if (length <= 0) return m;
+  // no interpolation necessary
+  if (length == 1) {
+    std::copy (values, values + s, res);
+    return m;
+  }
+
+  // index of the interval containing the frequency, -1 left of it
+  int idx = (std::upper_bound (freq, freq + length, f) - freq) - 1;
+
+  // cubic spline interpolation
+  if (rsp != NULL) {
+    for (i = 0; i < s; i++)
+      res[i] = nr_complex_t (rsp[i].evaluate (f, idx),
+			     isp[i].evaluate (f, idx));
+  }
+  // linear interpolation
+  else {
+    if (idx < 0) idx = 0;
+    const nr_complex_t * y = values + idx * s;
+    // dependency variable in scope
+    if (f == freq[idx]) {
+      std::copy (y, y + s, res);
+    }
+    // dependency variable is beyond scope; use last tangent
+    else {
+      if (idx == length - 1) {
+	idx--;
+	y -= s;
+      }
+      nr_double_t x1 = freq[idx], x2 = freq[idx + 1];
+      const nr_complex_t * y2 = y + s;
+      for (i = 0; i < s; i++) {
+	if (x1 == x2)
+	  res[i] = (y[i] + y2[i]) / 2.0;
+	else
+	  res[i] = nr_complex_t (((x2 - f) * real (y[i]) +
+				  (f - x1) * real (y2[i])) / (x2 - x1),
+				 ((x2 - f) * imag (y[i]) +
+				  (f - x1) * imag (y2[i])) / (x2 - x1));
+      }
     }
   }
 
+  // convert magnitude and phase to complex values
+  if (dataType & DATA_POLAR) {
+    for (i = 0; i < s; i++) res[i] = std::polar (real (res[i]), imag (res[i]));
+  }
+  return m;
+}
+
+/* This function returns the S-parameter matrix of the model for the
+   given frequency.  The matrix of the last frequency is kept since
+   all instances sharing the model ask for the same frequencies. */
+matrix spmodel::getMatrixS (nr_double_t frequency) {
+  {
+    std::lock_guard<std::mutex> guard (lock);
+    if (cached && lastFrequency == frequency) return lastMatrix;
+  }
+
+  // first interpolate the matrix values
+  matrix s = interpolate (frequency);
+
   // then convert them to S-parameters if necessary
   switch (paraType) {
   case 'Y':
@@ -129,9 +350,60 @@ matrix spfile::getInterpolMatrixS (nr_double_t frequency) {
     s = gtos (s);
     break;
   }
+
+  std::lock_guard<std::mutex> guard (lock);
+  lastMatrix = s;
+  lastFrequency = frequency;
+  cached = true;
   return s;
 }
 
+// Constructor creates an empty and unnamed instance of the spfile class.
+spfile::spfile () {
+  data = NULL;
+  sfreq = nfreq = NULL;
+  FMIN = SOPT = RN = NULL;
+  interpolType = dataType = 0;
+  nPorts = 0;
+  paraType = 'S';
+}
+
+// Destructor deletes spfile object from memory.
+spfile::~spfile () {
+  // the data is owned by the shared model
+}
+
+/* Loads the given touchstone file, or shares it with other instances
+   using the same file and interpolation settings. */
+void spfile::loadModel (const char * file) {
+  model = spmodel::load (file, interpolType, dataType);
+  if (model != NULL) {
+    nPorts = model->nPorts;
+    data = model->data;
+    sfreq = model->sfreq;
+    nfreq = model->nfreq;
+    RN = model->RN;
+    FMIN = model->FMIN;
+    SOPT = model->SOPT;
+    paraType = model->paraType;
+  }
+}
+
+// Drops the reference to the touchstone data.
+void spfile::releaseModel (void) {
+  model.reset ();
+  data = NULL;
+  sfreq = nfreq = NULL;
+  FMIN = SOPT = RN = NULL;
+}
+
+/* This function returns the S-parameter matrix of the circuit for the
+   given frequency.  It uses interpolation for frequency points which
+   are not part of the original touchstone file. */
+matrix spfile::getInterpolMatrixS (nr_double_t frequency) {
+  return model->getMatrixS (frequency);
+}
+
 /* This function expands the actual S-parameter file data stored
    within the touchstone file to have an additional reference one-port
    whose S-parameter is -1 (i.e. ground). */
@@ -190,71 +462,3 @@ matrix spfile::shrinkSParaMatrix (matrix s) {
   }
   return res;
 }
-
-void spfile::prepare (void) {
-
-}
-
-/* The function creates an additional data vector for the given matrix
-   entry and adds it to the dataset. */
-void spfile::createVector (int r, int c) {
-  int i = r * (nPorts + 1) + c;
-  spara[i].r = r;
-  spara[i].c = c;
-  qucs::vector * v = new qucs::vector (matvec::createMatrixString ("S", r, c),
-			       sfreq->getSize ());
-  v->setDependencies (new strlist ());
-  v->getDependencies()->add (sfreq->getName ());
-  data->addVariable (v);
-  spara[i].v = v;
-}
-
-/* This function goes through the dataset stored within the original
-   touchstone file and looks for the S-parameter matrices and
-   frequency vector.  It also tries to find the noise parameter
-   data. */
-void spfile::createIndex (void) {
-  qucs::vector * v; int s = nPorts + 1;
-  char * n;
-  const char *name;
-  int r, c, i;
-
-  // go through list of dependency vectors and find frequency vectors
-  for (v = data->getDependencies (); v != NULL; v = (::vector *) v->getNext ()) {
-    if ((name = v->getName ()) != NULL) {
-      if (!strcmp (name, "frequency")) sfreq = v;
-      else if (!strcmp (name, "nfreq")) nfreq = v;
-    }
-  }
-
-  // create vector index
-  spara = new spfile_vector[s * s] ();
-
-  // go through list of variable vectors and find matrix entries
-  for (v = data->getVariables (); v != NULL; v = (::vector *) v->getNext ()) {
-    if ((n = matvec::isMatrixVector (v->getName (), r, c)) != NULL) {
-      // save matrix vector indices
-      i = r * s + c;
-      spara[i].r = r;
-      spara[i].c = c;
-      spara[i].prepare (v, sfreq, false, interpolType, dataType);
-      paraType = n[0];  // save type of touchstone data
-      free (n);
-    }
-    if ((name = v->getName ()) != NULL) {
-      // find noise parameter vectors
-      if (!strcmp (name, "Rn")) {
-	RN = new spfile_vector ();
-	RN->prepare (v, nfreq, true, interpolType, dataType);
-      }
-      else if (!strcmp (name, "Fmin")) {
-	FMIN = new spfile_vector ();
-	FMIN->prepare (v, nfreq, true, interpolType, dataType);
-      }
-      else if (!strcmp (name, "Sopt")) {
-	SOPT = new spfile_vector ();
-	SOPT->prepare (v, nfreq, false, interpolType, dataType);
-      }
-    }
-  }
-}
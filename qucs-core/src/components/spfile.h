@@ -25,6 +25,8 @@
 #ifndef __SPFILE_H__
 #define __SPFILE_H__
 
+#include <memory>
+
 namespace qucs {
   class vector;
   class matvec;
@@ -32,6 +34,8 @@ namespace qucs {
   class interpolator;
 }
 
+class spmodel;
+
 class spfile_vector
 {
  public:
@@ -56,18 +60,19 @@ class spfile
  public:
   spfile ();
   ~spfile ();
-  void createIndex (void);
-  void prepare (void);
-  void createVector (int, int);
+  void loadModel (const char *);
+  void releaseModel (void);
   qucs::matrix expandSParaMatrix (qucs::matrix);
   qucs::matrix shrinkSParaMatrix (qucs::matrix);
   qucs::matrix getInterpolMatrixS (nr_double_t);
 
+  /* The touchstone data is shared by all instances using the same file
+     and interpolation settings, the pointers below refer into it. */
+  std::shared_ptr<spmodel> model;
   int nPorts;
   qucs::dataset * data;
   qucs::vector * sfreq;
   qucs::vector * nfreq;
-  spfile_vector * spara;
   spfile_vector * RN;
   spfile_vector * FMIN;
   spfile_vector * SOPT;
@@ -31,7 +31,19 @@
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
+#include <stdint.h>
 #include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if HAVE_SYS_MMAN_H
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include "logging.h"
 #include "complex.h"
@@ -52,18 +64,27 @@ namespace qucs {
 dataset::dataset () : object () {
   variables = dependencies = NULL;
   file = NULL;
+  binary = 0;
+  chunkSize = 0;
+  stream = NULL;
 }
 
 // Constructor creates an named instance of the dataset class.
 dataset::dataset (char * n) : object (n) {
   variables = dependencies = NULL;
   file = NULL;
+  binary = 0;
+  chunkSize = 0;
+  stream = NULL;
 }
 
 /* The copy constructor creates a new instance based on the given
    dataset object. */
 dataset::dataset (const dataset & d) : object (d) {
   file = d.file ? strdup (d.file) : NULL;
+  binary = d.binary;
+  chunkSize = 0;
+  stream = NULL;
   vector * v;
   // copy dependency vectors
   for (v = d.dependencies; v != NULL; v = (vector *) v->getNext ()) {
@@ -88,6 +109,7 @@ dataset::~dataset () {
     n = (vector *) v->getNext ();
     delete v;
   }
+  if (stream) fclose (stream);
   free (file);
 }
 
@@ -101,6 +123,7 @@ void dataset::addDependency (vector * v) {
 
 // This function removes a dependency vector from the current dataset.
 void dataset::delDependency (vector * v) {
+  streamed.erase (v);
   if (dependencies == v) {
     dependencies = (vector *) v->getNext ();
     if (dependencies) dependencies->setPrev (NULL);
@@ -159,6 +182,7 @@ void dataset::addVariable (vector * v) {
 
 // This function removes a variable vector from the current dataset.
 void dataset::delVariable (vector * v) {
+  streamed.erase (v);
   if (variables == v) {
     variables = (vector *) v->getNext ();
     if (variables) variables->setPrev (NULL);
@@ -332,35 +356,243 @@ void dataset::print (void) {
 
   FILE * f = stdout;
 
+  // finish streamed output
+  if (isStreaming () && closeStream () == 0) return;
+
   // open file for writing
   if (file) {
-    if ((f = fopen (file, "w")) == NULL) {
+    if ((f = fopen (file, binary ? "wb" : "w")) == NULL) {
       logprint (LOG_ERROR, "cannot create file `%s': %s\n",
 		file, strerror (errno));
       return;
     }
   }
 
-  // print header
-  fprintf (f, "<Qucs Dataset " PACKAGE_VERSION ">\n");
-
-  // print dependencies
-  for (vector * d = dependencies; d != NULL; d = (vector *) d->getNext ()) {
-    printDependency (d, f);
+  if (binary) {
+    printBinary (f);
   }
+  else {
+    // print header
+    fprintf (f, "<Qucs Dataset " PACKAGE_VERSION ">\n");
 
-  // print variables
-  for (vector * v = variables; v != NULL; v = (vector *) v->getNext ()) {
-    if (v->getDependencies () != NULL)
-      printVariable (v, f);
-    else
-      printDependency (v, f);
+    // print dependencies
+    for (vector * d = dependencies; d != NULL; d = (vector *) d->getNext ()) {
+      printDependency (d, f);
+    }
+
+    // print variables
+    for (vector * v = variables; v != NULL; v = (vector *) v->getNext ()) {
+      if (v->getDependencies () != NULL)
+	printVariable (v, f);
+      else
+	printDependency (v, f);
+    }
   }
 
   // close file if necessary
   if (file) fclose (f);
 }
 
+/* Binary datasets store all values as little-endian IEEE doubles.  The
+   byte-wise access works on any host and is turned into plain loads
+   and stores by the compiler on little-endian machines. */
+static void putDouble (unsigned char * p, double d) {
+  uint64_t u;
+  memcpy (&u, &d, sizeof (u));
+  for (int i = 0; i < 8; i++) p[i] = (unsigned char) (u >> (8 * i));
+}
+
+static double getDouble (const unsigned char * p) {
+  uint64_t u = 0;
+  double d;
+  for (int i = 7; i >= 0; i--) u = (u << 8) | p[i];
+  memcpy (&d, &u, sizeof (d));
+  return d;
+}
+
+/* Returns non-zero if the given vector has any non-real value from the
+   given position on. */
+static int isComplexVector (vector * v, int first) {
+  for (int i = first; i < v->getSize (); i++)
+    if (imag (v->get (i)) != 0.0) return 1;
+  return 0;
+}
+
+/* Encodes the values of the given vector from the given position on
+   into the buffer.  Real and imaginary parts are interleaved for
+   complex vectors. */
+static void encodeValues (std::vector<unsigned char> & buf, vector * v,
+			  int first, int cplx) {
+  buf.resize ((v->getSize () - first) * (cplx ? 16 : 8));
+  unsigned char * p = buf.data ();
+  for (int i = first; i < v->getSize (); i++) {
+    nr_complex_t c = v->get (i);
+    putDouble (p, (double) real (c));
+    p += 8;
+    if (cplx) {
+      putDouble (p, (double) imag (c));
+      p += 8;
+    }
+  }
+}
+
+/* Returns the tag introducing the given vector in a binary dataset.
+   Variables without dependencies are written as independent vectors
+   the same way as in the text format. */
+static std::string binaryTag (vector * v, int variable, int count) {
+  std::string tag;
+  if (variable && v->getDependencies () != NULL) {
+    tag = std::string ("<dep ") + v->getName ();
+    for (strlistiterator it (v->getDependencies ()); *it; ++it)
+      tag += std::string (" ") + *it;
+  }
+  else {
+    tag = std::string ("<indep ") + v->getName ();
+    if (count) tag += " " + std::to_string (v->getSize ());
+  }
+  return tag + ">\n";
+}
+
+/* This function prints the dataset in the binary format.  The header
+   is a textual directory of the vectors using the tags of the text
+   format, each followed by a <block OFFSET COUNT TYPE> tag.  It gives
+   the position of the vector data relative to the data section, the
+   number of values and whether they are real or complex.  The header
+   is terminated by a <data> tag.  The data section starts at the next
+   8 byte boundary and holds the raw values. */
+void dataset::printBinary (FILE * f) {
+  std::vector<vector *> order;
+  std::vector<int> cplx;
+  vector * v;
+
+  for (v = dependencies; v != NULL; v = (vector *) v->getNext ())
+    order.push_back (v);
+  for (v = variables; v != NULL; v = (vector *) v->getNext ())
+    order.push_back (v);
+
+  // print the vector directory
+  unsigned long long offset = 0;
+  long pos = fprintf (f, "<Qucs Binary Dataset " PACKAGE_VERSION ">\n");
+  for (size_t n = 0; n < order.size (); n++) {
+    v = order[n];
+    cplx.push_back (isComplexVector (v, 0));
+    pos += fprintf (f, "%s", binaryTag (v, n >= (size_t) countDependencies (),
+					1).c_str ());
+    pos += fprintf (f, "<block %llu %d %s>\n", offset, v->getSize (),
+		    cplx[n] ? "complex" : "real");
+    offset += v->getSize () * (cplx[n] ? 16 : 8);
+  }
+  pos += fprintf (f, "<data>\n");
+  for (; pos % 8; pos++) fputc (0, f);
+
+  // print the data section
+  std::vector<unsigned char> buf;
+  for (size_t n = 0; n < order.size (); n++) {
+    encodeValues (buf, order[n], 0, cplx[n]);
+    fwrite (buf.data (), 1, buf.size (), f);
+  }
+}
+
+/* A streamed binary dataset is written while the simulation runs.  Its
+   header holds a <stream open> tag, which is changed into <stream done>
+   once the dataset is complete.  The data section consists of records,
+   each starting at an 8 byte boundary with a tag line.  <indep NAME> and
+   <dep NAME DEPENDENCIES> tags declare a vector, repeated declarations
+   update its dependencies.  A <chunk NAME COUNT TYPE> tag is followed by
+   the next values of a vector.  Since the records are only appended the
+   file can be read at any time during the simulation. */
+static const char streamHeader[] = "<Qucs Binary Dataset " PACKAGE_VERSION ">\n";
+
+// Opens the streamed dataset file if necessary.  Returns zero on success.
+int dataset::openStream (void) {
+  if (stream != NULL) return 0;
+  if (file == NULL || (stream = fopen (file, "wb")) == NULL) {
+    logprint (LOG_ERROR, "cannot stream dataset into `%s': %s\n",
+	      file ? file : "stdout", file ? strerror (errno) : "not a file");
+    chunkSize = 0;
+    return -1;
+  }
+  writeStreamTag (std::string (streamHeader) + "<stream open>\n<data>\n");
+  return 0;
+}
+
+/* Writes the given tag into the streamed dataset and pads the file to
+   the next 8 byte boundary.  The file is always aligned before. */
+void dataset::writeStreamTag (const std::string & tag) {
+  static const char pad[8] = { 0 };
+  fwrite (tag.data (), 1, tag.size (), stream);
+  fwrite (pad, 1, (8 - tag.size () % 8) % 8, stream);
+}
+
+/* The function writes the values of the given vector, which have not
+   been written yet, as chunk into the streamed dataset.  The vector is
+   declared first if necessary.  If requested the vector values are
+   dropped from memory afterwards. */
+void dataset::writeStream (vector * v, int variable, int drop) {
+  auto s = streamed.find (v);
+  if (s == streamed.end ()) {
+    streamed_t z = { 0, 0 };
+    s = streamed.insert (std::make_pair (v, z)).first;
+    writeStreamTag (binaryTag (v, variable, 0));
+  }
+  int first = s->second.written - s->second.dropped;
+  int count = v->getSize () - first;
+  if (count > 0) {
+    std::vector<unsigned char> buf;
+    int cplx = isComplexVector (v, first);
+    writeStreamTag (std::string ("<chunk ") + v->getName () + " " +
+		    std::to_string (count) + (cplx ? " complex>\n" : " real>\n"));
+    encodeValues (buf, v, first, cplx);
+    fwrite (buf.data (), 1, buf.size (), stream);
+    s->second.written += count;
+  }
+  if (drop) {
+    s->second.dropped += v->getSize ();
+    v->clear ();
+  }
+}
+
+/* This function writes the vectors holding at least a chunk of new
+   values into the streamed dataset and drops them from memory.  It is
+   meant to be called by analyses producing large amounts of data. */
+void dataset::streamData (void) {
+  if (chunkSize <= 0 || openStream ()) return;
+  // number of values not written yet
+  auto pending = [this] (vector * v) {
+    auto s = streamed.find (v);
+    if (s == streamed.end ()) return v->getSize ();
+    return v->getSize () - (s->second.written - s->second.dropped);
+  };
+  vector * v;
+  for (v = dependencies; v != NULL; v = (vector *) v->getNext ())
+    if (pending (v) >= chunkSize) writeStream (v, 0, 1);
+  for (v = variables; v != NULL; v = (vector *) v->getNext ())
+    if (pending (v) >= chunkSize) writeStream (v, 1, 1);
+  fflush (stream);
+}
+
+/* Writes the remaining values of all vectors into the streamed dataset
+   and marks it as done.  The vectors are declared once more since
+   their dependencies may have changed.  Returns zero on success. */
+int dataset::closeStream (void) {
+  vector * v;
+  if (openStream ()) return -1;
+  for (int variable = 0; variable < 2; variable++) {
+    for (v = variable ? variables : dependencies; v != NULL;
+	 v = (vector *) v->getNext ()) {
+      int known = streamed.find (v) != streamed.end ();
+      writeStream (v, variable, 0);
+      if (known) writeStreamTag (binaryTag (v, variable, 0));
+    }
+  }
+  fseek (stream, strlen (streamHeader), SEEK_SET);
+  fputs ("<stream done>\n", stream);
+  fclose (stream);
+  stream = NULL;
+  chunkSize = 0;
+  return 0;
+}
+
 /* Prints the given vector as independent dataset vector into the
    given file descriptor. */
 void dataset::printDependency (vector * v, FILE * f) {
@@ -411,10 +643,17 @@ void dataset::printData (vector * v, FILE * f) {
    messages and returns NULL. */
 dataset * dataset::load (const char * file) {
   FILE * f;
+  char head[32];
   if ((f = fopen (file, "r")) == NULL) {
     logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
     return NULL;
   }
+  if (fgets (head, sizeof (head), f) != NULL &&
+      !strncmp (head, "<Qucs Binary Dataset ", 21)) {
+    fclose (f);
+    return load_binary (file);
+  }
+  rewind (f);
   dataset_in = f;
   dataset_restart (dataset_in);
   if (dataset_parse () != 0) {
@@ -434,6 +673,258 @@ dataset * dataset::load (const char * file) {
   return dataset_result;
 }
 
+// A vector read from a binary dataset.
+struct binary_vector_t {
+  vector * v;
+  int variable;
+  int requested;
+  strlist * deps;
+};
+
+/* Splits the given tag into its space separated words.  Returns an
+   empty list if the tag is malformed. */
+static std::vector<std::string> binaryWords (const std::string & tag) {
+  std::vector<std::string> words;
+  if (tag.size () < 3 || tag[0] != '<' || tag[tag.size () - 1] != '>')
+    return words;
+  size_t b = 1, e;
+  while ((e = tag.find (' ', b)) != std::string::npos) {
+    words.push_back (tag.substr (b, e - b));
+    b = e + 1;
+  }
+  words.push_back (tag.substr (b, tag.size () - 1 - b));
+  return words;
+}
+
+/* Handles an <indep> or <dep> tag of a binary dataset.  A repeated
+   declaration replaces the kind and the dependencies of the vector.
+   Returns the index of the vector or -1 if the tag is invalid. */
+static int binaryDeclare (std::vector<binary_vector_t> & vecs,
+			  std::map<std::string, int> & names,
+			  const std::vector<std::string> & words) {
+  int variable;
+  if (words[0] == "dep" && words.size () >= 2)
+    variable = 1;
+  else if (words[0] == "indep" && words.size () >= 2 && words.size () <= 3)
+    variable = 0;
+  else
+    return -1;
+
+  auto it = names.find (words[1]);
+  int n = it == names.end () ? (int) vecs.size () : it->second;
+  if (it == names.end ()) {
+    binary_vector_t b = { new vector (words[1]), 0, -1, NULL };
+    vecs.push_back (b);
+    names[words[1]] = n;
+  }
+  binary_vector_t & b = vecs[n];
+  b.variable = variable;
+  delete b.deps;
+  b.deps = NULL;
+  if (variable) {
+    b.deps = new strlist ();
+    for (size_t i = 2; i < words.size (); i++)
+      b.deps->append (words[i].c_str ());
+  }
+  else if (words.size () == 3) {
+    b.requested = atoi (words[2].c_str ());
+  }
+  return n;
+}
+
+// Appends the given number of encoded values to the vector.
+static void decodeValues (vector * v, const unsigned char * p, int count,
+			  int cplx) {
+  for (int i = 0; i < count; i++, p += cplx ? 16 : 8)
+    v->add (nr_complex_t (getDouble (p), cplx ? getDouble (p + 8) : 0));
+}
+
+/* Parses the binary dataset given as memory block.  Streamed datasets
+   which are still being written are read up to their last complete
+   record.  Returns NULL and emits error messages if the data is
+   corrupted or, if requested, inconsistent. */
+static dataset * parse_binary (const char * file, const unsigned char * map,
+			       size_t len, int check) {
+  static const char mark[] = "\n<data>\n";
+  const char * base = (const char *) map;
+  const char * end = std::search (base, base + len, mark, mark + 8);
+  if (end == base + len) {
+    logprint (LOG_ERROR, "error loading `%s': no binary dataset header\n",
+	      file);
+    return NULL;
+  }
+  size_t start = (end - base + 8 + 7) & ~((size_t) 7);
+  size_t size = len > start ? len - start : 0;
+
+  std::vector<binary_vector_t> vecs;
+  std::map<std::string, int> names;
+  std::vector<std::string> words;
+  int errors = 0, stream = 0, last = -1;
+
+  // go through the header
+  std::string header (base, end - base + 1);
+  size_t line = header.find ('\n') + 1, next;
+  for (; !errors && line < header.size (); line = next + 1) {
+    next = header.find ('\n', line);
+    words = binaryWords (header.substr (line, next - line));
+    if (words.empty ()) {
+      errors++;
+    }
+    else if (words[0] == "stream" && words.size () == 2) {
+      stream = words[1] == "done" ? 2 : 1;
+    }
+    else if (words[0] == "block" && words.size () == 4 && last >= 0) {
+      unsigned long long offset = strtoull (words[1].c_str (), NULL, 10);
+      int count = atoi (words[2].c_str ());
+      int cplx = words[3] == "complex";
+      if (count < 0 || offset + (unsigned long long) count * (cplx ? 16 : 8)
+	  > size)
+	errors++;
+      else
+	decodeValues (vecs[last].v, map + start + offset, count, cplx);
+      last = -1;
+    }
+    else if ((last = binaryDeclare (vecs, names, words)) < 0) {
+      errors++;
+    }
+  }
+
+  // go through the records of a streamed dataset
+  size_t pos = 0;
+  while (stream && !errors && pos < size) {
+    const char * rec = base + start + pos;
+    const char * eol = std::find (rec, base + len, '\n');
+    if (eol == base + len) {
+      if (stream == 2) errors++;
+      break;
+    }
+    words = binaryWords (std::string (rec, eol - rec));
+    next = (pos + (eol - rec) + 1 + 7) & ~((size_t) 7);
+    if (words.empty ()) {
+      errors++;
+    }
+    else if (words[0] == "chunk" && words.size () == 4) {
+      auto it = names.find (words[1]);
+      int count = atoi (words[2].c_str ());
+      int cplx = words[3] == "complex";
+      size_t length = (size_t) count * (cplx ? 16 : 8);
+      if (it == names.end () || count < 0) {
+	errors++;
+      }
+      else if (next + length > size) {
+	// incomplete record of a running simulation
+	if (stream == 2) errors++;
+	break;
+      }
+      else {
+	decodeValues (vecs[it->second].v, map + start + next, count, cplx);
+      }
+      next += length;
+    }
+    else if (binaryDeclare (vecs, names, words) < 0) {
+      errors++;
+    }
+    pos = next;
+  }
+
+  if (errors) {
+    logprint (LOG_ERROR, "error loading `%s': corrupted binary dataset\n",
+	      file);
+    for (auto & b : vecs) {
+      delete b.v;
+      delete b.deps;
+    }
+    return NULL;
+  }
+
+  // create the dataset
+  dataset * data = new dataset ();
+  for (auto & b : vecs) {
+    if (b.variable) {
+      b.v->setDependencies (b.deps);
+      data->appendVariable (b.v);
+    }
+    else {
+      b.v->setRequested (b.requested >= 0 ? b.requested : b.v->getSize ());
+      data->appendDependency (b.v);
+    }
+  }
+  if (check && dataset_check (data) != 0) {
+    delete data;
+    return NULL;
+  }
+  data->setFile (file);
+  data->setBinary (1);
+  return data;
+}
+
+/* Reads the given binary dataset file.  The file is mapped into memory
+   if possible. */
+static dataset * read_binary (const char * file, int check) {
+  dataset * data;
+#if HAVE_SYS_MMAN_H
+  int fd;
+  struct stat st;
+  if ((fd = open (file, O_RDONLY)) < 0 || fstat (fd, &st) != 0) {
+    logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
+    if (fd >= 0) close (fd);
+    return NULL;
+  }
+  void * map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED) {
+    logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
+    return NULL;
+  }
+  data = parse_binary (file, (const unsigned char *) map, st.st_size, check);
+  munmap (map, st.st_size);
+#else
+  FILE * f;
+  if ((f = fopen (file, "rb")) == NULL) {
+    logprint (LOG_ERROR, "error loading `%s': %s\n", file, strerror (errno));
+    return NULL;
+  }
+  std::vector<unsigned char> buf;
+  unsigned char chunk[65536];
+  size_t n;
+  while ((n = fread (chunk, 1, sizeof (chunk), f)) > 0)
+    buf.insert (buf.end (), chunk, chunk + n);
+  fclose (f);
+  data = parse_binary (file, buf.data (), buf.size (), check);
+#endif
+  return data;
+}
+
+/* This static function reads a full dataset from the given binary
+   dataset file and returns it.  On failure the function emits
+   appropriate error messages and returns NULL. */
+dataset * dataset::load_binary (const char * file) {
+  return read_binary (file, 1);
+}
+
+/* The function reads the values written into the streamed dataset so
+   far back into memory.  This is necessary before the dataset is
+   passed to the equation solver. */
+void dataset::restoreStream (void) {
+  if (stream == NULL) return;
+  fflush (stream);
+  dataset * data = read_binary (file, 0);
+  if (data == NULL) return;
+  for (auto & s : streamed) {
+    vector * v = s.first, * o;
+    if (s.second.dropped == 0) continue;
+    if ((o = data->findDependency (v->getName ())) == NULL &&
+	(o = data->findVariable (v->getName ())) == NULL) continue;
+    if (o->getSize () < s.second.dropped) continue;
+    vector all;
+    for (int i = 0; i < s.second.dropped; i++) all.add (o->get (i));
+    for (int i = 0; i < v->getSize (); i++) all.add (v->get (i));
+    *v = all;
+    s.second.dropped = 0;
+  }
+  delete data;
+}
+
 /* This static function read a full dataset from the given touchstone
    file and returns it.  On failure the function emits appropriate
    error messages and returns NULL. */
@@ -25,8 +25,14 @@
 #ifndef __DATASET_H__
 #define __DATASET_H__
 
+#include <map>
+#include <string>
+
 #include "object.h"
 
+// number of values per vector written at once into streamed datasets
+#define DATASET_STREAM_CHUNK 4096
+
 namespace qucs {
 
 class vector;
@@ -53,7 +59,14 @@ class dataset : public object
   void assignDependency (const char *const, const char * const);
   char * getFile (void);
   void setFile (const char *);
+  void setBinary (int b) { binary = b; }
+  int isBinary (void) { return binary; }
+  void setStream (int chunk) { chunkSize = chunk; }
+  int isStreaming (void) { return chunkSize > 0 || stream != NULL; }
+  void streamData (void);
+  void restoreStream (void);
   void print (void);
+  void printBinary (FILE *);
   void printData (qucs::vector *, FILE *);
   void printDependency (qucs::vector *, FILE *);
   void printVariable (qucs::vector *, FILE *);
@@ -65,6 +78,7 @@ class dataset : public object
   int isVariable (qucs::vector *);
   qucs::vector * findOrigin (char *);
   static dataset * load (const char *);
+  static dataset * load_binary (const char *);
   static dataset * load_touchstone (const char *);
   static dataset * load_csv (const char *);
   static dataset * load_citi (const char *);
@@ -74,10 +88,26 @@ class dataset : public object
   int countDependencies (void);
   int countVariables (void);
 
+ private:
+  int openStream (void);
+  int closeStream (void);
+  void writeStream (qucs::vector *, int, int);
+  void writeStreamTag (const std::string &);
+
  private:
   char * file;
+  int binary;
   qucs::vector * dependencies;
   qucs::vector * variables;
+
+  // state of streamed output
+  struct streamed_t {
+    int written;  // number of values written into the file
+    int dropped;  // number of values dropped from memory
+  };
+  int chunkSize;
+  FILE * stream;
+  std::map<qucs::vector *, streamed_t> streamed;
 };
 
 } // namespace qucs
@@ -42,6 +42,10 @@ namespace qucs {
 // Constructor creates an unnamed instance of the dcsolver class.
 dcsolver::dcsolver () : nasolver<nr_double_t> () {
   saveOPs = 0;
+  contMode = CONT_None;
+  contPoints = 0;
+  contNext = 0;
+  statIterations = statFallbacks = 0;
   type = ANALYSIS_DC;
   setDescription ("DC");
 }
@@ -49,6 +53,10 @@ dcsolver::dcsolver () : nasolver<nr_double_t> () {
 // Constructor creates a named instance of the dcsolver class.
 dcsolver::dcsolver (char * n) : nasolver<nr_double_t> (n) {
   saveOPs = 0;
+  contMode = CONT_None;
+  contPoints = 0;
+  contNext = 0;
+  statIterations = statFallbacks = 0;
   type = ANALYSIS_DC;
   setDescription ("DC");
 }
@@ -61,6 +69,10 @@ dcsolver::~dcsolver () {
    based on the given dcsolver object. */
 dcsolver::dcsolver (dcsolver & o) : nasolver<nr_double_t> (o) {
   saveOPs = o.saveOPs;
+  contMode = o.contMode;
+  contPoints = 0;
+  contNext = o.contNext;
+  statIterations = statFallbacks = 0;
 }
 
 /* This is the DC netlist solver.  It prepares the circuit list and
@@ -70,15 +82,13 @@ int dcsolver::solve (void) {
   saveOPs |= !strcmp (getPropertyString ("saveOPs"), "yes") ? SAVE_OPS : 0;
   saveOPs |= !strcmp (getPropertyString ("saveAll"), "yes") ? SAVE_ALL : 0;
   const char * const solver = getPropertyString ("Solver");
+  setThreads (getPropertyInteger ("Threads"));
 
   // initialize node voltages, first guess for non-linear circuits and
   // generate extra circuits if necessary
   init ();
   setCalculation ((calculate_func_t) &calc);
 
-  // start the iterative solver
-  solve_pre ();
-
   // choose a solver
   if (!strcmp (solver, "CroutLU"))
     eqnAlgo = ALGO_LU_DECOMPOSITION_CROUT;
@@ -90,6 +100,11 @@ int dcsolver::solve (void) {
     eqnAlgo = ALGO_QR_DECOMPOSITION_LS;
   else if (!strcmp (solver, "GolubSVD"))
     eqnAlgo = ALGO_SV_DECOMPOSITION;
+  else if (!strcmp (solver, "SparseLU"))
+    eqnAlgo = ALGO_SPARSE_LU_DECOMPOSITION;
+
+  // start the iterative solver, the matrix type depends on the solver
+  solve_pre ();
 
   // local variables for the fallback thingies
   int retry = -1, error, fallback = 0, preferred;
@@ -117,6 +132,10 @@ int dcsolver::solve (void) {
   }
   preferred = convHelper;
 
+  // start from the previous sweep points if requested
+  int seeded = contMode != CONT_None;
+  statIterations = statFallbacks = 0;
+
   if (!subnet->isNonLinear ()) {
     // Start the linear solver.
     convHelper = CONV_None;
@@ -125,8 +144,13 @@ int dcsolver::solve (void) {
   else do {
     // Run the DC solver once.
     try_running () {
-      applyNodeset ();
+      if (!seeded || !applyContinuation ()) {
+	seeded = 0;
+	applyNodeset ();
+      }
       error = solve_nonlinear ();
+      // count the iterations of failed attempts as well
+      statIterations += iterations;
 #if DEBUG
       if (!error) {
 	logprint (LOG_STATUS,
@@ -134,18 +158,30 @@ int dcsolver::solve (void) {
 		  getName (), iterations);
       }
 #endif /* DEBUG */
-      if (!error) retry = -1;
+      if (!error) {
+	retry = -1;
+	if (contMode != CONT_None) storeContinuation ();
+      }
     }
     // Appropriate exception handling.
     catch_exception () {
     case EXCEPTION_NO_CONVERGENCE:
       pop_exception ();
+      if (seeded) {
+	// try the usual initial guess before any convergence helper
+	seeded = 0;
+	statFallbacks++;
+	retry++;
+	restart ();
+	break;
+      }
       if (preferred == helpers[fallback] && preferred) fallback++;
       convHelper = helpers[fallback++];
       if (convHelper != -1) {
 	logprint (LOG_ERROR, "WARNING: %s: %s analysis failed, using fallback "
 		  "#%d (%s)\n", getName (), getDescription ().c_str(), fallback,
 		  getHelperDescription ());
+	statFallbacks++;
 	retry++;
 	restart ();
       }
@@ -172,10 +208,7 @@ int dcsolver::solve (void) {
 /* Goes through the list of circuit objects and runs its calcDC()
    function. */
 void dcsolver::calc (dcsolver * self) {
-  circuit * root = self->getNet()->getRoot ();
-  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
-    c->calcDC ();
-  }
+  self->calculateCircuits ([] (circuit * c) { c->calcDC (); });
 }
 
 /* Goes through the list of circuit objects and runs its initDC()
@@ -205,6 +238,57 @@ void dcsolver::saveOperatingPoints (void) {
   }
 }
 
+/* Sets the continuation mode and the value of the swept parameter for
+   the next solve().  CONT_None drops the previous solutions. */
+void dcsolver::setContinuation (int mode, nr_double_t p) {
+  contMode = mode;
+  contNext = p;
+  if (mode == CONT_None) {
+    contPoints = 0;
+    contX[0] = contX[1] = tvector<nr_double_t> ();
+  }
+}
+
+/* Returns the number of Newton iterations of all attempts and the
+   number of fallbacks, i.e. restarts from the usual initial guess and
+   convergence helpers, used by the last solve(). */
+bool dcsolver::getStatistics (int & iter, int & fallbacks) {
+  iter = statIterations;
+  fallbacks = statFallbacks;
+  return true;
+}
+
+/* The function seeds the solution vector with the solution of the
+   previous sweep point, linearly extrapolated to the next point if
+   requested, and passes it to the non-linear circuits.  Returns zero
+   if there is no usable previous solution. */
+int dcsolver::applyContinuation (void) {
+  if (contPoints < 1 || contX[0].size () != x->size ()) return 0;
+  *x = contX[0];
+  if (contMode == CONT_Extrapolate && contPoints > 1 &&
+      contParam[0] != contParam[1]) {
+    nr_double_t f = (contNext - contParam[0]) / (contParam[0] - contParam[1]);
+    for (int r = 0; r < (int) x->size (); r++) {
+      nr_double_t x0 = contX[0].get (r);
+      x->set (r, x0 + f * (x0 - contX[1].get (r)));
+    }
+  }
+  if (xprev != NULL) *xprev = *x;
+  saveSolution ();
+  restartNR ();
+  return 1;
+}
+
+/* Keeps the converged solution of the current sweep point and the one
+   of the point before. */
+void dcsolver::storeContinuation (void) {
+  contX[1] = contX[0];
+  contParam[1] = contParam[0];
+  contX[0] = *x;
+  contParam[0] = contNext;
+  if (contPoints < 2) contPoints++;
+}
+
 // properties
 PROP_REQ [] = {
   PROP_NO_PROP };
@@ -220,6 +304,7 @@ PROP_OPT [] = {
     PROP_RNG_STR6 ("none", "SourceStepping", "gMinStepping",
 		   "LineSearch", "Attenuation", "SteepestDescent") },
   { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" }, PROP_RNG_SOL },
+  { "Threads", PROP_INT, { 1, PROP_NO_STR }, PROP_RNGII (0, 256) },
   PROP_NO_PROP };
 struct define_t dcsolver::anadef =
   { "DC", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
@@ -41,9 +41,22 @@ class dcsolver : public nasolver<nr_double_t>
   void init (void);
   void restart (void);
   void saveOperatingPoints (void);
+  void setContinuation (int, nr_double_t);
+  bool getStatistics (int &, int &);
+
+ private:
+  int  applyContinuation (void);
+  void storeContinuation (void);
 
  private:
   int saveOPs;
+  int contMode;
+  int contPoints;
+  nr_double_t contNext;
+  nr_double_t contParam[2];
+  tvector<nr_double_t> contX[2];
+  int statIterations;
+  int statFallbacks;
 };
 
 } // namespace qucs
@@ -117,6 +117,8 @@ environment::~environment () {
 void environment::copyVariables (variable * org) {
   variable * var;
   root = NULL;
+  symbols.clear ();
+  values.clear ();
   while (org != NULL) {
     // copy variable (references only)
     var = new variable (*org);
@@ -139,6 +141,7 @@ void environment::copyVariables (variable * org) {
     }
     var->setNext (root);
     root = var;
+    indexVariable (var);
     org = org->getNext ();
   }
 }
@@ -162,6 +165,8 @@ void environment::deleteVariables (void) {
     delete var;
   }
   root = NULL;
+  symbols.clear ();
+  values.clear ();
 }
 
 /* This function adds a variable to the environment. */
@@ -169,17 +174,24 @@ void environment::addVariable (variable * const var, const bool pass) {
   var->setNext (root);
   var->setPassing (pass);
   this->root = var;
+  indexVariable (var);
+}
+
+/* Puts the given variable into the symbol tables.  Since variables
+   are prepended to the list it shadows earlier ones of the same
+   name. */
+void environment::indexVariable (variable * const var) {
+  if (var->getType () == VAR_VALUE)
+    values[var->getName ()] = var;
+  else
+    symbols[var->getName ()] = var;
 }
 
 /* This function looks for the variable name in the environment and
    returns it if possible.  Otherwise the function returns NULL. */
 variable * environment::getVariable (const char * const n) const {
-  for (variable * var = root; var != NULL; var = var->getNext ()) {
-    if (var->getType () != VAR_VALUE)
-      if (!strcmp (var->getName (), n))
-	return var;
-  }
-  return NULL;
+  auto it = symbols.find (n);
+  return it != symbols.end () ? it->second : NULL;
 }
 
 // The function runs the equation checker for this environment.
@@ -268,12 +280,8 @@ void environment::fetchConstants (void) {
    being a saved value and returns the variable pointer or NULL if
    there is no such variable. */
 variable * environment::findValue (char * n) {
-  for (variable * var = root; var != NULL; var = var->getNext ()) {
-    if (var->getType () == VAR_VALUE)
-      if (!strcmp (var->getName (), n))
-	return var;
-  }
-  return NULL;
+  auto it = values.find (n);
+  return it != values.end () ? it->second : NULL;
 }
 
 /* Puts the given variable name and its computed result into the list
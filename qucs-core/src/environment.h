@@ -33,6 +33,7 @@
 
 #include <list>
 #include <string>
+#include <unordered_map>
 
 #include "equation.h"
 
@@ -116,8 +117,14 @@ class environment
   }
 
  private:
+  void indexVariable (variable * const);
+
   std::string name;
   variable * root;
+  /* Symbol tables of the variable list mapping the names to the first
+     (i.e. most recently added) variable; saved values separately. */
+  std::unordered_map<std::string, variable *> symbols;
+  std::unordered_map<std::string, variable *> values;
   eqn::checker * checkee;
   eqn::solver * solvee;
   std::list<environment *> children;
@@ -35,12 +35,17 @@
 #include <float.h>
 
 #include <limits>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <iterator>
 
 #include "compat.h"
 #include "logging.h"
 #include "precision.h"
 #include "complex.h"
 #include "tmatrix.h"
+#include "tspmatrix.h"
 #include "eqnsys.h"
 #include "exception.h"
 #include "exceptionstack.h"
@@ -57,6 +62,7 @@ eqnsys<nr_type_t>::eqnsys () {
   B = X = NULL;
   S = E = NULL;
   T = R = NULL;
+  As = L = U = NULL;
   nPvt = NULL;
   cMap = rMap = NULL;
   update = 1;
@@ -73,6 +79,8 @@ eqnsys<nr_type_t>::~eqnsys () {
   delete S;
   delete E;
   delete V;
+  delete L;
+  delete U;
   delete[] rMap;
   delete[] cMap;
   delete[] nPvt;
@@ -83,9 +91,12 @@ eqnsys<nr_type_t>::~eqnsys () {
 template <class nr_type_t>
 eqnsys<nr_type_t>::eqnsys (eqnsys & e) {
   A = e.A;
+  As = e.As;
   V = NULL;
   S = E = NULL;
   T = R = NULL;
+  L = U = NULL;
+  sOrder = e.sOrder;
   B = e.B ? new tvector<nr_type_t> (*(e.B)) : NULL;
   cMap = rMap = NULL;
   nPvt = NULL;
@@ -121,6 +132,116 @@ void eqnsys<nr_type_t>::passEquationSys (tmatrix<nr_type_t> * nA,
   X = refX;
 }
 
+/*! This function passes a sparse left hand side matrix to the
+   equation system solver.  Apart from the matrix type it behaves
+   exactly like the above function and is meant to be used with the
+   sparse solution algorithms only. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::passEquationSys (tspmatrix<nr_type_t> * nA,
+					 tvector<nr_type_t> * refX,
+					 tvector<nr_type_t> * nB) {
+  if (nA != NULL) {
+    // a different matrix invalidates the previous factorization
+    if (As != nA) {
+      delete L; L = NULL;
+      delete U; U = NULL;
+    }
+    As = nA;
+    update = 1;
+    if (N != As->getCols ()) {
+      N = As->getCols ();
+      delete[] cMap; cMap = new int[N];
+      delete[] rMap; rMap = new int[N];
+      delete[] nPvt; nPvt = new nr_double_t[N];
+      delete L; L = NULL;
+      delete U; U = NULL;
+    }
+  }
+  else {
+    update = 0;
+  }
+  delete B;
+  B = new tvector<nr_type_t> (*nB);
+  X = refX;
+}
+
+/*! The function computes a fill reducing column ordering for the
+   given sparse matrix.  It applies a minimum degree ordering to the
+   graph of A + A^T, densely connected nodes are ordered last.  It is
+   meant to be called once after the non-zero pattern of the matrix
+   has been set up.  Subsequent sparse LU decompositions reuse the
+   ordering as well as the pivoting and structure of the first
+   factorization. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::reorderSparse (tspmatrix<nr_type_t> * nA) {
+  int n = nA->getCols ();
+  int * Ap = nA->getColPtr (), * Ai = nA->getRowIdx ();
+  int dense = std::max (16, (int) (10 * std::sqrt ((double) n)));
+  std::vector< std::vector<int> > adj (n);
+  std::vector<char> done (n, 0);
+  std::vector<int> late, merged;
+  int i, p;
+
+  // build the adjacency lists of the graph of A + A^T
+  for (i = 0; i < n; i++) {
+    for (p = Ap[i]; p < Ap[i + 1]; p++) {
+      if (Ai[p] == i) continue;
+      adj[i].push_back (Ai[p]);
+      adj[Ai[p]].push_back (i);
+    }
+  }
+  for (i = 0; i < n; i++) {
+    std::sort (adj[i].begin (), adj[i].end ());
+    adj[i].erase (std::unique (adj[i].begin (), adj[i].end ()), adj[i].end ());
+    if ((int) adj[i].size () > dense) {
+      late.push_back (i);
+      done[i] = 1;
+    }
+  }
+
+  // remove the dense nodes from the graph
+  typedef std::pair<int, int> degree_t;
+  std::priority_queue<degree_t, std::vector<degree_t>,
+    std::greater<degree_t> > queue;
+  for (i = 0; i < n; i++) {
+    if (done[i]) continue;
+    adj[i].erase (std::remove_if (adj[i].begin (), adj[i].end (),
+				  [&done] (int j) { return done[j] != 0; }),
+		  adj[i].end ());
+    queue.push (degree_t ((int) adj[i].size (), i));
+  }
+
+  // eliminate the node with minimum degree repeatedly
+  sOrder.clear ();
+  sOrder.reserve (n);
+  while (!queue.empty ()) {
+    degree_t d = queue.top ();
+    queue.pop ();
+    int v = d.second;
+    if (done[v] || d.first != (int) adj[v].size ()) continue;
+    done[v] = 1;
+    sOrder.push_back (v);
+    // the neighbours of the eliminated node form a clique
+    for (int u : adj[v]) {
+      merged.clear ();
+      std::set_union (adj[u].begin (), adj[u].end (),
+		      adj[v].begin (), adj[v].end (),
+		      std::back_inserter (merged));
+      merged.erase (std::remove_if (merged.begin (), merged.end (),
+				    [u, v] (int j) { return j == u || j == v; }),
+		    merged.end ());
+      adj[u].swap (merged);
+      queue.push (degree_t ((int) adj[u].size (), u));
+    }
+    std::vector<int> ().swap (adj[v]);
+  }
+  sOrder.insert (sOrder.end (), late.begin (), late.end ());
+
+  // previous factorization cannot be reused anymore
+  delete L; L = NULL;
+  delete U; U = NULL;
+}
+
 /*! Depending on the algorithm applied to the equation system solver
    the function stores the solution of the system into the matrix
    pointed to by the X matrix reference. */
@@ -175,6 +296,15 @@ void eqnsys<nr_type_t>::solve (void) {
   case ALGO_QR_DECOMPOSITION_2:
     solve_qrh ();
     break;
+  case ALGO_SPARSE_LU_DECOMPOSITION:
+    solve_lu_sparse ();
+    break;
+  case ALGO_SPARSE_LU_FACTORIZATION:
+    factorize_lu_sparse ();
+    break;
+  case ALGO_SPARSE_LU_SUBSTITUTION:
+    substitute_lu_sparse ();
+    break;
   }
 #if DEBUG && 0
   logprint (LOG_STATUS, "NOTIFY: %dx%d eqnsys solved in %ld seconds\n",
@@ -502,6 +632,413 @@ void eqnsys<nr_type_t>::substitute_lu_doolittle (void) {
   }
 }
 
+/*! The function uses a sparse LU decomposition and the appropriate
+   forward and backward substitutions in order to solve the linear
+   equation system.  Memory and computation time scale with the number
+   of non-zero entries of the (sparse) A matrix and its factors rather
+   than with the square or cube of its size. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::solve_lu_sparse (void) {
+
+  // skip decomposition if requested
+  if (update) {
+    // perform LU composition
+    factorize_lu_sparse ();
+  }
+
+  // finally solve the equation system
+  substitute_lu_sparse ();
+}
+
+/*! Relative threshold used during sparse partial pivoting.  A diagonal
+   element is preferred over the largest element in its column as long
+   as its magnitude is not smaller than this fraction of it. */
+#define SPARSE_PIVOT_TOL 0.1
+
+/*! This function determines the set of rows of the partially computed
+   L matrix reachable from the non-zero entries of the given column of
+   the sparse A matrix (a depth first search in the graph of L).  The
+   rows are stored in topological order in xi[top...N-1] and the
+   function returns 'top'.  The second half of xi is used as a stack. */
+template <class nr_type_t>
+int eqnsys<nr_type_t>::sparse_reach (int col, int * xi, int * pinv,
+				     char * mark) {
+  int * Ap = As->getColPtr (), * Ai = As->getRowIdx ();
+  int * Lp = L->getColPtr (), * Li = L->getRowIdx ();
+  int * stack = xi + N;
+  int top = N, head, j, jnew, p, p2, done;
+
+  for (int k = Ap[col]; k < Ap[col + 1]; k++) {
+    if (mark[Ai[k]]) continue;
+    // non-recursive depth first search starting at row Ai[k]
+    head = 0;
+    xi[0] = Ai[k];
+    while (head >= 0) {
+      j = xi[head];
+      jnew = pinv[j];
+      if (!mark[j]) {
+	mark[j] = 1;
+	stack[head] = (jnew < 0) ? 0 : Lp[jnew] + 1;
+      }
+      done = 1;
+      p2 = (jnew < 0) ? 0 : Lp[jnew + 1];
+      for (p = stack[head]; p < p2; p++) {
+	if (mark[Li[p]]) continue;
+	stack[head] = p;
+	xi[++head] = Li[p];
+	done = 0;
+	break;
+      }
+      if (done) {
+	head--;
+	xi[--top] = j;
+      }
+    }
+  }
+
+  // unmark the reached rows
+  for (p = top; p < N; p++) mark[xi[p]] = 0;
+  return top;
+}
+
+/*! The function decomposes the sparse left hand matrix into a lower
+   L (with unity diagonal) and an upper U matrix.  If there is a
+   previous decomposition of a matrix with the same non-zero pattern
+   its pivoting and structure are reused and only the numerical values
+   are computed.  Full pivoting is done again only if a pivot element
+   collapses. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::factorize_lu_sparse (void) {
+  if (L != NULL && U != NULL) {
+    if (refactorize_lu_sparse ()) return;
+#if DEBUG
+    logprint (LOG_STATUS, "NOTIFY: sparse LU refactorization failed, "
+	      "pivoting again\n");
+#endif
+  }
+  pivot_lu_sparse ();
+}
+
+/*! Threshold used during sparse refactorization.  If a pivot element
+   gets smaller than this fraction of the largest element below it the
+   pivoting order is considered to be collapsed. */
+#define SPARSE_REPIVOT_TOL 1e-3
+
+/*! The function computes the numerical values of the sparse LU
+   decomposition using the pivoting and the non-zero structure of the
+   previous decomposition.  The entries within each column of U are
+   stored in topological order, thus the sparse triangular solve does
+   not need any graph search.  The function returns zero if a pivot
+   element collapses and non-zero otherwise. */
+template <class nr_type_t>
+int eqnsys<nr_type_t>::refactorize_lu_sparse (void) {
+  int * Ap = As->getColPtr (), * Ai = As->getRowIdx ();
+  int * Lp = L->getColPtr (), * Li = L->getRowIdx ();
+  int * Up = U->getColPtr (), * Ui = U->getRowIdx ();
+  nr_type_t * Ax = As->getData ();
+  nr_type_t * Lx = L->getData ();
+  nr_type_t * Ux = U->getData ();
+  int k, p, q, j;
+  nr_double_t a, t;
+  nr_type_t pivot;
+
+  // workspaces, the rows are numbered by their pivot position
+  std::vector<nr_type_t> x (N, 0.0);
+  std::vector<int> pinv (N);
+  for (k = 0; k < N; k++) pinv[rMap[k]] = k;
+
+  for (k = 0; k < N; k++) {
+    int col = cMap[k];
+    for (p = Ap[col]; p < Ap[col + 1]; p++) x[pinv[Ai[p]]] = Ax[p];
+
+    // solve L * x = A(:,col) along the known structure of U
+    for (p = Up[k]; p < Up[k + 1] - 1; p++) {
+      j = Ui[p];
+      Ux[p] = x[j];
+      x[j] = 0.0;
+      for (q = Lp[j] + 1; q < Lp[j + 1]; q++) x[Li[q]] -= Lx[q] * Ux[p];
+    }
+
+    // check pivot element against the remaining column entries
+    pivot = x[k];
+    for (a = 0, q = Lp[k] + 1; q < Lp[k + 1]; q++)
+      if ((t = abs (x[Li[q]])) > a) a = t;
+    if (abs (pivot) == 0 || abs (pivot) < a * SPARSE_REPIVOT_TOL)
+      return 0;
+
+    // store diagonal of U and the lower matrix entries
+    Ux[Up[k + 1] - 1] = pivot;
+    x[k] = 0.0;
+    for (q = Lp[k] + 1; q < Lp[k + 1]; q++) {
+      Lx[q] = x[Li[q]] / pivot;
+      x[Li[q]] = 0.0;
+    }
+  }
+  return 1;
+}
+
+/*! This function decomposes the sparse left hand matrix into a lower
+   L (with unity diagonal) and an upper U matrix.  It implements a left
+   looking (Gilbert-Peierls) LU decomposition with threshold partial
+   row pivoting.  Each column is obtained by a sparse triangular solve
+   with the already computed part of L, thus only the non-zero entries
+   of the factors are ever touched.  On exit rMap holds the row
+   permutation and cMap the column ordering. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::pivot_lu_sparse (void) {
+  int * Ap = As->getColPtr (), * Ai = As->getRowIdx ();
+  nr_type_t * Ax = As->getData ();
+  int k, p, i, top, col, ipiv;
+  nr_double_t a, t;
+  nr_type_t pivot;
+
+  // fill reducing column ordering if available
+  for (k = 0; k < N; k++)
+    cMap[k] = (int) sOrder.size () == N ? sOrder[k] : k;
+
+  // create new factors, the entries within their columns are not
+  // sorted but stored in the order of computation
+  delete L; L = new tspmatrix<nr_type_t> (N);
+  delete U; U = new tspmatrix<nr_type_t> (N);
+  L->reserve (2 * As->getNonZeros () + N);
+  U->reserve (2 * As->getNonZeros () + N);
+
+  // workspaces
+  std::vector<nr_type_t> x (N, 0.0);
+  std::vector<int> xi (2 * N);
+  std::vector<int> pinv (N, -1);
+  std::vector<char> mark (N, 0);
+
+  for (k = 0; k < N; k++) {
+    col = cMap[k];
+
+    // solve L * x = A(:,col) for the reachable rows only
+    top = sparse_reach (col, xi.data (), pinv.data (), mark.data ());
+    for (p = Ap[col]; p < Ap[col + 1]; p++) x[Ai[p]] = Ax[p];
+    int * Lp = L->getColPtr (), * Li = L->getRowIdx ();
+    nr_type_t * Lx = L->getData ();
+    for (p = top; p < N; p++) {
+      int j = xi[p];
+      int J = pinv[j];
+      if (J < 0) continue;
+      // skip the unity diagonal stored first in each column of L
+      for (int q = Lp[J] + 1; q < Lp[J + 1]; q++) x[Li[q]] -= Lx[q] * x[j];
+    }
+
+    // find the pivot element and store the upper matrix entries
+    for (ipiv = -1, a = -1, p = top; p < N; p++) {
+      i = xi[p];
+      if (pinv[i] < 0) {
+	if ((t = abs (x[i])) > a) {
+	  a = t;
+	  ipiv = i;
+	}
+      }
+      else U->append (pinv[i], x[i]);
+    }
+
+    // check pivot element and throw appropriate exception
+    if (ipiv < 0 || a <= 0) {
+      if (pinv[col] < 0)
+	ipiv = col;
+      else for (ipiv = 0; pinv[ipiv] >= 0; ipiv++) ;
+      qucs::exception * e = new qucs::exception (EXCEPTION_SINGULAR);
+      e->setText ("no pivot != 0 found during sparse LU decomposition");
+      e->setData (ipiv);
+      throw_exception (e);
+      pivot = NR_TINY; /* virtual resistance to ground */
+    }
+    else {
+      // prefer the diagonal element if it is large enough
+      if (pinv[col] < 0 && abs (x[col]) >= a * SPARSE_PIVOT_TOL) ipiv = col;
+      pivot = x[ipiv];
+    }
+
+    // diagonal of the upper matrix comes last in each column
+    U->append (k, pivot);
+    U->commitCol (k);
+    pinv[ipiv] = k;
+
+    // lower matrix entries, unity diagonal comes first in each column
+    L->append (ipiv, 1.0);
+    for (p = top; p < N; p++) {
+      i = xi[p];
+      if (pinv[i] < 0) L->append (i, x[i] / pivot);
+      x[i] = 0.0;
+    }
+    L->commitCol (k);
+  }
+
+  // renumber the rows of L according to the final pivoting
+  int * Li = L->getRowIdx ();
+  for (p = 0; p < L->getNonZeros (); p++) Li[p] = pinv[Li[p]];
+
+  // remember the row exchanges
+  for (i = 0; i < N; i++) rMap[pinv[i]] = i;
+}
+
+/*! The function is used in order to run the forward and backward
+   substitutions using the sparse LU decomposed matrix (Lii are
+   ones). */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::substitute_lu_sparse (void) {
+  int * Lp = L->getColPtr (), * Li = L->getRowIdx ();
+  int * Up = U->getColPtr (), * Ui = U->getRowIdx ();
+  nr_type_t * Lx = L->getData ();
+  nr_type_t * Ux = U->getData ();
+  std::vector<nr_type_t> y (N);
+  int i, p;
+
+  // apply row exchanges
+  for (i = 0; i < N; i++) y[i] = B_(rMap[i]);
+
+  // forward substitution in order to solve LY = B
+  for (i = 0; i < N; i++) {
+    if (y[i] == 0.0) continue;
+    for (p = Lp[i] + 1; p < Lp[i + 1]; p++) y[Li[p]] -= Lx[p] * y[i];
+  }
+
+  // backward substitution in order to solve UX = Y
+  for (i = N - 1; i >= 0; i--) {
+    y[i] /= Ux[Up[i + 1] - 1];
+    if (y[i] == 0.0) continue;
+    for (p = Up[i]; p < Up[i + 1] - 1; p++) y[Ui[p]] -= Ux[p] * y[i];
+  }
+
+  // apply column ordering
+  for (i = 0; i < N; i++) X_(cMap[i]) = y[i];
+}
+
+/*! The function runs the forward and backward substitutions for
+   several right hand sides at once using the present LU factorization
+   of the matrix.  Each column of the given N x K matrix holds a right
+   hand side on entry and the corresponding solution on return.  Since
+   every entry of the factors is read once for all right hand sides
+   the function is considerably faster than K separate substitutions.
+   Other algorithms than LU substitutions solve each column on its
+   own. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::substitute (tmatrix<nr_type_t> & R) {
+  assert (R.getRows () == N);
+  switch (algo) {
+  case ALGO_LU_SUBSTITUTION_CROUT:
+    substitute_lu_block (R, 1);
+    break;
+  case ALGO_LU_SUBSTITUTION_DOOLITTLE:
+    substitute_lu_block (R, 0);
+    break;
+  case ALGO_SPARSE_LU_SUBSTITUTION:
+    substitute_lu_sparse_block (R);
+    break;
+  default: {
+    tvector<nr_type_t> * Xsave = X;
+    tvector<nr_type_t> x (N);
+    for (int k = 0; k < R.getCols (); k++) {
+      delete B;
+      B = new tvector<nr_type_t> (R.getCol (k));
+      X = &x;
+      solve ();
+      R.setCol (k, x);
+    }
+    X = Xsave;
+    break;
+  }
+  }
+}
+
+/*! Blocked forward and backward substitutions using the dense LU
+   decomposed matrix.  The diagonal of U (Crout's definition) or L
+   (Doolittle's definition) consists of ones.  The rows of the right
+   hand side matrix are contiguous in memory, thus the inner loops run
+   over all right hand sides and zero entries of the factors are
+   skipped entirely. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::substitute_lu_block (tmatrix<nr_type_t> & R,
+					     int crout) {
+  int i, c, k, K = R.getCols ();
+  tmatrix<nr_type_t> Y (N, K);
+  nr_type_t * y = Y.getData ();
+  nr_type_t f;
+
+  // apply row exchanges
+  for (i = 0; i < N; i++)
+    for (k = 0; k < K; k++) y[i * K + k] = R (rMap[i], k);
+
+  // forward substitution in order to solve LY = B
+  for (i = 0; i < N; i++) {
+    nr_type_t * yi = y + i * K;
+    for (c = 0; c < i; c++) {
+      if ((f = A_(i, c)) == 0.0) continue;
+      nr_type_t * yc = y + c * K;
+      for (k = 0; k < K; k++) yi[k] -= f * yc[k];
+    }
+    if (crout) {
+      f = 1.0 / A_(i, i);
+      for (k = 0; k < K; k++) yi[k] *= f;
+    }
+  }
+
+  // backward substitution in order to solve UX = Y
+  for (i = N - 1; i >= 0; i--) {
+    nr_type_t * yi = y + i * K;
+    for (c = i + 1; c < N; c++) {
+      if ((f = A_(i, c)) == 0.0) continue;
+      nr_type_t * yc = y + c * K;
+      for (k = 0; k < K; k++) yi[k] -= f * yc[k];
+    }
+    if (!crout) {
+      f = 1.0 / A_(i, i);
+      for (k = 0; k < K; k++) yi[k] *= f;
+    }
+  }
+  R = Y;
+}
+
+/*! Blocked forward and backward substitutions using the sparse LU
+   factors.  Each column of L and U is traversed once for all the
+   right hand sides. */
+template <class nr_type_t>
+void eqnsys<nr_type_t>::substitute_lu_sparse_block (tmatrix<nr_type_t> & R) {
+  int * Lp = L->getColPtr (), * Li = L->getRowIdx ();
+  int * Up = U->getColPtr (), * Ui = U->getRowIdx ();
+  nr_type_t * Lx = L->getData ();
+  nr_type_t * Ux = U->getData ();
+  int i, p, k, K = R.getCols ();
+  tmatrix<nr_type_t> Y (N, K);
+  nr_type_t * y = Y.getData ();
+  nr_type_t f;
+
+  // apply row exchanges
+  for (i = 0; i < N; i++)
+    for (k = 0; k < K; k++) y[i * K + k] = R (rMap[i], k);
+
+  // forward substitution in order to solve LY = B
+  for (i = 0; i < N; i++) {
+    nr_type_t * yi = y + i * K;
+    for (p = Lp[i] + 1; p < Lp[i + 1]; p++) {
+      nr_type_t * yr = y + Li[p] * K;
+      f = Lx[p];
+      for (k = 0; k < K; k++) yr[k] -= f * yi[k];
+    }
+  }
+
+  // backward substitution in order to solve UX = Y
+  for (i = N - 1; i >= 0; i--) {
+    nr_type_t * yi = y + i * K;
+    f = 1.0 / Ux[Up[i + 1] - 1];
+    for (k = 0; k < K; k++) yi[k] *= f;
+    for (p = Up[i]; p < Up[i + 1] - 1; p++) {
+      nr_type_t * yr = y + Ui[p] * K;
+      f = Ux[p];
+      for (k = 0; k < K; k++) yr[k] -= f * yi[k];
+    }
+  }
+
+  // apply column ordering
+  for (i = 0; i < N; i++)
+    for (k = 0; k < K; k++) R (cMap[i], k) = y[i * K + k];
+}
+
 /*! The function solves the equation system using a full-step iterative
    method (called Jacobi's method) or a single-step method (called
    Gauss-Seidel) depending on the given algorithm.  If the current X
@@ -47,8 +47,15 @@ enum algo_type {
   ALGO_SV_DECOMPOSITION           = 0x1000,
   // testing
   ALGO_QR_DECOMPOSITION_2         = 0x2000,
+  // sparse matrices
+  ALGO_SPARSE_LU_FACTORIZATION    = 0x4000,
+  ALGO_SPARSE_LU_SUBSTITUTION     = 0x8000,
+  ALGO_SPARSE_LU_DECOMPOSITION    = 0xC000,
 };
 
+//! Checks whether the given algorithm operates on sparse matrices.
+#define ALGO_IS_SPARSE(a) (((a) & ALGO_SPARSE_LU_DECOMPOSITION) != 0)
+
 //! Definition of pivoting strategies.
 enum pivot_type {
   PIVOT_NONE    = 0x01,
@@ -56,8 +63,11 @@ enum pivot_type {
   PIVOT_FULL    = 0x04
 };
 
+#include <vector>
+
 #include "tvector.h"
 #include "tmatrix.h"
+#include "tspmatrix.h"
 
 namespace qucs {
 
@@ -72,7 +82,11 @@ class eqnsys
   int  getAlgo (void) { return algo; }
   void passEquationSys (tmatrix<nr_type_t> *, tvector<nr_type_t> *,
 			tvector<nr_type_t> *);
+  void passEquationSys (tspmatrix<nr_type_t> *, tvector<nr_type_t> *,
+			tvector<nr_type_t> *);
+  void reorderSparse (tspmatrix<nr_type_t> *);
   void solve (void);
+  void substitute (tmatrix<nr_type_t> &);
 
  private:
   int update;
@@ -92,6 +106,11 @@ class eqnsys
   tvector<nr_double_t> * S;
   tvector<nr_double_t> * E;
 
+  tspmatrix<nr_type_t> * As;
+  tspmatrix<nr_type_t> * L;
+  tspmatrix<nr_type_t> * U;
+  std::vector<int> sOrder;
+
   void solve_inverse (void);
   void solve_gauss (void);
   void solve_gauss_jordan (void);
@@ -101,6 +120,14 @@ class eqnsys
   void factorize_lu_doolittle (void);
   void substitute_lu_crout (void);
   void substitute_lu_doolittle (void);
+  void solve_lu_sparse (void);
+  void factorize_lu_sparse (void);
+  void pivot_lu_sparse (void);
+  int  refactorize_lu_sparse (void);
+  void substitute_lu_sparse (void);
+  void substitute_lu_block (tmatrix<nr_type_t> &, int);
+  void substitute_lu_sparse_block (tmatrix<nr_type_t> &);
+  int  sparse_reach (int, int *, int *, char *);
   void solve_qr (void);
   void solve_qr_ls (void);
   void solve_qrh (void);
@@ -31,6 +31,7 @@
 #include <string.h>
 #include <cmath>
 #include <ctype.h>
+#include <unordered_set>
 
 #include "logging.h"
 #include "complex.h"
@@ -340,14 +341,7 @@ void reference::findVariable (void)
         node * eqn;
         if (checkee != NULL)
         {
-            for (eqn = checkee->getEquations (); eqn; eqn = eqn->getNext ())
-            {
-                if (!strcmp (n, A(eqn)->result))
-                {
-                    ref = eqn;
-                    break;
-                }
-            }
+            ref = checkee->findEquation (n);
         }
         if (solvee != NULL && !ref)
         {
@@ -430,6 +424,8 @@ void assignment::rename (char * n)
 {
     free (result);
     result = n ? strdup (n) : NULL;
+    // the checker's symbol table may still map the former name
+    if (checkee != NULL) checkee->dropIndex ();
 }
 
 // Destructor deletes an instance of the assignment class.
@@ -1259,7 +1255,7 @@ strlist * node::recurseDependencies (checker * check, strlist * deps)
     for (int i = 0; i < deps->length (); i++)
     {
         char * var = deps->get (i);
-        node * child = check->findEquation (check->equations, var);
+        node * child = check->findEquation (var);
         /* Check each child equation. */
         if (child != NULL)
         {
@@ -1386,6 +1382,7 @@ checker::checker ()
     defs = NULL;
     equations = NULL;
     consts = false;
+    indexed = NULL;
 }
 
 // Destructor deletes an instance of the checker class.
@@ -1686,15 +1683,36 @@ node * checker::findEquation (node * root, const char * const n)
     return NULL;
 }
 
-/* The function returns the equation resulting in the passed variable
-   or NULL if there is no such equation. */
-node * checker::findEquation (const char * const n) const
+/* The function (re)builds the symbol table of the checker's list of
+   equations.  Earlier equations shadow later ones with the same name
+   just like a linear search through the list would do. */
+void checker::indexEquations (void) const
 {
+    symbols.clear ();
     foreach_equation (eqn)
     {
-        if (!strcmp (A(eqn)->result, n)) return eqn;
+        if (eqn->result) symbols.emplace (eqn->result, eqn);
     }
-    return NULL;
+    indexed = equations;
+}
+
+/* Invalidates the symbol table.  It gets rebuilt on the next lookup
+   of a variable. */
+void checker::dropIndex (void)
+{
+    symbols.clear ();
+    indexed = NULL;
+}
+
+/* The function returns the equation resulting in the passed variable
+   or NULL if there is no such equation.  The lookup uses the symbol
+   table which is rebuilt if the head of the list of equations changed
+   or an equation of the checker has been renamed. */
+node * checker::findEquation (const char * const n) const
+{
+    if (indexed != equations) indexEquations ();
+    auto it = symbols.find (n);
+    return it != symbols.end () ? it->second : NULL;
 }
 
 /* This function display the error messages due to equation cycles and
@@ -1762,6 +1780,7 @@ node * checker::lastEquation (node * root)
 // Removes the given equation node from the list of known equations.
 void checker::dropEquation (node * eqn)
 {
+    dropIndex ();
     if (eqn == equations)
     {
         equations = eqn->getNext ();
@@ -1780,6 +1799,7 @@ void checker::dropEquation (node * eqn)
 void checker::reorderEquations (void)
 {
     node * root = NULL, * next, * last;
+    std::unordered_set<std::string> known;
 
     // Go through the list of equations.
     for (node * eqn = equations; eqn != NULL; eqn = next)
@@ -1792,7 +1812,7 @@ void checker::reorderEquations (void)
         for (found = gens = i = 0; i < deps->length (); i++)
         {
             char * var = deps->get (i);
-            if (findEquation (root, var) != NULL) found++;
+            if (known.count (var)) found++;
             if (isGenerated (var)) gens++;
         }
         // Yes.
@@ -1802,6 +1822,7 @@ void checker::reorderEquations (void)
                the new list. */
             dropEquation (eqn);
             root = appendEquation (root, eqn);
+            known.insert (A(eqn)->result);
             eqn->evalPossible = 1;
             // Now start over from the beginning.
             next = equations;
@@ -1821,6 +1842,7 @@ void checker::reorderEquations (void)
    passes the checker instance to each equation. */
 void checker::setEquations (node * eqns)
 {
+    dropIndex ();
     equations = eqns;
     foreach_equation (eqn)
     {
@@ -2442,12 +2464,7 @@ strlist * checker::variables (void)
 // Checks if the given variable name is an equation.
 bool checker::containsVariable (const char * const ident) const
 {
-    foreach_equation (eqn)
-    {
-        if (!strcmp (ident, eqn->result))
-            return true;
-    }
-    return false;
+    return findEquation (ident) != NULL;
 }
 
 // Structure defining a predefined constant.
@@ -2518,17 +2535,30 @@ node * checker::addComplex (const char * type, const char * ident,
 // Adds given equation to the equation list.
 void checker::addEquation (node * eqn)
 {
+    bool valid = indexed == equations;
+    eqn->checkee = this;
     eqn->setNext (equations);
     equations = eqn;
+    // the new equation shadows the ones of the same name
+    if (valid && A(eqn)->result)
+    {
+        symbols[A(eqn)->result] = eqn;
+        indexed = equations;
+    }
 }
 
 // Appends the given equation to the equation list.
 void checker::appendEquation (node * eqn)
 {
+    eqn->checkee = this;
     eqn->setNext (NULL);
     node * last = lastEquation (equations);
     if (last != NULL)
+    {
         last->setNext (eqn);
+        if (indexed == equations && A(eqn)->result)
+            symbols.emplace (A(eqn)->result, eqn);
+    }
     else
         equations = eqn;
 }
@@ -2595,12 +2625,10 @@ node * checker::createReference (const char * type, const char * ident,
    returned. */
 nr_double_t checker::getDouble (const char * const ident) const
 {
-    foreach_equation (eqn)
+    node * eqn = findEquation (ident);
+    if (eqn != NULL)
     {
-        if (!strcmp (ident, eqn->result))
-        {
-            return eqn->getResultDouble ();
-        }
+        return A(eqn)->getResultDouble ();
     }
     return 0.0;
 }
@@ -2609,16 +2637,11 @@ nr_double_t checker::getDouble (const char * const ident) const
    specified assignment.  If found the given value is set. */
 void checker::setDouble (const char * const ident, nr_double_t val)
 {
-    foreach_equation (eqn)
+    node * eqn = findEquation (ident);
+    if (eqn != NULL && A(eqn)->body->getTag () == CONSTANT)
     {
-        if (!strcmp (ident, eqn->result))
-        {
-            if (eqn->body->getTag () == CONSTANT)
-            {
-                constant * c = C (eqn->body);
-                if (c->type == TAG_DOUBLE) c->d = val;
-            }
-        }
+        constant * c = C (A(eqn)->body);
+        if (c->type == TAG_DOUBLE) c->d = val;
     }
 }
 
@@ -2627,12 +2650,10 @@ void checker::setDouble (const char * const ident, nr_double_t val)
    vector is returned. */
 qucs::vector checker::getVector (const char * const ident) const
 {
-    foreach_equation (eqn)
+    node * eqn = findEquation (ident);
+    if (eqn != NULL)
     {
-        if (!strcmp (ident, eqn->result))
-        {
-            return eqn->getResultVector ();
-        }
+        return A(eqn)->getResultVector ();
     }
     return qucs::vector ();
 }
@@ -25,6 +25,9 @@
 #ifndef __EQUATION_H__
 #define __EQUATION_H__
 
+#include <string>
+#include <unordered_map>
+
 #include "object.h"
 #include "complex.h"
 #include "vector.h"
@@ -311,13 +314,21 @@ public:
   void setDefinitions (struct definition_t * d) { defs = d; }
   struct definition_t * getDefinitions (void) { return defs; }
   node * findProperty (char *);
+  void dropIndex (void);
 
 public:
   node * equations;
 
  private:
+  void indexEquations (void) const;
+
   bool consts;
   struct definition_t * defs;
+  /* Symbol table of the equation list mapping the variable names to
+     the first equation defining them.  It is valid for the list
+     starting at 'indexed' only and rebuilt on demand. */
+  mutable std::unordered_map<std::string, node *> symbols;
+  mutable node * indexed;
 };
 
 /* The solver class is finally used to solve the list of equations. */
@@ -2289,7 +2289,7 @@ constant * evaluate:: QUCS_CONCAT2 (efunc,_v_v) (constant * args) { \
   _DEFV ();							    \
   qucs::vector * val = new qucs::vector (QUCS_CONCAT2 (cfunc,_1d) (*v));    \
   int k = val->getSize ();					    \
-  *val = isign > 0 ? *val / k : *val * k;			    \
+  if (isign > 0) *val /= k; else *val *= k;			    \
   res->v = val;							    \
   int n = t->getSize ();					    \
   if (k != n) {                                                     \
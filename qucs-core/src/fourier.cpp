@@ -30,6 +30,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <cmath>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <mutex>
 
 #include "consts.h"
 #include "object.h"
@@ -37,62 +41,315 @@
 #include "vector.h"
 #include "fourier.h"
 
-// Helper macro.
-#define Swap(a,b) { nr_double_t t; t = a; a = b; b = t; }
-
 namespace qucs {
 
 using namespace fourier;
 
-/* The function performs a 1-dimensional fast fourier transformation.
-   Each data item is meant to be defined in equidistant steps.  The
-   number of data items needs to be of binary size, e.g. 64, 128. */
-void fourier::_fft_1d (nr_double_t * data, int len, int isign) {
+/* A plan holds everything needed to transform a given number of
+   complex values: the factorization of the length, the twiddle
+   factors of both directions.  Lengths built of the factors 2, 3 and 5
+   are transformed by a self-sorting mixed radix algorithm, any other
+   length by Bluestein's algorithm which maps the transformation onto a
+   convolution of binary size.  Plans are created once per length and
+   kept for later transformations.  A plan is not modified once
+   created, the work array is passed by the caller, thus plans can be
+   used by several threads at once. */
+class fftplan
+{
+ public:
+  fftplan (int);
+  static fftplan & get (int);
+  void execute (nr_complex_t *, int);
+  void execute (nr_complex_t *, int, nr_complex_t *);
+  void executeReal (nr_complex_t *, int);
+  int getWorkSize (void) const { return worksize; }
+
+ private:
+  void bluestein (nr_complex_t *, int, nr_complex_t *);
+
+  int n;
+  int worksize;
+  std::vector<int> radix;
+  std::vector<nr_complex_t> twiddle[2];
+  fftplan * conv;
+  std::vector<nr_complex_t> chirp;
+  std::vector<nr_complex_t> kernel[2];
+  std::vector<nr_complex_t> rtwiddle;
+};
+
+// Constructor creates the plan for the given length.
+fftplan::fftplan (int len) {
+  int m = n = len;
+  conv = NULL;
+  worksize = n;
+  if (n <= 1) return;
+
+  // twiddle factors separating the transformations of real values
+  if (n % 2 == 0) {
+    rtwiddle.resize (n / 4 + 1);
+    for (int k = 0; k <= n / 4; k++)
+      rtwiddle[k] = std::polar (1.0, 2 * pi * k / n);
+  }
 
-  // bit reversal method
-  int i, j, m, n;
-  n = 2 * len;
-  j = 0;
-  for (i = 0; i < n; i += 2) {
-    if (j > i) {                   // was index already swapped ?
-      Swap (data[j], data[i]);     // swap real part
-      Swap (data[j+1], data[i+1]); // swap imaginary part
+  while (m % 4 == 0) { radix.push_back (4); m /= 4; }
+  while (m % 2 == 0) { radix.push_back (2); m /= 2; }
+  while (m % 3 == 0) { radix.push_back (3); m /= 3; }
+  while (m % 5 == 0) { radix.push_back (5); m /= 5; }
+
+  if (m > 1) {
+    // other prime factors: convolution of binary size >= 2n - 1
+    int c = 1;
+    while (c < 2 * n - 1) c <<= 1;
+    radix.clear ();
+    conv = &get (c);
+    chirp.resize (n);
+    for (int j = 0; j < n; j++) {
+      long long q = ((long long) j * j) % (2 * n);
+      chirp[j] = std::polar (1.0, pi * q / n);
     }
-    m = len;
-    while (m >= 2 && j >= m) {     // calculate next swap index
-      j -= m;
-      m >>= 1;
+    for (int s = 0; s < 2; s++) {
+      kernel[s].assign (c, 0.0);
+      for (int j = 0; j < n; j++) {
+	nr_complex_t b = s ? chirp[j] : conj (chirp[j]);
+	kernel[s][j] = b;
+	if (j > 0) kernel[s][c - j] = b;
+      }
+      conv->execute (&kernel[s][0], 1);
     }
-    j += m;
+    // the convolution and the work array of its transformations
+    worksize = c + conv->getWorkSize ();
+    return;
   }
 
-  // Danielson-Lanzcos algorithm
-  int mmax, istep;
-  nr_double_t wt, th, wr, wi, wpr, wpi, ti, tr;
-  mmax = 2;
-  while (n > mmax) {
-    istep = mmax << 1;
-    th = isign * (2 * pi / mmax);
-    wt = sin (0.5 * th);
-    wpr = -2.0 * wt * wt;
-    wpi = sin (th);
-    wr = 1.0;
-    wi = 0.0;
-    for (m = 1; m < mmax; m += 2) {
-      for (i = m; i <= n; i += istep) {
-	j = i + mmax;
-	tr = wr * data[j] - wi * data[j-1];
-	ti = wr * data[j-1] + wi * data[j];
-	data[j] = data[i] - tr;
-	data[j-1] = data[i-1] - ti;
-	data[i] += tr;
-	data[i-1] += ti;
+  // twiddle factors of each pass
+  for (int ns = 1, r = 0; r < (int) radix.size (); ns *= radix[r++]) {
+    int p = radix[r];
+    for (int j = 0; j < ns; j++) {
+      for (int k = 1; k < p; k++) {
+	nr_complex_t w = std::polar (1.0, 2 * pi * k * j / (ns * p));
+	twiddle[0].push_back (w);
+	twiddle[1].push_back (conj (w));
       }
-      wr = (wt = wr) * wpr - wi * wpi + wr;
-      wi = wi * wpr + wt * wpi + wi;
     }
-    mmax = istep;
   }
+  worksize = n;
+}
+
+/* Returns the (cached) plan for the given length.  The lock is
+   recursive since creating a plan for Bluestein's algorithm requests
+   the plan of the convolution. */
+fftplan & fftplan::get (int len) {
+  static std::map<int, fftplan> plans;
+  static std::recursive_mutex plansLock;
+  std::lock_guard<std::recursive_mutex> guard (plansLock);
+  std::map<int, fftplan>::iterator it = plans.find (len);
+  if (it == plans.end ()) {
+    fftplan p (len);
+    it = plans.insert (std::make_pair (len, p)).first;
+  }
+  return it->second;
+}
+
+// Complex multiplication without the checks for infinite values.
+static inline nr_complex_t cmul (const nr_complex_t & a,
+				 const nr_complex_t & b) {
+  return nr_complex_t (real (a) * real (b) - imag (a) * imag (b),
+		       real (a) * imag (b) + imag (a) * real (b));
+}
+
+// Multiplication by i or -i depending on the sign.
+static inline nr_complex_t jmul (const nr_complex_t & a, int isign) {
+  return isign > 0 ? nr_complex_t (-imag (a), real (a)) :
+    nr_complex_t (imag (a), -real (a));
+}
+
+/* Small transformations of the given radix with the twiddle factors
+   already applied.  The sign of the exponent is given by 'isign'. */
+template <int P>
+static inline void butterfly (nr_complex_t * v, int isign);
+
+template <>
+inline void butterfly<2> (nr_complex_t * v, int) {
+  nr_complex_t a = v[0];
+  v[0] = a + v[1];
+  v[1] = a - v[1];
+}
+
+template <>
+inline void butterfly<3> (nr_complex_t * v, int isign) {
+  static const nr_double_t s3 = std::sqrt (3.0) / 2;
+  nr_complex_t a = v[1] + v[2];
+  nr_complex_t b = v[0] - 0.5 * a;
+  nr_complex_t c = jmul (s3 * (v[1] - v[2]), isign);
+  v[0] += a;
+  v[1] = b + c;
+  v[2] = b - c;
+}
+
+template <>
+inline void butterfly<4> (nr_complex_t * v, int isign) {
+  nr_complex_t a = v[0] + v[2];
+  nr_complex_t b = v[0] - v[2];
+  nr_complex_t c = v[1] + v[3];
+  nr_complex_t d = jmul (v[1] - v[3], isign);
+  v[0] = a + c;
+  v[2] = a - c;
+  v[1] = b + d;
+  v[3] = b - d;
+}
+
+template <>
+inline void butterfly<5> (nr_complex_t * v, int isign) {
+  static const nr_double_t c1 = std::cos (2 * pi / 5);
+  static const nr_double_t c2 = std::cos (4 * pi / 5);
+  static const nr_double_t s1 = std::sin (2 * pi / 5);
+  static const nr_double_t s2 = std::sin (4 * pi / 5);
+  nr_complex_t b1 = v[1] + v[4], b2 = v[2] + v[3];
+  nr_complex_t d1 = v[1] - v[4], d2 = v[2] - v[3];
+  nr_complex_t a = v[0] + c1 * b1 + c2 * b2;
+  nr_complex_t b = jmul (s1 * d1 + s2 * d2, isign);
+  nr_complex_t c = v[0] + c2 * b1 + c1 * b2;
+  nr_complex_t d = jmul (s2 * d1 - s1 * d2, isign);
+  v[0] += b1 + b2;
+  v[1] = a + b;
+  v[4] = a - b;
+  v[2] = c + d;
+  v[3] = c - d;
+}
+
+/* One pass of the self-sorting (Stockham) algorithm.  It combines
+   'ns' sized transformations of the source into 'ns * P' sized
+   transformations of the destination. */
+template <int P>
+static void pass (const nr_complex_t * x, nr_complex_t * y, int n, int ns,
+		  const nr_complex_t * tw, int isign) {
+  int m = n / P, blocks = m / ns;
+  nr_complex_t v[5];
+  for (int j = 0; j < ns; j++) {
+    const nr_complex_t * w = tw + j * (P - 1);
+    for (int b = 0; b < blocks; b++) {
+      const nr_complex_t * src = x + b * ns + j;
+      nr_complex_t * dst = y + b * ns * P + j;
+      v[0] = src[0];
+      v[1] = cmul (src[m], w[0]);
+      if (P > 2) v[2] = cmul (src[2*m], w[1]);
+      if (P > 3) v[3] = cmul (src[3*m], w[2]);
+      if (P > 4) v[4] = cmul (src[4*m], w[3]);
+      butterfly<P> (v, isign);
+      dst[0] = v[0]; dst[ns] = v[1];
+      if (P > 2) dst[2*ns] = v[2];
+      if (P > 3) dst[3*ns] = v[3];
+      if (P > 4) dst[4*ns] = v[4];
+    }
+  }
+}
+
+/* The function transforms the given values in place.  The result is
+   sum (x[k] * exp (isign * 2 * pi * j * k * i / n)), thus it is not
+   scaled.  The work array holds at least getWorkSize() values. */
+void fftplan::execute (nr_complex_t * x, int isign, nr_complex_t * work) {
+  if (n <= 1) return;
+  if (conv) {
+    bluestein (x, isign, work);
+    return;
+  }
+  nr_complex_t * a = x, * b = work;
+  const nr_complex_t * tw = &twiddle[isign < 0][0];
+  for (int ns = 1, r = 0; r < (int) radix.size (); r++) {
+    int p = radix[r];
+    switch (p) {
+    case 2: pass<2> (a, b, n, ns, tw, isign); break;
+    case 3: pass<3> (a, b, n, ns, tw, isign); break;
+    case 4: pass<4> (a, b, n, ns, tw, isign); break;
+    case 5: pass<5> (a, b, n, ns, tw, isign); break;
+    }
+    tw += ns * (p - 1);
+    ns *= p;
+    std::swap (a, b);
+  }
+  if (a != x) std::copy (a, a + n, x);
+}
+
+// Transforms the given values in place using a temporary work array.
+void fftplan::execute (nr_complex_t * x, int isign) {
+  if (n <= 1) return;
+  std::vector<nr_complex_t> work (worksize);
+  execute (x, isign, &work[0]);
+}
+
+/* Bluestein's algorithm: with j * k = (j^2 + k^2 - (k - j)^2) / 2 the
+   transformation is a convolution with a chirp which is done using
+   the transformations of a binary size. */
+void fftplan::bluestein (nr_complex_t * x, int isign, nr_complex_t * work) {
+  int j, c = conv->n, s = isign < 0;
+  std::fill (work, work + c, 0.0);
+  for (j = 0; j < n; j++)
+    work[j] = cmul (x[j], s ? conj (chirp[j]) : chirp[j]);
+  conv->execute (work, 1, work + c);
+  for (j = 0; j < c; j++) work[j] = cmul (work[j], kernel[s][j]);
+  conv->execute (work, -1, work + c);
+  for (j = 0; j < n; j++)
+    x[j] = cmul (work[j], s ? conj (chirp[j]) : chirp[j]) / (nr_double_t) c;
+}
+
+/* The function transforms n real values.  These are stored in the
+   first half of the given array, the complete spectrum is returned.
+   For even lengths the real values are transformed as n/2 complex
+   values which are separated afterwards. */
+void fftplan::executeReal (nr_complex_t * x, int isign) {
+  nr_double_t * d = (nr_double_t *) x;
+  int k, h = n / 2;
+  if (n <= 1) return;
+
+  if (n & 1) {
+    for (k = n - 1; k >= 0; k--) x[k] = d[k];
+    execute (x, isign);
+    return;
+  }
+
+  // pairs of values are the real and imaginary parts
+  get (h).execute (x, isign);
+
+  // separate the transformations of even and odd values
+  nr_complex_t e, o, w;
+  e = x[0];
+  x[0] = real (e) + imag (e);
+  x[h] = real (e) - imag (e);
+  for (k = 1; 2 * k <= h; k++) {
+    nr_complex_t a = x[k], b = x[h - k];
+    w = isign < 0 ? conj (rtwiddle[k]) : rtwiddle[k];
+    e = 0.5 * (a + conj (b));
+    o = jmul (0.5 * (a - conj (b)), -1);
+    x[k] = e + cmul (w, o);
+    if (2 * k < h) x[h - k] = conj (e - cmul (w, o));
+  }
+  for (k = 1; k < h; k++) x[n - k] = conj (x[k]);
+}
+
+/* The function performs a 1-dimensional fast fourier transformation.
+   Each data item is meant to be defined in equidistant steps.  The
+   number of data items is arbitrary.  The forward transformation
+   (isign = 1) uses a negative exponent. */
+void fourier::_fft_1d (nr_double_t * data, int len, int isign) {
+  fftplan::get (len).execute ((nr_complex_t *) data, -isign);
+}
+
+/* The function transforms 'count' vectors of 'len' complex values
+   each, stored one after another. */
+void fourier::_fft_1d_n (nr_double_t * data, int len, int count,
+			 int isign) {
+  if (len <= 1) return;
+  fftplan & p = fftplan::get (len);
+  std::vector<nr_complex_t> work (p.getWorkSize ());
+  for (int i = 0; i < count; i++, data += 2 * len)
+    p.execute ((nr_complex_t *) data, -isign, &work[0]);
+}
+
+/* The function transforms 'len' real values.  These are expected in
+   the first half of the data array which holds the resulting 'len'
+   complex values afterwards. */
+void fourier::_fft_1d_r (nr_double_t * data, int len, int isign) {
+  fftplan::get (len).executeReal ((nr_complex_t *) data, -isign);
 }
 
 /* The function transforms two real vectors using a single fast
@@ -154,36 +411,42 @@ void fourier::_ifft_1d_2r (nr_double_t * r1, nr_double_t * r2, int len) {
   }
 }
 
+/* Checks whether the given vector has real values only. */
+static bool isReal (vector & var) {
+  for (int i = 0; i < var.getSize (); i++)
+    if (imag (var (i)) != 0.0) return false;
+  return true;
+}
+
+/* Transforms the first 'len' values of the given vector which has
+   been sized appropriately.  Real valued data is transformed by a
+   half sized transformation. */
+static void transform (vector & res, int len, int isign) {
+  nr_double_t * data = (nr_double_t *) &res (0);
+  if (isReal (res)) {
+    for (int i = 0; i < len; i++) data[i] = real (res (i));
+    _fft_1d_r (data, len, isign);
+  }
+  else
+    _fft_1d (data, len, isign);
+}
+
 /* This function performs a 1-dimensional fast fourier transformation
    on the given vector 'var'.  If 'sign' is -1 the inverse fft is
    computed, if +1 the fft itself is computed.  It returns a vector of
    binary size (as necessary for a fft). */
 vector fourier::fft_1d (vector var, int isign) {
-  int i, n, len = var.getSize ();
+  int i, len = var.getSize ();
 
   // compute necessary binary data array size
   int size = 2;
   while (size < len) size <<= 1;
 
-  // put data items (temporary array) in place
-  nr_double_t * data;
-  data = (nr_double_t *) calloc (2 * size * sizeof (nr_double_t), 1);
-  for (n = i = 0; i < len; i++, n += 2) {
-    data[n] = real (var (i)); data[n+1] = imag (var (i));
-  }
-
-  // run 1-dimensional fft
-  _fft_1d (data, size, isign);
-
-  // store transformed data items in result vector
+  // run 1-dimensional fft on the zero padded data
   vector res = vector (size);
-  for (n = i = 0; i < size; i++, n += 2) {
-    res (i) = nr_complex_t (data[n], data[n+1]);
-    if (isign < 0) res (i) /= size;
-  }
-
-  // free temporary data array
-  free (data);
+  for (i = 0; i < len; i++) res (i) = var (i);
+  transform (res, size, isign);
+  if (isign < 0) res = res / (nr_double_t) size;
   return res;
 }
 
@@ -191,36 +454,18 @@ vector fourier::fft_1d (vector var, int isign) {
    transformation.  Each data item is meant to be defined in
    equidistant steps. */
 void fourier::_dft_1d (nr_double_t * data, int len, int isign) {
-  int k, n, size = 2 * len * sizeof (nr_double_t);
-  nr_double_t * res = (nr_double_t *) calloc (size, 1);
-  nr_double_t th, c, s;
-  for (n = 0; n < 2 * len; n += 2) {
-    th = n * pi / 2 / len;
-    for (k = 0; k < 2 * len; k += 2) {
-      c = cos (k * th);
-      s = isign * sin (k * th);
-      res[n] += data[k] * c + data[k+1] * s;
-      res[n+1] += data[k+1] * c - data[k] * s;
-    }
-  }
-  memcpy (data, res, size);
-  free (res);
+  _fft_1d (data, len, isign);
 }
 
 /* The function performs a 1-dimensional discrete fourier
    transformation on the given vector 'var'.  If 'sign' is -1 the
    inverse dft is computed, if +1 the dft itself is computed. */
 vector fourier::dft_1d (vector var, int isign) {
-  int k, n, len = var.getSize ();
-  vector res = vector (len);
-  for (n = 0; n < len; n++) {
-    nr_double_t th = - isign * 2 * pi * n / len;
-    nr_complex_t val = 0;
-    for (k = 0; k < len; k++)
-      val += var (k) * std::polar (1.0, th * k);
-    res (n) = isign < 0 ? val / (nr_double_t) len : val;
-  }
-  return res;
+  int len = var.getSize ();
+  if (len == 0) return var;
+  transform (var, len, isign);
+  if (isign < 0) var = var / (nr_double_t) len;
+  return var;
 }
 
 // Helper functions.
@@ -239,74 +484,36 @@ void fourier::_idft_1d (nr_double_t * data, int len) {
 
 /* The function performs a n-dimensional fast fourier transformation.
    Each data item is meant to be defined in equidistant steps.  The
-   number of data items needs to be of binary size, e.g. 64, 128 for
-   each dimension. */
+   dimensions are transformed one after another, the last dimension
+   varying fastest. */
 void fourier::_fft_nd (nr_double_t * data, int len[], int nd, int isign) {
-
- int i, i1, i2, i3, i2rev, i3rev, ip1, ip2, ip3, ifp1, ifp2;
- int ibit, k1, k2, n, np, nr, nt;
-
- // compute total number of complex values
- for (nt = 1, i = 0; i < nd; i++) nt *= len[i];
-
- // main loop over the dimensions
- for (np = 1, i = nd - 1; i >= 0; i--) {
-   n = len[i];
-   nr = nt / (n * np);
-   ip1 = np << 1;
-   ip2 = ip1 * n;
-   ip3 = ip2 * nr;
-
-   // bit-reversal method
-   for (i2rev = 1, i2 = 1; i2 <= ip2; i2 += ip1) {
-     if (i2 < i2rev) {
-       for (i1 = i2; i1 <= i2 + ip1 - 2; i1 += 2) {
-	 for (i3 = i1; i3 <= ip3; i3 += ip2) {
-	   i3rev = i2rev + i3 - i2;
-	   Swap (data[i3-1], data[i3rev-1]);
-	   Swap (data[i3], data[i3rev]);
-	 }
-       }
-     }
-     ibit = ip2 >> 1;
-     while (ibit >= ip1 && i2rev > ibit) {
-       i2rev -= ibit;
-       ibit >>= 1;
-     }
-     i2rev += ibit;
-   }
-
-   // Danielson-Lanzcos algorithm
-   nr_double_t ti, tr, wt, th, wr, wi, wpi, wpr;
-   ifp1 = ip1;
-   while (ifp1 < ip2) {
-     ifp2 = ifp1 << 1;
-     th = isign * 2 * pi / (ifp2 / ip1);
-     wt = sin (0.5 * th);
-     wpr = -2.0 * wt * wt;
-     wpi = sin (th);
-     wr = 1.0;
-     wi = 0.0;
-     for (i3 = 1; i3 <= ifp1; i3 += ip1) {
-       for (i1 = i3; i1 <= i3 + ip1 - 2; i1 += 2) {
-	 for (i2 = i1; i2 <= ip3; i2 += ifp2) {
-	   k1 = i2;
-	   k2 = k1 + ifp1;
-	   tr = wr * data[k2-1] - wi * data[k2];
-	   ti = wr * data[k2] + wi * data[k2-1];
-	   data[k2-1] = data[k1-1] - tr;
-	   data[k2] = data[k1] - ti;
-	   data[k1-1] += tr;
-	   data[k1] += ti;
-	 }
-       }
-       wr = (wt = wr) * wpr - wi * wpi + wr;
-       wi = wi * wpr + wt * wpi + wi;
-     }
-     ifp1 = ifp2;
-   }
-   np *= n;
- }
+  nr_complex_t * d = (nr_complex_t *) data;
+  std::vector<nr_complex_t> t, work;
+  int i, k, n, b, o, np, nt;
+
+  // compute total number of complex values
+  for (nt = 1, i = 0; i < nd; i++) nt *= len[i];
+
+  // main loop over the dimensions
+  for (np = 1, i = nd - 1; i >= 0; i--) {
+    fftplan & p = fftplan::get (n = len[i]);
+    if (n <= 1) continue;
+    work.resize (p.getWorkSize ());
+    if (np == 1) {
+      for (b = 0; b < nt; b += n) p.execute (d + b, isign, &work[0]);
+    }
+    else {
+      t.resize (n);
+      for (b = 0; b < nt; b += n * np) {
+	for (o = b; o < b + np; o++) {
+	  for (k = 0; k < n; k++) t[k] = d[o + k * np];
+	  p.execute (&t[0], isign, &work[0]);
+	  for (k = 0; k < n; k++) d[o + k * np] = t[k];
+	}
+      }
+    }
+    np *= n;
+  }
 }
 
 // Helper functions.
@@ -43,6 +43,8 @@ namespace fourier {
   // internal functions
   void  _fft_1d (nr_double_t *, int, int isign = 1);
   void _ifft_1d (nr_double_t *, int);
+  void  _fft_1d_n (nr_double_t *, int, int, int isign = 1);
+  void  _fft_1d_r (nr_double_t *, int, int isign = 1);
   void  _dft_1d (nr_double_t *, int, int isign = 1);
   void _idft_1d (nr_double_t *, int);
 
@@ -29,6 +29,7 @@
 #include<algorithm>
 
 #include <stdio.h>
+#include <string.h>
 
 #include "object.h"
 #include "logging.h"
@@ -43,6 +44,7 @@
 #include "ptrlist.h"
 #include "tvector.h"
 #include "tmatrix.h"
+#include "tspmatrix.h"
 #include "eqnsys.h"
 #include "analysis.h"
 #include "dataset.h"
@@ -51,6 +53,11 @@
 
 #define HB_DEBUG 0
 
+// Settings of the GMRES solver used for the matrix-free balancing.
+#define HB_KRYLOV_RESTART 30
+#define HB_KRYLOV_MAXITER 1000
+#define HB_KRYLOV_TOL     1e-9
+
 namespace qucs {
 
 using namespace fourier;
@@ -66,6 +73,9 @@ hbsolver::hbsolver () : analysis () {
   vs = x = NULL;
   runs = 0;
   ndfreqs = NULL;
+  sparse = krylov = false;
+  PB = NULL;
+  PE = NULL;
 }
 
 // Constructor creates a named instance of the hbsolver class.
@@ -79,6 +89,9 @@ hbsolver::hbsolver (char * n) : analysis (n) {
   vs = x = NULL;
   runs = 0;
   ndfreqs = NULL;
+  sparse = krylov = false;
+  PB = NULL;
+  PE = NULL;
 }
 
 // Destructor deletes the hbsolver class object.
@@ -119,6 +132,10 @@ hbsolver::~hbsolver () {
 
   delete x;
   delete[] ndfreqs;
+
+  // delete preconditioner
+  delete[] PB;
+  delete[] PE;
 }
 
 /* The copy constructor creates a new instance of the hbsolver class
@@ -137,6 +154,10 @@ hbsolver::hbsolver (hbsolver & o) : analysis (o) {
   vs = x = NULL;
   runs = o.runs;
   ndfreqs = NULL;
+  sparse = o.sparse;
+  krylov = o.krylov;
+  PB = NULL;
+  PE = NULL;
 }
 
 #define VS_(r) (*VS) (r)
@@ -149,6 +170,11 @@ int hbsolver::solve (void) {
   int iterations = 0, done = 0;
   int MaxIterations = getPropertyInteger ("MaxIter");
 
+  // choose the linear algebra, the matrix-free balancing uses sparse
+  // matrices for the linear network as well
+  krylov = !strcmp (getPropertyString ("Solver"), "GMRES");
+  sparse = krylov || !strcmp (getPropertyString ("Solver"), "SparseLU");
+
   // collect different parts of the circuit
   splitCircuits ();
 
@@ -229,6 +255,13 @@ int hbsolver::solve (void) {
 	break;
       }
 
+      if (krylov) {
+	// solve JF * VS(n+1) = JF * VS(n) - FV without forming JF
+	solveVoltagesKrylov ();
+	VectorIFFT (vs);
+	continue;
+      }
+
 #if HB_DEBUG
       fprintf (stderr, "JG -- G-Jacobian in t:\n"); JG->print ();
       fprintf (stderr, "JQ -- C-Jacobian in t:\n"); JQ->print ();
@@ -572,6 +605,17 @@ void hbsolver::createMatrixLinearA (void) {
   int f = 0;
   nr_double_t freq;
 
+  // the matrix-free balancing keeps one sparse block per frequency
+  if (krylov) {
+    AB.clear ();
+    for (int i = 0; i < rfreqs.size (); i++) {
+      for (auto *lc : lincircuits)
+	lc->calcHB (rfreqs[i]);
+      AB.push_back (createBlockLinearA ());
+    }
+    return;
+  }
+
   // create new MNA matrix
   A = new tmatrix<nr_complex_t> ((N + M) * lnfreqs);
 
@@ -650,6 +694,90 @@ void hbsolver::fillMatrixLinearA (tmatrix<nr_complex_t> * A, int f) {
   }
 }
 
+/* The MNA matrix of the linear network is block diagonal (one block
+   per frequency).  This function creates the block for the frequency
+   the linear circuits have been calculated for last, extended by the
+   rows and columns of the excitation voltage sources.  The positions
+   of the 100 Ohm resistors across the excitations are part of the
+   block as well. */
+tspmatrix<nr_complex_t> hbsolver::createBlockLinearA (void) {
+  int N = nnanodes;
+  int sa = N + nlnvsrcs;
+  int ss = sa + nnlvsrcs;
+  int nr, nc, r, c, v;
+
+  // collect the entries of each column, the diagonal is always there
+  std::vector< std::vector< std::pair<int, nr_complex_t> > > cols (ss);
+  for (c = 0; c < ss; c++) cols[c].emplace_back (c, 0.0);
+
+  // through each linear circuit
+  for (auto *cir : lincircuits) {
+    int s = cir->getSize ();
+    v = cir->getVoltageSources ();
+    for (r = 0; r < s; r++) {
+      if ((nr = cir->getNode(r)->getNode () - 1) < 0) continue;
+      // G-matrix entries
+      for (c = 0; c < s; c++) {
+	if ((nc = cir->getNode(c)->getNode () - 1) < 0) continue;
+	cols[nc].emplace_back (nr, cir->getY (r, c));
+      }
+      // B- and C-matrix entries of built in voltage sources
+      for (c = 0; c < v; c++) {
+	nc = cir->getVoltageSource () + c;
+	cols[N + nc].emplace_back (nr, cir->getB (r, nc));
+	cols[nr].emplace_back (N + nc, cir->getC (nc, r));
+      }
+    }
+    // D-matrix entries
+    for (r = 0; r < v; r++) {
+      nr = cir->getVoltageSource () + r;
+      for (c = 0; c < v; c++) {
+	nc = cir->getVoltageSource () + c;
+	cols[N + nc].emplace_back (N + nr, cir->getD (nr, nc));
+      }
+    }
+  }
+
+  // the excitation voltage sources
+  c = sa;
+  for (auto *vs : excitations) {
+    int pn = vs->getNode(NODE_1)->getNode () - 1;
+    int nn = vs->getNode(NODE_2)->getNode () - 1;
+    if (pn >= 0) {
+      cols[c].emplace_back (pn, +1.0);
+      cols[pn].emplace_back (c, +1.0);
+    }
+    if (nn >= 0) {
+      cols[c].emplace_back (nn, -1.0);
+      cols[nn].emplace_back (c, -1.0);
+    }
+    if (pn >= 0 && nn >= 0) {
+      cols[nn].emplace_back (pn, 0.0);
+      cols[pn].emplace_back (nn, 0.0);
+    }
+    c++;
+  }
+
+  // sum up the entries of each position in the order given
+  tspmatrix<nr_complex_t> B (ss);
+  for (c = 0; c < ss; c++) {
+    std::vector< std::pair<int, nr_complex_t> > & col = cols[c];
+    std::stable_sort (col.begin (), col.end (),
+		      [] (const std::pair<int, nr_complex_t> & a,
+			  const std::pair<int, nr_complex_t> & b) {
+			return a.first < b.first;
+		      });
+    for (size_t i = 0; i < col.size (); ) {
+      nr_complex_t y = 0.0;
+      r = col[i].first;
+      while (i < col.size () && col[i].first == r) y += col[i++].second;
+      B.append (r, y);
+    }
+    B.commitCol (c);
+  }
+  return B;
+}
+
 // The function inverts the given matrix A into the matrix H.
 void hbsolver::invertMatrix (tmatrix<nr_complex_t> * A,
 			     tmatrix<nr_complex_t> * H) {
@@ -712,6 +840,7 @@ void hbsolver::invertMatrix (tmatrix<nr_complex_t> * A,
       current vector caused by the excitations
    4. invert this overall transimpedance matrix
    5. extract the variable transadmittance matrix entries
+   The matrix-free balancing uses createBlocksLinearY() instead.
 */
 void hbsolver::createMatrixLinearY (void) {
   int M = nlnvsrcs;
@@ -724,20 +853,11 @@ void hbsolver::createMatrixLinearY (void) {
   int se = nnlvsrcs;
   int sy = sv + se;
 
-  // allocate new transimpedance matrix
-  Z = new tmatrix<nr_complex_t> (sy * lnfreqs);
-
-  // prepare equation system
-  eqnsys<nr_complex_t> eqns;
-  tvector<nr_complex_t> * V;
-  tvector<nr_complex_t> * I;
-
-  // 1. create variable transimpedance matrix entries relating
-  // voltages at the balanced nodes to the currents through these
-  // nodes into the non-linear part
-  int sn = sv * lnfreqs;
-  V = new tvector<nr_complex_t> (sa);
-  I = new tvector<nr_complex_t> (sa);
+  // the matrix-free balancing has got no overall MNA matrix
+  if (krylov) {
+    createBlocksLinearY ();
+    return;
+  }
 
   // connect a 100 Ohm resistor (to ground) to balanced node in the MNA matrix
   for (c = 0; c < sv * lnfreqs; c++) A_(c, c) += 0.01;
@@ -759,10 +879,39 @@ void hbsolver::createMatrixLinearY (void) {
     }
   }
 
+  // allocate new transimpedance matrix
+  Z = new tmatrix<nr_complex_t> (sy * lnfreqs);
+
+  // prepare equation system
+  eqnsys<nr_complex_t> eqns;
+  tvector<nr_complex_t> * V;
+  tvector<nr_complex_t> * I;
+
+  // 1. create variable transimpedance matrix entries relating
+  // voltages at the balanced nodes to the currents through these
+  // nodes into the non-linear part
+  int sn = sv * lnfreqs;
+  V = new tvector<nr_complex_t> (sa);
+  I = new tvector<nr_complex_t> (sa);
+
+  // the MNA matrix is block diagonal (one block per frequency), thus
+  // a sparse factorization is considerably cheaper if requested
+  tspmatrix<nr_complex_t> * As = NULL;
+  if (sparse) {
+    As = new tspmatrix<nr_complex_t> (*A);
+    eqns.reorderSparse (As);
+  }
+
   // LU decompose the MNA matrix
   try_running () {
-    eqns.setAlgo (ALGO_LU_FACTORIZATION_CROUT);
-    eqns.passEquationSys (A, V, I);
+    if (As != NULL) {
+      eqns.setAlgo (ALGO_SPARSE_LU_FACTORIZATION);
+      eqns.passEquationSys (As, V, I);
+    }
+    else {
+      eqns.setAlgo (ALGO_LU_FACTORIZATION_CROUT);
+      eqns.passEquationSys (A, V, I);
+    }
     eqns.solve ();
   }
   // appropriate exception handling
@@ -774,11 +923,15 @@ void hbsolver::createMatrixLinearY (void) {
   }
 
   // aquire variable transimpedance matrix entries
-  eqns.setAlgo (ALGO_LU_SUBSTITUTION_CROUT);
+  eqns.setAlgo (As != NULL ? ALGO_SPARSE_LU_SUBSTITUTION :
+		ALGO_LU_SUBSTITUTION_CROUT);
   for (c = 0; c < sn; c++) {
     I->set (0.0);
     I_(c) = 1.0;
-    eqns.passEquationSys (A, V, I);
+    if (As != NULL)
+      eqns.passEquationSys (As, V, I);
+    else
+      eqns.passEquationSys (A, V, I);
     eqns.solve ();
     // ZV | ..
     // ---+---
@@ -811,7 +964,10 @@ void hbsolver::createMatrixLinearY (void) {
       I->set (0.0);
       if (pnode) I_(pn) = +1.0;
       if (nnode) I_(nn) = -1.0;
-      eqns.passEquationSys (A, V, I);
+      if (As != NULL)
+	eqns.passEquationSys (As, V, I);
+      else
+	eqns.passEquationSys (A, V, I);
       eqns.solve ();
       // .. | ZC
       // ---+---
@@ -832,6 +988,7 @@ void hbsolver::createMatrixLinearY (void) {
   }
   delete I;
   delete V;
+  delete As;
 
   // allocate new transadmittance matrix
   Y = new tmatrix<nr_complex_t> (sy * lnfreqs);
@@ -854,6 +1011,128 @@ void hbsolver::createMatrixLinearY (void) {
   delete Z; Z = NULL;
 }
 
+/* The MNA matrix of the linear network is block diagonal (one block
+   per frequency), so are the transimpedance and transadmittance
+   matrices.  For the matrix-free balancing this function therefore
+   solves the linear network for each frequency on its own and inverts
+   the small transimpedance block of the balanced nodes and the
+   excitations.  The transadmittance blocks of the balanced nodes are
+   kept in [YB], continued conjugately, all blocks are kept in [YF]
+   until the constant currents have been computed. */
+void hbsolver::createBlocksLinearY (void) {
+  int N = nnanodes;
+  int M = nlnvsrcs;
+  int sa = N + M;
+  int sv = nbanodes;
+  int sy = sv + nnlvsrcs;
+  int c, r, f;
+
+  // nodes of the excitations
+  std::vector<int> pnodes, nnodes;
+  for (auto *vs : excitations) {
+    pnodes.push_back (vs->getNode(NODE_1)->getNode ());
+    nnodes.push_back (vs->getNode(NODE_2)->getNode ());
+  }
+
+  tmatrix<nr_complex_t> ZF (sy), YF1 (sy);
+  tvector<nr_complex_t> V (sa + nnlvsrcs), I (sa + nnlvsrcs);
+  YF.assign (lnfreqs * sy * sy, 0.0);
+
+  for (f = 0; f < lnfreqs; f++) {
+    // the MNA matrix of this frequency, the excitation voltage sources
+    // are decoupled from the linear network
+    tspmatrix<nr_complex_t> AS (AB[f]);
+    for (c = 0; c < nnlvsrcs; c++) {
+      int pn = pnodes[c] - 1, nn = nnodes[c] - 1;
+      if (pn >= 0) {
+	AS.set (pn, sa + c, 0.0);
+	AS.set (sa + c, pn, 0.0);
+      }
+      if (nn >= 0) {
+	AS.set (nn, sa + c, 0.0);
+	AS.set (sa + c, nn, 0.0);
+      }
+      AS.set (sa + c, sa + c, 1.0);
+    }
+
+    // connect a 100 Ohm resistor (to ground) to the balanced nodes
+    for (r = 0; r < sv; r++) AS.add (r, r, 0.01);
+
+    // connect a 100 Ohm resistor (in parallel) to each excitation
+    for (c = 0; c < nnlvsrcs; c++) {
+      int pn = pnodes[c] - 1, nn = nnodes[c] - 1;
+      if (pn >= 0) AS.add (pn, pn, 0.01);
+      if (nn >= 0) AS.add (nn, nn, 0.01);
+      if (pn >= 0 && nn >= 0) {
+	AS.add (pn, nn, -0.01);
+	AS.add (nn, pn, -0.01);
+      }
+    }
+
+    eqnsys<nr_complex_t> eqns;
+    eqns.reorderSparse (&AS);
+
+    // LU decompose the MNA matrix
+    try_running () {
+      eqns.setAlgo (ALGO_SPARSE_LU_FACTORIZATION);
+      eqns.passEquationSys (&AS, &V, &I);
+      eqns.solve ();
+    }
+    // appropriate exception handling
+    catch_exception () {
+    case EXCEPTION_PIVOT:
+    default:
+      logprint (LOG_ERROR, "WARNING: %s: during A factorization\n",
+		getName ());
+      estack.print ();
+    }
+
+    // unit currents into the balanced nodes and through the excitations
+    eqns.setAlgo (ALGO_SPARSE_LU_SUBSTITUTION);
+    for (c = 0; c < sy; c++) {
+      I.set (0.0);
+      if (c < sv) {
+	I (c) = 1.0;
+      }
+      else {
+	if (pnodes[c - sv]) I (pnodes[c - sv] - 1) = +1.0;
+	if (nnodes[c - sv]) I (nnodes[c - sv] - 1) = -1.0;
+      }
+      eqns.passEquationSys (&AS, &V, &I);
+      eqns.solve ();
+      for (r = 0; r < sv; r++) ZF (r, c) = V (r);
+      for (r = sv; r < sy; r++) {
+	nr_complex_t z = 0.0;
+	if (pnodes[r - sv]) z += V (pnodes[r - sv] - 1);
+	if (nnodes[r - sv]) z -= V (nnodes[r - sv] - 1);
+	ZF (r, c) = z;
+      }
+    }
+
+    // invert the transimpedance block and substract the 100 Ohm resistor
+    invertMatrix (&ZF, &YF1);
+    for (r = 0; r < sy; r++) {
+      for (c = 0; c < sy; c++) {
+	nr_complex_t y = YF1 (r, c);
+	if (r == c) y -= 0.01;
+	YF[(f * sy + r) * sy + c] = y;
+      }
+    }
+  }
+
+  // keep the blocks of the balanced nodes, continued conjugately
+  YB.assign (nlfreqs * sv * sv, 0.0);
+  for (f = 0; f < nlfreqs; f++) {
+    int ff = f < lnfreqs ? f : 2 * lnfreqs - 2 - f;
+    for (r = 0; r < sv; r++) {
+      for (c = 0; c < sv; c++) {
+	nr_complex_t y = YF[(ff * sy + r) * sy + c];
+	YB[(f * sv + r) * sv + c] = f < lnfreqs ? y : conj (y);
+      }
+    }
+  }
+}
+
 /* Little helper function obtaining a transimpedance value for the
    given voltage source (excitation) and for a given frequency
    index. */
@@ -889,6 +1168,16 @@ void hbsolver::calcConstantCurrent (void) {
     }
   }
 
+  // transadmittance matrix entries, given by blocks per frequency in
+  // the matrix-free balancing
+  int sy = nbanodes + nnlvsrcs;
+  auto y = [this, sy] (int r, int c) -> nr_complex_t {
+    if (Y != NULL) return Y_(r, c);
+    int f = r % lnfreqs;
+    if (f != c % lnfreqs) return 0.0;
+    return YF[(f * sy + r / lnfreqs) * sy + c / lnfreqs];
+  };
+
   // compute constant current vector for balanced nodes
   IC = new tvector<nr_complex_t> (sn);
   // .. | YC * VC
@@ -897,7 +1186,7 @@ void hbsolver::calcConstantCurrent (void) {
   for (r = 0; r < sn; r++) {
     nr_complex_t i = 0.0;
     for (c = 0; c < se; c++) {
-      i += Y_(r, c + sn) * VC (c);
+      i += y (r, c + sn) * VC (c);
     }
     int f = r % lnfreqs;
     if (f != 0 && f != lnfreqs - 1) i /= 2;
@@ -914,13 +1203,14 @@ void hbsolver::calcConstantCurrent (void) {
   for (r = 0; r < se; r++) {
     nr_complex_t i = 0.0;
     for (c = 0; c < se; c++) {
-      i += Y_(r + sn, c + sn) * VC (c);
+      i += y (r + sn, c + sn) * VC (c);
     }
     IS->set (r, i);
   }
 
   // delete overall transadmittance matrix
   delete Y; Y = NULL;
+  YF.clear ();
 }
 
 /* Checks whether currents through the interconnects of the linear and
@@ -954,6 +1244,8 @@ int hbsolver::checkBalance (void) {
 #define C_(r,c) (*jq) ((r)*nlfreqs+f,(c)*nlfreqs+f)
 #undef  FI_
 #undef  FQ_
+#define GT_(r,c) JGt[pairs[(r)*nbanodes+(c)]*nlfreqs+f]
+#define CT_(r,c) JQt[pairs[(r)*nbanodes+(c)]*nlfreqs+f]
 #define FI_(r) (*ig) ((r)*nlfreqs+f)
 #define FQ_(r) (*fq) ((r)*nlfreqs+f)
 #define IR_(r) (*ir) ((r)*nlfreqs+f)
@@ -978,8 +1270,14 @@ void hbsolver::fillMatrixNonLinear (tmatrix<nr_complex_t> * jg,
       // apply G- and C-matrix entries
       for (c = 0; c < s; c++) {
 	if ((nc = cir->getNode(c)->getNode () - 1) < 0) continue;
-	G_(nr, nc) += cir->getY (r, c);
-	C_(nr, nc) += cir->getQV (r, c);
+	if (jg != NULL) {
+	  G_(nr, nc) += cir->getY (r, c);
+	  C_(nr, nc) += cir->getQV (r, c);
+	}
+	else {
+	  GT_(nr, nc) += cir->getY (r, c);
+	  CT_(nr, nc) += cir->getQV (r, c);
+	}
       }
       // apply I- and Q-vector entries
       FI_(nr) -= cir->getI (r);
@@ -1008,13 +1306,13 @@ void hbsolver::prepareNonLinear (void) {
   if (QR == NULL) {
     QR = new tvector<nr_complex_t> (N * nlfreqs);
   }
-  if (JG == NULL) {
+  if (JG == NULL && !krylov) {
     JG = new tmatrix<nr_complex_t> (N * nlfreqs);
   }
-  if (JQ == NULL) {
+  if (JQ == NULL && !krylov) {
     JQ = new tmatrix<nr_complex_t> (N * nlfreqs);
   }
-  if (JF == NULL) {
+  if (JF == NULL && !krylov) {
     JF = new tmatrix<nr_complex_t> (N * nlfreqs);
   }
 
@@ -1053,6 +1351,9 @@ void hbsolver::prepareNonLinear (void) {
   for (auto *cir : nolcircuits) {
     cir->initHB (nlfreqs);
   }
+
+  // prepare the matrix-free balancing
+  if (krylov) prepareKrylov ();
 }
 
 /* Saves the node voltages of the given circuit and for the given
@@ -1075,8 +1376,14 @@ void hbsolver::loadMatrices (void) {
   FQ->set (0.0);
   IR->set (0.0);
   QR->set (0.0);
-  JG->set (0.0);
-  JQ->set (0.0);
+  if (krylov) {
+    std::fill (JGt.begin (), JGt.end (), 0.0);
+    std::fill (JQt.begin (), JQt.end (), 0.0);
+  }
+  else {
+    JG->set (0.0);
+    JQ->set (0.0);
+  }
   // through each frequency
   for (int f = 0; f < nlfreqs; f++) {
     // calculate components' HB matrices and vector for the given frequency
@@ -1101,12 +1408,9 @@ void hbsolver::VectorFFT (tvector<nr_complex_t> * V, int isign) {
   nr_double_t * d = (double *)V->getData ();
 
   if (nd == 1) {
-    // for each node a single 1d-FFT
-    for (k = i = 0; i < nodes; i++, k += 2 * n) {
-      nr_double_t * dst = &d[k];
-      _fft_1d (dst, n, isign);
-      if (isign > 0) for (r = 0; r < 2 * n; r++) *dst++ /= n;
-    }
+    // a 1d-FFT for each node, all using the same plan
+    _fft_1d_n (d, n, nodes, isign);
+    if (isign > 0) for (r = 0; r < 2 * n * nodes; r++) d[r] /= n;
   }
   else {
     // for each node a single nd-FFT
@@ -1185,7 +1489,11 @@ void hbsolver::solveHB (void) {
       // part 1 of right hand side vector
       ir -= il;
       // transadmittance matrix multiplied by voltage vector
-      for (int c = 0; c < nbanodes * nlfreqs; c++) {
+      if (krylov) {
+	const nr_complex_t * y = &YB[(f * nbanodes + r / nlfreqs) * nbanodes];
+	for (int c = 0; c < nbanodes; c++) il += y[c] * VS_(c * nlfreqs + f);
+      }
+      else for (int c = 0; c < nbanodes * nlfreqs; c++) {
 	il += YV_(r, c) * VS_(c);
       }
       // charge vector
@@ -1296,6 +1604,256 @@ void hbsolver::solveVoltages (void) {
   *vs = *VS;
 }
 
+/* The function prepares the matrix-free balancing.  Only node pairs
+   connected by a non-linear circuit have G- and C-Jacobian entries.
+   These are stored as vectors in the time domain. */
+void hbsolver::prepareKrylov (void) {
+  int N = nbanodes, slots = 0;
+
+  // enumerate the node pairs of the non-linear circuits
+  pairs.assign (N * N, -1);
+  for (auto *cir : nolcircuits) {
+    int s = cir->getSize ();
+    for (int r = 0; r < s; r++) {
+      int nr = cir->getNode(r)->getNode () - 1;
+      if (nr < 0) continue;
+      for (int c = 0; c < s; c++) {
+	int nc = cir->getNode(c)->getNode () - 1;
+	if (nc < 0 || pairs[nr * N + nc] >= 0) continue;
+	pairs[nr * N + nc] = slots++;
+      }
+    }
+  }
+  JGt.assign (slots * nlfreqs, 0.0);
+  JQt.assign (slots * nlfreqs, 0.0);
+  kt = kg = kq = tvector<nr_complex_t> (N * nlfreqs);
+
+  // the preconditioner has an N x N block for each frequency
+  delete[] PB;
+  delete[] PE;
+  PB = new tmatrix<nr_complex_t>[nlfreqs];
+  PE = new eqnsys<nr_complex_t>[nlfreqs];
+  for (int f = 0; f < nlfreqs; f++) PB[f] = tmatrix<nr_complex_t> (N);
+}
+
+/* The function applies the Jacobian JF = [YV] + j[O] * JQ + JG to the
+   given frequency domain vector.  [YV] is diagonal in frequency.  The
+   frequency domain blocks of JG and JQ are circulant, thus applying
+   them is a convolution which is done by multiplying the time domain
+   conductances and capacitances with the time domain vector. */
+void hbsolver::applyJacobian (tvector<nr_complex_t> & V,
+			      tvector<nr_complex_t> & R) {
+  int N = nbanodes, n = nlfreqs;
+  int r, c, f;
+
+  // linear network
+  for (r = 0; r < N; r++) {
+    for (f = 0; f < n; f++) {
+      const nr_complex_t * y = &YB[(f * N + r) * N];
+      nr_complex_t i = 0.0;
+      for (c = 0; c < N; c++) i += y[c] * V (c * n + f);
+      R (r * n + f) = i;
+    }
+  }
+
+  // non-linear circuits in the time domain
+  kt = V;
+  VectorIFFT (&kt);
+  kg.set (0.0);
+  kq.set (0.0);
+  for (r = 0; r < N; r++) {
+    for (c = 0; c < N; c++) {
+      int k = pairs[r * N + c];
+      if (k < 0) continue;
+      const nr_complex_t * g = &JGt[k * n];
+      const nr_complex_t * q = &JQt[k * n];
+      for (f = 0; f < n; f++) {
+	kg (r * n + f) += g[f] * kt (c * n + f);
+	kq (r * n + f) += q[f] * kt (c * n + f);
+      }
+    }
+  }
+  VectorFFT (&kg);
+  VectorFFT (&kq);
+  for (r = 0; r < N; r++) {
+    for (f = 0; f < n; f++) {
+      R (r * n + f) += kg (r * n + f) + OM_(f) * kq (r * n + f);
+    }
+  }
+}
+
+/* The block-diagonal preconditioner is the Jacobian with the
+   non-linear circuits replaced by their average conductances and
+   capacitances.  The function applies its inverse to the given
+   vector. */
+void hbsolver::applyPreconditioner (tvector<nr_complex_t> & V,
+				    tvector<nr_complex_t> & R) {
+  int N = nbanodes, n = nlfreqs;
+  tvector<nr_complex_t> b (N), x (N);
+  for (int f = 0; f < n; f++) {
+    for (int r = 0; r < N; r++) b (r) = V (r * n + f);
+    PE[f].passEquationSys (&PB[f], &x, &b);
+    PE[f].solve ();
+    for (int r = 0; r < N; r++) R (r * n + f) = x (r);
+  }
+}
+
+// Complex inner product of two vectors.
+static nr_complex_t dotKrylov (tvector<nr_complex_t> & a,
+			       tvector<nr_complex_t> & b) {
+  nr_complex_t d = 0.0;
+  for (int i = 0; i < (int) a.size (); i++) d += conj (a (i)) * b (i);
+  return d;
+}
+
+// Euclidian norm of a vector.
+static nr_double_t normKrylov (tvector<nr_complex_t> & a) {
+  nr_double_t n = 0.0;
+  for (int i = 0; i < (int) a.size (); i++) n += std::norm (a (i));
+  return std::sqrt (n);
+}
+
+/* This function solves the equation system
+   JF * VS(n+1) = JF * VS(n) - FV
+   using the restarted GMRES method with the block-diagonal
+   preconditioner applied from the right.  The Jacobian JF is never
+   formed.  The previous voltages are the initial guess. */
+void hbsolver::solveVoltagesKrylov (void) {
+  int N = nbanodes, n = nlfreqs, S = N * n, m = HB_KRYLOV_RESTART;
+  int f, r, c, i, j, k, iter = 0;
+
+  // save previous iteration voltage
+  *VP = *VS;
+
+  // average conductances and capacitances of the non-linear circuits
+  int slots = JGt.size () / n;
+  std::vector<nr_complex_t> gm (slots, 0.0), qm (slots, 0.0);
+  for (k = 0; k < slots; k++) {
+    for (f = 0; f < n; f++) {
+      gm[k] += JGt[k * n + f];
+      qm[k] += JQt[k * n + f];
+    }
+    gm[k] /= (nr_double_t) n;
+    qm[k] /= (nr_double_t) n;
+  }
+
+  // LU factorize the preconditioner blocks
+  try_running () {
+    tvector<nr_complex_t> px (N), pb (N);
+    for (f = 0; f < n; f++) {
+      tmatrix<nr_complex_t> & P = PB[f];
+      for (r = 0; r < N; r++) {
+	for (c = 0; c < N; c++) {
+	  nr_complex_t p = YB[(f * N + r) * N + c];
+	  if ((k = pairs[r * N + c]) >= 0) p += gm[k] + OM_(f) * qm[k];
+	  P (r, c) = p;
+	}
+      }
+      PE[f].setAlgo (ALGO_LU_FACTORIZATION_CROUT);
+      PE[f].passEquationSys (&P, &px, &pb);
+      PE[f].solve ();
+      PE[f].setAlgo (ALGO_LU_SUBSTITUTION_CROUT);
+    }
+  }
+  // appropriate exception handling
+  catch_exception () {
+  case EXCEPTION_PIVOT:
+  default:
+    logprint (LOG_ERROR, "WARNING: %s: during preconditioner "
+	      "factorization\n", getName ());
+    estack.print ();
+  }
+
+  // Krylov basis, Hessenberg matrix and Givens rotations
+  std::vector<tvector<nr_complex_t> > v (m + 1, tvector<nr_complex_t> (S));
+  std::vector<nr_complex_t> h ((m + 1) * m), g (m + 1), sn (m), y (m);
+  std::vector<nr_double_t> cs (m);
+  tvector<nr_complex_t> w (S), z (S);
+#define H_(r,c) h[(r) * m + (c)]
+
+  nr_double_t bnorm = normKrylov (*RH), rnorm;
+  if (bnorm == 0.0) bnorm = 1.0;
+
+  for (;;) {
+    // residual of the current solution
+    applyJacobian (*VS, w);
+    for (i = 0; i < S; i++) v[0] (i) = RH->get (i) - w (i);
+    rnorm = normKrylov (v[0]);
+    if (rnorm <= HB_KRYLOV_TOL * bnorm || iter >= HB_KRYLOV_MAXITER) break;
+    for (i = 0; i < S; i++) v[0] (i) /= rnorm;
+    std::fill (g.begin (), g.end (), 0.0);
+    g[0] = rnorm;
+
+    // Arnoldi process
+    for (j = 0; j < m && iter < HB_KRYLOV_MAXITER; ) {
+      applyPreconditioner (v[j], z);
+      applyJacobian (z, w);
+      iter++;
+      for (i = 0; i <= j; i++) {
+	H_(i, j) = dotKrylov (v[i], w);
+	for (k = 0; k < S; k++) w (k) -= H_(i, j) * v[i] (k);
+      }
+      nr_double_t hn = normKrylov (w);
+      H_(j + 1, j) = hn;
+      if (hn > 0.0) for (k = 0; k < S; k++) v[j + 1] (k) = w (k) / hn;
+
+      // apply previous rotations to the new column
+      for (i = 0; i < j; i++) {
+	nr_complex_t t = cs[i] * H_(i, j) + sn[i] * H_(i + 1, j);
+	H_(i + 1, j) = -conj (sn[i]) * H_(i, j) + cs[i] * H_(i + 1, j);
+	H_(i, j) = t;
+      }
+      // eliminate the subdiagonal entry
+      nr_double_t a = std::abs (H_(j, j)), t = std::sqrt (a * a + hn * hn);
+      if (t == 0.0) {
+	cs[j] = 1.0;
+	sn[j] = 0.0;
+      }
+      else if (a == 0.0) {
+	cs[j] = 0.0;
+	sn[j] = 1.0;
+      }
+      else {
+	cs[j] = a / t;
+	sn[j] = H_(j, j) / a * hn / t;
+      }
+      H_(j, j) = cs[j] * H_(j, j) + sn[j] * hn;
+      H_(j + 1, j) = 0.0;
+      g[j + 1] = -conj (sn[j]) * g[j];
+      g[j] = cs[j] * g[j];
+      j++;
+      if (std::abs (g[j]) <= HB_KRYLOV_TOL * bnorm || hn == 0.0) break;
+    }
+
+    // solve the triangular system and update the solution
+    for (i = j - 1; i >= 0; i--) {
+      nr_complex_t t = g[i];
+      for (k = i + 1; k < j; k++) t -= H_(i, k) * y[k];
+      y[i] = H_(i, i) != 0.0 ? t / H_(i, i) : 0.0;
+    }
+    w.set (0.0);
+    for (i = 0; i < j; i++)
+      for (k = 0; k < S; k++) w (k) += y[i] * v[i] (k);
+    applyPreconditioner (w, z);
+    for (k = 0; k < S; k++) VS_(k) += z (k);
+  }
+#undef H_
+
+  if (rnorm > HB_KRYLOV_TOL * bnorm) {
+    logprint (LOG_ERROR, "WARNING: %s: GMRES residual %g after %d "
+	      "iterations\n", getName (), (double) (rnorm / bnorm), iter);
+  }
+#if DEBUG
+  else {
+    logprint (LOG_STATUS, "NOTIFY: %s: GMRES converged after %d "
+	      "iterations\n", getName (), iter);
+  }
+#endif
+
+  // save new voltages in time domain vector
+  *vs = *VS;
+}
+
 /* The following function extends the existing linear MNA matrix to
    contain the additional rows and columns for the excitation voltage
    sources. */
@@ -1348,6 +1906,12 @@ void hbsolver::fillMatrixLinearExtended (tmatrix<nr_complex_t> * Y,
 /* The function calculates and saves the final solution. */
 void hbsolver::finalSolution (void) {
 
+  // the matrix-free balancing solves one frequency after the other
+  if (krylov) {
+    finalSolutionBlocks ();
+    return;
+  }
+
   // extend the linear MNA matrix
   *NA = extendMatrixLinear (*NA, nnlvsrcs);
 
@@ -1373,12 +1937,21 @@ void hbsolver::finalSolution (void) {
     }
   }
 
-  // use QR decomposition for the final solution
+  // use LU decomposition for the final solution
   try_running () {
     eqnsys<nr_complex_t> eqns;
-    eqns.setAlgo (ALGO_LU_DECOMPOSITION);
-    eqns.passEquationSys (NA, V, I);
-    eqns.solve ();
+    if (sparse) {
+      tspmatrix<nr_complex_t> As (*NA);
+      eqns.reorderSparse (&As);
+      eqns.setAlgo (ALGO_SPARSE_LU_DECOMPOSITION);
+      eqns.passEquationSys (&As, V, I);
+      eqns.solve ();
+    }
+    else {
+      eqns.setAlgo (ALGO_LU_DECOMPOSITION);
+      eqns.passEquationSys (NA, V, I);
+      eqns.solve ();
+    }
   }
   // appropriate exception handling
   catch_exception () {
@@ -1391,6 +1964,53 @@ void hbsolver::finalSolution (void) {
   for (int i = 0; i < N; i++) x->set (i, V_(i));
 }
 
+/* The function calculates the final solution using the sparse MNA
+   blocks of the linear network extended by the excitations, one block
+   per frequency. */
+void hbsolver::finalSolutionBlocks (void) {
+  int sa = nnanodes + nlnvsrcs;
+  tvector<nr_complex_t> V (sa + nnlvsrcs), I (sa + nnlvsrcs);
+
+  // final solution
+  x = new tvector<nr_complex_t> (nnanodes * lnfreqs);
+
+  for (int f = 0; f < lnfreqs; f++) {
+    // put the voltages of the excitations into right hand side
+    int c = sa;
+    I.set (0.0);
+    for (auto *vs : excitations) {
+      vs->calcHB (rfreqs[f]);
+      I (c++) = vs->getE (VSRC_1);
+    }
+
+    // put currents through balanced nodes into right hand side
+    for (int n = 0; n < nbanodes; n++) {
+      nr_complex_t i = IL->get (n * nlfreqs + f);
+      if (f != 0 && f != lnfreqs - 1) i *= 2;
+      I (n) = i;
+    }
+
+    // use sparse LU decomposition for the final solution
+    try_running () {
+      eqnsys<nr_complex_t> eqns;
+      eqns.reorderSparse (&AB[f]);
+      eqns.setAlgo (ALGO_SPARSE_LU_DECOMPOSITION);
+      eqns.passEquationSys (&AB[f], &V, &I);
+      eqns.solve ();
+    }
+    // appropriate exception handling
+    catch_exception () {
+    case EXCEPTION_PIVOT:
+    default:
+      logprint (LOG_ERROR, "WARNING: %s: during final AC analysis\n",
+		getName ());
+      estack.print ();
+    }
+    for (int n = 0; n < nnanodes; n++) x->set (n * lnfreqs + f, V (n));
+  }
+  AB.clear ();
+}
+
 // Saves simulation results.
 void hbsolver::saveResults (void) {
   vector * f;
@@ -1425,6 +2045,8 @@ PROP_OPT [] = {
   { "vabstol", PROP_REAL, { 1e-6, PROP_NO_STR }, PROP_RNG_X01I },
   { "reltol", PROP_REAL, { 1e-3, PROP_NO_STR }, PROP_RNG_X01I },
   { "MaxIter", PROP_INT, { 150, PROP_NO_STR }, PROP_RNGII (2, 10000) },
+  { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" },
+    PROP_RNG_STR3 ("CroutLU", "SparseLU", "GMRES") },
   PROP_NO_PROP };
 struct define_t hbsolver::anadef =
   { "HB", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
@@ -29,12 +29,14 @@
 
 #include "ptrlist.h"
 #include "tvector.h"
+#include "tspmatrix.h"
 
 namespace qucs {
 
 class vector;
 class strlist;
 class circuit;
+template <class nr_type_t> class eqnsys;
 
 class hbsolver : public analysis
 {
@@ -62,10 +64,13 @@ class hbsolver : public analysis
   void fillMatrixLinearA (tmatrix<nr_complex_t> *, int);
   void invertMatrix (tmatrix<nr_complex_t> *, tmatrix<nr_complex_t> *);
   void createMatrixLinearY (void);
+  void createBlocksLinearY (void);
+  tspmatrix<nr_complex_t> createBlockLinearA (void);
   void saveResults (void);
   void calcConstantCurrent (void);
   nr_complex_t excitationZ (tvector<nr_complex_t> *, circuit *, int);
   void finalSolution (void);
+  void finalSolutionBlocks (void);
   void fillMatrixNonLinear (tmatrix<nr_complex_t> *, tmatrix<nr_complex_t> *,
 			    tvector<nr_complex_t> *, tvector<nr_complex_t> *,
 			    tvector<nr_complex_t> *, tvector<nr_complex_t> *,
@@ -85,6 +90,11 @@ class hbsolver : public analysis
   void fillMatrixLinearExtended (tmatrix<nr_complex_t> *,
 				 tvector<nr_complex_t> *);
   void saveNodeVoltages (circuit *, int);
+  void prepareKrylov (void);
+  void solveVoltagesKrylov (void);
+  void applyJacobian (tvector<nr_complex_t> &, tvector<nr_complex_t> &);
+  void applyPreconditioner (tvector<nr_complex_t> &,
+			    tvector<nr_complex_t> &);
 
  private:
   std::vector<nr_double_t> negfreqs;    // full frequency set
@@ -126,6 +136,19 @@ class hbsolver : public analysis
   tvector<nr_complex_t> * x;
   tvector<nr_complex_t> * vs;
 
+  // matrix-free balancing
+  bool sparse;                      // sparse LU for the linear network
+  bool krylov;                      // GMRES instead of forming JF
+  std::vector<tspmatrix<nr_complex_t> > AB; // [NA] as sparse blocks
+  std::vector<nr_complex_t> YB;     // [YV] as one block per frequency
+  std::vector<nr_complex_t> YF;     // [Y] as one block per frequency
+  std::vector<int> pairs;           // slots of the non-linear node pairs
+  std::vector<nr_complex_t> JGt;    // G-Jacobian in t of the node pairs
+  std::vector<nr_complex_t> JQt;    // C-Jacobian in t of the node pairs
+  tmatrix<nr_complex_t> * PB;       // preconditioner blocks
+  eqnsys<nr_complex_t> * PE;        // and their LU factorizations
+  tvector<nr_complex_t> kt, kg, kq; // time domain workspace
+
   int runs;
   int lnfreqs;
   int nlfreqs;
@@ -26,15 +26,8 @@
 # include <config.h>
 #endif
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 #include <cmath>
 
-#include "precision.h"
-#include "tvector.h"
-#include "poly.h"
-#include "spline.h"
 #include "history.h"
 
 namespace qucs {
@@ -45,113 +38,124 @@ namespace qucs {
 void history::truncate (const nr_double_t tcut)
 {
     std::size_t i;
-    std::size_t ts = this->t->size ();
 
-    for (i = this->leftidx (); i < ts; i++)
+    for (i = this->t->tail; i > this->t->head; i--)
     {
-      if ( (*this->t)[i] > tcut)
+      if ((*this->t)[i - 1] <= tcut)
       {
 	break;
       }
     }
-    this->resize (ts - i);
+    // the time values may be shared with other histories
+    this->t->tail = i;
+    this->values->tail = std::min (this->values->tail, i);
+    this->values->head = std::min (this->values->head, this->values->tail);
 }
 
 
 /* This function drops those values in the history which are older
    than the specified age of the history instance. */
 void history::drop (void) {
-  if(this->values->empty())
+  if (this->values->empty() || age <= 0.0)
     return;
-  nr_double_t f = this->first ();
   nr_double_t l = this->last ();
-  if (age > 0.0 && l - f > age) {
-    std::size_t r;
-    std::size_t i = this->leftidx ();
-    for (r = 0; i < this->t->size (); r++, i++)
-      if (l - (*this->t)[i] < age)
-	break;
-    // keep 2 values being older than specified age
-    r += this->unused ();
-    if (r >= 2)
-      r -= 2;
-    r = std::min(r,this->values->size()-1);
-    if (r > 127)
-      /* erase the first r value */
-      this->values->erase(this->values->begin(),this->values->begin()+r);
-  }
+  std::size_t i = this->leftidx ();
+  std::size_t r = this->rightidx ();
+  while (i < r && l - (*this->t)[i] >= age)
+    i++;
+  // keep 2 values being older than specified age
+  i = i >= 2 ? i - 2 : 0;
+  i = std::min (i, this->values->tail - 1);
+  if (i > this->values->head)
+    this->values->head = i;
 }
 
-/* Interpolates a value using 2 left side and 2 right side values if
-   possible. */
-nr_double_t history::interpol (nr_double_t tval, int idx, bool left) {
-  static spline spl (SPLINE_BC_NATURAL);
-  static tvector<nr_double_t> x (4);
-  static tvector<nr_double_t> y (4);
-
-  unsigned int n = left ? idx + 1: idx;
-  if (n > 1 && n + 2 < this->values->size ()) {
-    int i, k, l = this->leftidx ();
-    for (k = 0, i = n - 2; k < 4; i++, k++) {
-      x (k) = (*this->t)[i + l];
-      y (k) = (*this->values)[i];
-    }
-    spl.vectors (y, x);
-    spl.construct ();
-    return spl.evaluate (tval).f0;
-  }
-  return (*this->values)[idx];
+/* Evaluates the cubic polynomial between the given points with the
+   given second derivatives at the points. */
+static nr_double_t cubic (nr_double_t x0, nr_double_t x1,
+			  nr_double_t y0, nr_double_t y1,
+			  nr_double_t m0, nr_double_t m1, nr_double_t x) {
+  nr_double_t h = x1 - x0;
+  nr_double_t a = (x1 - x) / h;
+  nr_double_t b = (x - x0) / h;
+  return a * y0 + b * y1 + ((a * a * a - a) * m0 + (b * b * b - b) * m1) *
+    h * h / 6;
+}
+
+/* Interpolates a value using the natural cubic spline through the 2
+   left side and 2 right side values of the given index.  The spline
+   is computed in place, so there is neither any memory allocation nor
+   any shared state. */
+nr_double_t history::interpol (nr_double_t tval, std::size_t k) {
+  const historybuffer & x = *this->t;
+  const historybuffer & y = *this->values;
+  nr_double_t x0 = x[k - 1], x1 = x[k], x2 = x[k + 1], x3 = x[k + 2];
+  nr_double_t y0 = y[k - 1], y1 = y[k], y2 = y[k + 1], y3 = y[k + 2];
+  nr_double_t h0 = x1 - x0, h1 = x2 - x1, h2 = x3 - x2;
+
+  // second derivatives at the inner points
+  nr_double_t r1 = 6 * ((y2 - y1) / h1 - (y1 - y0) / h0);
+  nr_double_t r2 = 6 * ((y3 - y2) / h2 - (y2 - y1) / h1);
+  nr_double_t a = 2 * (h0 + h1), d = 2 * (h1 + h2);
+  nr_double_t det = a * d - h1 * h1;
+  nr_double_t m1 = (r1 * d - h1 * r2) / det;
+  nr_double_t m2 = (a * r2 - h1 * r1) / det;
+
+  if (tval < x1)
+    return cubic (x0, x1, y0, y1, 0, m1, tval);
+  if (tval > x2)
+    return cubic (x2, x3, y2, y3, m2, 0, tval);
+  return cubic (x1, x2, y1, y2, m1, m2, tval);
 }
 
 /* The function returns the value nearest to the given time value.  If
    the otional parameter is true then additionally cubic spline
    interpolation is used. */
 nr_double_t history::nearest (nr_double_t tval, bool interpolate) {
-  if (t->empty())
+  std::size_t l = this->leftidx ();
+  std::size_t r = this->rightidx ();
+  if (l >= r)
     return 0.0;
 
-  int l = this->leftidx ();
-  int r = t->size () - 1;
-  int i = -1;
-  nr_double_t diff = std::numeric_limits<nr_double_t>::max();
-  sign = true;
-  i = seek (tval, l, r, diff, i);
-  i = i - l;
-  if (interpolate)
-    return interpol (tval, i, sign);
-  return (*this->values)[i];
+  std::size_t k = seek (tval);
+  if (interpolate && k > l && k + 2 < r)
+    return interpol (tval, k);
+  if (k + 1 < r && (*this->t)[k + 1] - tval < tval - (*this->t)[k])
+    k++;
+  return (*this->values)[k];
 }
 
-/* The function is utilized in order to find the nearest value to a
-   given time value.  Since the time vector is ordered a recursive
-   lookup algorithm can be used.  The function returns the current
-   index into the time vector as well as the error in time. */
-int history::seek (nr_double_t tval, int l, int r, nr_double_t& diff,
-		   int idx) {
-  int i = (l + r) / 2;
-  if (l == r)
-    return i;
-  nr_double_t v = (*this->t)[i];
-  nr_double_t d = v - tval;
-  if (fabs (d) < diff) {
-    // better approximation
-    diff = fabs (d);
-    sign = d < 0.0 ? true : false;
-    idx = i;
-  }
-  else if (i == l) {
-    // no better
-    return idx;
-  }
-  if (d < 0.0) {
-    // look later
-    return seek (tval, i, r, diff, idx);
+/* The function returns the index of the latest time value not being
+   later than the given time value (or the first one).  Usually the
+   time values requested are slightly later than the ones requested
+   before, so the lookup starts at the previous result and moves
+   forward a few steps.  Otherwise the ordered time vector is
+   bisected. */
+std::size_t history::seek (nr_double_t tval) {
+  const historybuffer & x = *this->t;
+  std::size_t l = this->leftidx ();
+  std::size_t r = this->rightidx ();
+
+  std::size_t k = this->cursor;
+  if (k >= l && k < r && x[k] <= tval) {
+    for (int n = 0; n < 8; n++) {
+      if (k + 1 >= r || x[k + 1] > tval)
+	return this->cursor = k;
+      k++;
+    }
   }
-  else if (d > 0.0) {
-    // look earlier
-    return seek (tval, l, i, diff, idx);
+
+  // bisection in [l, r)
+  if (x[l] > tval)
+    return this->cursor = l;
+  while (r - l > 1) {
+    std::size_t i = (l + r) / 2;
+    if (x[i] <= tval)
+      l = i;
+    else
+      r = i;
   }
-  return idx;
+  return this->cursor = l;
 }
 
 } // namespace qucs
@@ -25,47 +25,79 @@
 #ifndef __HISTORY_H__
 #define __HISTORY_H__
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <utility>
 
 namespace qucs {
 
+/* The history buffer stores the values of a history in a ring.  Each
+   value is addressed by its absolute index, i.e. the number of values
+   appended before.  Dropping the oldest values just advances the
+   head, the capacity is doubled when the ring is full. */
+class historybuffer
+{
+public:
+  historybuffer () : head(0), tail(0), data(16) {}
+
+  void push_back (const nr_double_t val) {
+    if (tail - head == data.size ()) grow ();
+    data[tail++ & (data.size () - 1)] = val;
+  }
+  nr_double_t operator [] (const std::size_t i) const {
+    return data[i & (data.size () - 1)];
+  }
+  bool empty (void) const { return head == tail; }
+  std::size_t size (void) const { return tail - head; }
+  nr_double_t back (void) const { return (*this)[tail - 1]; }
+
+public:
+  std::size_t head;   // absolute index of the oldest value
+  std::size_t tail;   // absolute index behind the youngest value
+
+private:
+  void grow (void) {
+    std::vector<nr_double_t> d (2 * data.size ());
+    for (std::size_t i = head; i < tail; i++)
+      d[i & (d.size () - 1)] = (*this)[i];
+    data.swap (d);
+  }
+  std::vector<nr_double_t> data;
+};
+
 class history
 {
 public:
   /*! default constructor */
   history ():
-    sign(false),
     age(0),
-    values(std::make_shared<std::vector<nr_double_t>>()),
-    t(std::make_shared<std::vector<nr_double_t>>()) 
+    cursor(0),
+    values(std::make_shared<historybuffer>()),
+    t(std::make_shared<historybuffer>())
   {};
-  
+
   /*! The copy constructor creates a new instance based on the given
       history object. */
   history (const history &h)
   {
       this->age = h.age;
-      this->t = std::make_shared<std::vector<nr_double_t>>(*(h.t));
-      this->values = std::make_shared<std::vector<nr_double_t>>(*(h.values));
+      this->cursor = h.cursor;
+      this->values = std::make_shared<historybuffer>(*(h.values));
+      if (h.t == h.values)
+	this->t = this->values;
+      else
+	this->t = std::make_shared<historybuffer>(*(h.t));
   }
 
   /*! The function appends the given value to the history. */
   void push_back (const nr_double_t val) {
     this->values->push_back(val);
-    if (this->values != this->t) 
+    if (this->values != this->t)
       this->drop ();
   }
 
-  /* This function drops the most recent n values in the history. */
-  void truncate (const std::size_t n) = delete;
-  void resize(const std::size_t n)
-  {
-    this->t->resize (n);
-    this->values->resize (n);
-  }
-
+  //! Returns the number of time values in the history.
   std::size_t size (void) const
   {
     return t->size ();
@@ -89,47 +121,44 @@ public:
     return this->t->empty() ? 0.0 : (*this->t)[leftidx ()];
   }
 
-  // Returns left-most valid index into the time value vector.
-  unsigned int leftidx (void) const {
-    int ts = this->t->size ();
-    int vs = this->values->size ();
-    return ts - vs > 0 ? ts - vs : 0;
-  }
-
-  /*! Returns number of unused values (time value vector shorter than
-   value vector). */
-  std::size_t unused (void) {
-    int ts = t->size ();
-    int vs = values->size ();
-    return vs - ts > 0 ? vs - ts : 0;
-  }
-  
   //! Returns the duration of the history.
   nr_double_t duration(void) const {
      return last () - first ();
   }
-  
+
   void truncate (const nr_double_t);
-  
+
   void drop (void);
   void self (void) { this->t = this->values; }
 
-  nr_double_t interpol (nr_double_t, int, bool);
   nr_double_t nearest (nr_double_t, bool interpolate = true);
-  int seek (nr_double_t, int, int, nr_double_t&, int);
 
-  nr_double_t getTfromidx (const int idx)  {
-    return this->t == NULL ? 0.0 : (*this->t)[idx];
+  nr_double_t getTfromidx (const int idx) const {
+    return (*this->t)[this->t->head + idx];
+  }
+  nr_double_t getValfromidx (const int idx) const {
+    std::size_t i = this->t->head + idx;
+    if (i < this->values->head || i >= this->values->tail) return 0.0;
+    return (*this->values)[i];
+  }
+
+ private:
+  // Returns the absolute index of the oldest time having a value.
+  std::size_t leftidx (void) const {
+    return std::max (this->t->head, this->values->head);
   }
-  nr_double_t getValfromidx (const int idx) {
-    return this->values == NULL ? 0.0 : (*this->values)[idx];
+  // Returns the absolute index behind the youngest time having a value.
+  std::size_t rightidx (void) const {
+    return std::min (this->t->tail, this->values->tail);
   }
+  std::size_t seek (nr_double_t);
+  nr_double_t interpol (nr_double_t, std::size_t);
 
  private:
-  bool sign;
   nr_double_t age;
-  std::shared_ptr<std::vector<nr_double_t>> values;
-  std::shared_ptr<std::vector<nr_double_t>> t;
+  std::size_t cursor;
+  std::shared_ptr<historybuffer> values;
+  std::shared_ptr<historybuffer> t;
 };
 
 } // namespace qucs
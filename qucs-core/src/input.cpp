@@ -32,6 +32,8 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <chrono>
+
 #include "logging.h"
 #include "component.h"
 #include "components.h"
@@ -79,17 +81,20 @@ input::~input () {
    representation and stores it into the given netlist object.  The
    function returns zero on success and non-zero otherwise. */
 int input::netlist (net * netlist) {
+  std::chrono::steady_clock::time_point start, parsed, checked, created;
 
   // tell the scanner to use the specified file
-  netlist_in = getFile ();
+  netlist_lex_file (getFile ());
 
   // save the netlist object
   subnet = netlist;
 
   logprint (LOG_STATUS, "parsing netlist...\n");
+  start = std::chrono::steady_clock::now ();
 
   if (netlist_parse () != 0)
     return -1;
+  parsed = std::chrono::steady_clock::now ();
 
   logprint (LOG_STATUS, "checking netlist...\n");
   if (netlist_checker (env) != 0)
@@ -97,6 +102,7 @@ int input::netlist (net * netlist) {
 
   if (netlist_checker_variables (env) != 0)
     return -1;
+  checked = std::chrono::steady_clock::now ();
 
 #if DEBUG
   netlist_list ();
@@ -107,6 +113,14 @@ int input::netlist (net * netlist) {
   factory ();
 
   netlist_destroy ();
+  created = std::chrono::steady_clock::now ();
+
+  // report the time spent in each phase
+  typedef std::chrono::duration<double> seconds;
+  logprint (LOG_STATUS, "NOTIFY: netlist parsed in %.3f s, checked in %.3f s, "
+	    "created in %.3f s\n", seconds (parsed - start).count (),
+	    seconds (checked - parsed).count (),
+	    seconds (created - checked).count ());
   return 0;
 }
 
@@ -187,7 +201,7 @@ void input::factory (void) {
     // handle substrate definitions
     if (!def->action && def->substrate) {
       if ((s = createSubstrate (def->type)) != NULL) {
-	s->setName (def->instance);
+	s->setName (netlist_instance_name (def));
 
 	// add the properties to substrate
 	for (pairs = def->pairs; pairs != NULL; pairs = pairs->next)
@@ -210,8 +224,9 @@ void input::factory (void) {
 	assignDefaultProperties (s, def->define);
 
 	// put new substrate definition into environment
-	char * n = strrchr (def->instance, '.');
-	variable * v = new variable (n ? n + 1 : def->instance);
+	char * name = netlist_instance_name (def);
+	char * n = strrchr (name, '.');
+	variable * v = new variable (n ? n + 1 : name);
 	v->setSubstrate (s);
 	def->env->addVariable (v);
       }
@@ -221,7 +236,7 @@ void input::factory (void) {
     // handle nodeset definitions
     else if (!def->action && def->nodeset) {
       n = new nodeset ();
-      n->setName (def->nodes->node);
+      n->setName (netlist_node_name (def, def->nodes));
       n->setValue (def->pairs->value->value);
       subnet->addNodeset (n);
       // remove this definition from the list
@@ -237,7 +252,7 @@ void input::factory (void) {
       c = createCircuit (def->type);
       assert (c != NULL);
       o = (object *) c;
-      c->setName (def->instance);
+      c->setName (netlist_instance_name (def));
       c->setNonLinear (def->nonlinear != 0);
       c->setSubcircuit (def->subcircuit == nullptr ? "" : def->subcircuit);
 
@@ -248,7 +263,7 @@ void input::factory (void) {
       // add appropriate nodes to circuit
       for (i = 0, nodes = def->nodes; nodes; nodes = nodes->next, i++)
 	if (i < c->getSize ())
-	  c->setNode (i, nodes->node);
+	  c->setNode (i, netlist_node_name (def, nodes));
 
       // add the properties to circuit
       for (pairs = def->pairs; pairs != NULL; pairs = pairs->next) {
@@ -184,6 +184,7 @@ int e_trsolver::init (nr_double_t start, nr_double_t firstdelta, int mode)
 
     int error = 0;
     const char * const solver = getPropertyString ("Solver");
+    setThreads (getPropertyInteger ("Threads"));
     relaxTSR = !strcmp (getPropertyString ("relaxTSR"), "yes") ? true : false;
     initialDC = !strcmp (getPropertyString ("initialDC"), "yes") ? true : false;
     // fetch simulation properties
@@ -211,6 +212,8 @@ int e_trsolver::init (nr_double_t start, nr_double_t firstdelta, int mode)
         eqnAlgo = ALGO_QR_DECOMPOSITION_LS;
     else if (!strcmp (solver, "GolubSVD"))
         eqnAlgo = ALGO_SV_DECOMPOSITION;
+    else if (!strcmp (solver, "SparseLU"))
+        eqnAlgo = ALGO_SPARSE_LU_DECOMPOSITION;
 
     // Perform initial DC analysis.
     if (initialDC)
@@ -492,7 +495,7 @@ int e_trsolver::stepsolve_sync(nr_double_t synctime)
     if (error) return -1;
 
     // check whether Jacobian matrix is still non-singular
-    if (!A->isFinite ())
+    if (!isJacobianFinite ())
     {
 //        messagefcn (LOG_ERROR, "ERROR: %s: Jacobian singular at t = %.3e, "
 //                  "aborting %s analysis\n", getName (), (double) current,
@@ -728,7 +731,7 @@ int e_trsolver::stepsolve_async(nr_double_t steptime)
         if (rejected) continue;
 
         // check whether Jacobian matrix is still non-singular
-        if (!A->isFinite ())
+        if (!isJacobianFinite ())
         {
             messagefcn (LOG_ERROR, "ERROR: %s: Jacobian singular at t = %.3e, "
                       "aborting %s analysis\n", getName (), (double) current,
@@ -899,19 +902,21 @@ int e_trsolver::getNodeV (char * label, nr_double_t& nodeV)
     }
 }
 
-/* Get the voltage reported by a voltage probe */
-int e_trsolver::getVProbeV (char * probename, nr_double_t& probeV)
+/* Looks for the circuit of the given type and name.  Subcircuit
+   elements are found by the name within the subcircuit prefixed by
+   the subcircuit type.  Returns NULL if there is no such circuit. */
+circuit * e_trsolver::findCircuit (int type, const char * name)
 {
     // string to hold the full name of the circuit
     std::string fullname;
 
     // check for NULL name
-    if (probename)
+    if (name)
     {
         circuit * root = subnet->getRoot ();
         for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
         {
-            if (c->getType () == CIR_VPROBE) {
+            if (c->getType () == type) {
 
                 fullname.clear ();
 
@@ -925,107 +930,142 @@ int e_trsolver::getVProbeV (char * probename, nr_double_t& probeV)
                 }
 
                 // append the user supplied name to search for
-                fullname.append (probename);
+                fullname.append (name);
 
-                // Check if it is the desired voltage source
+                // Check if it is the desired circuit
                 if (strcmp (fullname.c_str(), c->getName ()) == 0)
                 {
-                    // Saves the real and imaginary voltages in the probe to the
-                    // named variables Vr and Vi
-                    c->saveOperatingPoints ();
-                    // We are only interested in the real part for transient
-                    // analysis
-                    probeV = c->getOperatingPoint ("Vr");
-
-                    return 0;
+                    return c;
                 }
             }
         }
     }
-    return -1;
+    return NULL;
+}
+
+/* Get the voltage reported by a voltage probe */
+int e_trsolver::getVProbeV (char * probename, nr_double_t& probeV)
+{
+    circuit * c = findCircuit (CIR_VPROBE, probename);
+    if (c == NULL) return -1;
+
+    // Saves the real and imaginary voltages in the probe to the
+    // named variables Vr and Vi
+    c->saveOperatingPoints ();
+    // We are only interested in the real part for transient
+    // analysis
+    probeV = c->getOperatingPoint ("Vr");
+    return 0;
 }
 
 /* Get the current reported by a current probe */
 int e_trsolver::getIProbeI (char * probename, nr_double_t& probeI)
 {
-    // string to hold the full name of the circuit
-    std::string fullname;
+    circuit * c = findCircuit (CIR_IPROBE, probename);
+    if (c == NULL) return -1;
 
-    // check for NULL name
-    if (probename)
-    {
-        circuit * root = subnet->getRoot ();
-        for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
-        {
-            if (c->getType () == CIR_IPROBE) {
-
-                fullname.clear ();
+    // Get the current reported by the probe
+    probeI = real (x->get (c->getVoltageSource () + getN ()));
+    return 0;
+}
 
-                // Subcircuit elements top level name is the
-                // subcircuit type (the base name of the subcircuit
-                // file)
-                if (!c->getSubcircuit ().empty())
-                {
-                    fullname.append (c->getSubcircuit ());
-                    fullname.append (".");
-                }
+int e_trsolver::setECVSVoltage(char * ecvsname, nr_double_t V)
+{
+    circuit * c = findCircuit (CIR_ECVS, ecvsname);
+    if (c == NULL) return -1;
 
-                // append the user supplied name to search for
-                fullname.append (probename);
+    // Set the voltage to the desired value
+    c->setProperty("U", V);
+    return 0;
+}
 
-                // Check if it is the desired voltage source
-                if (strcmp (fullname.c_str(), c->getName ()) == 0)
-                {
-                    // Get the current reported by the probe
-                    probeI = real (x->get (c->getVoltageSource () + getN ()));
+/* Resolves the name of a node, probe or ecvs once, so that its value
+   can be accessed by the returned handle without looking it up again.
+   Returns -1 if there is no such quantity. */
+int e_trsolver::getHandle (int type, char * name)
+{
+    handle_t h;
+    h.type = type;
+    h.node = -1;
+    h.c = NULL;
 
-                    return 0;
-                }
-            }
-        }
+    switch (type)
+    {
+    case ETR_HANDLE_NODE_V:
+        if (name == NULL || (h.node = nlist->getNodeNr (name)) == -1)
+            return -1;
+        break;
+    case ETR_HANDLE_VPROBE_V:
+        h.c = findCircuit (CIR_VPROBE, name);
+        break;
+    case ETR_HANDLE_IPROBE_I:
+        h.c = findCircuit (CIR_IPROBE, name);
+        break;
+    case ETR_HANDLE_ECVS_V:
+        h.c = findCircuit (CIR_ECVS, name);
+        break;
+    default:
+        return -1;
     }
-    return -1;
+    if (type != ETR_HANDLE_NODE_V && h.c == NULL)
+        return -1;
+
+    handles.push_back (h);
+    return (int) handles.size () - 1;
 }
 
-int e_trsolver::setECVSVoltage(char * ecvsname, nr_double_t V)
+// Returns the current value of the quantity given by the handle.
+nr_double_t e_trsolver::getHandleValue (const handle_t & h)
 {
-    // string to hold the full name of the circuit
-    std::string fullname;
+    switch (h.type)
+    {
+    case ETR_HANDLE_NODE_V:
+        return x->get (h.node);
+    case ETR_HANDLE_VPROBE_V:
+        h.c->saveOperatingPoints ();
+        return h.c->getOperatingPoint ("Vr");
+    case ETR_HANDLE_IPROBE_I:
+        return real (x->get (h.c->getVoltageSource () + getN ()));
+    case ETR_HANDLE_ECVS_V:
+        return h.c->getPropertyDouble ("U");
+    }
+    return 0.0;
+}
 
-    // check for NULL name
-    if (ecvsname)
+/* Obtains the values of the quantities given by the array of handles.
+   Returns -1 if a handle is invalid, 0 otherwise. */
+int e_trsolver::getValues (const int * h, int n, nr_double_t * values)
+{
+    int ret = 0;
+    for (int i = 0; i < n; i++)
     {
-        circuit * root = subnet->getRoot ();
-        for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
+        if (h[i] < 0 || h[i] >= (int) handles.size ())
         {
-            // examine only ECVS elements
-            if (c->getType () == CIR_ECVS) {
-
-                fullname.clear ();
-
-                // Subcircuit elements top level name is the
-                // subcircuit type (the base name of the subcircuit
-                // file)
-                if (!c->getSubcircuit ().empty())
-                {
-                    fullname.append (c->getSubcircuit ());
-                    fullname.append (".");
-                }
-
-                // append the user supplied name to search for
-                fullname.append (ecvsname);
+            ret = -1;
+            continue;
+        }
+        values[i] = getHandleValue (handles[h[i]]);
+    }
+    return ret;
+}
 
-                // Check if it is the desired voltage source
-                if (strcmp (fullname.c_str(), c->getName ()) == 0)
-                {
-                    // Set the voltage to the desired value
-                    c->setProperty("U", V);
-                    return 0;
-                }
-            }
+/* Sets the voltages of the ecvs components given by the array of
+   handles.  Returns -1 if a handle is not a valid ecvs handle, 0
+   otherwise. */
+int e_trsolver::setValues (const int * h, int n, const nr_double_t * values)
+{
+    int ret = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (h[i] < 0 || h[i] >= (int) handles.size () ||
+            handles[h[i]].type != ETR_HANDLE_ECVS_V)
+        {
+            ret = -1;
+            continue;
         }
+        handles[h[i]].c->setProperty ("U", values[i]);
     }
-    return -1;
+    return ret;
 }
 
 void e_trsolver::updateExternalInterpTime(nr_double_t t)
@@ -1060,17 +1100,43 @@ void e_trsolver::truncateHistory (nr_double_t t)
 
 int e_trsolver::getJacRows()
 {
-    return A->getRows();
+    return As ? As->getRows() : A->getRows();
 }
 
 int e_trsolver::getJacCols()
 {
-    return A->getCols();
+    return As ? As->getCols() : A->getCols();
 }
 
 void e_trsolver::getJacData(int r, int c, nr_double_t& data)
 {
-    data = A->get(r,c);
+    data = As ? As->get(r,c) : A->get(r,c);
+}
+
+/* Returns the solution vector, i.e. the node voltages followed by the
+   branch currents, without copying it. */
+const nr_double_t * e_trsolver::getSolutionView (void)
+{
+    return x ? x->getData () : NULL;
+}
+
+/* Gives access to the values of the Jacobian matrix without copying
+   them.  A sparse matrix is handed out in compressed sparse column
+   format, otherwise all values row by row.  Returns the number of
+   values. */
+int e_trsolver::getJacView (const nr_double_t *& values, const int *& colptr,
+                            const int *& rowidx)
+{
+    if (As)
+    {
+        values = As->getData ();
+        colptr = As->getColPtr ();
+        rowidx = As->getRowIdx ();
+        return As->getNonZeros ();
+    }
+    values = A ? A->getData () : NULL;
+    colptr = rowidx = NULL;
+    return A ? A->getRows () * A->getCols () : 0;
 }
 
 // properties
@@ -1097,6 +1163,7 @@ PROP_OPT [] =
     { "LTEfactor", PROP_REAL, { 1, PROP_NO_STR }, PROP_RNGII (1, 16) },
     { "Temp", PROP_REAL, { 26.85, PROP_NO_STR }, PROP_MIN_VAL (K) },
     { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" }, PROP_RNG_SOL },
+    { "Threads", PROP_INT, { 1, PROP_NO_STR }, PROP_RNGII (0, 256) },
     { "relaxTSR", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
     { "initialDC", PROP_STR, { PROP_NO_VAL, "yes" }, PROP_RNG_YESNO },
     PROP_NO_PROP
@@ -148,6 +148,31 @@ public:
       */
     int getIProbeI (char * probename, nr_double_t& probeI);
 
+    /** \brief Resolves the name of a quantity to a handle
+      * \param type One of the ETR_HANDLE_TYPE values
+      * \param name Pointer to character array containing the name
+      * \return The handle or -1 if there is no such quantity
+      *
+      * See trsolver_interface::getHandle() for details.
+      */
+    int getHandle (int type, char * name);
+
+    /// Obtains the values of \a n quantities given by their handles.
+    int getValues (const int * handles, int n, nr_double_t * values);
+
+    /// Sets the voltages of \a n ecvs components given by their handles.
+    int setValues (const int * handles, int n, const nr_double_t * values);
+
+    /// Returns the solution vector without copying it.
+    const nr_double_t * getSolutionView (void);
+
+    /** \brief Gives direct access to the Jacobian matrix
+      *
+      * See trsolver_interface::getJacView() for details.
+      */
+    int getJacView (const nr_double_t *& values, const int *& colptr,
+                    const int *& rowidx);
+
     // debugging functions
     void debug (void);
     void printx (void);
@@ -181,6 +206,18 @@ private:
     int rejected;
     int convError;
 
+    /// A resolved quantity: its type and the node or circuit.
+    struct handle_t
+    {
+        int type;
+        int node;
+        circuit * c;
+    };
+    std::vector<handle_t> handles;
+
+    circuit * findCircuit (int type, const char * name);
+    nr_double_t getHandleValue (const handle_t &);
+
     void initETR (nr_double_t start, nr_double_t, int);
     void truncateHistory (nr_double_t);
     void updateExternalInterpTime(nr_double_t);
@@ -53,9 +53,14 @@
 #endif
 
 #include <string>
+#include <type_traits>
 
 using namespace qucs;
 
+// the views and bulk transfers hand out the solver's own arrays
+static_assert (std::is_same<nr_double_t, double>::value,
+               "nr_double_t must be double for the bulk interface");
+
 // constructor
 qucsint::qucsint ()
 {
@@ -308,6 +313,38 @@ int trsolver_interface::getJacData (int r, int c, double& data)
     }
 }
 
+int trsolver_interface::getHandle (int type, char * name)
+{
+    if (etr) return etr->getHandle (type, name);
+    else return -2;
+}
+
+int trsolver_interface::getValues (const int * handles, int n, double * values)
+{
+    if (etr) return etr->getValues (handles, n, values);
+    else return -2;
+}
+
+int trsolver_interface::setValues (const int * handles, int n,
+                                   const double * values)
+{
+    if (etr) return etr->setValues (handles, n, values);
+    else return -2;
+}
+
+const double * trsolver_interface::getSolutionView (void)
+{
+    if (etr) return etr->getSolutionView ();
+    else return NULL;
+}
+
+int trsolver_interface::getJacView (const double *& values,
+                                    const int *& colptr, const int *& rowidx)
+{
+    if (etr) return etr->getJacView (values, colptr, rowidx);
+    else return -2;
+}
+
 int trsolver_interface::getNodeV (char * label, double& nodeV)
 {
     if (etr)
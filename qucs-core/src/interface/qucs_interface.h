@@ -95,6 +95,12 @@ protected:
 
 enum ETR_MODE { ETR_MODE_ASYNC, ETR_MODE_SYNC };
 
+/// Kinds of quantities accessible through handles, see getHandle().
+enum ETR_HANDLE_TYPE { ETR_HANDLE_NODE_V,
+                       ETR_HANDLE_VPROBE_V,
+                       ETR_HANDLE_IPROBE_I,
+                       ETR_HANDLE_ECVS_V };
+
 /** \class trsolver_interface
   * \brief subclass for interfacing to the Qucs transient circuit solvers.
   *
@@ -201,6 +207,68 @@ public:
       */
     int getIProbeI (char * probename, double& probeI);
 
+    /** \brief Resolves the name of a quantity to a handle
+      * \param type One of the ETR_HANDLE_TYPE values
+      * \param name Pointer to character array containing the name of the
+      * node, probe or ecvs
+      * \return The handle (zero or positive) or -1 if there is no such
+      * quantity
+      *
+      * The names are looked up the same way as in getNodeV(),
+      * getVProbeV(), getIProbeI() and setECVSVoltage(). Resolve the
+      * names once after init() and use the handles with getValues()
+      * and setValues() at every time step.
+      */
+    int getHandle (int type, char * name);
+
+    /** \brief Obtains the values of several quantities at once
+      * \param handles Array of \a n handles
+      * \param n Number of handles
+      * \param values Array receiving the \a n values
+      * \return Integer flag reporting success or failure
+      *
+      * Returns 0 on success and -1 if one of the handles is invalid.
+      * The values of ecvs handles are their voltages to be set.
+      */
+    int getValues (const int * handles, int n, double * values);
+
+    /** \brief Sets the voltages of several ecvs components at once
+      * \param handles Array of \a n ecvs handles
+      * \param n Number of handles
+      * \param values Array of the \a n new voltages
+      * \return Integer flag reporting success or failure
+      *
+      * Returns 0 on success and -1 if one of the handles is not a
+      * valid ecvs handle.
+      */
+    int setValues (const int * handles, int n, const double * values);
+
+    /** \brief Gives direct access to the solution vector
+      * \return Pointer to the getN() + getM() values of the solution
+      *
+      * The returned array is the solver's own solution vector, i.e.
+      * what getsolution() copies. It changes with every time step and
+      * is valid as long as the solver exists.
+      */
+    const double * getSolutionView (void);
+
+    /** \brief Gives direct access to the Jacobian matrix
+      * \param values Receives the pointer to the matrix values
+      * \param colptr Receives the column pointers of a sparse matrix
+      * \param rowidx Receives the row indices of a sparse matrix
+      * \return The number of values, -2 without solver
+      *
+      * If the Jacobian is a sparse matrix it is stored in compressed
+      * sparse column format: the values of column c are
+      * values[colptr[c]] up to values[colptr[c+1]-1] located in the rows
+      * rowidx[colptr[c]] and so on. Otherwise \a colptr and \a rowidx
+      * are set to NULL and \a values holds the getJacRows() times
+      * getJacCols() values row by row. The data is what getJacData()
+      * returns.
+      */
+    int getJacView (const double *& values, const int *& colptr,
+                    const int *& rowidx);
+
     /** \brief Sets pointer to function used to print messages during a sim
       * \param printing function to be used by e_trsolver
       *
@@ -90,6 +90,7 @@
 #include <cstdlib>
 #include <string.h>
 #include <cmath>
+#include <utility>
 
 #include "logging.h"
 #include "object.h"
@@ -179,6 +180,36 @@ const matrix& matrix::operator=(const matrix & m) {
   return *this;
 }
 
+/*!\brief Move constructor
+
+   The move constructor takes over the elements of the given matrix
+   object and leaves it empty.
+*/
+matrix::matrix (matrix && m) {
+  rows = m.rows;
+  cols = m.cols;
+  data = m.data;
+  m.rows = m.cols = 0;
+  m.data = NULL;
+}
+
+/*!\brief Move assignment operator
+
+  \param[in] m object to take the elements from
+  \return assigned object
+*/
+matrix& matrix::operator=(matrix && m) {
+  if (&m != this) {
+    delete[] data;
+    rows = m.rows;
+    cols = m.cols;
+    data = m.data;
+    m.rows = m.cols = 0;
+    m.data = NULL;
+  }
+  return *this;
+}
+
 /*!\brief Destructor
 
    Destructor deletes a matrix object.
@@ -193,7 +224,7 @@ matrix::~matrix () {
    \todo Why not inline and synonymous of ()
    \todo c and r const
 */
-nr_complex_t matrix::get (int r, int c) {
+nr_complex_t matrix::get (int r, int c) const {
   return data[r * cols + c];
 }
 
@@ -225,30 +256,21 @@ void matrix::print (void) {
    \param[a] first matrix
    \param[b] second matrix
    \note assert same size
-   \todo a and b are const
+   \note the first matrix is taken by value, thus the result of a
+         preceding operation is reused
 */
-matrix operator + (matrix a, matrix b) {
-  assert (a.getRows () == b.getRows () && a.getCols () == b.getCols ());
-
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) + b.get (r, c));
-  return res;
+matrix operator + (matrix a, const matrix & b) {
+  a += b;
+  return a;
 }
 
 /*!\brief Intrinsic matrix addition.
    \param[in] a matrix to add
    \note assert same size
-   \todo a is const
 */
-matrix matrix::operator += (matrix a) {
+matrix & matrix::operator += (const matrix & a) {
   assert (a.getRows () == rows && a.getCols () == cols);
-
-  int r, c, i;
-  for (i = 0, r = 0; r < a.getRows (); r++)
-    for (c = 0; c < a.getCols (); c++, i++)
-      data[i] += a.get (r, c);
+  for (int i = 0; i < rows * cols; i++) data[i] += a.data[i];
   return *this;
 }
 
@@ -256,25 +278,16 @@ matrix matrix::operator += (matrix a) {
    \param[a] first matrix
    \param[b] second matrix
    \note assert same size
-   \todo a and b are const
 */
-matrix operator - (matrix a, matrix b) {
-  assert (a.getRows () == b.getRows () && a.getCols () == b.getCols ());
-
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) - b.get (r, c));
-  return res;
+matrix operator - (matrix a, const matrix & b) {
+  a -= b;
+  return a;
 }
 
 /*!\brief Unary minus. */
-matrix matrix::operator - () {
+matrix matrix::operator - () const {
   matrix res (getRows (), getCols ());
-  int r, c, i;
-  for (i = 0, r = 0; r < getRows (); r++)
-    for (c = 0; c < getCols (); c++, i++)
-      res.set (r, c, -data[i]);
+  for (int i = 0; i < rows * cols; i++) res.data[i] = -data[i];
   return res;
 }
 
@@ -282,12 +295,9 @@ matrix matrix::operator - () {
    \param[in] a matrix to substract
    \note assert same size
 */
-matrix matrix::operator -= (matrix a) {
+matrix & matrix::operator -= (const matrix & a) {
   assert (a.getRows () == rows && a.getCols () == cols);
-  int r, c, i;
-  for (i = 0, r = 0; r < a.getRows (); r++)
-    for (c = 0; c < a.getCols (); c++, i++)
-      data[i] -= a.get (r, c);
+  for (int i = 0; i < rows * cols; i++) data[i] -= a.data[i];
   return *this;
 }
 
@@ -295,78 +305,58 @@ matrix matrix::operator -= (matrix a) {
    \param[in] a matrix to scale
    \param[in] z scaling complex
    \return Scaled matrix
-   \todo Why not a and z const
 */
 matrix operator * (matrix a, nr_complex_t z) {
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) * z);
-  return res;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] *= z;
+  return a;
 }
 
 /*!\brief Matrix scaling complex version (different order)
    \param[in] a matrix to scale
    \param[in] z scaling complex
    \return Scaled matrix
-   \todo Why not a and z const
-   \todo Why not inline
 */
 matrix operator * (nr_complex_t z, matrix a) {
-  return a * z;
+  return std::move (a) * z;
 }
 
 /*!\brief Matrix scaling complex version
    \param[in] a matrix to scale
    \param[in] d scaling real
    \return Scaled matrix
-   \todo Why not d and a const
 */
 matrix operator * (matrix a, nr_double_t d) {
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) * d);
-  return res;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] *= d;
+  return a;
 }
 
 /*!\brief Matrix scaling real version (different order)
    \param[in] a matrix to scale
    \param[in] d scaling real
    \return Scaled matrix
-   \todo Why not inline?
-   \todo Why not d and a const
 */
 matrix operator * (nr_double_t d, matrix a) {
-  return a * d;
+  return std::move (a) * d;
 }
 
 /*!\brief Matrix scaling division by complex version
    \param[in] a matrix to scale
    \param[in] z scaling complex
    \return Scaled matrix
-   \todo Why not a and z const
 */
 matrix operator / (matrix a, nr_complex_t z) {
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) / z);
-  return res;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] /= z;
+  return a;
 }
 
 /*!\brief Matrix scaling division by real version
    \param[in] a matrix to scale
    \param[in] d scaling real
    \return Scaled matrix
-   \todo Why not a and d const
 */
 matrix operator / (matrix a, nr_double_t d) {
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) / d);
-  return res;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] /= d;
+  return a;
 }
 
 /*! Matrix multiplication.
@@ -375,9 +365,8 @@ matrix operator / (matrix a, nr_double_t d) {
     \param[a] first matrix
     \param[b] second matrix
     \note assert compatibility
-    \todo a and b are const
 */
-matrix operator * (matrix a, matrix b) {
+matrix operator * (const matrix & a, const matrix & b) {
   assert (a.getCols () == b.getRows ());
 
   int r, c, i, n = a.getCols ();
@@ -385,8 +374,8 @@ matrix operator * (matrix a, matrix b) {
   matrix res (a.getRows (), b.getCols ());
   for (r = 0; r < a.getRows (); r++) {
     for (c = 0; c < b.getCols (); c++) {
-      for (i = 0, z = 0; i < n; i++) z += a.get (r, i) * b.get (i, c);
-      res.set (r, c, z);
+      for (i = 0, z = 0; i < n; i++) z += a (r, i) * b (i, c);
+      res (r, c) = z;
     }
   }
   return res;
@@ -396,102 +385,83 @@ matrix operator * (matrix a, matrix b) {
    \param[in] a matrix
    \param[in] z complex to add
    \todo Move near other +
-   \todo a and z are const
 */
 matrix operator + (matrix a, nr_complex_t z) {
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) + z);
-  return res;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] += z;
+  return a;
 }
 
 /*!\brief Complex scalar addition different order.
    \param[in] a matrix
    \param[in] z complex to add
    \todo Move near other +
-   \todo a and z are const
-   \todo Why not inline
 */
 matrix operator + (nr_complex_t z, matrix a) {
-  return a + z;
+  return std::move (a) + z;
 }
 
 /*!\brief Real scalar addition.
    \param[in] a matrix
    \param[in] d real to add
    \todo Move near other +
-   \todo a and d are const
 */
 matrix operator + (matrix a, nr_double_t d) {
-  matrix res (a.getRows (), a.getCols ());
-  for (int r = 0; r < a.getRows (); r++)
-    for (int c = 0; c < a.getCols (); c++)
-      res.set (r, c, a.get (r, c) + d);
-  return res;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] += d;
+  return a;
 }
 
 /*!\brief Real scalar addition different order.
    \param[in] a matrix
    \param[in] d real to add
    \todo Move near other +
-   \todo a and d are const
-   \todo Why not inline
 */
 matrix operator + (nr_double_t d, matrix a) {
-  return a + d;
+  return std::move (a) + d;
 }
 
 /*!\brief Complex scalar substraction
    \param[in] a matrix
    \param[in] z complex to add
    \todo Move near other +
-   \todo a and z are const
-   \todo Why not inline
 */
 matrix operator - (matrix a, nr_complex_t z) {
-  return -z + a;
+  return -z + std::move (a);
 }
 
 /*!\brief Complex scalar substraction different order
    \param[in] a matrix
    \param[in] z complex to add
    \todo Move near other +
-   \todo a and z are const
-   \todo Why not inline
 */
 matrix operator - (nr_complex_t z, matrix a) {
-  return -a + z;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] = -a.data[i] + z;
+  return a;
 }
 
 /*!\brief Real scalar substraction
    \param[in] a matrix
    \param[in] z real to add
    \todo Move near other +
-   \todo a and z are const
-   \todo Why not inline
 */
 matrix operator - (matrix a, nr_double_t d) {
-  return -d + a;
+  return -d + std::move (a);
 }
 
 /*!\brief Real scalar substraction different order
    \param[in] a matrix
    \param[in] z real to add
    \todo Move near other +
-   \todo a and z are const
-   \todo Why not inline
 */
 matrix operator - (nr_double_t d, matrix a) {
-  return -a + d;
+  for (int i = 0; i < a.rows * a.cols; i++) a.data[i] = -a.data[i] + d;
+  return a;
 }
 
 /*!\brief Matrix transposition
    \param[in] a Matrix to transpose
    \todo add transpose in place
-   \todo a is const
 */
-matrix transpose (matrix a) {
+matrix transpose (const matrix & a) {
   matrix res (a.getCols (), a.getRows ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -502,9 +472,8 @@ matrix transpose (matrix a) {
 /*!\brief Conjugate complex matrix.
   \param[in] a Matrix to conjugate
   \todo add conj in place
-  \todo a is const
 */
-matrix conj (matrix a) {
+matrix conj (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -519,18 +488,16 @@ matrix conj (matrix a) {
    \param[in] a Matrix to transpose
    \todo add adjoint in place
    \todo Do not lazy and avoid conj and transpose copy
-   \todo a is const
 */
-matrix adjoint (matrix a) {
+matrix adjoint (const matrix & a) {
   return transpose (conj (a));
 }
 
 /*!\brief Computes magnitude of each matrix element.
    \param[in] a matrix
    \todo add abs in place
-   \todo a is const
 */
-matrix abs (matrix a) {
+matrix abs (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -541,7 +508,7 @@ matrix abs (matrix a) {
 /*!\brief Computes magnitude in dB of each matrix element.
    \param[in] a matrix
 */
-matrix dB (matrix a) {
+matrix dB (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -552,9 +519,8 @@ matrix dB (matrix a) {
 /*!\brief Computes the argument of each matrix element.
    \param[in] a matrix
    \todo add arg in place
-   \todo a is const
 */
-matrix arg (matrix a) {
+matrix arg (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -565,9 +531,8 @@ matrix arg (matrix a) {
 /*!\brief Real part matrix.
    \param[in] a matrix
    \todo add real in place
-   \todo a is const
 */
-matrix real (matrix a) {
+matrix real (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -578,9 +543,8 @@ matrix real (matrix a) {
 /*!\brief Imaginary part matrix.
    \param[in] a matrix
    \todo add imag in place
-   \todo a is const
 */
-matrix imag (matrix a) {
+matrix imag (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -591,7 +555,7 @@ matrix imag (matrix a) {
 /*!\brief Multiply a matrix by itself
    \param[in] a matrix
 */
-matrix sqr (matrix a) {
+matrix sqr (const matrix & a) {
   return a * a;
 }
 
@@ -621,9 +585,8 @@ matrix eye (int s) {
 
 /*!\brief Create a diagonal matrix from a vector
    \param[in] diag vector to write on the diagonal
-   \todo diag is const
 */
-matrix diagonal (qucs::vector diag) {
+matrix diagonal (const qucs::vector & diag) {
   int size = diag.getSize ();
   matrix res (size);
   for (int i = 0; i < size; i++) res (i, i) = diag (i);
@@ -656,7 +619,7 @@ matrix pow (matrix a, int n) {
    \todo #ifdef 0
    \todo static?
 */
-nr_complex_t cofactor (matrix a, int u, int v) {
+nr_complex_t cofactor (const matrix & a, int u, int v) {
   matrix res (a.getRows () - 1, a.getCols () - 1);
   int r, c, ra, ca;
   for (ra = r = 0; r < res.getRows (); r++, ra++) {
@@ -685,7 +648,7 @@ nr_complex_t cofactor (matrix a, int u, int v) {
    \todo #ifdef 0
    \todo static ?
 */
-nr_complex_t detLaplace (matrix a) {
+nr_complex_t detLaplace (const matrix & a) {
   assert (a.getRows () == a.getCols ());
   int s = a.getRows ();
   nr_complex_t res = 0;
@@ -759,9 +722,8 @@ nr_complex_t detGauss (matrix a) {
 /*!\brief Compute determinant of the given matrix.
    \param[in] a matrix
    \return Complex determinant
-   \todo a const?
 */
-nr_complex_t det (matrix a) {
+nr_complex_t det (const matrix & a) {
 #if 0
   return detLaplace (a);
 #else
@@ -775,10 +737,9 @@ nr_complex_t det (matrix a) {
   \param[in] a matrix to invert
   \todo Static?
   \bug recursive! Stack overflow
-  \todo a const?
   \todo #ifdef 0
 */
-matrix inverseLaplace (matrix a) {
+matrix inverseLaplace (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   nr_complex_t d = detLaplace (a);
   assert (abs (d) != 0); // singular matrix
@@ -792,7 +753,6 @@ matrix inverseLaplace (matrix a) {
 
    Compute inverse matrix of the given matrix by Gauss-Jordan
    elimination.
-   \todo a const?
    \todo static?
    \note assert non singulat matix
    \param[in] a matrix to invert
@@ -800,11 +760,10 @@ matrix inverseLaplace (matrix a) {
 matrix inverseGaussJordan (matrix a) {
   nr_double_t MaxPivot;
   nr_complex_t f;
-  matrix b, e;
+  matrix & b = a, e;
   int i, c, r, pivot, n = a.getCols ();
 
-  // create temporary matrix and the result matrix
-  b = matrix (a);
+  // the argument is a copy and serves as temporary matrix
   e = eye (n);
 
   // create the eye matrix in 'b' and the result in 'e'
@@ -844,16 +803,38 @@ matrix inverseGaussJordan (matrix a) {
 
 /*!\brief Compute inverse matrix
    \param[in] a matrix to invert
-   \todo a is const
 */
 matrix inverse (matrix a) {
 #if 0
   return inverseLaplace (a);
 #else
-  return inverseGaussJordan (a);
+  return inverseGaussJordan (std::move (a));
 #endif
 }
 
+/* The following helpers replace the products with the diagonal
+   matrices of the parameter conversions by a scaling of the rows or
+   columns.  This saves the O(n^3) multiplications and yields the same
+   values as the products. */
+static matrix scaleRows (const qucs::vector & v, matrix a) {
+  for (int r = 0; r < a.getRows (); r++)
+    for (int c = 0; c < a.getCols (); c++)
+      a (r, c) = v (r) * a (r, c);
+  return a;
+}
+
+static matrix scaleCols (matrix a, const qucs::vector & v) {
+  for (int r = 0; r < a.getRows (); r++)
+    for (int c = 0; c < a.getCols (); c++)
+      a (r, c) = a (r, c) * v (c);
+  return a;
+}
+
+static matrix addDiagonal (matrix a, const qucs::vector & v) {
+  for (int i = 0; i < a.getRows (); i++) a (i, i) += v (i);
+  return a;
+}
+
 /*!\brief S params to S params
 
   Convert scattering parameters with the reference impedance 'zref'
@@ -888,19 +869,18 @@ matrix inverse (matrix a) {
   \todo Correct documentation about standing waves [1-4]
   \todo Implement Speciale implementation [2-3] if applicable
   \return Renormalized scattering matrix
-  \todo s, zref and z0 const
 */
-matrix stos (matrix s, qucs::vector zref, qucs::vector z0) {
+matrix stos (const matrix & s, const qucs::vector & zref, const qucs::vector & z0) {
   int d = s.getRows ();
-  matrix e, r;
-  qucs::vector a;
+  qucs::vector r, a;
 
   assert (d == s.getCols () && d == z0.getSize () && d == zref.getSize ());
 
-  e = eye (d);
-  r = diagonal ((z0 - zref) / (z0 + zref));
+  r = (z0 - zref) / (z0 + zref);
   a = sqrt (z0 / zref) * 2 * zref / (z0 + zref);
-  return diagonal (1 / a) * (s - r) * inverse (e - r * s) * diagonal (a);
+  matrix n = addDiagonal (-scaleRows (r, s), qucs::vector (d, 1));
+  return scaleCols (scaleRows (1 / a, addDiagonal (s, -r)) *
+		    inverse (std::move (n)), a);
 }
 
 /*!\brief S renormalization with all part identic
@@ -909,9 +889,8 @@ matrix stos (matrix s, qucs::vector zref, qucs::vector z0) {
    \param[in] z0 new reference impedance
    \todo Why not inline
    \return Renormalized scattering matrix
-   \todo s, zref and z0 const
 */
-matrix stos (matrix s, nr_complex_t zref, nr_complex_t z0) {
+matrix stos (const matrix & s, nr_complex_t zref, nr_complex_t z0) {
   int d = s.getRows ();
   return stos (s, qucs::vector (d, zref), qucs::vector (d, z0));
 }
@@ -922,9 +901,8 @@ matrix stos (matrix s, nr_complex_t zref, nr_complex_t z0) {
   \param[in] z0 new reference impedance
   \todo Why not inline
   \return Renormalized scattering matrix
-  \todo s, zref and z0 const
 */
-matrix stos (matrix s, nr_double_t zref, nr_double_t z0) {
+matrix stos (const matrix & s, nr_double_t zref, nr_double_t z0) {
   return stos (s, nr_complex_t (zref, 0), nr_complex_t (z0, 0));
 }
 
@@ -934,9 +912,8 @@ matrix stos (matrix s, nr_double_t zref, nr_double_t z0) {
    \param[in] z0 new reference impedance
    \todo Why not inline
    \return Renormalized scattering matrix
-   \todo s, zref and z0 const
 */
-matrix stos (matrix s, qucs::vector zref, nr_complex_t z0) {
+matrix stos (const matrix & s, const qucs::vector & zref, nr_complex_t z0) {
   return stos (s, zref, qucs::vector (zref.getSize (), z0));
 }
 
@@ -945,10 +922,9 @@ matrix stos (matrix s, qucs::vector zref, nr_complex_t z0) {
   \param[in] zref original reference impedance
   \param[in] z0 new reference impedance
   \todo Why not inline
-  \todo s, zref and z0 const
   \return Renormalized scattering matrix
 */
-matrix stos (matrix s, nr_complex_t zref, qucs::vector z0) {
+matrix stos (const matrix & s, nr_complex_t zref, const qucs::vector & z0) {
   return stos (s, qucs::vector (z0.getSize (), zref), z0);
 }
 
@@ -971,19 +947,18 @@ matrix stos (matrix s, nr_complex_t zref, qucs::vector z0) {
   \note We could safely drop the \f$1/2\f$ in \f$F\f$ because we compute
         \f$FXF^{-1}\f$ and therefore \f$1/2\f$ will simplify.
   \bug not correct if zref is complex
-  \todo s, z0 const
   \return Impedance matrix
 */
-matrix stoz (matrix s, qucs::vector z0) {
+matrix stoz (const matrix & s, const qucs::vector & z0) {
   int d = s.getRows ();
-  matrix e, zref, gref;
+  qucs::vector g;
 
   assert (d == s.getCols () && d == z0.getSize ());
 
-  e = eye (d);
-  zref = diagonal (z0);
-  gref = diagonal (sqrt (real (1 / z0)));
-  return inverse (gref) * inverse (e - s) * (s * zref + zref) * gref;
+  g = sqrt (real (1 / z0));
+  matrix n = addDiagonal (-s, qucs::vector (d, 1));
+  return scaleCols (scaleRows (1 / g, inverse (std::move (n))) *
+		    addDiagonal (scaleCols (s, z0), z0), g);
 }
 
 /*!\brief Scattering parameters to impedance matrix identic case
@@ -991,9 +966,8 @@ matrix stoz (matrix s, qucs::vector z0) {
    \param[in] z0 Normalisation impedance
    \return Impedance matrix
    \todo Why not inline?
-   \todo s and z0 const?
 */
-matrix stoz (matrix s, nr_complex_t z0) {
+matrix stoz (const matrix & s, nr_complex_t z0) {
   return stoz (s, qucs::vector (s.getRows (), z0));
 }
 
@@ -1017,18 +991,16 @@ matrix stoz (matrix s, nr_complex_t z0) {
   \note We could safely drop the \f$1/2\f$ in \f$F\f$ because we compute
         \f$FXF^{-1}\f$ and therefore \f$1/2\f$ will simplify.
   \bug not correct if zref is complex
-  \todo z and z0 const?
 */
-matrix ztos (matrix z, qucs::vector z0) {
+matrix ztos (const matrix & z, const qucs::vector & z0) {
   int d = z.getRows ();
-  matrix e, zref, gref;
+  qucs::vector g;
 
   assert (d == z.getCols () && d == z0.getSize ());
 
-  e = eye (d);
-  zref = diagonal (z0);
-  gref = diagonal (sqrt (real (1 / z0)));
-  return gref * (z - zref) * inverse (z + zref) * inverse (gref);
+  g = sqrt (real (1 / z0));
+  return scaleCols (scaleRows (g, addDiagonal (z, -z0)) *
+		    inverse (addDiagonal (z, z0)), 1 / g);
 }
 
 /*!\brief Convert impedance matrix to scattering parameters identic case
@@ -1036,9 +1008,8 @@ matrix ztos (matrix z, qucs::vector z0) {
    \param[in] z0 Normalisation impedance
    \return Scattering matrix
    \todo Why not inline
-   \todo z and z0 const
  */
-matrix ztos (matrix z, nr_complex_t z0) {
+matrix ztos (const matrix & z, nr_complex_t z0) {
   return ztos (z, qucs::vector (z.getRows (), z0));
 }
 
@@ -1049,9 +1020,8 @@ matrix ztos (matrix z, nr_complex_t z0) {
    \param[in] z impedance matrix
    \return Admittance matrix
    \todo Why not inline
-   \todo z const
 */
-matrix ztoy (matrix z) {
+matrix ztoy (const matrix & z) {
   assert (z.getRows () == z.getCols ());
   return inverse (z);
 }
@@ -1080,19 +1050,19 @@ matrix ztoy (matrix z) {
   \note We could safely drop the \f$1/2\f$ in \f$F\f$ because we compute
         \f$FXF^{-1}\f$ and therefore \f$1/2\f$ will simplify.
   \bug not correct if zref is complex
-  \todo s and z0 const
   \return Admittance matrix
 */
-matrix stoy (matrix s, qucs::vector z0) {
+matrix stoy (const matrix & s, const qucs::vector & z0) {
   int d = s.getRows ();
-  matrix e, zref, gref;
+  qucs::vector g;
 
   assert (d == s.getCols () && d == z0.getSize ());
 
-  e = eye (d);
-  zref = diagonal (z0);
-  gref = diagonal (sqrt (real (1 / z0)));
-  return inverse (gref) * inverse (s * zref + zref) * (e - s) * gref;
+  g = sqrt (real (1 / z0));
+  matrix n = addDiagonal (-s, qucs::vector (d, 1));
+  return scaleCols (scaleRows (1 / g,
+			       inverse (addDiagonal (scaleCols (s, z0), z0))) *
+		    n, g);
 }
 
 /*!\brief Convert scattering pto adminttance parameters identic case
@@ -1100,9 +1070,8 @@ matrix stoy (matrix s, qucs::vector z0) {
    \param[in] z0 Normalisation impedance
    \return Admittance matrix
    \todo Why not inline
-   \todo s and z0 const
  */
-matrix stoy (matrix s, nr_complex_t z0) {
+matrix stoy (const matrix & s, nr_complex_t z0) {
   return stoy (s, qucs::vector (s.getRows (), z0));
 }
 
@@ -1131,28 +1100,26 @@ matrix stoy (matrix s, nr_complex_t z0) {
    \note We could safely drop the \f$1/2\f$ in \f$F\f$ because we compute
          \f$FXF^{-1}\f$ and therefore \f$1/2\f$ will simplify.
    \bug not correct if zref is complex
-   \todo why not y and z0 const
    \return Scattering matrix
 */
-matrix ytos (matrix y, qucs::vector z0) {
+matrix ytos (const matrix & y, const qucs::vector & z0) {
   int d = y.getRows ();
-  matrix e, zref, gref;
+  qucs::vector g, one (d, 1);
 
   assert (d == y.getCols () && d == z0.getSize ());
 
-  e = eye (d);
-  zref = diagonal (z0);
-  gref = diagonal (sqrt (real (1 / z0)));
-  return gref * (e - zref * y) * inverse (e + zref * y) * inverse (gref);
+  g = sqrt (real (1 / z0));
+  matrix zy = scaleRows (z0, y);
+  return scaleCols (scaleRows (g, addDiagonal (-zy, one)) *
+		    inverse (addDiagonal (zy, one)), 1 / g);
 }
 /*!\brief Convert Admittance matrix to scattering parameters identic case
    \param[in] y Admittance matrix
    \param[in] z0 Normalisation impedance
    \return Scattering matrix
    \todo Why not inline
-   \todo y and z0 const
  */
-matrix ytos (matrix y, nr_complex_t z0) {
+matrix ytos (const matrix & y, nr_complex_t z0) {
   return ytos (y, qucs::vector (y.getRows (), z0));
 }
 /*!\brief Converts chain matrix to scattering parameters.
@@ -1180,9 +1147,8 @@ matrix ytos (matrix y, nr_complex_t z0) {
     \param[in] z2 impedance at input 2
     \return Chain matrix
     \note Assert 2 by 2 matrix
-    \todo Why not s,z1,z2 const
 */
-matrix stoa (matrix s, nr_complex_t z1, nr_complex_t z2) {
+matrix stoa (const matrix & s, nr_complex_t z1, nr_complex_t z2) {
   nr_complex_t d = s (0, 0) * s (1, 1) - s (0, 1) * s (1, 0);
   nr_complex_t n = 2.0 * s (1, 0) * sqrt (fabs (real (z1) * real (z2)));
   matrix a (2);
@@ -1221,9 +1187,8 @@ matrix stoa (matrix s, nr_complex_t z1, nr_complex_t z2) {
     \param[in] z2 impedance at input 2
     \return Scattering matrix
     \bug Do not use fabs
-    \todo a, z1, z2 const
 */
-matrix atos (matrix a, nr_complex_t z1, nr_complex_t z2) {
+matrix atos (const matrix & a, nr_complex_t z1, nr_complex_t z2) {
   nr_complex_t d = 2.0 * sqrt (fabs (real (z1) * real (z2)));
   nr_complex_t n = a (0, 0) * z2 + a (0, 1) +
     a (1, 0) * z1 * z2 + a (1, 1) * z1;
@@ -1268,9 +1233,8 @@ matrix atos (matrix a, nr_complex_t z1, nr_complex_t z2) {
     \param[in] z2 impedance at input 2
     \return hybrid matrix
     \note Assert 2 by 2 matrix
-    \todo Why not s,z1,z2 const
  */
-matrix stoh (matrix s, nr_complex_t z1, nr_complex_t z2) {
+matrix stoh (const matrix & s, nr_complex_t z1, nr_complex_t z2) {
   nr_complex_t n = s (0, 1) * s (1, 0);
   nr_complex_t d = (1.0 - s (0, 0)) * (1.0 + s (1, 1)) + n;
   matrix h (2);
@@ -1306,9 +1270,8 @@ matrix stoh (matrix s, nr_complex_t z1, nr_complex_t z2) {
    \param[in] z2 impedance at input 2
    \return scattering matrix
    \note Assert 2 by 2 matrix
-   \todo Why not h,z1,z2 const
 */
-matrix htos (matrix h, nr_complex_t z1, nr_complex_t z2) {
+matrix htos (const matrix & h, nr_complex_t z1, nr_complex_t z2) {
   nr_complex_t n = h (0, 1) * h (1, 0);
   nr_complex_t d = (1.0 + h (0, 0) / z1) * (1.0 + z2 * h (1, 1)) - n;
   matrix s (2);
@@ -1330,9 +1293,8 @@ matrix htos (matrix h, nr_complex_t z1, nr_complex_t z2) {
   \param[in] z2 impedance at input 2
   \return second hybrid matrix
   \note Assert 2 by 2 matrix
-  \todo Why not s,z1,z2 const
 */
-matrix stog (matrix s, nr_complex_t z1, nr_complex_t z2) {
+matrix stog (const matrix & s, nr_complex_t z1, nr_complex_t z2) {
   nr_complex_t n = s (0, 1) * s (1, 0);
   nr_complex_t d = (1.0 + s (0, 0)) * (1.0 - s (1, 1)) + n;
   matrix g (2);
@@ -1354,9 +1316,8 @@ matrix stog (matrix s, nr_complex_t z1, nr_complex_t z2) {
   \param[in] z2 impedance at input 2
   \return scattering matrix
   \note Assert 2 by 2 matrix
-  \todo Why not g,z1,z2 const
 */
-matrix gtos (matrix g, nr_complex_t z1, nr_complex_t z2) {
+matrix gtos (const matrix & g, nr_complex_t z1, nr_complex_t z2) {
   nr_complex_t n = g (0, 1) * g (1, 0);
   nr_complex_t d = (1.0 + g (0, 0) * z1) * (1.0 + g (1, 1) / z2) - n;
   matrix s (2);
@@ -1378,10 +1339,9 @@ matrix gtos (matrix g, nr_complex_t z1, nr_complex_t z2) {
   \return Impedance matrix
   \note Check if y matrix is a square matrix
   \todo Why not inline
-  \todo y const
   \todo move near ztoy()
 */
-matrix ytoz (matrix y) {
+matrix ytoz (const matrix & y) {
   assert (y.getRows () == y.getCols ());
   return inverse (y);
 }
@@ -1403,9 +1363,8 @@ matrix ytoz (matrix y) {
    \param[in] s S parameter matrix of device
    \return S-parameter noise correlation matrix
    \note Assert compatiblity of matrix
-   \todo cy s const
 */
-matrix cytocs (matrix cy, matrix s) {
+matrix cytocs (const matrix & cy, const matrix & s) {
   matrix e = eye (s.getRows ());
 
   assert (cy.getRows () == cy.getCols () && s.getRows () == s.getCols () &&
@@ -1429,9 +1388,8 @@ matrix cytocs (matrix cy, matrix s) {
     \param[in]  cs S parameter noise correlation
     \param[in] y Admittance matrix of device
     \return admittance noise correlation matrix
-    \todo cs, y const
 */
-matrix cstocy (matrix cs, matrix y) {
+matrix cstocy (const matrix & cs, const matrix & y) {
   matrix e = eye (y.getRows ());
 
   assert (cs.getRows () == cs.getCols () && y.getRows () == y.getCols () &&
@@ -1456,9 +1414,8 @@ matrix cstocy (matrix cs, matrix y) {
    \param[in] s S parameter matrix of device
    \return S-parameter noise correlation matrix
    \note Assert compatiblity of matrix
-   \todo cz, s const
 */
-matrix cztocs (matrix cz, matrix s) {
+matrix cztocs (const matrix & cz, const matrix & s) {
   matrix e = eye (s.getRows ());
 
   assert (cz.getRows () == cz.getCols () && s.getRows () == s.getCols () &&
@@ -1482,9 +1439,8 @@ matrix cztocs (matrix cz, matrix s) {
     \param[in]  cs S parameter noise correlation
     \param[in] z Impedance matrix of device
     \return Impedance noise correlation matrix
-    \todo cs, z const
 */
-matrix cstocz (matrix cs, matrix z) {
+matrix cstocz (const matrix & cs, const matrix & z) {
   assert (cs.getRows () == cs.getCols () && z.getRows () == z.getCols () &&
 	  cs.getRows () == z.getRows ());
   matrix e = eye (z.getRows ());
@@ -1506,9 +1462,8 @@ matrix cstocz (matrix cs, matrix z) {
     \param[in]  cz impedance noise correlation
     \param[in]  y Admittance matrix of device
     \return admittance noise correlation matrix
-    \todo cs, y const
 */
-matrix cztocy (matrix cz, matrix y) {
+matrix cztocy (const matrix & cz, const matrix & y) {
   assert (cz.getRows () == cz.getCols () && y.getRows () == y.getCols () &&
 	  cz.getRows () == y.getRows ());
 
@@ -1530,9 +1485,8 @@ matrix cztocy (matrix cz, matrix y) {
     \param[in]  cy Admittance noise correlation
     \param[in]  z Impedance matrix of device
     \return Impedance noise correlation matrix
-    \todo cs, z const
 */
-matrix cytocz (matrix cy, matrix z) {
+matrix cytocz (const matrix & cy, const matrix & z) {
   assert (cy.getRows () == cy.getCols () && z.getRows () == z.getCols () &&
 	  cy.getRows () == z.getRows ());
   return z * cy * adjoint (z);
@@ -1583,7 +1537,7 @@ void matrix::exchangeCols (int c1, int c2) {
   \param[in] q number of columns for the submatrix
   \todo check that (p+i)<rows and (q+j)<cols?
 */
-matrix matrix::getBlock(int i, int j, int p, int q) {
+matrix matrix::getBlock(int i, int j, int p, int q) const {
   matrix bm = matrix(p, q);
 
   // copy matrix elements
@@ -1601,7 +1555,7 @@ matrix matrix::getBlock(int i, int j, int p, int q) {
   \param[in] p number of rows for the submatrix
   \param[in] q number of columns for the submatrix
 */
-matrix matrix::getTopLeftCorner(int p, int q) {
+matrix matrix::getTopLeftCorner(int p, int q) const {
   return getBlock(0, 0, p, q);
 }
 
@@ -1611,7 +1565,7 @@ matrix matrix::getTopLeftCorner(int p, int q) {
   \param[in] p number of rows for the submatrix
   \param[in] q number of columns for the submatrix
 */
-matrix matrix::getBottomLeftCorner(int p, int q) {
+matrix matrix::getBottomLeftCorner(int p, int q) const {
   // bottom-left p by q block
   return getBlock(getRows()-p, 0, p, q);
 }
@@ -1622,7 +1576,7 @@ matrix matrix::getBottomLeftCorner(int p, int q) {
   \param[in] p number of rows for the submatrix
   \param[in] q number of columns for the submatrix
 */
-matrix matrix::getTopRightCorner(int p, int q) {
+matrix matrix::getTopRightCorner(int p, int q) const {
   // top-right p by q block
   return getBlock(0, getCols()-q, p, q);
 }
@@ -1633,7 +1587,7 @@ matrix matrix::getTopRightCorner(int p, int q) {
   \param[in] p number of rows for the submatrix
   \param[in] q number of columns for the submatrix
 */
-matrix matrix::getBottomRightCorner(int p, int q) {
+matrix matrix::getBottomRightCorner(int p, int q) const {
   // bottom-right p by q block
   return getBlock(getRows()-p, getCols()-q, p, q);
 }
@@ -1649,7 +1603,7 @@ matrix matrix::getBottomRightCorner(int p, int q) {
   \return matrix with assigned submatrix portion
   \todo check that (p+i)<rows and (q+j)<cols?
 */
-void matrix::setBlock(matrix m, int i, int j, int p, int q) {
+void matrix::setBlock(const matrix & m, int i, int j, int p, int q) {
   // copy matrix elements
   for (int r = 0; r < p; r++) {
     for (int c = 0; c < q; c++) {
@@ -1666,7 +1620,7 @@ void matrix::setBlock(matrix m, int i, int j, int p, int q) {
   \param[in] q number of columns to assign
   \return matrix with assigned submatrix portion
 */
-void matrix::setTopLeftCorner(matrix m, int p, int q) {
+void matrix::setTopLeftCorner(const matrix & m, int p, int q) {
   setBlock(m, 0, 0, p, q);
 }
 
@@ -1678,7 +1632,7 @@ void matrix::setTopLeftCorner(matrix m, int p, int q) {
   \param[in] q number of columns to assign
   \return matrix with assigned submatrix portion
 */
-void matrix::setBottomLeftCorner(matrix m, int p, int q) {
+void matrix::setBottomLeftCorner(const matrix & m, int p, int q) {
   setBlock(m, getRows()-p, 0, p, q);
 }
 
@@ -1690,7 +1644,7 @@ void matrix::setBottomLeftCorner(matrix m, int p, int q) {
   \param[in] q number of columns to assign
   \return matrix with assigned submatrix portion
 */
-void matrix::setTopRightCorner(matrix m, int p, int q) {
+void matrix::setTopRightCorner(const matrix & m, int p, int q) {
   setBlock(m, 0, getCols()-q, p, q);
 }
 
@@ -1702,7 +1656,7 @@ void matrix::setTopRightCorner(matrix m, int p, int q) {
   \param[in] q number of columns to assign
   \return matrix with assigned submatrix portion
 */
-void matrix::setBottomRightCorner(matrix m, int p, int q) {
+void matrix::setBottomRightCorner(const matrix & m, int p, int q) {
   setBlock(m, getRows()-p, getCols()-q, p, q);
 }
 
@@ -1727,7 +1681,7 @@ void matrix::setBottomRightCorner(matrix m, int p, int q) {
   \return matrix given by format out
   \todo m, in, out const
 */
-matrix twoport (matrix m, char in, char out) {
+matrix twoport (const matrix & m, char in, char out) {
   assert (m.getRows () >= 2 && m.getCols () >= 2);
   nr_complex_t d;
   matrix res (2);
@@ -1984,10 +1938,9 @@ matrix twoport (matrix m, char in, char out) {
    \param[in] m S parameter matrix
    \return Rollet factor
    \note Assert 2x2 matrix
-   \todo m const?
    \todo Rewrite with abs and expand det. It is cleaner.
 */
-nr_double_t rollet (matrix m) {
+nr_double_t rollet (const matrix & m) {
   assert (m.getRows () >= 2 && m.getCols () >= 2);
   nr_double_t res;
   res = (1 - norm (m (0, 0)) - norm (m (1, 1)) + norm (det (m))) /
@@ -1996,7 +1949,7 @@ nr_double_t rollet (matrix m) {
 }
 
 /* Computes stability measure B1 of the given S-parameter matrix. */
-nr_double_t b1 (matrix m) {
+nr_double_t b1 (const matrix & m) {
   assert (m.getRows () >= 2 && m.getCols () >= 2);
   nr_double_t res;
   res = 1 + norm (m (0, 0)) - norm (m (1, 1)) - norm (det (m));
@@ -2004,7 +1957,7 @@ nr_double_t b1 (matrix m) {
 }
 
 
-matrix rad2deg (matrix a) {
+matrix rad2deg (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -2012,7 +1965,7 @@ matrix rad2deg (matrix a) {
   return res;
 }
 
-matrix deg2rad (matrix a) {
+matrix deg2rad (const matrix & a) {
   matrix res (a.getRows (), a.getCols ());
   for (int r = 0; r < a.getRows (); r++)
     for (int c = 0; c < a.getCols (); c++)
@@ -0,0 +1,339 @@
+/*
+ * simd.cpp - element-wise kernels for complex arrays
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+/*!\file simd.cpp
+   Implements the element-wise kernels for complex arrays
+*/
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <cmath>
+#include <cfloat>
+
+#include "complex.h"
+#include "simd.h"
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#define SIMD_AVX2 __attribute__ ((target ("avx2")))
+#endif
+
+namespace qucs {
+
+namespace simd {
+
+#if SIMD_X86
+
+/* The AVX2 kernels process pairs of complex numbers, i.e. four double
+   values, and return the number of elements done.  The caller
+   computes the remaining element and pairs containing values the
+   vectorized code cannot handle using the scalar functions. */
+
+// Returns a bit mask of the complex numbers containing NaNs.
+SIMD_AVX2 static inline int invalid (__m256d x) {
+  return _mm256_movemask_pd (_mm256_cmp_pd (x, x, _CMP_UNORD_Q));
+}
+
+// Returns the absolute values of the given doubles.
+SIMD_AVX2 static inline __m256d absolute (__m256d x) {
+  return _mm256_andnot_pd (_mm256_set1_pd (-0.0), x);
+}
+
+// Returns a bit mask of the values outside the range [lo, hi].
+SIMD_AVX2 static inline int outside (__m256d x, double lo, double hi) {
+  __m256d m = _mm256_and_pd (_mm256_cmp_pd (x, _mm256_set1_pd (lo),
+					    _CMP_GE_OQ),
+			     _mm256_cmp_pd (x, _mm256_set1_pd (hi),
+					    _CMP_LE_OQ));
+  return ~_mm256_movemask_pd (m) & 15;
+}
+
+// Returns a bit mask of the non-zero values outside the range [lo, hi].
+SIMD_AVX2 static inline int scaled (__m256d x, double lo, double hi) {
+  __m256d zero = _mm256_cmp_pd (x, _mm256_setzero_pd (), _CMP_EQ_OQ);
+  return outside (x, lo, hi) & ~_mm256_movemask_pd (zero);
+}
+
+// Returns the norms of both complex numbers in all their lanes.
+SIMD_AVX2 static inline __m256d norms (__m256d x) {
+  __m256d sq = _mm256_mul_pd (x, x);
+  return _mm256_hadd_pd (sq, sq);
+}
+
+SIMD_AVX2 static int add_avx2 (nr_complex_t * r, const nr_complex_t * a,
+			       const nr_complex_t * b, int n) {
+  const double * x = (const double *) a, * y = (const double *) b;
+  double * z = (double *) r;
+  int i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    __m256d s = _mm256_add_pd (_mm256_loadu_pd (x + 2 * i),
+			       _mm256_loadu_pd (y + 2 * i));
+    _mm256_storeu_pd (z + 2 * i, s);
+  }
+  return i;
+}
+
+SIMD_AVX2 static int sub_avx2 (nr_complex_t * r, const nr_complex_t * a,
+			       const nr_complex_t * b, int n) {
+  const double * x = (const double *) a, * y = (const double *) b;
+  double * z = (double *) r;
+  int i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    __m256d s = _mm256_sub_pd (_mm256_loadu_pd (x + 2 * i),
+			       _mm256_loadu_pd (y + 2 * i));
+    _mm256_storeu_pd (z + 2 * i, s);
+  }
+  return i;
+}
+
+/* The product is (ac - bd) + j(bc + ad) as computed by the scalar
+   code as long as no NaNs appear. */
+SIMD_AVX2 static int mul_avx2 (nr_complex_t * r, const nr_complex_t * a,
+			       const nr_complex_t * b, int n) {
+  const double * x = (const double *) a, * y = (const double *) b;
+  double * z = (double *) r;
+  int i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    __m256d u = _mm256_loadu_pd (x + 2 * i);
+    __m256d v = _mm256_loadu_pd (y + 2 * i);
+    __m256d re = _mm256_movedup_pd (v);
+    __m256d im = _mm256_permute_pd (v, 15);
+    __m256d p = _mm256_addsub_pd (_mm256_mul_pd (u, re),
+				  _mm256_mul_pd (_mm256_permute_pd (u, 5), im));
+    if (invalid (p)) {
+      r[i] = a[i] * b[i];
+      r[i + 1] = a[i + 1] * b[i + 1];
+    }
+    else _mm256_storeu_pd (z + 2 * i, p);
+  }
+  return i;
+}
+
+/* The quotient uses Smith's algorithm just like the scalar code.
+   Operands which would be scaled by the scalar code are left to it. */
+SIMD_AVX2 static int div_avx2 (nr_complex_t * r, const nr_complex_t * a,
+			       const nr_complex_t * b, int n) {
+  const double * x = (const double *) a, * y = (const double *) b;
+  double * z = (double *) r;
+  const double lo = std::ldexp (1.0, -500), hi = std::ldexp (1.0, 500);
+  __m256d sgn = _mm256_set_pd (-0.0, 0.0, -0.0, 0.0);
+  int i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    __m256d u = _mm256_loadu_pd (x + 2 * i);
+    __m256d v = _mm256_loadu_pd (y + 2 * i);
+    __m256d us = _mm256_permute_pd (u, 5);
+    __m256d au = absolute (u);
+    __m256d c = _mm256_movedup_pd (v), ac = absolute (c);
+    __m256d d = _mm256_permute_pd (v, 15), ad = absolute (d);
+    // |c| < |d|: ratio = c/d, denom = c ratio + d, (a ratio + b, b ratio - a)
+    // otherwise: ratio = d/c, denom = d ratio + c, (b ratio + a, b - a ratio)
+    __m256d lt = _mm256_cmp_pd (ac, ad, _CMP_LT_OQ);
+    __m256d ratio = _mm256_blendv_pd (_mm256_div_pd (d, c),
+				      _mm256_div_pd (c, d), lt);
+    __m256d denom =
+      _mm256_blendv_pd (_mm256_add_pd (_mm256_mul_pd (d, ratio), c),
+			_mm256_add_pd (_mm256_mul_pd (c, ratio), d), lt);
+    __m256d n1 = _mm256_add_pd (_mm256_mul_pd (u, ratio),
+				_mm256_xor_pd (us, sgn));
+    __m256d n2 = _mm256_add_pd (_mm256_xor_pd (_mm256_mul_pd (us, ratio),
+					       sgn), u);
+    __m256d q = _mm256_div_pd (_mm256_blendv_pd (n2, n1, lt), denom);
+    int bad = invalid (q) | outside (_mm256_max_pd (ac, ad), lo, hi) |
+      scaled (_mm256_max_pd (au, _mm256_permute_pd (au, 5)), lo, hi) |
+      scaled (absolute (ratio), DBL_MIN, DBL_MAX);
+    if (bad) {
+      r[i] = a[i] / b[i];
+      r[i + 1] = a[i + 1] / b[i + 1];
+    }
+    else _mm256_storeu_pd (z + 2 * i, q);
+  }
+  return i;
+}
+
+/* The norm is computed as re * re + im * im by both the vectorized
+   and the scalar code, thus all values of an array are rounded alike.
+   With C++ libraries computing std::norm() as the squared magnitude
+   the result may differ from qucs::norm() in the last digit. */
+SIMD_AVX2 static int norm_avx2 (nr_complex_t * r, const nr_complex_t * a,
+				int n) {
+  const double * x = (const double *) a;
+  double * z = (double *) r;
+  int i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    __m256d u = _mm256_loadu_pd (x + 2 * i);
+    __m256d s = _mm256_hadd_pd (_mm256_mul_pd (u, u), _mm256_setzero_pd ());
+    _mm256_storeu_pd (z + 2 * i, s);
+  }
+  return i;
+}
+
+/* The magnitude is computed as the square root of the norm which may
+   differ from the scalar code in the last digit.  Values whose norm
+   is out of range are left to the scalar code. */
+SIMD_AVX2 static int abs_avx2 (nr_complex_t * r, const nr_complex_t * a,
+			       int n) {
+  const double * x = (const double *) a;
+  double * z = (double *) r;
+  int i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    __m256d u = _mm256_loadu_pd (x + 2 * i);
+    __m256d s = _mm256_hadd_pd (_mm256_mul_pd (u, u), _mm256_setzero_pd ());
+    if (outside (s, DBL_MIN, DBL_MAX) & 5) {
+      r[i] = std::abs (a[i]);
+      r[i + 1] = std::abs (a[i + 1]);
+    }
+    else _mm256_storeu_pd (z + 2 * i, _mm256_sqrt_pd (s));
+  }
+  return i;
+}
+
+/* The principal square root of x + jy with t = sqrt ((|z| + |x|) / 2)
+   is t + jy/2t for non-negative x and |y|/2t + j copysign(t, y)
+   otherwise. */
+SIMD_AVX2 static int sqrt_avx2 (nr_complex_t * r, const nr_complex_t * a,
+				int n) {
+  const double * x = (const double *) a;
+  double * z = (double *) r;
+  __m256d half = _mm256_set1_pd (0.5);
+  __m256d sgn = _mm256_set1_pd (-0.0);
+  int i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    __m256d u = _mm256_loadu_pd (x + 2 * i);
+    __m256d re = _mm256_movedup_pd (u);
+    __m256d im = _mm256_permute_pd (u, 15);
+    __m256d s = norms (u);
+    __m256d h = _mm256_add_pd (_mm256_sqrt_pd (s), absolute (re));
+    __m256d t = _mm256_sqrt_pd (_mm256_mul_pd (half, h));
+    __m256d w = _mm256_mul_pd (half, _mm256_div_pd (im, t));
+    __m256d p = _mm256_blend_pd (t, w, 10);
+    __m256d m = _mm256_blend_pd (absolute (w),
+				 _mm256_or_pd (t, _mm256_and_pd (im, sgn)), 10);
+    __m256d ge = _mm256_cmp_pd (re, _mm256_setzero_pd (), _CMP_GE_OQ);
+    __m256d q = _mm256_blendv_pd (m, p, ge);
+    if (outside (s, DBL_MIN, DBL_MAX) | invalid (q)) {
+      r[i] = qucs::sqrt (a[i]);
+      r[i + 1] = qucs::sqrt (a[i + 1]);
+    }
+    else _mm256_storeu_pd (z + 2 * i, q);
+  }
+  return i;
+}
+
+// Checks whether the processor supports the AVX2 instructions.
+static bool detect (void) {
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx2");
+}
+
+static bool active = detect ();
+
+#else /* !SIMD_X86 */
+
+static bool active = false;
+
+#endif /* SIMD_X86 */
+
+// Returns whether the vectorized kernels are used.
+bool enabled (void) {
+  return active;
+}
+
+/* Enables or disables the vectorized kernels.  They cannot be enabled
+   if the processor does not support them. */
+void enable (bool on) {
+#if SIMD_X86
+  active = on && detect ();
+#else
+  active = false;
+#endif
+}
+
+#if SIMD_X86
+#define SIMD_KERNEL(func,...) (active ? func##_avx2 (__VA_ARGS__) : 0)
+#else
+#define SIMD_KERNEL(func,...) 0
+#endif
+
+void add (nr_complex_t * r, const nr_complex_t * a,
+	  const nr_complex_t * b, int n) {
+  for (int i = SIMD_KERNEL (add, r, a, b, n); i < n; i++)
+    r[i] = a[i] + b[i];
+}
+
+void sub (nr_complex_t * r, const nr_complex_t * a,
+	  const nr_complex_t * b, int n) {
+  for (int i = SIMD_KERNEL (sub, r, a, b, n); i < n; i++)
+    r[i] = a[i] - b[i];
+}
+
+void mul (nr_complex_t * r, const nr_complex_t * a,
+	  const nr_complex_t * b, int n) {
+  for (int i = SIMD_KERNEL (mul, r, a, b, n); i < n; i++)
+    r[i] = a[i] * b[i];
+}
+
+void div (nr_complex_t * r, const nr_complex_t * a,
+	  const nr_complex_t * b, int n) {
+  for (int i = SIMD_KERNEL (div, r, a, b, n); i < n; i++)
+    r[i] = a[i] / b[i];
+}
+
+void norm (nr_complex_t * r, const nr_complex_t * a, int n) {
+  for (int i = SIMD_KERNEL (norm, r, a, n); i < n; i++)
+    r[i] = real (a[i]) * real (a[i]) + imag (a[i]) * imag (a[i]);
+}
+
+void abs (nr_complex_t * r, const nr_complex_t * a, int n) {
+  for (int i = SIMD_KERNEL (abs, r, a, n); i < n; i++)
+    r[i] = std::abs (a[i]);
+}
+
+// The logarithm is left to the scalar code, the norm is vectorized.
+void dB (nr_complex_t * r, const nr_complex_t * a, int n) {
+  norm (r, a, n);
+  for (int i = 0; i < n; i++)
+    r[i] = 10.0 * std::log10 (real (r[i]));
+}
+
+void arg (nr_complex_t * r, const nr_complex_t * a, int n) {
+  for (int i = 0; i < n; i++)
+    r[i] = std::arg (a[i]);
+}
+
+void sqrt (nr_complex_t * r, const nr_complex_t * a, int n) {
+  for (int i = SIMD_KERNEL (sqrt, r, a, n); i < n; i++)
+    r[i] = qucs::sqrt (a[i]);
+}
+
+void exp (nr_complex_t * r, const nr_complex_t * a, int n) {
+  for (int i = 0; i < n; i++)
+    r[i] = qucs::exp (a[i]);
+}
+
+} // namespace simd
+
+} // namespace qucs
@@ -0,0 +1,63 @@
+/*
+ * simd.h - element-wise kernels for complex arrays
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+/*!\file simd.h
+   \brief Element-wise kernels for arrays of complex numbers
+
+   The kernels work on the interleaved real and imaginary parts of
+   the complex arrays as used by the vector class.  On x86 processors
+   supporting AVX2 two complex numbers are processed at once, the
+   implementation is chosen at runtime.  Elements which the vectorized
+   code cannot compute exactly (overflows, infinities and the like) are
+   recomputed by the scalar code.  The result array may be one of the
+   operand arrays.  Functions yielding real values store them as
+   complex numbers with a zero imaginary part.
+*/
+
+namespace qucs {
+
+namespace simd {
+
+bool enabled (void);
+void enable (bool);
+
+void add  (nr_complex_t *, const nr_complex_t *, const nr_complex_t *, int);
+void sub  (nr_complex_t *, const nr_complex_t *, const nr_complex_t *, int);
+void mul  (nr_complex_t *, const nr_complex_t *, const nr_complex_t *, int);
+void div  (nr_complex_t *, const nr_complex_t *, const nr_complex_t *, int);
+void norm (nr_complex_t *, const nr_complex_t *, int);
+void abs  (nr_complex_t *, const nr_complex_t *, int);
+void dB   (nr_complex_t *, const nr_complex_t *, int);
+void arg  (nr_complex_t *, const nr_complex_t *, int);
+void sqrt (nr_complex_t *, const nr_complex_t *, int);
+void exp  (nr_complex_t *, const nr_complex_t *, int);
+
+} // namespace simd
+
+} // namespace qucs
+
+#endif /* __SIMD_H__ */
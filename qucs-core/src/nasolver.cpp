@@ -36,6 +36,8 @@
 #include <float.h>
 #include <assert.h>
 #include <limits>
+#include <vector>
+#include <algorithm>
 
 #include "logging.h"
 #include "complex.h"
@@ -51,6 +53,7 @@
 #include "strlist.h"
 #include "tvector.h"
 #include "tmatrix.h"
+#include "tspmatrix.h"
 #include "eqnsys.h"
 #include "precision.h"
 #include "operatingpoint.h"
@@ -66,7 +69,8 @@ template <class nr_type_t>
 nasolver<nr_type_t>::nasolver () : analysis ()
 {
     nlist = NULL;
-    A = C = NULL;
+    A = NULL;
+    As = C = NULL;
     z = x = xprev = zprev = NULL;
     reltol = abstol = vntol = 0;
     calculate_func = NULL;
@@ -75,6 +79,8 @@ nasolver<nr_type_t>::nasolver () : analysis ()
     updateMatrix = 1;
     gMin = srcFactor = 0;
     eqns = new eqnsys<nr_type_t> ();
+    threads = 1;
+    pool = NULL;
 }
 
 // Constructor creates a named instance of the nasolver class.
@@ -82,7 +88,8 @@ template <class nr_type_t>
 nasolver<nr_type_t>::nasolver (const std::string &n) : analysis (n)
 {
     nlist = NULL;
-    A = C = NULL;
+    A = NULL;
+    As = C = NULL;
     z = x = xprev = zprev = NULL;
     reltol = abstol = vntol = 0;
     calculate_func = NULL;
@@ -91,6 +98,8 @@ nasolver<nr_type_t>::nasolver (const std::string &n) : analysis (n)
     updateMatrix = 1;
     gMin = srcFactor = 0;
     eqns = new eqnsys<nr_type_t> ();
+    threads = 1;
+    pool = NULL;
 }
 
 // Destructor deletes the nasolver class object.
@@ -100,11 +109,13 @@ nasolver<nr_type_t>::~nasolver ()
     delete nlist;
     delete C;
     delete A;
+    delete As;
     delete z;
     delete x;
     delete xprev;
     delete zprev;
     delete eqns;
+    delete pool;
 }
 
 /* The copy constructor creates a new instance of the nasolver class
@@ -114,7 +125,8 @@ nasolver<nr_type_t>::nasolver (nasolver & o) : analysis (o)
 {
     nlist = o.nlist ? new nodelist (*(o.nlist)) : NULL;
     A = o.A ? new tmatrix<nr_type_t> (*(o.A)) : NULL;
-    C = o.C ? new tmatrix<nr_type_t> (*(o.C)) : NULL;
+    As = o.As ? new tspmatrix<nr_type_t> (*(o.As)) : NULL;
+    C = o.C ? new tspmatrix<nr_type_t> (*(o.C)) : NULL;
     z = o.z ? new tvector<nr_type_t> (*(o.z)) : NULL;
     x = o.x ? new tvector<nr_type_t> (*(o.x)) : NULL;
     xprev = zprev = NULL;
@@ -131,6 +143,9 @@ nasolver<nr_type_t>::nasolver (nasolver & o) : analysis (o)
     srcFactor = o.srcFactor;
     eqns = new eqnsys<nr_type_t> (*(o.eqns));
     solution = nasolution<nr_type_t> (o.solution);
+    stamps = o.stamps;
+    threads = o.threads;
+    pool = NULL;
 }
 
 /* The function runs the nodal analysis solver once, reports errors if
@@ -221,6 +236,8 @@ void nasolver<nr_type_t>::solve_pre (void)
     nlist = new nodelist (subnet);
     nlist->assignNodes ();
     assignVoltageSources ();
+    createStamps ();
+    createCircuitLists ();
 #if DEBUG && 0
     nlist->print ();
 #endif
@@ -229,7 +246,19 @@ void nasolver<nr_type_t>::solve_pre (void)
     int M = countVoltageSources ();
     int N = countNodes ();
     delete A;
-    A = new tmatrix<nr_type_t> (M + N);
+    A = NULL;
+    delete As;
+    As = NULL;
+    delete C;
+    C = NULL;
+    if (ALGO_IS_SPARSE (eqnAlgo))
+    {
+        // the ordering is computed once for the non-zero pattern
+        createSparsePattern ();
+        eqns->reorderSparse (As);
+    }
+    else
+        A = new tmatrix<nr_type_t> (M + N);
     delete z;
     z = new tvector<nr_type_t> (N + M);
     delete x;
@@ -547,10 +576,18 @@ void nasolver<nr_type_t>::createMatrix (void)
        Each of these minor matrices is going to be generated here. */
     if (updateMatrix)
     {
-        createGMatrix ();
-        createBMatrix ();
-        createCMatrix ();
-        createDMatrix ();
+        if (As != NULL)
+        {
+            createSparseMatrix ();
+        }
+        else
+        {
+            A->set (0.0);
+            createGMatrix ();
+            createBMatrix ();
+            createCMatrix ();
+            createDMatrix ();
+        }
     }
 
     /* Adjust G matrix if requested. */
@@ -560,7 +597,10 @@ void nasolver<nr_type_t>::createMatrix (void)
         int M = countVoltageSources ();
         for (int n = 0; n < N + M; n++)
         {
-            A->set (n, n, A->get (n, n) + gMin);
+            if (As != NULL)
+                As->add (n, n, gMin);
+            else
+                A->set (n, n, A->get (n, n) + gMin);
         }
     }
 
@@ -591,6 +631,92 @@ nr_type_t nasolver<nr_type_t>::MatValX (nr_complex_t z, nr_double_t *)
     return real (z);
 }
 
+/* The function creates the stamp of each circuit, i.e. the matrix
+   row (and column) each of its ports is connected to.  Ports connected
+   to ground get -1.  The stamps are created once after the nodes and
+   voltage sources have been enumerated and allow to put the entries of
+   the circuits directly into the MNA matrices without searching the
+   node list. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::createStamps (void)
+{
+    int N = countNodes ();
+    circuit * root = subnet->getRoot ();
+
+    // save node numbers into the circuit nodes, ground is zero
+    for (circuit * ct = root; ct != NULL; ct = (circuit *) ct->getNext ())
+        for (int i = 0; i < ct->getSize (); i++)
+            ct->getNode (i)->setNode (0);
+    for (int r = 0; r < N; r++)
+        for (auto &current : *nlist->getNode (r))
+            current->setNode (r + 1);
+
+    // create a stamp for each circuit
+    stamps.clear ();
+    for (circuit * ct = root; ct != NULL; ct = (circuit *) ct->getNext ())
+    {
+        stamp_t st;
+        st.ct = ct;
+        for (int i = 0; i < ct->getSize (); i++)
+            st.nodes.push_back (ct->getNode (i)->getNode () - 1);
+        stamps.push_back (st);
+    }
+}
+
+/* The function sorts the circuits into those which can be evaluated
+   concurrently and the others.  It creates the thread pool if more
+   than one thread is requested and there are enough circuits. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::createCircuitLists (void)
+{
+    circuit * root = subnet->getRoot ();
+    serialCircuits.clear ();
+    concurrentCircuits.clear ();
+    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
+    {
+        if (c->isConcurrent ())
+            concurrentCircuits.push_back (c);
+        else
+            serialCircuits.push_back (c);
+    }
+
+    int n = threads > 0 ? threads : threadpool::hardwareThreads ();
+    if (n > 1 && concurrentCircuits.size () > 1)
+    {
+        if (pool == NULL || pool->getThreads () != n)
+        {
+            delete pool;
+            pool = new threadpool (n);
+        }
+    }
+    else
+    {
+        delete pool;
+        pool = NULL;
+    }
+}
+
+/* The function applies the given function to each circuit.  If there
+   is a thread pool the circuits which allow it are evaluated
+   concurrently after all the others.  Since these do not depend on
+   each other the results are the same regardless of the number of
+   threads. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::calculateCircuits (
+    const std::function<void (circuit *)> & f)
+{
+    if (pool == NULL)
+    {
+        circuit * root = subnet->getRoot ();
+        for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
+            f (c);
+        return;
+    }
+    for (circuit * c : serialCircuits) f (c);
+    pool->run ((int) concurrentCircuits.size (),
+               [&] (int i) { f (concurrentCircuits[i]); });
+}
+
 /* The B matrix is an MxN matrix with only 0, 1 and -1 elements.  Each
    location in the matrix corresponds to a particular voltage source
    (first dimension) or a node (second dimension).  If the positive
@@ -598,35 +724,27 @@ nr_type_t nasolver<nr_type_t>::MatValX (nr_complex_t z, nr_double_t *)
    element (i,k) in the B matrix is a 1.  If the negative terminal of
    the ith voltage source is connected to node k, then the element
    (i,k) in the B matrix is a -1.  Otherwise, elements of the B matrix
-   are zero. */
+   are zero.  Each voltage source adds its entries at the nodes given
+   by its stamp into the previously zeroed matrix. */
 template <class nr_type_t>
 void nasolver<nr_type_t>::createBMatrix (void)
 {
     int N = countNodes ();
-    int M = countVoltageSources ();
-    circuit * vs;
-    struct nodelist_t * n;
-    nr_type_t val;
 
-    // go through each voltage sources (first dimension)
-    for (int c = 0; c < M; c++)
+    // go through each circuit with voltage sources
+    for (auto &st : stamps)
     {
-        vs = findVoltageSource (c);
-        // go through each node (second dimension)
-        for (int r = 0; r < N; r++)
+        circuit * vs = st.ct;
+        int v = vs->getVoltageSources ();
+        if (v <= 0) continue;
+        int c0 = vs->getVoltageSource ();
+        for (int p = 0; p < (int) st.nodes.size (); p++)
         {
-            val = 0.0;
-            n = nlist->getNode (r);
-            for (auto &current : *n)
-            {
-                // is voltage source connected to node ?
-	      if (current->getCircuit () == vs)
-                {
-		  val += MatVal (vs->getB (current->getPort (), c));
-                }
-            }
+            int r = st.nodes[p];
+            if (r < 0) continue;
             // put value into B matrix
-            A->set (r, c + N, val);
+            for (int c = c0; c < c0 + v; c++)
+                (*A) (r, c + N) += MatVal (vs->getB (p, c));
         }
     }
 }
@@ -643,213 +761,257 @@ template <class nr_type_t>
 void nasolver<nr_type_t>::createCMatrix (void)
 {
     int N = countNodes ();
-    int M = countVoltageSources ();
-    circuit * vs;
-    struct nodelist_t * n;
-    nr_type_t val;
 
-    // go through each voltage sources (second dimension)
-    for (int r = 0; r < M; r++)
+    // go through each circuit with voltage sources
+    for (auto &st : stamps)
     {
-        vs = findVoltageSource (r);
-        // go through each node (first dimension)
-        for (int c = 0; c < N; c++)
+        circuit * vs = st.ct;
+        int v = vs->getVoltageSources ();
+        if (v <= 0) continue;
+        int r0 = vs->getVoltageSource ();
+        for (int p = 0; p < (int) st.nodes.size (); p++)
         {
-            val = 0.0;
-            n = nlist->getNode (c);
-            for (auto &current: *n)
-            {
-                // is voltage source connected to node ?
-	      if (current->getCircuit () == vs)
-                {
-		  val += MatVal (vs->getC (r, current->getPort ()));
-                }
-            }
+            int c = st.nodes[p];
+            if (c < 0) continue;
             // put value into C matrix
-            A->set (r + N, c, val);
+            for (int r = r0; r < r0 + v; r++)
+                (*A) (r + N, c) += MatVal (vs->getC (r, p));
         }
     }
 }
 
 /* The D matrix is an MxM matrix that is composed entirely of zeros.
-   It can be non-zero if dependent sources are considered. */
+   It can be non-zero if dependent sources are considered.  Only the
+   voltage sources of the same circuit are coupled. */
 template <class nr_type_t>
 void nasolver<nr_type_t>::createDMatrix (void)
 {
-    int M = countVoltageSources ();
     int N = countNodes ();
-    circuit * vsr, * vsc;
-    nr_type_t val;
-    for (int r = 0; r < M; r++)
+
+    // go through each circuit with voltage sources
+    for (auto &st : stamps)
     {
-        vsr = findVoltageSource (r);
-        for (int c = 0; c < M; c++)
-        {
-            vsc = findVoltageSource (c);
-            val = 0.0;
-            if (vsr == vsc)
-            {
-                val = MatVal (vsr->getD (r, c));
-            }
-            A->set (r + N, c + N, val);
-        }
+        circuit * vs = st.ct;
+        int v = vs->getVoltageSources ();
+        if (v <= 0) continue;
+        int i0 = vs->getVoltageSource ();
+        for (int r = i0; r < i0 + v; r++)
+            for (int c = i0; c < i0 + v; c++)
+                (*A) (r + N, c + N) += MatVal (vs->getD (r, c));
     }
 }
 
-/* The G matrix is an NxN matrix formed in two steps.
-   1. Each element in the diagonal matrix is equal to the sum of the
-   conductance of each element connected to the corresponding node.
-   2. The off diagonal elements are the negative conductance of the
-   element connected to the pair of corresponding nodes.  Therefore a
-   resistor between nodes 1 and 2 goes into the G matrix at location
-   (1,2) and location (2,1).  If an element is grounded, it will only
-   have contribute to one entry in the G matrix -- at the appropriate
-   location on the diagonal. */
+/* The function creates a sparse matrix with the non-zero pattern of
+   the A matrix.  Each circuit contributes entries between all of its
+   nodes and its own voltage sources.  The pattern always contains the
+   diagonal and is structurally symmetric, thus it is kept when the
+   matrix gets transposed.  Finally the position of each circuit's
+   entry within the sparse matrix is saved in its stamp.  The positions
+   are the same in all matrices created by this function. */
 template <class nr_type_t>
-void nasolver<nr_type_t>::createGMatrix (void)
+tspmatrix<nr_type_t> * nasolver<nr_type_t>::createStampPattern (void)
 {
-    int pr, pc, N = countNodes ();
-    nr_type_t g;
-    struct nodelist_t * nr, * nc;
-    circuit * ct;
+    int N = countNodes ();
+    int M = countVoltageSources ();
+    int nnz = 0;
+    std::vector< std::vector<int> > cols (N + M);
 
-    // go through each column of the G matrix
-    for (int c = 0; c < N; c++)
+    // collect the row indices of each column
+    for (int r = 0; r < N + M; r++) cols[r].push_back (r);
+    for (auto &st : stamps)
     {
-        nc = nlist->getNode (c);
-        // go through each row of the G matrix
-        for (int r = 0; r < N; r++)
+        circuit * ct = st.ct;
+        int s = st.nodes.size ();
+        int v = ct->getVoltageSources ();
+        int vs = v > 0 ? N + ct->getVoltageSource () : 0;
+        for (int pr = 0; pr < s; pr++)
         {
-            nr = nlist->getNode (r);
-            g = 0.0;
-            // sum up the conductance of each connected circuit
-            for (auto & currentnc  : *nc)
-	      for (auto & currentnr: *nr)
-		if (currentnc->getCircuit () == currentnr->getCircuit ())
-		  {
-		    ct = currentnc->getCircuit ();
-		    pc = currentnc->getPort ();
-		    pr = currentnr->getPort ();
-		    g += MatVal (ct->getY (pr, pc));
-		  }
-            // put value into G matrix
-            A->set (r, c, g);
+            int nr = st.nodes[pr];
+            if (nr < 0) continue;
+            for (int pc = 0; pc < s; pc++)
+            {
+                int nc = st.nodes[pc];
+                if (nc >= 0) cols[nc].push_back (nr);
+            }
+            for (int c = 0; c < v; c++)
+            {
+                cols[vs + c].push_back (nr);
+                cols[nr].push_back (vs + c);
+            }
         }
+        for (int r = 0; r < v; r++)
+            for (int c = 0; c < v; c++)
+                cols[vs + c].push_back (vs + r);
     }
-}
 
-/* The following function creates the (N+M)x(N+M) noise current
-   correlation matrix used during the AC noise computations.  */
-template <class nr_type_t>
-void nasolver<nr_type_t>::createNoiseMatrix (void)
-{
-    int pr, pc, N = countNodes ();
-    int M = countVoltageSources ();
-    struct nodelist_t * n;
-    nr_type_t val;
-    int r, c, ri, ci;
-    struct nodelist_t * nr, * nc;
-    circuit * ct;
+    // sort and remove duplicates
+    for (int c = 0; c < N + M; c++)
+    {
+        std::sort (cols[c].begin (), cols[c].end ());
+        cols[c].erase (std::unique (cols[c].begin (), cols[c].end ()),
+                       cols[c].end ());
+        nnz += cols[c].size ();
+    }
 
-    // create new Cy matrix if necessary
-    delete C;
-    C = new tmatrix<nr_type_t> (N + M);
+    // create the sparse matrix
+    tspmatrix<nr_type_t> * P = new tspmatrix<nr_type_t> (N + M);
+    P->reserve (nnz);
+    for (int c = 0; c < N + M; c++)
+    {
+        for (int r : cols[c]) P->append (r, 0.0);
+        P->commitCol (c);
+    }
 
-    // go through each column of the Cy matrix
-    for (c = 0; c < N; c++)
+    // save the entry positions in the order used by createSparseMatrix()
+    for (auto &st : stamps)
     {
-        nc = nlist->getNode (c);
-        // go through each row of the Cy matrix
-        for (r = 0; r < N; r++)
+        circuit * ct = st.ct;
+        int s = st.nodes.size ();
+        int v = ct->getVoltageSources ();
+        int vs = v > 0 ? N + ct->getVoltageSource () : 0;
+        st.slots.clear ();
+        for (int pr = 0; pr < s; pr++)
         {
-            nr = nlist->getNode (r);
-            val = 0.0;
-            // sum up the noise-correlation of each connected circuit
-            for (auto & currentnc: *nc)
-		/* a = 0; a < nc->size(); a++ */
-	      for (auto &currentnr : *nr)
-		/* b = 0; b < nr->size(); b++) */
-                    if (currentnc->getCircuit () == currentnr->getCircuit ())
-                    {
-                        ct = currentnc->getCircuit ();
-                        pc = currentnc->getPort ();
-                        pr = currentnr->getPort ();
-                        val += MatVal (ct->getN (pr, pc));
-                    }
-            // put value into Cy matrix
-            C->set (r, c, val);
+            int nr = st.nodes[pr];
+            if (nr < 0) continue;
+            for (int pc = 0; pc < s; pc++)
+            {
+                int nc = st.nodes[pc];
+                if (nc >= 0) st.slots.push_back (P->find (nr, nc));
+            }
+            for (int c = 0; c < v; c++)
+            {
+                st.slots.push_back (P->find (nr, vs + c));
+                st.slots.push_back (P->find (vs + c, nr));
+            }
         }
+        for (int r = 0; r < v; r++)
+            for (int c = 0; c < v; c++)
+                st.slots.push_back (P->find (vs + r, vs + c));
     }
+    return P;
+}
 
-    // go through each additional voltage source and put coefficients into
-    // the noise current correlation matrix
-    circuit * vsr, * vsc;
-    for (r = 0; r < M; r++)
+/* The function creates the sparse A matrix with its non-zero pattern. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::createSparsePattern (void)
+{
+    As = createStampPattern ();
+#if DEBUG
+    logprint (LOG_STATUS, "NOTIFY: %s: sparse %dx%d MNA matrix with %d "
+              "non-zero entries\n", getName (), As->getRows (), As->getCols (),
+              As->getNonZeros ());
+#endif
+}
+
+/* This function assembles the sparse A matrix.  Each circuit adds its
+   G, B, C and D matrix entries at the positions saved in its stamp. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::createSparseMatrix (void)
+{
+    nr_type_t * Ax = As->getData ();
+
+    As->set (0.0);
+    for (auto &st : stamps)
     {
-        vsr = findVoltageSource (r);
-        for (c = 0; c < M; c++)
+        circuit * ct = st.ct;
+        const int * slot = st.slots.data ();
+        int s = st.nodes.size ();
+        int v = ct->getVoltageSources ();
+        int vs = v > 0 ? ct->getVoltageSource () : 0;
+        for (int pr = 0; pr < s; pr++)
         {
-            vsc = findVoltageSource (c);
-            val = 0.0;
-            if (vsr == vsc)
+            if (st.nodes[pr] < 0) continue;
+            // G matrix entries
+            for (int pc = 0; pc < s; pc++)
+                if (st.nodes[pc] >= 0)
+                    Ax[*slot++] += MatVal (ct->getY (pr, pc));
+            // B and C matrix entries
+            for (int c = 0; c < v; c++)
             {
-                ri = vsr->getSize () + r - vsr->getVoltageSource ();
-                ci = vsc->getSize () + c - vsc->getVoltageSource ();
-                val = MatVal (vsr->getN (ri, ci));
+                Ax[*slot++] += MatVal (ct->getB (pr, vs + c));
+                Ax[*slot++] += MatVal (ct->getC (vs + c, pr));
             }
-            C->set (r + N, c + N, val);
         }
+        // D matrix entries
+        for (int r = 0; r < v; r++)
+            for (int c = 0; c < v; c++)
+                Ax[*slot++] += MatVal (ct->getD (vs + r, vs + c));
     }
+}
 
-    // go through each additional voltage source
-    for (r = 0; r < M; r++)
+/* The G matrix is an NxN matrix formed in two steps.
+   1. Each element in the diagonal matrix is equal to the sum of the
+   conductance of each element connected to the corresponding node.
+   2. The off diagonal elements are the negative conductance of the
+   element connected to the pair of corresponding nodes.  Therefore a
+   resistor between nodes 1 and 2 goes into the G matrix at location
+   (1,2) and location (2,1).  If an element is grounded, it will only
+   have contribute to one entry in the G matrix -- at the appropriate
+   location on the diagonal.  Each circuit adds its entries at the
+   nodes given by its stamp. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::createGMatrix (void)
+{
+    // go through each circuit
+    for (auto &st : stamps)
     {
-        vsr = findVoltageSource (r);
-        // go through each node
-        for (c = 0; c < N; c++)
+        circuit * ct = st.ct;
+        int s = st.nodes.size ();
+        for (int pr = 0; pr < s; pr++)
         {
-            val = 0.0;
-            n = nlist->getNode (c);
-            for (auto &currentn: *n)
-	      /*i = 0; i < n->size(); i++ )*/
+            int r = st.nodes[pr];
+            if (r < 0) continue;
+            // sum up the conductance of the circuit
+            for (int pc = 0; pc < s; pc++)
             {
-                // is voltage source connected to node ?
-                if (currentn->getCircuit () == vsr)
-                {
-                    ri = vsr->getSize () + r - vsr->getVoltageSource ();
-                    ci = currentn->getPort ();
-                    val += MatVal (vsr->getN (ri, ci));
-                }
+                int c = st.nodes[pc];
+                if (c >= 0) (*A) (r, c) += MatVal (ct->getY (pr, pc));
             }
-            // put value into Cy matrix
-            C->set (r + N, c, val);
         }
     }
+}
 
-    // go through each voltage source
-    for (c = 0; c < M; c++)
+/* The following function creates the sparse (N+M)x(N+M) noise current
+   correlation matrix used during the AC noise computations.  */
+template <class nr_type_t>
+void nasolver<nr_type_t>::createNoiseMatrix (void)
+{
+    // create new sparse Cy matrix if necessary, it has got the non-zero
+    // pattern of the A matrix
+    if (C == NULL)
+        C = As != NULL ? new tspmatrix<nr_type_t> (*As) : createStampPattern ();
+    nr_type_t * Cx = C->getData ();
+
+    // go through each circuit and add its entries at the positions saved
+    // in its stamp, in the same order as createSparseMatrix() does
+    C->set (0.0);
+    for (auto &st : stamps)
     {
-        vsc = findVoltageSource (c);
-        // go through each node
-        for (r = 0; r < N; r++)
+        circuit * ct = st.ct;
+        const int * slot = st.slots.data ();
+        int s = st.nodes.size ();
+        int v = ct->getVoltageSources ();
+        for (int pr = 0; pr < s; pr++)
         {
-            val = 0.0;
-            n = nlist->getNode (r);
-            for (auto & currentn: *n)/*i = 0; i < n->size(); i++)*/
+            if (st.nodes[pr] < 0) continue;
+            // sum up the noise-correlation of the circuit
+            for (int pc = 0; pc < s; pc++)
+                if (st.nodes[pc] >= 0)
+                    Cx[*slot++] += MatVal (ct->getN (pr, pc));
+            // correlation between nodes and the voltage sources, these
+            // come after the ports in the circuit's noise matrix
+            for (int c = 0; c < v; c++)
             {
-                // is voltage source connected to node ?
-                if (currentn->getCircuit () == vsc)
-                {
-                    ci = vsc->getSize () + c - vsc->getVoltageSource ();
-                    ri = currentn->getPort ();
-                    val += MatVal (vsc->getN (ri, ci));
-                }
+                Cx[*slot++] += MatVal (ct->getN (pr, s + c));
+                Cx[*slot++] += MatVal (ct->getN (s + c, pr));
             }
-            // put value into Cy matrix
-            C->set (r, c + N, val);
         }
+        // put coefficients of the voltage sources into the matrix
+        for (int r = 0; r < v; r++)
+            for (int c = 0; c < v; c++)
+                Cx[*slot++] += MatVal (ct->getN (s + r, s + c));
     }
-
 }
 
 /* The i matrix is an 1xN matrix with each element of the matrix
@@ -987,6 +1149,17 @@ void nasolver<nr_type_t>::assignVoltageSources (void)
     subnet->setVoltageSources (nSources);
 }
 
+/* Solves the matrix equation for each column of the given right hand
+   side matrix at once.  The previous factorization of the MNA matrix
+   is reused, thus the solver must have been run once before with the
+   appropriate factorization algorithm. */
+template <class nr_type_t>
+void nasolver<nr_type_t>::runMNA (tmatrix<nr_type_t> & R)
+{
+    eqns->setAlgo (eqnAlgo);
+    eqns->substitute (R);
+}
+
 /* The matrix equation Ax = z is solved by x = A^-1*z.  The function
    applies the operation to the previously generated matrices. */
 template <class nr_type_t>
@@ -995,7 +1168,10 @@ void nasolver<nr_type_t>::runMNA (void)
 
     // just solve the equation system here
     eqns->setAlgo (eqnAlgo);
-    eqns->passEquationSys (updateMatrix ? A : NULL, x, z);
+    if (As != NULL)
+        eqns->passEquationSys (updateMatrix ? As : NULL, x, z);
+    else
+        eqns->passEquationSys (updateMatrix ? A : NULL, x, z);
     eqns->solve ();
 
     // if damped Newton-Raphson is requested
@@ -1173,6 +1349,14 @@ int nasolver<nr_type_t>::checkConvergence (void)
     return 1;
 }
 
+/* The function checks whether the (dense or sparse) Jacobian matrix
+   contains finite values only.  It returns zero otherwise. */
+template <class nr_type_t>
+int nasolver<nr_type_t>::isJacobianFinite (void)
+{
+    return As != NULL ? As->isFinite () : A->isFinite ();
+}
+
 /* The function saves the solution and right hand vector of the previous
    iteration. */
 template <class nr_type_t>
@@ -31,11 +31,16 @@
 // BUG
 #include "qucs_typedefs.h"
 #endif
+#include <vector>
+#include <functional>
+
 #include "tvector.h"
 #include "tmatrix.h"
+#include "tspmatrix.h"
 #include "eqnsys.h"
 #include "nasolution.h"
 #include "analysis.h"
+#include "threadpool.h"
 
 // Convergence helper definitions.
 #define CONV_None            0
@@ -97,10 +102,14 @@ protected:
     void applyNodeset (bool nokeep = true);
     void createNoiseMatrix (void);
     void runMNA (void);
+    void runMNA (tmatrix<nr_type_t> &);
     void createMatrix (void);
     void storeSolution (void);
     void recallSolution (void);
     int  checkConvergence (void);
+    int  isJacobianFinite (void);
+    void setThreads (int n) { threads = n; }
+    void calculateCircuits (const std::function<void (circuit *)> &);
 
 private:
     void assignVoltageSources (void);
@@ -108,6 +117,11 @@ private:
     void createBMatrix (void);
     void createCMatrix (void);
     void createDMatrix (void);
+    void createStamps (void);
+    void createCircuitLists (void);
+    tspmatrix<nr_type_t> * createStampPattern (void);
+    void createSparsePattern (void);
+    void createSparseMatrix (void);
     void createIVector (void);
     void createEVector (void);
     void createZVector (void);
@@ -128,7 +142,8 @@ protected:
     tvector<nr_type_t> * xprev;
     tvector<nr_type_t> * zprev;
     tmatrix<nr_type_t> * A;
-    tmatrix<nr_type_t> * C;
+    tspmatrix<nr_type_t> * As;
+    tspmatrix<nr_type_t> * C;
     int iterations;
     int convHelper;
     int fixpoint;
@@ -145,6 +160,21 @@ private:
     nr_double_t vntol;
     nasolution<nr_type_t> solution;
 
+    // matrix positions of the circuit entries
+    struct stamp_t
+    {
+        circuit * ct;
+        std::vector<int> nodes;
+        std::vector<int> slots;
+    };
+    std::vector<stamp_t> stamps;
+
+    // concurrent evaluation of the circuits
+    int threads;
+    threadpool * pool;
+    std::vector<circuit *> serialCircuits;
+    std::vector<circuit *> concurrentCircuits;
+
 private:
 
     calculate_func_t calculate_func;
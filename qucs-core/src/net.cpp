@@ -232,9 +232,10 @@ int net::containsAnalysis (analysis * child, int type) {
 }
 
 /* This function runs all registered analyses applied to the current
-   netlist, except for external analysis types. */
-dataset * net::runAnalysis (int &err) {
-  dataset * out = new dataset ();
+   netlist, except for external analysis types.  The results are saved
+   into the given dataset or a newly created one. */
+dataset * net::runAnalysis (int &err, dataset * out) {
+  if (out == NULL) out = new dataset ();
 
   // apply some data to all analyses
   for (auto *a : *actions) {
@@ -60,7 +60,7 @@ class net : public object
   void insertedNode (node *);
   void insertAnalysis (analysis *);
   void removeAnalysis (analysis *);
-  dataset * runAnalysis (int &);
+  dataset * runAnalysis (int &, dataset * out = NULL);
   void getDroppedCircuits (nodelist * nodes = NULL);
   void deleteUnusedCircuits (nodelist * nodes = NULL);
   int  getPorts (void) { return nPorts; }
@@ -57,6 +57,15 @@ struct pair_t {
   struct pair_t * next;
 };
 
+/* Representation of an expanded subcircuit instance.  Its elements
+   share the node and pair lists of the subcircuit definition, their
+   instance and internal node names are prefixed by the instance name
+   and the nodes connected to the ports are looked up in 'ports'. */
+struct instance_t {
+  char * name;
+  char * * ports;
+};
+
 /* Representation of a definition line in the netlist. */
 struct definition_t {
   char * type;
@@ -79,6 +88,7 @@ struct definition_t {
   char * subcircuit;
   struct value_t * values;
   struct define_t * define;
+  struct instance_t * overlay;
 };
 
 // Structure defining a key value pair.
@@ -161,8 +171,8 @@ struct define_t {
 #define PROP_RNG_MOS      PROP_RNG_STR2 ("nmos", "pmos")
 #define PROP_RNG_TYP      PROP_RNG_STR4 ("lin", "log", "list", "const")
 #define PROP_RNG_SOL \
-  PROP_RNG_STR5 ("CroutLU", "DoolittleLU", "HouseholderQR", \
-		 "HouseholderLQ", "GolubSVD")
+  PROP_RNG_STR6 ("CroutLU", "DoolittleLU", "HouseholderQR", \
+		 "HouseholderLQ", "GolubSVD", "SparseLU")
 #define PROP_RNG_DIS \
   PROP_RNG_STR7 ("Kirschning", "Kobayashi", "Yamashita", "Getsinger", \
 		 "Schneider", "Pramanick", "Hammerstad")
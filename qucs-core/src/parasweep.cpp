@@ -53,6 +53,8 @@ parasweep::parasweep () : analysis () {
   var = NULL;
   swp = NULL;
   eqn = NULL;
+  contMode = CONT_None;
+  statPoints = statIterations = statFallbacks = 0;
   type = ANALYSIS_SWEEP;
 }
 
@@ -61,6 +63,8 @@ parasweep::parasweep (char * n) : analysis (n) {
   var = NULL;
   swp = NULL;
   eqn = NULL;
+  contMode = CONT_None;
+  statPoints = statIterations = statFallbacks = 0;
   type = ANALYSIS_SWEEP;
 }
 
@@ -74,6 +78,8 @@ parasweep::~parasweep () {
 parasweep::parasweep (parasweep & p) : analysis (p) {
   var = new variable (*p.var);
   if (p.swp) swp = new sweep (*p.swp);
+  contMode = p.contMode;
+  statPoints = statIterations = statFallbacks = 0;
 }
 
 // Short macro in order to obtain the correct constant value.
@@ -108,6 +114,15 @@ int parasweep::initialize (void) {
     eqn = env->getChecker()->addDouble ("#sweep", n, 0);
   }
 
+  // continuation of the child analyses across the sweep points
+  const char * const cont = getPropertyString ("Continuation");
+  if (!strcmp (cont, "previous"))
+    contMode = CONT_Previous;
+  else if (!strcmp (cont, "extrapolate"))
+    contMode = CONT_Extrapolate;
+  else
+    contMode = CONT_None;
+
   // initialize first sweep value in environment and equation checker
   nr_double_t v = swp->get (0);
   env->setDoubleConstant (n, v);
@@ -135,8 +150,10 @@ int parasweep::cleanup (void) {
 
   // also run cleanup functionality for all children
   if( actions != nullptr)
-    for (auto *a : *actions)
+    for (auto *a : *actions) {
+      a->setContinuation (CONT_None, 0);
       a->cleanup ();
+    }
 
   return 0;
 }
@@ -145,40 +162,119 @@ int parasweep::cleanup (void) {
 int parasweep::solve (void) {
   int err = 0;
   runs++;
+  statPoints = statIterations = statFallbacks = 0;
 
-  // get fixed simulation properties
-  const char * const n = getPropertyString ("Param");
+#if HAVE_FORK
+  // solve the sweep points in parallel worker processes
+  int workers = countWorkers (swp->getSize ());
+  if (workers > 1) return solveParallel (workers);
+#endif
 
   // run the parameter sweep
+  continueChildren (CONT_None, 0);
   swp->reset ();
   for (int i = 0; i < swp->getSize (); i++) {
     // obtain next sweep point
     nr_double_t v = swp->next ();
     // display progress bar if requested
     if (progress) logprogressbar (i, swp->getSize (), 40);
-    // update environment and equation checker, then run solver
-    env->setDoubleConstant (n, v);
-    env->setDouble (n, v);
-    env->runSolver ();
-    // save results (swept parameter values)
-    if (runs == 1) saveResults ();
+    continueChildren (contMode, v);
+    err |= solvePoint (v);
+  }
+  // clear progress bar
+  if (progress) logprogressclear (40);
+
+  // report the iteration statistics of the sweep
+  if (contMode != CONT_None && statPoints > 0) {
+    logprint (LOG_STATUS, "NOTIFY: %s: %d points solved in %d iterations "
+	      "(%.1f per point), %d fallbacks\n", getName (), statPoints,
+	      statIterations, (nr_double_t) statIterations / statPoints,
+	      statFallbacks);
+  }
+  return err;
+}
+
+/* Passes the continuation mode and the next value of the swept
+   parameter to the child analyses. */
+void parasweep::continueChildren (int mode, nr_double_t v) {
+  for (auto *a : *actions)
+    a->setContinuation (mode, v);
+}
+
+/* The function runs the child analyses for the given value of the
+   swept parameter. */
+int parasweep::solvePoint (nr_double_t v) {
+  int err = 0;
+  const char * const n = getPropertyString ("Param");
+
+  // update environment and equation checker, then run solver
+  env->setDoubleConstant (n, v);
+  env->setDouble (n, v);
+  env->runSolver ();
+  // save results (swept parameter values)
+  if (runs == 1) saveResults ();
 #if DEBUG
-    logprint (LOG_STATUS, "NOTIFY: %s: running netlist for %s = %g\n",
-	      getName (), n, v);
+  logprint (LOG_STATUS, "NOTIFY: %s: running netlist for %s = %g\n",
+	    getName (), n, v);
 #endif
-    for (auto *a : *actions) {
-      err |= a->solve ();
-      // assign variable dataset dependencies to last order analyses
-      ptrlist<analysis> * lastorder = subnet->findLastOrderChildren (this);
-      for (auto *dep : *lastorder)
-	data->assignDependency (dep->getName (), var->getName ());
+  for (auto *a : *actions) {
+    int iter, fallbacks;
+    err |= a->solve ();
+    assignDependencies ();
+    // collect iteration statistics
+    if (a->getStatistics (iter, fallbacks)) {
+      statPoints++;
+      statIterations += iter;
+      statFallbacks += fallbacks;
     }
   }
-  // clear progress bar
-  if (progress) logprogressclear (40);
   return err;
 }
 
+// Assigns variable dataset dependencies to last order analyses.
+void parasweep::assignDependencies (void) {
+  ptrlist<analysis> * lastorder = subnet->findLastOrderChildren (this);
+  for (auto *dep : *lastorder)
+    data->assignDependency (dep->getName (), var->getName ());
+}
+
+#if HAVE_FORK
+/* The function runs the parameter sweep in the given number of worker
+   processes.  Each worker solves a contiguous chunk of sweep points on
+   its own copy of the netlist, the environment and the dataset.  The
+   child analyses are solved in the workers only, so none of them owns
+   threads which would get lost in the forked process. */
+int parasweep::solveParallel (int workers) {
+  int points = swp->getSize ();
+  const char * const n = getPropertyString ("Param");
+
+  // save the swept parameter values before any child results
+  swp->reset ();
+  for (int i = 0; i < points; i++) {
+    env->setDoubleConstant (n, swp->next ());
+    if (runs == 1) saveResults ();
+  }
+
+  int err = solveWorkers (workers, points, [this] (int first, int last) {
+      int err = 0;
+      continueChildren (CONT_None, 0);
+      for (int i = first; i < last; i++) {
+	continueChildren (contMode, swp->get (i));
+	err |= solvePoint (swp->get (i));
+      }
+      return err;
+    });
+  assignDependencies ();
+
+  // leave the environment at the last sweep point
+  nr_double_t v = swp->get (points - 1);
+  env->setDoubleConstant (n, v);
+  env->setDouble (n, v);
+  env->runSolver ();
+  return err;
+}
+#endif /* HAVE_FORK */
+
 /* This function saves the results of a single solve() functionality
    into the output dataset. */
 void parasweep::saveResults (void) {
@@ -204,6 +300,9 @@ PROP_OPT [] = {
   { "Stop", PROP_REAL, { 50, PROP_NO_STR }, PROP_NO_RANGE },
   { "Start", PROP_REAL, { 5, PROP_NO_STR }, PROP_NO_RANGE },
   { "Values", PROP_LIST, { 5, PROP_NO_STR }, PROP_NO_RANGE },
+  { "Workers", PROP_INT, { 1, PROP_NO_STR }, PROP_RNGII (0, 256) },
+  { "Continuation", PROP_STR, { PROP_NO_VAL, "none" },
+    PROP_RNG_STR3 ("none", "previous", "extrapolate") },
   PROP_NO_PROP };
 struct define_t parasweep::anadef =
   { "SW", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
@@ -43,10 +43,20 @@ class parasweep : public analysis
   int  cleanup (void);
   void saveResults (void);
 
+ private:
+  int  solvePoint (nr_double_t);
+  int  solveParallel (int);
+  void assignDependencies (void);
+  void continueChildren (int, nr_double_t);
+
  private:
   variable * var;
   sweep * swp;
   void * eqn;
+  int contMode;
+  int statPoints;
+  int statIterations;
+  int statFallbacks;
 };
 
 } // namespace qucs
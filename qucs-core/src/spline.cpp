@@ -95,7 +95,7 @@ spline::spline (tvector<nr_double_t> y, tvector<nr_double_t> t) {
 // Pass interpolation datapoints as vectors.
 void spline::vectors (qucs::vector y, qucs::vector t) {
   int i = t.getSize ();
-  assert (y.getSize () == i && i >= 3);
+  assert (y.getSize () == i && i >= 2);
 
   // create local copy of f(x)
   realloc (i);
@@ -107,7 +107,7 @@ void spline::vectors (qucs::vector y, qucs::vector t) {
 // Pass interpolation datapoints as tvectors.
 void spline::vectors (std::vector<nr_double_t> y, std::vector<nr_double_t> t) {
   int i = (int)t.size ();
-  assert ((int)y.size () == i && i >= 3);
+  assert ((int)y.size () == i && i >= 2);
 
   // create local copy of f(x)
   realloc (i);
@@ -119,7 +119,7 @@ void spline::vectors (std::vector<nr_double_t> y, std::vector<nr_double_t> t) {
 // Pass interpolation datapoints as tvectors.
 void spline::vectors (tvector<nr_double_t> y, tvector<nr_double_t> t) {
   int i = t.size ();
-  assert (y.size () == i && i >= 3);
+  assert (y.size () == i && i >= 2);
 
   // create local copy of f(x)
   realloc (i);
@@ -131,7 +131,7 @@ void spline::vectors (tvector<nr_double_t> y, tvector<nr_double_t> t) {
 // Pass interpolation datapoints as pointers.
 void spline::vectors (nr_double_t * y, nr_double_t * t, int len) {
   int i = len;
-  assert (i >= 3);
+  assert (i >= 2);
 
   // create local copy of f(x)
   realloc (i);
@@ -235,6 +235,8 @@ void spline::construct (void) {
 
   // second kind of cubic splines
   else if (boundary == SPLINE_BC_PERIODIC) {
+    // two points define a natural or clamped spline only
+    assert (n >= 2);
     // non-trigdiagonal equations - periodic boundary condition
     //std::vector<nr_double_t> z (n+1);
     nr_double_t *z = new nr_double_t[n+1];
@@ -341,6 +343,18 @@ poly spline::evaluate (nr_double_t t) {
   }
 }
 
+/* Evaluates the value of the spline at the given position within the
+   interval 'i' located by the caller, i.e. the index of the upper
+   bound of the position within the x-values minus one.  This saves the
+   search when several splines share the same x-values.  Periodic
+   splines are not handled. */
+nr_double_t spline::evaluate (nr_double_t t, int i) {
+  if (i < 0)
+    return f0[0] + (t - x[0]) * f1[0];
+  nr_double_t dx = t - x[i];
+  return f0[i] + dx * (f1[i] + dx * (f2[i] + dx * f3[i]));
+}
+
 // Destructor deletes an instance of the spline class.
 spline::~spline () {
   if (x)  delete[] x;
@@ -57,6 +57,7 @@ class spline
   void vectors (nr_double_t *, nr_double_t *, int);
   void construct (void);
   poly evaluate (nr_double_t);
+  nr_double_t evaluate (nr_double_t, int);
   void setBoundary (int b) { boundary = b; }
   void setDerivatives (nr_double_t l, nr_double_t r) { d0 = l; dn = r; }
 
@@ -105,20 +105,14 @@ spsolver::spsolver (spsolver & n) : analysis (n) {
   gnd = n.gnd;
 }
 
-/* This function joins two nodes of a single circuit (interconnected
-   nodes) and returns the resulting circuit. */
-circuit * spsolver::interconnectJoin (node * n1, node * n2) {
+/* This function joins the ports k and l of a single circuit
+   (interconnected nodes) and stores the S-parameters in the given
+   resulting circuit. */
+void spsolver::interconnectJoin (circuit * s, int k, int l,
+				 circuit * result) {
 
-  circuit * s = n1->getCircuit ();
-  circuit * result = new circuit (s->getSize () - 2);
   nr_complex_t p;
 
-  // allocate S-parameter and noise corellation matrices
-  result->initSP (); if (noise) result->initNoiseSP ();
-
-  // interconnected port numbers
-  int k = n1->getPort (), l = n2->getPort ();
-
   // denominator needs to be calculated only once
   nr_complex_t d = (1.0 - s->getS (k, l)) * (1.0 - s->getS (l, k)) -
     s->getS (k, k) * s->getS (l, l);
@@ -142,9 +136,6 @@ circuit * spsolver::interconnectJoin (node * n1, node * n2) {
     // skip connected node
     if (j1 == k || j1 == l) continue;
 
-    // assign node name of resulting circuit
-    result->setNode (j2, s->getNode(j1)->getName ());
-
     // inside S only
     for (i1 = 0; i1 < s->getSize (); i1++) {
 
@@ -164,24 +155,16 @@ circuit * spsolver::interconnectJoin (node * n1, node * n2) {
     // next column
     j2++; i2 = 0;
   }
-  return result;
 }
 
-/* This function joins two nodes of two different circuits (connected
-   nodes) and returns the resulting circuit. */
-circuit * spsolver::connectedJoin (node * n1, node * n2) {
+/* This function joins port k of circuit s and port l of circuit t
+   (connected nodes) and stores the S-parameters in the given
+   resulting circuit. */
+void spsolver::connectedJoin (circuit * s, int k, circuit * t, int l,
+			      circuit * result) {
 
-  circuit * s = n1->getCircuit ();
-  circuit * t = n2->getCircuit ();
-  circuit * result = new circuit (s->getSize () + t->getSize () - 2);
   nr_complex_t p;
 
-  // allocate S-parameter and noise corellation matrices
-  result->initSP (); if (noise) result->initNoiseSP ();
-
-  // connected port numbers
-  int k = n1->getPort (), l = n2->getPort ();
-
   // denominator needs to be calculated only once
   nr_complex_t d = 1.0 - s->getS (k, k) * t->getS (l, l);
 
@@ -203,9 +186,6 @@ circuit * spsolver::connectedJoin (node * n1, node * n2) {
     // skip connected node
     if (j1 == k) continue;
 
-    // assign node name of resulting circuit
-    result->setNode (j2, s->getNode(j1)->getName());
-
     // inside S
     for (i1 = 0; i1 < s->getSize (); i1++) {
 
@@ -238,9 +218,6 @@ circuit * spsolver::connectedJoin (node * n1, node * n2) {
     // skip connected node
     if (j1 == l) continue;
 
-    // assign node name of resulting circuit
-    result->setNode (j2, t->getNode(j1)->getName ());
-
     // across T and S
     for (i1 = 0; i1 < s->getSize (); i1++) {
 
@@ -267,21 +244,16 @@ circuit * spsolver::connectedJoin (node * n1, node * n2) {
     // next column
     j2++; i2 = 0;
   }
-
-  return result;
 }
 
-/* This function joins the two given nodes of a single circuit
+/* This function joins the ports k and l of a single circuit
    (interconnected nodes) and modifies the resulting circuit
    appropriately. */
-void spsolver::noiseInterconnect (circuit * result, node * n1, node * n2) {
+void spsolver::noiseInterconnect (circuit * result, circuit * c,
+				  int k, int l) {
 
-  circuit * c = n1->getCircuit ();
   nr_complex_t p, k1, k2, k3, k4;
 
-  // interconnected port numbers
-  int k = n1->getPort (), l = n2->getPort ();
-
   // denominator needs to be calculated only once
   nr_complex_t t = (1.0 - c->getS (k, l)) * (1.0 - c->getS (l, k)) -
     c->getS (k, k) * c->getS (l, l);
@@ -338,17 +310,13 @@ void spsolver::noiseInterconnect (circuit * result, node * n1, node * n2) {
 }
 
 
-/* The following function joins two nodes of two different circuits
-   and saves the noise wave correlation matrix in the resulting
-   circuit. */
-void spsolver::noiseConnect (circuit * result, node * n1, node * n2) {
-  circuit * c = n1->getCircuit ();
-  circuit * d = n2->getCircuit ();
+/* The following function joins port k of circuit c and port l of
+   circuit d and saves the noise wave correlation matrix in the
+   resulting circuit. */
+void spsolver::noiseConnect (circuit * result, circuit * c, int k,
+			     circuit * d, int l) {
   nr_complex_t p;
 
-  // connected port numbers
-  int k = n1->getPort (), l = n2->getPort ();
-
   // denominator needs to be calculated only once
   nr_complex_t t = 1.0 - c->getS (k, k) * d->getS (l, l);
 
@@ -444,36 +412,63 @@ void spsolver::noiseConnect (circuit * result, node * n1, node * n2) {
   }
 }
 
-/* Goes through the list of circuit objects and runs its frequency
-   dependent calcSP() function. */
+/* Goes through the list of original circuit objects and runs its
+   frequency dependent calcSP() function. */
 void spsolver::calc (nr_double_t freq) {
-  circuit * root = subnet->getRoot ();
-  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+  for (circuit * c : leaves) {
     c->calcSP (freq);
     if (noise) c->calcNoiseSP (freq);
   }
 }
 
+/* This function creates the circuit resulting from joining the two
+   given nodes.  It gets the remaining node names and its S-parameter
+   and noise correlation matrices are allocated. */
+circuit * spsolver::joinedCircuit (node * n1, node * n2) {
+  circuit * s = n1->getCircuit ();
+  circuit * t = n2->getCircuit ();
+  int k = n1->getPort (), l = n2->getPort (), i, j = 0;
+  circuit * result = new circuit (s == t ? s->getSize () - 2 :
+				  s->getSize () + t->getSize () - 2);
+
+  // assign node names of resulting circuit
+  for (i = 0; i < s->getSize (); i++) {
+    if (i == k || (s == t && i == l)) continue;
+    result->setNode (j++, s->getNode(i)->getName ());
+  }
+  if (s != t) {
+    for (i = 0; i < t->getSize (); i++) {
+      if (i == l) continue;
+      result->setNode (j++, t->getNode(i)->getName ());
+    }
+  }
+
+  // allocate S-parameter and noise corellation matrices
+  result->initSP (); if (noise) result->initNoiseSP ();
+  return result;
+}
+
 /* Go through each registered circuit object in the list and find the
    connection which results in a new subnetwork with the smallest
-   number of s-parameters to calculate. */
+   number of s-parameters to calculate.  The join is not computed
+   here but saved in the reduction plan. */
 void spsolver::reduce (void) {
 
 #if SORTED_LIST
   node * n1, * n2;
-  circuit * result, * cand1, * cand2;
+  circuit * cand1, * cand2;
 
   nlist->sortedNodes (&n1, &n2);
   cand1 = n1->getCircuit ();
   cand2 = n2->getCircuit ();
 #else /* !SORTED_LIST */
   node * n1, * n2, * cand;
-  circuit * result, * c1, * c2, * cand1, * cand2;
+  circuit * c1, * c2, * cand1, * cand2;
   int ports;
   circuit * root = subnet->getRoot ();
 
   // initialize local variables
-  result = c1 = c2 = cand1 = cand2 = NULL;
+  c1 = c2 = cand1 = cand2 = NULL;
   n1 = n2 = cand = NULL;
   ports = 10000; // huge
 
@@ -512,45 +507,85 @@ void spsolver::reduce (void) {
 
   // found a connection ?
   if (cand1 != NULL && cand2 != NULL) {
-    // connected
-    if (cand1 != cand2) {
 #if DEBUG && 0
+    if (cand1 != cand2)
       logprint (LOG_STATUS, "DEBUG: connected node (%s): %s - %s\n",
 		n1->getName (), cand1->getName (), cand2->getName ());
+    else
+      logprint (LOG_STATUS, "DEBUG: interconnected node (%s): %s\n",
+		n1->getName (), cand1->getName ());
 #endif /* DEBUG */
-      result = connectedJoin (n1, n2);
-      if (noise) noiseConnect (result, n1, n2);
-      subnet->reducedCircuit (result);
+    spjoin j;
+    j.s = cand1; j.k = n1->getPort ();
+    j.t = cand2; j.l = n2->getPort ();
+    j.result = joinedCircuit (n1, n2);
+    joins.push_back (j);
+    subnet->reducedCircuit (j.result);
 #if SORTED_LIST
-      nlist->remove (cand1);
-      nlist->remove (cand2);
-      nlist->insert (result);
+    nlist->remove (cand1);
+    if (cand1 != cand2) nlist->remove (cand2);
+    nlist->insert (j.result);
 #endif /* SORTED_LIST */
-      subnet->removeCircuit (cand1);
-      subnet->removeCircuit (cand2);
-      subnet->insertCircuit (result);
-      result->setOriginal (0);
+    /* Original circuits go to the drop list, the results of earlier
+       joins are still required by the plan and must not be deleted
+       here. */
+    subnet->removeCircuit (cand1, !results.count (cand1));
+    if (cand1 != cand2) subnet->removeCircuit (cand2, !results.count (cand2));
+    subnet->insertCircuit (j.result);
+    results.insert (j.result);
+  }
+}
+
+/* The function reduces the netlist to its ports once and saves the
+   joins in the reduction plan.  The topology does not change during
+   the frequency sweep, thus only the S-parameters of the joins are
+   computed for each frequency. */
+void spsolver::prepareReduction (void) {
+  circuit * root = subnet->getRoot ();
+  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
+    leaves.push_back (c);
+
+  int ports = subnet->countNodes ();
+  subnet->setReduced (0);
+  while (ports > subnet->getPorts ()) {
+    reduce ();
+    ports -= 2;
+  }
+
+  // the remaining circuits are deleted by the netlist
+  root = subnet->getRoot ();
+  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+    if (results.erase (c)) c->setOriginal (0);
+  }
+}
+
+/* This function computes the S-parameters (and noise correlation
+   matrices) of the joins saved in the reduction plan into the
+   preallocated resulting circuits. */
+void spsolver::joinCircuits (void) {
+  for (spjoin & j : joins) {
+    if (j.s != j.t) {
+      connectedJoin (j.s, j.k, j.t, j.l, j.result);
+      if (noise) noiseConnect (j.result, j.s, j.k, j.t, j.l);
     }
-    // interconnect
     else {
-#if DEBUG && 0
-      logprint (LOG_STATUS, "DEBUG: interconnected node (%s): %s\n",
-		n1->getName (), cand1->getName ());
-#endif
-      result = interconnectJoin (n1, n2);
-      if (noise) noiseInterconnect (result, n1, n2);
-      subnet->reducedCircuit (result);
-#if SORTED_LIST
-      nlist->remove (cand1);
-      nlist->insert (result);
-#endif /* SORTED_LIST */
-      subnet->removeCircuit (cand1);
-      subnet->insertCircuit (result);
-      result->setOriginal (0);
+      interconnectJoin (j.s, j.k, j.l, j.result);
+      if (noise) noiseInterconnect (j.result, j.s, j.k, j.l);
     }
   }
 }
 
+/* The function restores the original list of circuits and deletes
+   the circuits created by the reduction plan. */
+void spsolver::dropReduction (void) {
+  subnet->getDroppedCircuits (nlist);
+  subnet->deleteUnusedCircuits (nlist);
+  for (circuit * c : results) delete c;
+  results.clear ();
+  joins.clear ();
+  leaves.clear ();
+}
+
 /* Goes through the list of circuit objects and runs initializing
    functions if necessary. */
 void spsolver::init (void) {
@@ -566,7 +601,6 @@ void spsolver::init (void) {
    requested frequency and solves it then. */
 int spsolver::solve (void) {
   nr_double_t freq;
-  int ports;
   runs++;
 
   // fetch simulation properties
@@ -592,41 +626,73 @@ int spsolver::solve (void) {
   nlist = new nodelist (subnet);
   nlist->sort ();
 #endif /* SORTED_LIST */
+  prepareReduction ();
 
 #if DEBUG
   logprint (LOG_STATUS, "NOTIFY: %s: solving SP netlist\n", getName ());
 #endif
 
-  swp->reset ();
-  for (int i = 0; i < swp->getSize (); i++) {
-    freq = swp->next ();
-    if (progress) logprogressbar (i, swp->getSize (), 40);
-
-    ports = subnet->countNodes ();
-    subnet->setReduced (0);
-    calc (freq);
-
-#if DEBUG && 0
-    logprint (LOG_STATUS, "NOTIFY: %s: solving netlist for f = %e\n",
-	      getName (), (double) freq);
+  int err = 0;
+  int adapt = !strcmp (getPropertyString ("Adaptive"), "yes");
+  int workers = adapt ? 0 : countWorkers (swp->getSize ());
+  // solve a sparse set of frequencies and interpolate the rest
+  if (adapt) {
+    if (runs == 1) saveFrequencies ();
+    err = solveAdaptive (swp, [this] (nr_double_t f) { solveFrequency (f); });
+  }
+#if HAVE_FORK
+  // solve the frequency points in parallel worker processes
+  if (workers > 1) {
+    // save the frequencies before the results of the workers
+    if (runs == 1) saveFrequencies ();
+    err = solveWorkers (workers, swp->getSize (), [this] (int first, int last) {
+	for (int i = first; i < last; i++) solveFrequency (swp->get (i));
+	return 0;
+      });
+  }
 #endif
 
-    while (ports > subnet->getPorts ()) {
-      reduce ();
-      ports -= 2;
+  if (workers == 1) {
+    swp->reset ();
+    for (int i = 0; i < swp->getSize (); i++) {
+      freq = swp->next ();
+      if (progress) logprogressbar (i, swp->getSize (), 40);
+      solveFrequency (freq);
     }
-
-    saveResults (freq);
-    subnet->getDroppedCircuits (nlist);
-    subnet->deleteUnusedCircuits (nlist);
-    if (saveCVs & SAVE_CVS) saveCharacteristics (freq);
+    if (progress) logprogressclear (40);
   }
-  if (progress) logprogressclear (40);
+  dropReduction ();
   dropConnections ();
 #if SORTED_LIST
   delete nlist; nlist = NULL;
 #endif
-  return 0;
+  return err;
+}
+
+/* Solves the netlist for the given frequency by reducing it to the
+   ports according to the reduction plan and saves the results. */
+void spsolver::solveFrequency (nr_double_t freq) {
+  calc (freq);
+
+#if DEBUG && 0
+  logprint (LOG_STATUS, "NOTIFY: %s: solving netlist for f = %e\n",
+	    getName (), (double) freq);
+#endif
+
+  joinCircuits ();
+  saveResults (freq);
+  if (saveCVs & SAVE_CVS) saveCharacteristics (freq);
+}
+
+/* Saves all frequencies of the sweep into the dependency of the output
+   dataset at once. */
+void spsolver::saveFrequencies (void) {
+  vector * f;
+  if ((f = data->findDependency ("frequency")) == NULL) {
+    f = new vector ("frequency");
+    data->addDependency (f);
+  }
+  for (int i = 0; i < swp->getSize (); i++) f->add (swp->get (i));
 }
 
 /* The function goes through the list of circuit objects and creates
@@ -1086,10 +1152,9 @@ const char * spsolver::createCV (const std::string &c, const std::string &n) {
    saveCharacteristics() function.  Then puts these values into the
    dataset. */
 void spsolver::saveCharacteristics (nr_double_t freq) {
-  circuit * root = subnet->getRoot ();
   const char * n;
   vector * f = data->findDependency ("frequency");
-  for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ()) {
+  for (circuit * c : leaves) {
     c->saveCharacteristics (freq);
     if (!c->getSubcircuit ().empty() && !(saveCVs & SAVE_ALL)) continue;
     c->calcCharacteristics (freq);
@@ -1115,6 +1180,9 @@ PROP_OPT [] = {
   { "Values", PROP_LIST, { 10, PROP_NO_STR }, PROP_POS_RANGE },
   { "saveCVs", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
   { "saveAll", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+  { "Workers", PROP_INT, { 1, PROP_NO_STR }, PROP_RNGII (0, 256) },
+  { "Adaptive", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
+  { "AdaptTol", PROP_REAL, { 1e-3, PROP_NO_STR }, PROP_RNGXI (0, 1) },
   PROP_NO_PROP };
 struct define_t spsolver::anadef =
   { "SP", 0, PROP_ACTION, PROP_NO_SUBSTRATE, PROP_LINEAR, PROP_DEF };
@@ -26,6 +26,8 @@
 #define __SPSOLVER_H__
 
 #include <string>
+#include <vector>
+#include <unordered_set>
 
 namespace qucs {
 
@@ -54,10 +56,10 @@ class spsolver : public analysis
   void insertConnectors (node *);
   void insertOpen (node *);
   void insertGround (node *);
-  circuit * interconnectJoin (node *, node *);
-  circuit * connectedJoin (node *, node *);
-  void noiseConnect (circuit *, node *, node *);
-  void noiseInterconnect (circuit *, node *, node *);
+  void interconnectJoin (circuit *, int, int, circuit *);
+  void connectedJoin (circuit *, int, circuit *, int, circuit *);
+  void noiseConnect (circuit *, circuit *, int, circuit *, int);
+  void noiseInterconnect (circuit *, circuit *, int, int);
   void saveResults (nr_double_t);
   void saveNoiseResults (nr_complex_t[4], nr_complex_t[4],
 			 nr_double_t, vector *);
@@ -71,6 +73,21 @@ class spsolver : public analysis
   void dropDifferentialPort (circuit *);
   void dropConnections (void);
 
+ private:
+  void solveFrequency (nr_double_t);
+  void saveFrequencies (void);
+  circuit * joinedCircuit (node *, node *);
+  void prepareReduction (void);
+  void joinCircuits (void);
+  void dropReduction (void);
+
+  // a join of two ports of the reduction plan
+  struct spjoin {
+    circuit * s, * t;   // joined circuits, equal if interconnected
+    int k, l;           // joined ports
+    circuit * result;
+  };
+
  private:
   int tees, crosses, grounds, opens;
   int noise;
@@ -78,6 +95,9 @@ class spsolver : public analysis
   sweep * swp;
   nodelist * nlist;
   circuit * gnd;
+  std::vector<circuit *> leaves;
+  std::vector<spjoin> joins;
+  std::unordered_set<circuit *> results;
 };
 
 } // namespace qucs
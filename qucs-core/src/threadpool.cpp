@@ -0,0 +1,106 @@
+/*
+ * threadpool.cpp - thread pool class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "threadpool.h"
+
+namespace qucs {
+
+/* Constructor creates a thread pool with the given number of threads
+   including the calling thread.  Zero means one thread for each
+   available processor. */
+threadpool::threadpool (int n) {
+  threads = n > 0 ? n : hardwareThreads ();
+  tasks = pending = 0;
+  generation = 0;
+  quit = false;
+  task = NULL;
+  for (int i = 1; i < threads; i++)
+    workers.push_back (std::thread (&threadpool::worker, this, i));
+}
+
+// Destructor stops and joins the worker threads.
+threadpool::~threadpool () {
+  {
+    std::unique_lock<std::mutex> lock (mutex);
+    quit = true;
+  }
+  wake.notify_all ();
+  for (auto &t : workers) t.join ();
+}
+
+// Returns the number of concurrent threads supported by the machine.
+int threadpool::hardwareThreads (void) {
+  int n = (int) std::thread::hardware_concurrency ();
+  return n > 0 ? n : 1;
+}
+
+/* The function calls the given function for each index 0...n-1 and
+   returns when all of them are done.  The calling thread takes part
+   in the work. */
+void threadpool::run (int n, const std::function<void (int)> & f) {
+  if (threads <= 1 || n < 2) {
+    for (int i = 0; i < n; i++) f (i);
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock (mutex);
+    task = &f;
+    tasks = n;
+    pending = (int) workers.size ();
+    generation++;
+  }
+  wake.notify_all ();
+  runRange (0);
+  std::unique_lock<std::mutex> lock (mutex);
+  done.wait (lock, [this] { return pending == 0; });
+  task = NULL;
+}
+
+// Runs the part of the current loop belonging to the given thread.
+void threadpool::runRange (int id) {
+  int start = (int) ((long) tasks * id / threads);
+  int stop = (int) ((long) tasks * (id + 1) / threads);
+  for (int i = start; i < stop; i++) (*task) (i);
+}
+
+// The main loop of each worker thread.
+void threadpool::worker (int id) {
+  unsigned int seen = 0;
+  for (;;) {
+    std::unique_lock<std::mutex> lock (mutex);
+    wake.wait (lock, [&] { return quit || generation != seen; });
+    if (quit) return;
+    seen = generation;
+    lock.unlock ();
+    runRange (id);
+    lock.lock ();
+    if (--pending == 0) done.notify_one ();
+  }
+}
+
+} // namespace qucs
@@ -0,0 +1,68 @@
+/*
+ * threadpool.h - thread pool class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace qucs {
+
+/* The threadpool class runs loops of independent tasks in parallel.
+   The worker threads are created once and sleep in between.  Each
+   thread always gets the same contiguous range of the loop, thus the
+   distribution of the tasks does not depend on timing. */
+class threadpool
+{
+ public:
+  threadpool (int);
+  ~threadpool ();
+  int  getThreads (void) const { return threads; }
+  void run (int, const std::function<void (int)> &);
+  static int hardwareThreads (void);
+
+ private:
+  void worker (int);
+  void runRange (int);
+
+ private:
+  int threads;
+  int tasks;
+  int pending;
+  unsigned int generation;
+  bool quit;
+  const std::function<void (int)> * task;
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+};
+
+} // namespace qucs
+
+#endif /* __THREADPOOL_H__ */
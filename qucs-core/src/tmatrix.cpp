@@ -147,7 +147,7 @@ tvector<nr_type_t> tmatrix<nr_type_t>::getRow (int r) {
 // Puts the given tvector into the given row of the tmatrix instance.
 template <class nr_type_t>
 void tmatrix<nr_type_t>::setRow (int r, tvector<nr_type_t> v) {
-  assert (r >= 0 && r < rows && v.getSize () == cols);
+  assert (r >= 0 && r < rows && (int) v.size () == cols);
   nr_type_t * dst = &data[r * cols];
   nr_type_t * src = v.getData ();
   memcpy (dst, src, sizeof (nr_type_t) * cols);
@@ -167,7 +167,7 @@ tvector<nr_type_t> tmatrix<nr_type_t>::getCol (int c) {
 // Puts the given tvector into the given column of the tmatrix instance.
 template <class nr_type_t>
 void tmatrix<nr_type_t>::setCol (int c, tvector<nr_type_t> v) {
-  assert (c >= 0 && c < cols && v.getSize () == rows);
+  assert (c >= 0 && c < cols && (int) v.size () == rows);
   nr_type_t * dst = &data[c];
   nr_type_t * src = v.getData ();
   for (int r = 0; r < rows; r++, src++, dst += cols) *dst = *src;
@@ -176,6 +176,7 @@ int trsolver::solve (void)
     nr_double_t time, saveCurrent;
     int error = 0, convError = 0;
     const char * const solver = getPropertyString ("Solver");
+    setThreads (getPropertyInteger ("Threads"));
     relaxTSR = !strcmp (getPropertyString ("relaxTSR"), "yes") ? true : false;
     initialDC = !strcmp (getPropertyString ("initialDC"), "yes") ? true : false;
 
@@ -197,6 +198,8 @@ int trsolver::solve (void)
         eqnAlgo = ALGO_QR_DECOMPOSITION_LS;
     else if (!strcmp (solver, "GolubSVD"))
         eqnAlgo = ALGO_SV_DECOMPOSITION;
+    else if (!strcmp (solver, "SparseLU"))
+        eqnAlgo = ALGO_SPARSE_LU_DECOMPOSITION;
 
     // Perform initial DC analysis.
     if (initialDC)
@@ -325,7 +328,7 @@ int trsolver::solve (void)
             if (rejected) continue;
 
             // check whether Jacobian matrix is still non-singular
-            if (!A->isFinite ())
+            if (!isJacobianFinite ())
             {
                 logprint (LOG_ERROR, "ERROR: %s: Jacobian singular at t = %.3e, "
                           "aborting %s analysis\n", getName (), (double) current,
@@ -735,22 +738,15 @@ void trsolver::adjustOrder (int reduce)
    function. */
 void trsolver::calcDC (trsolver * self)
 {
-    circuit * root = self->getNet()->getRoot ();
-    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
-    {
-        c->calcDC ();
-    }
+    self->calculateCircuits ([] (circuit * c) { c->calcDC (); });
 }
 
 /* Goes through the list of circuit objects and runs its calcTR()
    function. */
 void trsolver::calcTR (trsolver * self)
 {
-    circuit * root = self->getNet()->getRoot ();
-    for (circuit * c = root; c != NULL; c = (circuit *) c->getNext ())
-    {
-        c->calcTR (self->current);
-    }
+    nr_double_t t = self->current;
+    self->calculateCircuits ([t] (circuit * c) { c->calcTR (t); });
 }
 
 /* Goes through the list of circuit objects and runs its initDC()
@@ -868,6 +864,8 @@ void trsolver::saveAllResults (nr_double_t time)
     }
     if (runs == 1) t->add (time);
     saveResults ("Vt", "It", 0, t);
+    // write large amounts of results into a streamed dataset
+    data->streamData ();
 }
 
 /* This function is meant to adapt the current time-step the transient
@@ -957,6 +955,7 @@ PROP_OPT [] =
     { "LTEfactor", PROP_REAL, { 1, PROP_NO_STR }, PROP_RNGII (1, 16) },
     { "Temp", PROP_REAL, { 26.85, PROP_NO_STR }, PROP_MIN_VAL (K) },
     { "Solver", PROP_STR, { PROP_NO_VAL, "CroutLU" }, PROP_RNG_SOL },
+    { "Threads", PROP_INT, { 1, PROP_NO_STR }, PROP_RNGII (0, 256) },
     { "relaxTSR", PROP_STR, { PROP_NO_VAL, "no" }, PROP_RNG_YESNO },
     { "initialDC", PROP_STR, { PROP_NO_VAL, "yes" }, PROP_RNG_YESNO },
     PROP_NO_PROP
@@ -0,0 +1,222 @@
+/*
+ * tspmatrix.cpp - sparse matrix template class implementation
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#else
+// BUG
+#include "qucs_typedefs.h"
+#endif
+
+#include <assert.h>
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+
+#include "compat.h"
+#include "complex.h"
+#include "tspmatrix.h"
+
+namespace qucs {
+
+// Constructor creates an unnamed instance of the tspmatrix class.
+template <class nr_type_t>
+tspmatrix<nr_type_t>::tspmatrix () : colPtr (1, 0) {
+  rows = 0;
+  cols = 0;
+}
+
+/* Constructor creates an empty square sparse matrix with the given
+   number of rows and columns. */
+template <class nr_type_t>
+tspmatrix<nr_type_t>::tspmatrix (int s) : colPtr (s + 1, 0) {
+  rows = cols = s;
+}
+
+/* Constructor creates an empty sparse matrix with the given number of
+   rows and columns. */
+template <class nr_type_t>
+tspmatrix<nr_type_t>::tspmatrix (int r, int c) : colPtr (c + 1, 0) {
+  rows = r;
+  cols = c;
+}
+
+/* This constructor creates a sparse matrix from the given dense
+   matrix.  Only non-zero entries and the diagonal are kept. */
+template <class nr_type_t>
+tspmatrix<nr_type_t>::tspmatrix (tmatrix<nr_type_t> & m) :
+  colPtr (m.getCols () + 1, 0) {
+  rows = m.getRows ();
+  cols = m.getCols ();
+  for (int c = 0; c < cols; c++) {
+    for (int r = 0; r < rows; r++) {
+      nr_type_t v = m (r, c);
+      if (v != 0.0 || r == c) append (r, v);
+    }
+    commitCol (c);
+  }
+}
+
+// Removes all entries from the matrix, the size is kept.
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::clear (void) {
+  colPtr.assign (cols + 1, 0);
+  rowIdx.clear ();
+  values.clear ();
+}
+
+// Reserves memory for the given number of non-zero entries.
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::reserve (int nnz) {
+  rowIdx.reserve (nnz);
+  values.reserve (nnz);
+}
+
+/* Appends an entry to the column currently being built.  The row
+   indices within a column must be given in ascending order. */
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::append (int r, nr_type_t v) {
+  assert (r >= 0 && r < rows);
+  rowIdx.push_back (r);
+  values.push_back (v);
+}
+
+/* Finishes the given column.  All entries appended since the previous
+   call belong to this column. */
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::commitCol (int c) {
+  assert (c >= 0 && c < cols);
+  colPtr[c + 1] = (int) values.size ();
+}
+
+/* Returns the position of the given entry in the value array or -1
+   if the entry is not part of the non-zero pattern. */
+template <class nr_type_t>
+int tspmatrix<nr_type_t>::find (int r, int c) const {
+  assert (r >= 0 && r < rows && c >= 0 && c < cols);
+  const int * b = rowIdx.data () + colPtr[c];
+  const int * e = rowIdx.data () + colPtr[c + 1];
+  const int * i = std::lower_bound (b, e, r);
+  if (i != e && *i == r) return (int) (i - rowIdx.data ());
+  return -1;
+}
+
+// Returns the matrix element at the given row and column.
+template <class nr_type_t>
+nr_type_t tspmatrix<nr_type_t>::get (int r, int c) const {
+  int i = find (r, c);
+  return i < 0 ? nr_type_t (0.0) : values[i];
+}
+
+/* Sets the matrix element at the given row and column.  The entry
+   must be part of the non-zero pattern unless the value is zero. */
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::set (int r, int c, nr_type_t z) {
+  int i = find (r, c);
+  assert (i >= 0 || z == 0.0);
+  if (i >= 0) values[i] = z;
+}
+
+// Adds the given value to the matrix element at the given position.
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::add (int r, int c, nr_type_t z) {
+  int i = find (r, c);
+  assert (i >= 0 || z == 0.0);
+  if (i >= 0) values[i] += z;
+}
+
+// Sets all the non-zero pattern elements to the given value.
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::set (nr_type_t z) {
+  std::fill (values.begin (), values.end (), z);
+}
+
+// Transposes the matrix in place.
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::transpose (void) {
+  int nnz = getNonZeros ();
+  std::vector<int> tPtr (rows + 1, 0);
+  std::vector<int> tIdx (nnz);
+  std::vector<nr_type_t> tVal (nnz);
+
+  // count entries in each row
+  for (int i = 0; i < nnz; i++) tPtr[rowIdx[i] + 1]++;
+  for (int r = 0; r < rows; r++) tPtr[r + 1] += tPtr[r];
+
+  // scatter the entries into the transposed columns
+  std::vector<int> next (tPtr.begin (), tPtr.end () - 1);
+  for (int c = 0; c < cols; c++) {
+    for (int i = colPtr[c]; i < colPtr[c + 1]; i++) {
+      int p = next[rowIdx[i]]++;
+      tIdx[p] = c;
+      tVal[p] = values[i];
+    }
+  }
+  colPtr.swap (tPtr);
+  rowIdx.swap (tIdx);
+  values.swap (tVal);
+  std::swap (rows, cols);
+}
+
+// Checks validity of matrix.
+template <class nr_type_t>
+int tspmatrix<nr_type_t>::isFinite (void) {
+  for (int i = 0; i < getNonZeros (); i++)
+    if (!std::isfinite (real (values[i]))) return 0;
+  return 1;
+}
+
+// Multiplication of sparse matrix and vector.
+template <class nr_type_t>
+tvector<nr_type_t> tspmatrix<nr_type_t>::operator * (tvector<nr_type_t> b) {
+  assert (cols == (int) b.size ());
+  tvector<nr_type_t> res (rows);
+  for (int c = 0; c < cols; c++) {
+    nr_type_t z = b.get (c);
+    if (z == 0.0) continue;
+    for (int i = colPtr[c]; i < colPtr[c + 1]; i++)
+      res (rowIdx[i]) += values[i] * z;
+  }
+  return res;
+}
+
+#ifdef DEBUG
+// Debug function: Prints the non-zero entries of the matrix object.
+template <class nr_type_t>
+void tspmatrix<nr_type_t>::print (bool realonly) {
+  for (int c = 0; c < cols; c++) {
+    for (int i = colPtr[c]; i < colPtr[c + 1]; i++) {
+      if (realonly) {
+	fprintf (stderr, "(%d,%d) %+.2e\n", rowIdx[i], c,
+		 (double) real (values[i]));
+      } else {
+	fprintf (stderr, "(%d,%d) %+.2e%+.2ei\n", rowIdx[i], c,
+		 (double) real (values[i]), (double) imag (values[i]));
+      }
+    }
+  }
+}
+#endif /* DEBUG */
+
+} // namespace qucs
@@ -0,0 +1,89 @@
+/*
+ * tspmatrix.h - sparse matrix template class definitions
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef __TSPMATRIX_H__
+#define __TSPMATRIX_H__
+
+#include <vector>
+#include <assert.h>
+
+#include "tvector.h"
+#include "tmatrix.h"
+
+namespace qucs {
+
+/* The tspmatrix class stores a sparse matrix in compressed sparse
+   column (CSC) format.  The non-zero pattern is set up once column by
+   column using append() and commitCol(), afterwards only the values
+   of the existing entries are going to be modified. */
+template <class nr_type_t>
+class tspmatrix
+{
+ public:
+  tspmatrix ();
+  tspmatrix (int);
+  tspmatrix (int, int);
+  tspmatrix (tmatrix<nr_type_t> &);
+  tspmatrix (const tspmatrix &) = default;
+  tspmatrix & operator = (const tspmatrix &) = default;
+  ~tspmatrix () = default;
+
+  // pattern construction
+  void clear (void);
+  void reserve (int);
+  void append (int, nr_type_t);
+  void commitCol (int);
+
+  // element access
+  int  find (int, int) const;
+  nr_type_t get (int, int) const;
+  void set (int, int, nr_type_t);
+  void add (int, int, nr_type_t);
+  void set (nr_type_t);
+
+  int  getCols (void) const { return cols; }
+  int  getRows (void) const { return rows; }
+  int  getNonZeros (void) const { return (int) values.size (); }
+  int * getColPtr (void) { return colPtr.data (); }
+  int * getRowIdx (void) { return rowIdx.data (); }
+  nr_type_t * getData (void) { return values.data (); }
+
+  void transpose (void);
+  int  isFinite (void);
+  tvector<nr_type_t> operator * (tvector<nr_type_t>);
+  void print (bool realonly = false);
+
+ private:
+  int cols;
+  int rows;
+  std::vector<int> colPtr;
+  std::vector<int> rowIdx;
+  std::vector<nr_type_t> values;
+};
+
+} // namespace qucs
+
+#include "tspmatrix.cpp"
+
+#endif /* __TSPMATRIX_H__ */
@@ -54,6 +54,16 @@
 
 using namespace qucs;
 
+// Checks whether the given environment has equations to be exported.
+static int hasOutputEquations (environment * env) {
+  eqn::checker * checkee = env->getChecker ();
+  if (checkee == NULL) return 0;
+  for (eqn::node * eqn = checkee->getEquations (); eqn != NULL;
+       eqn = eqn->getNext ())
+    if (eqn->output) return 1;
+  return 0;
+}
+
 /*! \todo replace environement name root by "/" in order to be filesystem compatible */
 int main (int argc, char ** argv) {
 
@@ -66,6 +76,8 @@ int main (int argc, char ** argv) {
   dataset * out;
   environment * root;
   int listing = 0;
+  int binary = 0;
+  int stream = 0;
   int ret = 0;
   int dynamicLoad = 0;
 
@@ -100,6 +112,8 @@ int main (int argc, char ** argv) {
 	"  -v, --version  display version information and exit\n"
 	"  -i FILENAME    use file as input netlist (default stdin)\n"
 	"  -o FILENAME    use file as output dataset (default stdout)\n"
+	"  -B, --binary   write the output dataset in binary format\n"
+	"  -S, --stream   write the binary output dataset during the simulation\n"
 	"  -b, --bar      enable textual progress bar\n"
 	"  -g, --gui      special progress bar used by gui\n"
 	"  -c, --check    check the input netlist and exit\n"
@@ -118,6 +132,12 @@ int main (int argc, char ** argv) {
       outfile = argv[++i];
       redirect_status_to_stdout();
     }
+    else if (!strcmp (argv[i], "-B") || !strcmp (argv[i], "--binary")) {
+      binary = 1;
+    }
+    else if (!strcmp (argv[i], "-S") || !strcmp (argv[i], "--stream")) {
+      binary = stream = 1;
+    }
     else if (!strcmp (argv[i], "-b") || !strcmp (argv[i], "--bar")) {
       progressbar_enable = 1;
     }
@@ -246,14 +266,26 @@ int main (int argc, char ** argv) {
   gnd->setName ("GND");
   subnet->insertCircuit (gnd);
 
+  // stream results into the output file during the analyses
+  out = new dataset ();
+  out->setFile (outfile);
+  out->setBinary (binary);
+  if (stream) {
+    if (outfile != NULL)
+      out->setStream (DATASET_STREAM_CHUNK);
+    else
+      logprint (LOG_ERROR, "cannot stream dataset into stdout\n");
+  }
+
   // analyse the netlist
   int err = 0;
-  out = subnet->runAnalysis (err);
+  subnet->runAnalysis (err, out);
   ret |= err;
 
-  // evaluate output dataset
+  // evaluate output dataset, streamed data is needed in memory for that
+  if (out->isStreaming () && hasOutputEquations (root))
+    out->restoreStream ();
   ret |= root->equationSolver (out);
-  out->setFile (outfile);
   out->print ();
 
   estack.print ("uncaught");
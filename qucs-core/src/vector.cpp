@@ -136,6 +136,37 @@ const vector& vector::operator=(const vector & v) {
   return *this;
 }
 
+/* The move constructor takes over the data and the properties of the
+   given vector object. */
+vector::vector (vector && v) : object (v) {
+  size = v.size;
+  capacity = v.capacity;
+  data = v.data;
+  dependencies = v.dependencies;
+  origin = v.origin;
+  requested = v.requested;
+  next = v.next;
+  prev = v.prev;
+  v.data = NULL;
+  v.size = v.capacity = 0;
+  v.dependencies = NULL;
+  v.origin = NULL;
+}
+
+/* The move assignment takes over the data of the given vector object
+   and leaves any other properties untouched. */
+vector & vector::operator=(vector && v) {
+  if (&v != this) {
+    free (data);
+    size = v.size;
+    capacity = v.capacity;
+    data = v.data;
+    v.data = NULL;
+    v.size = v.capacity = 0;
+  }
+  return *this;
+}
+
 // Destructor deletes a vector object.
 vector::~vector () {
   free (data);
@@ -169,6 +200,12 @@ void vector::add (nr_complex_t c) {
   data[size++] = c;
 }
 
+/* Removes all data items from the vector.  The memory is kept in
+   order to be reused by subsequent calls to add(). */
+void vector::clear (void) {
+  size = 0;
+}
+
 /* This function appends the given vector to the vector. */
 void vector::add (vector * v) {
   if (v != NULL) {
@@ -185,7 +222,7 @@ void vector::add (vector * v) {
 }
 
 // Returns the complex data item at the given position.
-nr_complex_t vector::get (int i) {
+nr_complex_t vector::get (int i) const {
   return data[i];
 }
 
@@ -202,7 +239,7 @@ int vector::getSize (void) const {
   return size;
 }
 
-int vector::checkSizes (vector v1, vector v2) {
+int vector::checkSizes (const vector & v1, const vector & v2) {
   if (v1.getSize () != v2.getSize ()) {
     logprint (LOG_ERROR, "vector '%s' and '%s' have different sizes\n",
 	      v1.getName (), v2.getName ());
@@ -241,7 +278,7 @@ nr_double_t vector::minimum (void) {
 
 /* Unwraps a phase vector in radians.  Adds +/- 2*Pi if consecutive
    values jump about |Pi|. */
-vector unwrap (vector v, nr_double_t tol, nr_double_t step) {
+vector unwrap (const vector & v, nr_double_t tol, nr_double_t step) {
   vector result (v.getSize ());
   nr_double_t add = 0;
   result (0) = v (0);
@@ -257,61 +294,61 @@ vector unwrap (vector v, nr_double_t tol, nr_double_t step) {
   return result;
 }
 
-nr_complex_t sum (vector v) {
+nr_complex_t sum (const vector & v) {
   nr_complex_t result (0.0);
   for (int i = 0; i < v.getSize (); i++) result += v.get (i);
   return result;
 }
 
-nr_complex_t prod (vector v) {
+nr_complex_t prod (const vector & v) {
   nr_complex_t result (1.0);
   for (int i = 0; i < v.getSize (); i++) result *= v.get (i);
   return result;
 }
 
-nr_complex_t avg (vector v) {
+nr_complex_t avg (const vector & v) {
   nr_complex_t result (0.0);
   for (int i = 0; i < v.getSize (); i++) result += v.get (i);
   return result / (nr_double_t) v.getSize ();
 }
 
-vector signum (vector v) {
+vector signum (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (signum (v.get (i)), i);
   return result;
 }
 
-vector sign (vector v) {
+vector sign (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (sign (v.get (i)), i);
   return result;
 }
 
-vector xhypot (vector v, const nr_complex_t z) {
+vector xhypot (const vector & v, const nr_complex_t z) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (xhypot (v.get(i), z), i);
   return result;
 }
 
-vector xhypot (vector v, const nr_double_t d) {
+vector xhypot (const vector & v, const nr_double_t d) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (xhypot (v.get(i), d), i);
   return result;
 }
 
-vector xhypot (const nr_complex_t z, vector v) {
+vector xhypot (const nr_complex_t z, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (xhypot (z, v.get (i)), i);
   return result;
 }
 
-vector xhypot (const nr_double_t d, vector v) {
+vector xhypot (const nr_double_t d, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (xhypot (d, v.get (i)), i);
   return result;
 }
 
-vector xhypot (vector v1, vector v2) {
+vector xhypot (const vector & v1, const vector & v2) {
   int j, i, n, len, len1 = v1.getSize (), len2 = v2.getSize ();
   if (len1 >= len2) {
     assert (len1 % len2 == 0);
@@ -328,116 +365,115 @@ vector xhypot (vector v1, vector v2) {
   return res;
 }
 
-vector sinc (vector v) {
+vector sinc (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (sinc (v.get (i)), i);
   return result;
 }
 
-vector abs (vector v) {
+vector abs (const vector & v) {
   vector result (v);
-  for (int i = 0; i < v.getSize (); i++) result.set (abs (v.get (i)), i);
+  simd::abs (result.data, result.data, result.getSize ());
   return result;
 }
 
-vector norm (vector v) {
+vector norm (const vector & v) {
   vector result (v);
-  for (int i = 0; i < v.getSize (); i++) result.set (norm (v.get (i)), i);
+  simd::norm (result.data, result.data, result.getSize ());
   return result;
 }
 
-vector arg (vector v) {
+vector arg (const vector & v) {
   vector result (v);
-  for (int i = 0; i < v.getSize (); i++) result.set (arg (v.get (i)), i);
+  simd::arg (result.data, result.data, result.getSize ());
   return result;
 }
 
-vector real (vector v) {
+vector real (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (real (v.get (i)), i);
   return result;
 }
 
-vector imag (vector v) {
+vector imag (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (imag (v.get (i)), i);
   return result;
 }
 
-vector conj (vector v) {
+vector conj (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (conj (v.get (i)), i);
   return result;
 }
 
-vector dB (vector v) {
+vector dB (const vector & v) {
   vector result (v);
-  for (int i = 0; i < v.getSize (); i++)
-    result.set (10.0 * std::log10 (norm (v.get (i))), i);
+  simd::dB (result.data, result.data, result.getSize ());
   return result;
 }
 
-vector sqrt (vector v) {
+vector sqrt (const vector & v) {
   vector result (v);
-  for (int i = 0; i < v.getSize (); i++) result.set (sqrt (v.get (i)), i);
+  simd::sqrt (result.data, result.data, result.getSize ());
   return result;
 }
 
-vector exp (vector v) {
+vector exp (const vector & v) {
   vector result (v);
-  for (int i = 0; i < v.getSize (); i++) result.set (exp (v.get (i)), i);
+  simd::exp (result.data, result.data, result.getSize ());
   return result;
 }
 
-vector limexp (vector v) {
+vector limexp (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (limexp (v.get (i)), i);
   return result;
 }
 
-vector log (vector v) {
+vector log (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (log (v.get (i)), i);
   return result;
 }
 
-vector log10 (vector v) {
+vector log10 (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (log10 (v.get (i)), i);
   return result;
 }
 
-vector log2 (vector v) {
+vector log2 (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (log2 (v.get (i)), i);
   return result;
 }
 
-vector pow (vector v, const nr_complex_t z) {
+vector pow (const vector & v, const nr_complex_t z) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (pow (v.get(i), z), i);
   return result;
 }
 
-vector pow (vector v, const nr_double_t d) {
+vector pow (const vector & v, const nr_double_t d) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (pow (v.get(i), d), i);
   return result;
 }
 
-vector pow (const nr_complex_t z, vector v) {
+vector pow (const nr_complex_t z, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (pow (z, v.get (i)), i);
   return result;
 }
 
-vector pow (const nr_double_t d, vector v) {
+vector pow (const nr_double_t d, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (pow (d, v.get (i)), i);
   return result;
 }
 
-vector pow (vector v1, vector v2) {
+vector pow (const vector & v1, const vector & v2) {
   int j, i, n, len, len1 = v1.getSize (), len2 = v2.getSize ();
   if (len1 >= len2) {
     assert (len1 % len2 == 0);
@@ -454,150 +490,150 @@ vector pow (vector v1, vector v2) {
   return res;
 }
 
-vector sin (vector v) {
+vector sin (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (sin (v.get (i)), i);
   return result;
 }
 
-vector asin (vector v) {
+vector asin (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (asin (v.get (i)), i);
   return result;
 }
 
-vector acos (vector v) {
+vector acos (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (acos (v.get (i)), i);
   return result;
 }
 
-vector cos (vector v) {
+vector cos (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (cos (v.get (i)), i);
   return result;
 }
 
-vector tan (vector v) {
+vector tan (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (tan (v.get (i)), i);
   return result;
 }
 
-vector atan (vector v) {
+vector atan (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (atan (v.get (i)), i);
   return result;
 }
 
-vector cot (vector v) {
+vector cot (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (cot (v.get (i)), i);
   return result;
 }
 
-vector acot (vector v) {
+vector acot (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (acot (v.get (i)), i);
   return result;
 }
 
-vector sinh (vector v) {
+vector sinh (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (sinh (v.get (i)), i);
   return result;
 }
 
-vector asinh (vector v) {
+vector asinh (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (asinh (v.get (i)), i);
   return result;
 }
 
-vector cosh (vector v) {
+vector cosh (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (cosh (v.get (i)), i);
   return result;
 }
 
-vector sech (vector v) {
+vector sech (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (sech (v.get (i)), i);
   return result;
 }
 
-vector cosech (vector v) {
+vector cosech (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (cosech (v.get (i)), i);
   return result;
 }
 
-vector acosh (vector v) {
+vector acosh (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (acosh (v.get (i)), i);
   return result;
 }
 
-vector asech (vector v) {
+vector asech (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (asech (v.get (i)), i);
   return result;
 }
 
-vector tanh (vector v) {
+vector tanh (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (tanh (v.get (i)), i);
   return result;
 }
 
-vector atanh (vector v) {
+vector atanh (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (atanh (v.get (i)), i);
   return result;
 }
 
-vector coth (vector v) {
+vector coth (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (coth (v.get (i)), i);
   return result;
 }
 
-vector acoth (vector v) {
+vector acoth (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (acoth (v.get (i)), i);
   return result;
 }
 
 // converts impedance to reflexion coefficient
-vector ztor (vector v, nr_complex_t zref) {
+vector ztor (const vector & v, nr_complex_t zref) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result (i) = ztor (v (i), zref);
   return result;
 }
 
 // converts admittance to reflexion coefficient
-vector ytor (vector v, nr_complex_t zref) {
+vector ytor (const vector & v, nr_complex_t zref) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result (i) = ytor (v (i), zref);
   return result;
 }
 
 // converts reflexion coefficient to impedance
-vector rtoz (vector v, nr_complex_t zref) {
+vector rtoz (const vector & v, nr_complex_t zref) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result (i) = rtoz (v (i), zref);
   return result;
 }
 
 // converts reflexion coefficient to admittance
-vector rtoy (vector v, nr_complex_t zref) {
+vector rtoy (const vector & v, nr_complex_t zref) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result (i) = rtoy (v (i), zref);
   return result;
 }
 
 // differentiates 'var' with respect to 'dep' exactly 'n' times
-vector diff (vector var, vector dep, int n) {
+vector diff (const vector & var, const vector & dep, int n) {
   int k, xi, yi, exchange = 0;
   vector x, y;
   // exchange dependent and independent variable if necessary
@@ -635,263 +671,129 @@ vector diff (vector var, vector dep, int n) {
   return result;
 }
 
-vector vector::operator=(const nr_complex_t c) {
+vector & vector::operator=(const nr_complex_t c) {
   for (int i = 0; i < size; i++) data[i] = c;
   return *this;
 }
 
-vector vector::operator=(const nr_double_t d) {
+vector & vector::operator=(const nr_double_t d) {
   for (int i = 0; i < size; i++) data[i] = d;
   return *this;
 }
 
-vector vector::operator+=(vector v) {
+vector & vector::operator+=(const vector & v) {
   int i, n, len = v.getSize ();
   assert (size % len == 0);
+  if (len == size) {
+    simd::add (data, data, v.data, size);
+    return *this;
+  }
   for (i = n = 0; i < size; i++) { data[i] += v (n); if (++n >= len) n = 0; }
   return *this;
 }
 
-vector vector::operator+=(const nr_complex_t c) {
+vector & vector::operator+=(const nr_complex_t c) {
   for (int i = 0; i < size; i++) data[i] += c;
   return *this;
 }
 
-vector vector::operator+=(const nr_double_t d) {
+vector & vector::operator+=(const nr_double_t d) {
   for (int i = 0; i < size; i++) data[i] += d;
   return *this;
 }
 
-vector operator+(vector v1, vector v2) {
-  int len1 = v1.getSize (), len2 = v2.getSize ();
-  vector result;
-  if (len1 >= len2) {
-    result  = v1;
-    result += v2;
-  } else {
-    result  = v2;
-    result += v1;
-  }
-  return result;
-}
-
-vector operator+(vector v, const nr_complex_t c) {
-  vector result (v);
-  result += c;
-  return result;
-}
-
-vector operator+(const nr_complex_t c, vector v) {
-  return v + c;
-}
-
-vector operator+(vector v, const nr_double_t d) {
-  vector result (v);
-  result += d;
-  return result;
-}
-
-vector operator+(const nr_double_t d, vector v) {
-  return v + d;
-}
-
-vector vector::operator-() {
-  vector result (size);
-  for (int i = 0; i < size; i++) result (i) = -data[i];
-  return result;
-}
-
-vector vector::operator-=(vector v) {
+vector & vector::operator-=(const vector & v) {
   int i, n, len = v.getSize ();
   assert (size % len == 0);
+  if (len == size) {
+    simd::sub (data, data, v.data, size);
+    return *this;
+  }
   for (i = n = 0; i < size; i++) { data[i] -= v (n); if (++n >= len) n = 0; }
   return *this;
 }
 
-vector vector::operator-=(const nr_complex_t c) {
+vector & vector::operator-=(const nr_complex_t c) {
   for (int i = 0; i < size; i++) data[i] -= c;
   return *this;
 }
 
-vector vector::operator-=(const nr_double_t d) {
+vector & vector::operator-=(const nr_double_t d) {
   for (int i = 0; i < size; i++) data[i] -= d;
   return *this;
 }
 
-vector operator-(vector v1, vector v2) {
-  int len1 = v1.getSize (), len2 = v2.getSize ();
-  vector result;
-  if (len1 >= len2) {
-    result  = v1;
-    result -= v2;
-  } else {
-    result  = -v2;
-    result += v1;
-  }
-  return result;
-}
-
-vector operator-(vector v, const nr_complex_t c) {
-  vector result (v);
-  result -= c;
-  return result;
-}
-
-vector operator-(vector v, const nr_double_t d) {
-  vector result (v);
-  result -= d;
-  return result;
-}
-
-vector operator-(const nr_complex_t c, vector v) {
-  vector result (-v);
-  result += c;
-  return result;
-}
-
-vector operator-(const nr_double_t d, vector v) {
-  vector result (-v);
-  result += d;
-  return result;
-}
-
-vector vector::operator*=(vector v) {
+vector & vector::operator*=(const vector & v) {
   int i, n, len = v.getSize ();
   assert (size % len == 0);
+  if (len == size) {
+    simd::mul (data, data, v.data, size);
+    return *this;
+  }
   for (i = n = 0; i < size; i++) { data[i] *= v (n); if (++n >= len) n = 0; }
   return *this;
 }
 
-vector vector::operator*=(const nr_complex_t c) {
+vector & vector::operator*=(const nr_complex_t c) {
   for (int i = 0; i < size; i++) data[i] *= c;
   return *this;
 }
 
-vector vector::operator*=(const nr_double_t d) {
+vector & vector::operator*=(const nr_double_t d) {
   for (int i = 0; i < size; i++) data[i] *= d;
   return *this;
 }
 
-vector operator*(vector v1, vector v2) {
-  int len1 = v1.getSize (), len2 = v2.getSize ();
-  vector result;
-  if (len1 >= len2) {
-    result  = v1;
-    result *= v2;
-  } else {
-    result  = v2;
-    result *= v1;
-  }
-  return result;
-}
-
-vector operator*(vector v, const nr_complex_t c) {
-  vector result (v);
-  result *= c;
-  return result;
-}
-
-vector operator*(vector v, const nr_double_t d) {
-  vector result (v);
-  result *= d;
-  return result;
-}
-
-vector operator*(const nr_complex_t c, vector v) {
-  return v * c;
-}
-
-vector operator*(const nr_double_t d, vector v) {
-  return v * d;
-}
-
-vector vector::operator/=(vector v) {
+vector & vector::operator/=(const vector & v) {
   int i, n, len = v.getSize ();
   assert (size % len == 0);
+  if (len == size) {
+    simd::div (data, data, v.data, size);
+    return *this;
+  }
   for (i = n = 0; i < size; i++) { data[i] /= v (n); if (++n >= len) n = 0; }
   return *this;
 }
 
-vector vector::operator/=(const nr_complex_t c) {
+vector & vector::operator/=(const nr_complex_t c) {
   for (int i = 0; i < size; i++) data[i] /= c;
   return *this;
 }
 
-vector vector::operator/=(const nr_double_t d) {
+vector & vector::operator/=(const nr_double_t d) {
   for (int i = 0; i < size; i++) data[i] /= d;
   return *this;
 }
 
-vector operator/(vector v1, vector v2) {
-  int len1 = v1.getSize (), len2 = v2.getSize ();
-  vector result;
-  if (len1 >= len2) {
-    assert (len1 % len2 == 0);
-    result  = v1;
-    result /= v2;
-  } else {
-    assert (len2 % len1 == 0);
-    result  = 1 / v2;
-    result *= v1;
-  }
-  return result;
-}
-
-vector operator/(vector v, const nr_complex_t c) {
-  vector result (v);
-  result /= c;
-  return result;
-}
-
-vector operator/(vector v, const nr_double_t d) {
-  vector result (v);
-  result /= d;
-  return result;
-}
-
-vector operator/(const nr_complex_t c, vector v) {
-  vector result (v);
-  result  = c;
-  result /= v;
-  return result;
-}
-
-vector operator/(const nr_double_t d, vector v) {
-  vector result (v);
-  result  = d;
-  result /= v;
-  return result;
-}
-
-vector operator%(vector v, const nr_complex_t z) {
+vector operator%(const vector & v, const nr_complex_t z) {
   int len = v.getSize ();
   vector result (len);
   for (int i = 0; i < len; i++) result (i) = v (i) % z;
   return result;
 }
 
-vector operator%(vector v, const nr_double_t d) {
+vector operator%(const vector & v, const nr_double_t d) {
   int len = v.getSize ();
   vector result (len);
   for (int i = 0; i < len; i++) result (i) = v (i) % d;
   return result;
 }
 
-vector operator%(const nr_complex_t z, vector v) {
+vector operator%(const nr_complex_t z, const vector & v) {
   int len = v.getSize ();
   vector result (len);
   for (int i = 0; i < len; i++) result (i) = z % v (i);
   return result;
 }
 
-vector operator%(const nr_double_t d, vector v) {
+vector operator%(const nr_double_t d, const vector & v) {
   int len = v.getSize ();
   vector result (len);
   for (int i = 0; i < len; i++) result (i) = d % v (i);
   return result;
 }
 
-vector operator%(vector v1, vector v2) {
+vector operator%(const vector & v1, const vector & v2) {
   int j, i, n, len, len1 = v1.getSize (), len2 = v2.getSize ();
   if (len1 >= len2) {
     assert (len1 % len2 == 0);
@@ -998,7 +900,7 @@ vector logspace (nr_double_t start, nr_double_t stop, int points) {
   return result;
 }
 
-vector cumsum (vector v) {
+vector cumsum (const vector & v) {
   vector result (v);
   nr_complex_t val (0.0);
   for (int i = 0; i < v.getSize (); i++) {
@@ -1008,7 +910,7 @@ vector cumsum (vector v) {
   return result;
 }
 
-vector cumavg (vector v) {
+vector cumavg (const vector & v) {
   vector result (v);
   nr_complex_t val (0.0);
   for (int i = 0; i < v.getSize (); i++) {
@@ -1018,7 +920,7 @@ vector cumavg (vector v) {
   return result;
 }
 
-vector cumprod (vector v) {
+vector cumprod (const vector & v) {
   vector result (v);
   nr_complex_t val (1.0);
   for (int i = 0; i < v.getSize (); i++) {
@@ -1028,43 +930,43 @@ vector cumprod (vector v) {
   return result;
 }
 
-vector ceil (vector v) {
+vector ceil (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (ceil (v.get (i)), i);
   return result;
 }
 
-vector fix (vector v) {
+vector fix (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (fix (v.get (i)), i);
   return result;
 }
 
-vector floor (vector v) {
+vector floor (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (floor (v.get (i)), i);
   return result;
 }
 
-vector round (vector v) {
+vector round (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (round (v.get (i)), i);
   return result;
 }
 
-vector sqr (vector v) {
+vector sqr (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (sqr (v.get (i)), i);
   return result;
 }
 
-vector step (vector v) {
+vector step (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (step (v.get (i)), i);
   return result;
 }
 
-static nr_double_t integrate_n (vector v) { /* using trapezoidal rule */
+static nr_double_t integrate_n (const vector & v) { /* using trapezoidal rule */
   nr_double_t result = 0.0;
   for (int i = 1; i < v.getSize () - 1; i++) result += norm (v.get (i));
   result += 0.5 * norm (v.get (0));
@@ -1090,73 +992,73 @@ nr_double_t vector::stddev (void) {
   return std::sqrt (variance ());
 }
 
-vector erf (vector v) {
+vector erf (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (erf (v.get (i)), i);
   return result;
 }
 
-vector erfc (vector v) {
+vector erfc (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (erfc (v.get (i)), i);
   return result;
 }
 
-vector erfinv (vector v) {
+vector erfinv (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (erfinv (v.get (i)), i);
   return result;
 }
 
-vector erfcinv (vector v) {
+vector erfcinv (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (erfcinv (v.get (i)), i);
   return result;
 }
 
-vector rad2deg (vector v) {
+vector rad2deg (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (rad2deg (v.get (i)), i);
   return result;
 }
 
-vector deg2rad (vector v) {
+vector deg2rad (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (deg2rad (v.get (i)), i);
   return result;
 }
 
-vector i0 (vector v) {
+vector i0 (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (i0 (v.get (i)), i);
   return result;
 }
 
-vector jn (const int n, vector v) {
+vector jn (const int n, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (jn (n, v.get (i)), i);
   return result;
 }
 
-vector yn (const int n, vector v) {
+vector yn (const int n, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (yn (n, v.get (i)), i);
   return result;
 }
 
-vector polar (const nr_complex_t a, vector v) {
+vector polar (const nr_complex_t a, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (qucs::polar (a, v.get (i)), i);
   return result;
 }
 
-vector polar (vector v, const nr_complex_t p) {
+vector polar (const vector & v, const nr_complex_t p) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++) result.set (qucs::polar (v.get (i), p), i);
   return result;
 }
 
-vector polar (vector a, vector p) {
+vector polar (const vector & a, const vector & p) {
   int j, i, n, len, len1 = a.getSize (), len2 = p.getSize ();
   if (len1 >= len2) {
     assert (len1 % len2 == 0);
@@ -1173,21 +1075,21 @@ vector polar (vector a, vector p) {
   return res;
 }
 
-vector atan2 (const nr_double_t y, vector v) {
+vector atan2 (const nr_double_t y, const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++)
     result.set (atan2 (y, v.get (i)), i);
   return result;
 }
 
-vector atan2 (vector v, const nr_double_t x) {
+vector atan2 (const vector & v, const nr_double_t x) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++)
     result.set (atan2 (v.get (i), x) , i);
   return result;
 }
 
-vector atan2 (vector y, vector x) {
+vector atan2 (const vector & y, const vector & x) {
   int j, i, n, len, len1 = y.getSize (), len2 = x.getSize ();
   if (len1 >= len2) {
     assert (len1 % len2 == 0);
@@ -1204,28 +1106,28 @@ vector atan2 (vector y, vector x) {
   return res;
 }
 
-vector w2dbm (vector v) {
+vector w2dbm (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++)
     result.set (10.0 * log10 (v.get (i) / 0.001), i);
   return result;
 }
 
-vector dbm2w (vector v) {
+vector dbm2w (const vector & v) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++)
     result.set (0.001 * pow (10.0 , v.get (i) / 10.0), i);
   return result;
 }
 
-nr_double_t integrate (vector v, const nr_double_t h) {
+nr_double_t integrate (const vector & v, const nr_double_t h) {
   nr_double_t s = real (v.get (0) ) / 2;
   for (int i = 1; i < v.getSize () - 1; i++)
     s += real (v.get (i));
   return (s + real (v.get (v.getSize () - 1) ) / 2) * h;
 }
 
-nr_complex_t integrate (vector v, const nr_complex_t h) {
+nr_complex_t integrate (const vector & v, const nr_complex_t h) {
   nr_complex_t s;
   s = v.get (0) / 2.0;
   for (int i = 1; i < v.getSize () - 1; i++)
@@ -1233,7 +1135,7 @@ nr_complex_t integrate (vector v, const nr_complex_t h) {
   return (s + v.get (v.getSize () - 1) / 2.0) * h;
 }
 
-vector dbm (vector v, const nr_complex_t z) {
+vector dbm (const vector & v, const nr_complex_t z) {
   vector result (v);
   for (int i = 0; i < v.getSize (); i++)
     result.set (10.0 * log10 (norm (v.get (i)) / conj (z) / 0.001), i);
@@ -1246,7 +1148,7 @@ vector runavg (const nr_complex_t x, const int n) {
   return result;
 }
 
-vector runavg (vector v, const int n) {
+vector runavg (const vector & v, const int n) {
   nr_complex_t s (0.0), y;
   int len = v.getSize () - n + 1, i;
   vector result (len);
@@ -1263,7 +1165,7 @@ vector runavg (vector v, const int n) {
 // smooth a vector over an aperture a
 // done extending the vector endpoints and using a two-sided moving average
 // moving average length is always odd
-vector smooth(vector v, nr_double_t a) {
+vector smooth(const vector & v, nr_double_t a) {
   int len = v.getSize (), i;
   int t2 = floor(len/2 * a / 100); // moving average is over 2*t2+1 elements
   // auxiliary vector, extend original vector at beginning and end
@@ -1283,7 +1185,7 @@ vector smooth(vector v, nr_double_t a) {
 }
 
 //Ths function calculates the group delay from the svec=S[i,j] and frequency vectors
-vector groupdelay(vector svec, vector freq)
+vector groupdelay(const vector & svec, const vector & freq)
 {
  return -diff(unwrap(arg(svec)), (2*pi)*(freq));
 }
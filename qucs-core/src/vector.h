@@ -27,10 +27,13 @@
 #define __VECTOR_H__
 
 #include <limits>
+#include <cassert>
+#include <cstdlib>
 
 #include "consts.h"
 #include "precision.h"
 #include "complex.h"
+#include "simd.h"
 
 #ifdef log2
 #undef log2
@@ -43,10 +46,23 @@ class vector;
 
 qucs::vector linspace (nr_double_t, nr_double_t, int);
 qucs::vector logspace (nr_double_t, nr_double_t, int);
-qucs::vector runavg (qucs::vector, const int);
+qucs::vector runavg (const qucs::vector &, const int);
 qucs::vector runavg (const nr_complex_t, const int);
 
-class vector : public object
+/* Base class of the element-wise vector expressions.  The arithmetic
+   operators of vectors return expression objects which refer to their
+   operands instead of computed vectors.  A compound expression is
+   evaluated element by element in a single pass when it is assigned
+   to a vector, thus no temporary vectors are created.  As with
+   in-place operations shorter operands are repeated. */
+template <class E>
+class vecexpr
+{
+ public:
+  const E & self (void) const { return static_cast<const E &> (*this); }
+};
+
+class vector : public object, public vecexpr<vector>
 {
  public:
   vector * getNext (void) const { return this->next; }
@@ -64,15 +80,19 @@ class vector : public object
   vector (int, nr_complex_t);
   vector (const std::string &, int);
   vector (const vector &);
+  vector (vector &&);
+  template <class E> vector (const vecexpr<E> &);
   const vector& operator = (const vector &);
+  vector & operator = (vector &&);
   ~vector ();
   void add (nr_complex_t);
   void add (vector *);
-  nr_complex_t get (int);
+  void clear (void);
+  nr_complex_t get (int) const;
   void set (nr_double_t, int);
   void set (const nr_complex_t, int);
   int getSize (void) const;
-  int checkSizes (vector, vector);
+  int checkSizes (const vector &, const vector &);
   int getRequested (void) { return requested; }
   void setRequested (int n) { requested = n; }
   void reverse (void);
@@ -90,150 +110,131 @@ class vector : public object
   nr_double_t variance (void);
   nr_double_t stddev   (void);
 
-  friend nr_complex_t sum     (vector);
-  friend nr_complex_t prod    (vector);
-  friend nr_complex_t avg     (vector);
-  friend vector  cumsum  (vector);
-  friend vector  cumprod (vector);
-  friend vector  cumavg  (vector);
-  friend vector  smooth  (vector, const nr_double_t);
-  friend vector  groupdelay  (vector, vector);
-  friend vector  dbm     (vector, const nr_complex_t);
-  friend nr_complex_t integrate (vector v, const nr_complex_t);
-  friend nr_double_t integrate (vector v, const nr_double_t);
+  friend nr_complex_t sum     (const vector &);
+  friend nr_complex_t prod    (const vector &);
+  friend nr_complex_t avg     (const vector &);
+  friend vector  cumsum  (const vector &);
+  friend vector  cumprod (const vector &);
+  friend vector  cumavg  (const vector &);
+  friend vector  smooth  (const vector &, const nr_double_t);
+  friend vector  groupdelay  (const vector &, const vector &);
+  friend vector  dbm     (const vector &, const nr_complex_t);
+  friend nr_complex_t integrate (const vector & v, const nr_complex_t);
+  friend nr_double_t integrate (const vector & v, const nr_double_t);
 
   // vector manipulations
-  friend vector real   (vector);  // the real part
-  friend vector imag   (vector);  // the imaginary part
-  friend vector conj   (vector);  // the complex conjugate
-  friend vector norm   (vector);  // the square of the magnitude
-  friend vector arg    (vector);  // the angle in the plane
-  friend vector dB     (vector);
-  friend vector log    (vector);
-  friend vector log2   (vector);
-  friend vector pow    (vector, const nr_complex_t);
-  friend vector pow    (vector, const nr_double_t);
-  friend vector pow    (const nr_complex_t, vector);
-  friend vector pow    (const nr_double_t, vector);
-  friend vector pow    (vector, vector);
-  friend vector ztor   (vector, nr_complex_t);
-  friend vector rtoz   (vector, nr_complex_t);
-  friend vector ytor   (vector, nr_complex_t);
-  friend vector rtoy   (vector, nr_complex_t);
-  friend vector diff   (vector, vector, int);
-  friend vector unwrap (vector, nr_double_t, nr_double_t);
-
-  friend vector polar   (vector, const nr_complex_t);
-  friend vector polar   (const nr_complex_t, vector);
-  friend vector polar   (vector, vector);
-  friend vector atan2   (vector, const nr_double_t);
-  friend vector atan2   (const nr_double_t, vector);
-  friend vector atan2   (vector, vector);
-  friend vector dbm2w   (vector);
-  friend vector w2dbm   (vector);
-  friend vector xhypot  (vector, vector);
-  friend vector xhypot  (vector, const nr_complex_t);
-  friend vector xhypot  (vector, const nr_double_t);
-  friend vector xhypot  (const nr_complex_t, vector);
-  friend vector xhypot  (const nr_double_t, vector);
+  friend vector real   (const vector &);  // the real part
+  friend vector imag   (const vector &);  // the imaginary part
+  friend vector conj   (const vector &);  // the complex conjugate
+  friend vector norm   (const vector &);  // the square of the magnitude
+  friend vector arg    (const vector &);  // the angle in the plane
+  friend vector dB     (const vector &);
+  friend vector log    (const vector &);
+  friend vector log2   (const vector &);
+  friend vector pow    (const vector &, const nr_complex_t);
+  friend vector pow    (const vector &, const nr_double_t);
+  friend vector pow    (const nr_complex_t, const vector &);
+  friend vector pow    (const nr_double_t, const vector &);
+  friend vector pow    (const vector &, const vector &);
+  friend vector ztor   (const vector &, nr_complex_t);
+  friend vector rtoz   (const vector &, nr_complex_t);
+  friend vector ytor   (const vector &, nr_complex_t);
+  friend vector rtoy   (const vector &, nr_complex_t);
+  friend vector diff   (const vector &, const vector &, int);
+  friend vector unwrap (const vector &, nr_double_t, nr_double_t);
+
+  friend vector polar   (const vector &, const nr_complex_t);
+  friend vector polar   (const nr_complex_t, const vector &);
+  friend vector polar   (const vector &, const vector &);
+  friend vector atan2   (const vector &, const nr_double_t);
+  friend vector atan2   (const nr_double_t, const vector &);
+  friend vector atan2   (const vector &, const vector &);
+  friend vector dbm2w   (const vector &);
+  friend vector w2dbm   (const vector &);
+  friend vector xhypot  (const vector &, const vector &);
+  friend vector xhypot  (const vector &, const nr_complex_t);
+  friend vector xhypot  (const vector &, const nr_double_t);
+  friend vector xhypot  (const nr_complex_t, const vector &);
+  friend vector xhypot  (const nr_double_t, const vector &);
 
   // overloaded math functions
-  friend vector abs     (vector);
-  friend vector log10   (vector);
-  friend vector exp     (vector);
-  friend vector limexp  (vector);
-  friend vector sqrt    (vector);
-  friend vector sin     (vector);
-  friend vector asin    (vector);
-  friend vector cos     (vector);
-  friend vector acos    (vector);
-  friend vector tan     (vector);
-  friend vector atan    (vector);
-  friend vector cot     (vector);
-  friend vector acot    (vector);
-  friend vector sinh    (vector);
-  friend vector asinh   (vector);
-  friend vector cosh    (vector);
-  friend vector sech    (vector);
-  friend vector cosech  (vector);
-  friend vector acosh   (vector);
-  friend vector asech   (vector);
-  friend vector tanh    (vector);
-  friend vector atanh   (vector);
-  friend vector coth    (vector);
-  friend vector acoth   (vector);
-  friend vector signum  (vector);
-  friend vector sign    (vector);
-  friend vector sinc    (vector);
-  friend vector ceil    (vector);
-  friend vector floor   (vector);
-  friend vector fix     (vector);
-  friend vector round   (vector);
-  friend vector sqr     (vector);
-  friend vector step    (vector);
-  friend vector jn      (const int, vector);
-  friend vector yn      (const int, vector);
-  friend vector i0      (vector);
-  friend vector erf     (vector);
-  friend vector erfc    (vector);
-  friend vector erfinv  (vector);
-  friend vector erfcinv (vector);
-  friend vector rad2deg     (vector);
-  friend vector deg2rad     (vector);
+  friend vector abs     (const vector &);
+  friend vector log10   (const vector &);
+  friend vector exp     (const vector &);
+  friend vector limexp  (const vector &);
+  friend vector sqrt    (const vector &);
+  friend vector sin     (const vector &);
+  friend vector asin    (const vector &);
+  friend vector cos     (const vector &);
+  friend vector acos    (const vector &);
+  friend vector tan     (const vector &);
+  friend vector atan    (const vector &);
+  friend vector cot     (const vector &);
+  friend vector acot    (const vector &);
+  friend vector sinh    (const vector &);
+  friend vector asinh   (const vector &);
+  friend vector cosh    (const vector &);
+  friend vector sech    (const vector &);
+  friend vector cosech  (const vector &);
+  friend vector acosh   (const vector &);
+  friend vector asech   (const vector &);
+  friend vector tanh    (const vector &);
+  friend vector atanh   (const vector &);
+  friend vector coth    (const vector &);
+  friend vector acoth   (const vector &);
+  friend vector signum  (const vector &);
+  friend vector sign    (const vector &);
+  friend vector sinc    (const vector &);
+  friend vector ceil    (const vector &);
+  friend vector floor   (const vector &);
+  friend vector fix     (const vector &);
+  friend vector round   (const vector &);
+  friend vector sqr     (const vector &);
+  friend vector step    (const vector &);
+  friend vector jn      (const int, const vector &);
+  friend vector yn      (const int, const vector &);
+  friend vector i0      (const vector &);
+  friend vector erf     (const vector &);
+  friend vector erfc    (const vector &);
+  friend vector erfinv  (const vector &);
+  friend vector erfcinv (const vector &);
+  friend vector rad2deg     (const vector &);
+  friend vector deg2rad     (const vector &);
 
   // operator functions
-  friend vector operator + (vector, vector);
-  friend vector operator + (vector, const nr_complex_t);
-  friend vector operator + (vector, const nr_double_t);
-  friend vector operator + (const nr_complex_t, vector);
-  friend vector operator + (const nr_double_t, vector);
-  friend vector operator - (vector, vector);
-  friend vector operator - (vector, const nr_complex_t);
-  friend vector operator - (vector, const nr_double_t);
-  friend vector operator - (const nr_complex_t, vector);
-  friend vector operator - (const nr_double_t, vector);
-  friend vector operator * (vector, vector);
-  friend vector operator * (vector, const nr_complex_t);
-  friend vector operator * (vector, const nr_double_t);
-  friend vector operator * (const nr_complex_t, vector);
-  friend vector operator * (const nr_double_t, vector);
-  friend vector operator / (vector, vector);
-  friend vector operator / (vector, const nr_complex_t);
-  friend vector operator / (vector, const nr_double_t);
-  friend vector operator / (const nr_complex_t, vector);
-  friend vector operator / (const nr_double_t, vector);
-  friend vector operator % (vector, vector);
-  friend vector operator % (vector, const nr_complex_t);
-  friend vector operator % (vector, const nr_double_t);
-  friend vector operator % (const nr_complex_t, vector);
-  friend vector operator % (const nr_double_t, vector);
+  friend vector operator % (const vector &, const vector &);
+  friend vector operator % (const vector &, const nr_complex_t);
+  friend vector operator % (const vector &, const nr_double_t);
+  friend vector operator % (const nr_complex_t, const vector &);
+  friend vector operator % (const nr_double_t, const vector &);
 
   // comparisons
   //  friend int      operator == (const vector *, const vector *);
   //  friend int      operator != (const vector *, const vector *);
 
   // assignment operations
-  vector operator  - ();
-  vector operator  = (const nr_complex_t);
-  vector operator  = (const nr_double_t);
-  vector operator += (vector);
-  vector operator += (const nr_complex_t);
-  vector operator += (const nr_double_t);
-  vector operator -= (vector);
-  vector operator -= (const nr_complex_t);
-  vector operator -= (const nr_double_t);
-  vector operator *= (vector);
-  vector operator *= (const nr_complex_t);
-  vector operator *= (const nr_double_t);
-  vector operator /= (vector);
-  vector operator /= (const nr_complex_t);
-  vector operator /= (const nr_double_t);
+  template <class E> vector & operator = (const vecexpr<E> &);
+  vector & operator  = (const nr_complex_t);
+  vector & operator  = (const nr_double_t);
+  vector & operator += (const vector &);
+  vector & operator += (const nr_complex_t);
+  vector & operator += (const nr_double_t);
+  vector & operator -= (const vector &);
+  vector & operator -= (const nr_complex_t);
+  vector & operator -= (const nr_double_t);
+  vector & operator *= (const vector &);
+  vector & operator *= (const nr_complex_t);
+  vector & operator *= (const nr_double_t);
+  vector & operator /= (const vector &);
+  vector & operator /= (const nr_complex_t);
+  vector & operator /= (const nr_double_t);
 
   // easy accessor operators
   nr_complex_t  operator () (int i) const { return data[i]; }
   nr_complex_t& operator () (int i) { return data[i]; }
 
  private:
+  friend class vecref;
   int requested;
   int size;
   int capacity;
@@ -249,90 +250,291 @@ class vector : public object
 
    for more info
 */
-nr_complex_t sum     (vector);
-nr_complex_t prod    (vector);
-nr_complex_t avg     (vector);
-vector  cumsum  (vector);
-vector  cumprod (vector);
-vector  cumavg  (vector);
-vector  smooth  (vector, const nr_double_t);
-vector  dbm     (vector, const nr_complex_t z = 50.0);
-nr_complex_t integrate (vector v, const nr_complex_t);
-nr_double_t integrate (vector v, const nr_double_t);
-vector real   (vector);  // the real part
-vector imag   (vector);  // the imaginary part
-vector conj   (vector);  // the complex conjugate
-vector norm   (vector);  // the square of the magnitude
-vector arg    (vector);  // the angle in the plane
-vector dB     (vector);
-vector log    (vector);
-vector log2   (vector);
-vector pow    (vector, const nr_complex_t);
-vector pow    (vector, const nr_double_t);
-vector pow    (const nr_complex_t, vector);
-vector pow    (const nr_double_t, vector);
-vector pow    (vector, vector);
-vector ztor   (vector, nr_complex_t zref = 50.0);
-vector rtoz   (vector, nr_complex_t zref = 50.0);
-vector ytor   (vector, nr_complex_t zref = 50.0);
-vector rtoy   (vector, nr_complex_t zref = 50.0);
-vector diff   (vector, vector, int n = 1);
-vector unwrap (vector, nr_double_t tol = pi, nr_double_t step = 2 * pi);
-vector polar   (vector, const nr_complex_t);
-vector polar   (const nr_complex_t, vector);
-vector polar   (vector, vector);
-vector atan2   (vector, const nr_double_t);
-vector atan2   (const nr_double_t, vector);
-vector atan2   (vector, vector);
-vector dbm2w   (vector);
-vector w2dbm   (vector);
-vector xhypot  (vector, vector);
-vector xhypot  (vector, const nr_complex_t);
-vector xhypot  (vector, const nr_double_t);
-vector xhypot  (const nr_complex_t, vector);
-vector xhypot  (const nr_double_t, vector);
-vector abs     (vector);
-vector log10   (vector);
-vector exp     (vector);
-vector limexp  (vector);
-vector sqrt    (vector);
-vector sin     (vector);
-vector asin    (vector);
-vector cos     (vector);
-vector acos    (vector);
-vector tan     (vector);
-vector atan    (vector);
-vector cot     (vector);
-vector acot    (vector);
-vector sinh    (vector);
-vector asinh   (vector);
-vector cosh    (vector);
-vector sech    (vector);
-vector cosech  (vector);
-vector acosh   (vector);
-vector asech   (vector);
-vector tanh    (vector);
-vector atanh   (vector);
-vector coth    (vector);
-vector acoth   (vector);
-vector signum  (vector);
-vector sign    (vector);
-vector sinc    (vector);
-vector ceil    (vector);
-vector floor   (vector);
-vector fix     (vector);
-vector round   (vector);
-vector sqr     (vector);
-vector step    (vector);
-vector jn      (const int, vector);
-vector yn      (const int, vector);
-vector i0      (vector);
-vector erf     (vector);
-vector erfc    (vector);
-vector erfinv  (vector);
-vector erfcinv (vector);
-vector rad2deg     (vector);
-vector deg2rad     (vector);
+nr_complex_t sum     (const vector &);
+nr_complex_t prod    (const vector &);
+nr_complex_t avg     (const vector &);
+vector  cumsum  (const vector &);
+vector  cumprod (const vector &);
+vector  cumavg  (const vector &);
+vector  smooth  (const vector &, const nr_double_t);
+vector  dbm     (const vector &, const nr_complex_t z = 50.0);
+nr_complex_t integrate (const vector & v, const nr_complex_t);
+nr_double_t integrate (const vector & v, const nr_double_t);
+vector real   (const vector &);  // the real part
+vector imag   (const vector &);  // the imaginary part
+vector conj   (const vector &);  // the complex conjugate
+vector norm   (const vector &);  // the square of the magnitude
+vector arg    (const vector &);  // the angle in the plane
+vector dB     (const vector &);
+vector log    (const vector &);
+vector log2   (const vector &);
+vector pow    (const vector &, const nr_complex_t);
+vector pow    (const vector &, const nr_double_t);
+vector pow    (const nr_complex_t, const vector &);
+vector pow    (const nr_double_t, const vector &);
+vector pow    (const vector &, const vector &);
+vector ztor   (const vector &, nr_complex_t zref = 50.0);
+vector rtoz   (const vector &, nr_complex_t zref = 50.0);
+vector ytor   (const vector &, nr_complex_t zref = 50.0);
+vector rtoy   (const vector &, nr_complex_t zref = 50.0);
+vector diff   (const vector &, const vector &, int n = 1);
+vector unwrap (const vector &, nr_double_t tol = pi, nr_double_t step = 2 * pi);
+vector polar   (const vector &, const nr_complex_t);
+vector polar   (const nr_complex_t, const vector &);
+vector polar   (const vector &, const vector &);
+vector atan2   (const vector &, const nr_double_t);
+vector atan2   (const nr_double_t, const vector &);
+vector atan2   (const vector &, const vector &);
+vector dbm2w   (const vector &);
+vector w2dbm   (const vector &);
+vector xhypot  (const vector &, const vector &);
+vector xhypot  (const vector &, const nr_complex_t);
+vector xhypot  (const vector &, const nr_double_t);
+vector xhypot  (const nr_complex_t, const vector &);
+vector xhypot  (const nr_double_t, const vector &);
+vector abs     (const vector &);
+vector log10   (const vector &);
+vector exp     (const vector &);
+vector limexp  (const vector &);
+vector sqrt    (const vector &);
+vector sin     (const vector &);
+vector asin    (const vector &);
+vector cos     (const vector &);
+vector acos    (const vector &);
+vector tan     (const vector &);
+vector atan    (const vector &);
+vector cot     (const vector &);
+vector acot    (const vector &);
+vector sinh    (const vector &);
+vector asinh   (const vector &);
+vector cosh    (const vector &);
+vector sech    (const vector &);
+vector cosech  (const vector &);
+vector acosh   (const vector &);
+vector asech   (const vector &);
+vector tanh    (const vector &);
+vector atanh   (const vector &);
+vector coth    (const vector &);
+vector acoth   (const vector &);
+vector signum  (const vector &);
+vector sign    (const vector &);
+vector sinc    (const vector &);
+vector ceil    (const vector &);
+vector floor   (const vector &);
+vector fix     (const vector &);
+vector round   (const vector &);
+vector sqr     (const vector &);
+vector step    (const vector &);
+vector jn      (const int, const vector &);
+vector yn      (const int, const vector &);
+vector i0      (const vector &);
+vector erf     (const vector &);
+vector erfc    (const vector &);
+vector erfinv  (const vector &);
+vector erfcinv (const vector &);
+vector rad2deg     (const vector &);
+vector deg2rad     (const vector &);
+
+// A vector operand of an expression.
+class vecref : public vecexpr<vecref>
+{
+ public:
+  vecref (const vector & v) : data (v.data), size (v.size) { }
+  int getSize (void) const { return size; }
+  const nr_complex_t * getData (void) const { return data; }
+  nr_complex_t operator [] (int i) const {
+    return i < size ? data[i] : data[i % size];
+  }
+
+ private:
+  const nr_complex_t * data;
+  int size;
+};
+
+// A complex scalar operand of an expression.
+class veccomplex : public vecexpr<veccomplex>
+{
+ public:
+  veccomplex (const nr_complex_t z) : val (z) { }
+  int getSize (void) const { return 0; }
+  nr_complex_t operator [] (int) const { return val; }
+
+ private:
+  nr_complex_t val;
+};
+
+// A real scalar operand of an expression.
+class vecreal : public vecexpr<vecreal>
+{
+ public:
+  vecreal (const nr_double_t d) : val (d) { }
+  int getSize (void) const { return 0; }
+  nr_double_t operator [] (int) const { return val; }
+
+ private:
+  nr_double_t val;
+};
+
+// Vectors are referred to, expressions are held by value.
+template <class E> struct vecoperand { typedef E type; };
+template <> struct vecoperand<vector> { typedef vecref type; };
+
+// The element-wise operations.
+struct vecadd {
+  template <class A, class B>
+  static nr_complex_t apply (const A a, const B b) { return a + b; }
+  static void kernel (nr_complex_t * r, const nr_complex_t * a,
+		      const nr_complex_t * b, int n) { simd::add (r, a, b, n); }
+};
+struct vecsub {
+  template <class A, class B>
+  static nr_complex_t apply (const A a, const B b) { return a - b; }
+  static void kernel (nr_complex_t * r, const nr_complex_t * a,
+		      const nr_complex_t * b, int n) { simd::sub (r, a, b, n); }
+};
+struct vecmul {
+  template <class A, class B>
+  static nr_complex_t apply (const A a, const B b) { return a * b; }
+  static void kernel (nr_complex_t * r, const nr_complex_t * a,
+		      const nr_complex_t * b, int n) { simd::mul (r, a, b, n); }
+};
+struct vecdiv {
+  template <class A, class B>
+  static nr_complex_t apply (const A a, const B b) { return a / b; }
+  static void kernel (nr_complex_t * r, const nr_complex_t * a,
+		      const nr_complex_t * b, int n) { simd::div (r, a, b, n); }
+};
+
+// An element-wise operation of two operands.
+template <class Op, class L, class R>
+class vecbinary : public vecexpr<vecbinary<Op, L, R> >
+{
+ public:
+  vecbinary (const L & a, const R & b) : l (a), r (b) {
+    size = l.getSize () > r.getSize () ? l.getSize () : r.getSize ();
+    assert (l.getSize () == 0 || size % l.getSize () == 0);
+    assert (r.getSize () == 0 || size % r.getSize () == 0);
+  }
+  int getSize (void) const { return size; }
+  const L & getLeft (void) const { return l; }
+  const R & getRight (void) const { return r; }
+  nr_complex_t operator [] (int i) const { return Op::apply (l[i], r[i]); }
+
+ private:
+  L l;
+  R r;
+  int size;
+};
+
+// The negation of an operand.
+template <class E>
+class vecnegate : public vecexpr<vecnegate<E> >
+{
+ public:
+  vecnegate (const E & a) : e (a) { }
+  int getSize (void) const { return e.getSize (); }
+  nr_complex_t operator [] (int i) const { return -e[i]; }
+
+ private:
+  E e;
+};
+
+// Evaluates the given expression into the given array.
+template <class E>
+inline void veceval (nr_complex_t * d, const E & x, int n) {
+  for (int i = 0; i < n; i++) d[i] = x[i];
+}
+
+// Operations of two vectors of equal length use the vectorized kernels.
+template <class Op>
+inline void veceval (nr_complex_t * d,
+		     const vecbinary<Op, vecref, vecref> & x, int n) {
+  const vecref & a = x.getLeft (), & b = x.getRight ();
+  if (a.getSize () == n && b.getSize () == n)
+    Op::kernel (d, a.getData (), b.getData (), n);
+  else
+    for (int i = 0; i < n; i++) d[i] = x[i];
+}
+
+// Evaluates the given expression into a new unnamed vector.
+template <class E>
+vector::vector (const vecexpr<E> & e) : object () {
+  const E & x = e.self ();
+  capacity = size = x.getSize ();
+  data = size > 0 ? (nr_complex_t *)
+    malloc (sizeof (nr_complex_t) * capacity) : NULL;
+  veceval (data, x, size);
+  dependencies = NULL;
+  origin = NULL;
+  requested = 0;
+  next = prev = nullptr;
+}
+
+/* Evaluates the given expression into the vector.  Only the data is
+   assigned.  The vector itself may appear in the expression since
+   each element depends on the same element of the operands only. */
+template <class E>
+vector & vector::operator = (const vecexpr<E> & e) {
+  const E & x = e.self ();
+  int n = x.getSize ();
+  if (n == size) {
+    veceval (data, x, n);
+    return *this;
+  }
+  nr_complex_t * d = n > 0 ? (nr_complex_t *)
+    malloc (sizeof (nr_complex_t) * n) : NULL;
+  veceval (d, x, n);
+  free (data);
+  data = d;
+  capacity = size = n;
+  return *this;
+}
+
+#define VECEXPR_OPERATOR(op, func) \
+  template <class A, class B> \
+  inline vecbinary<func, typename vecoperand<A>::type, \
+		   typename vecoperand<B>::type> \
+  operator op (const vecexpr<A> & a, const vecexpr<B> & b) { \
+    return vecbinary<func, typename vecoperand<A>::type, \
+		     typename vecoperand<B>::type> (a.self (), b.self ()); \
+  } \
+  template <class A> \
+  inline vecbinary<func, typename vecoperand<A>::type, veccomplex> \
+  operator op (const vecexpr<A> & a, const nr_complex_t z) { \
+    return vecbinary<func, typename vecoperand<A>::type, veccomplex> \
+      (a.self (), z); \
+  } \
+  template <class A> \
+  inline vecbinary<func, typename vecoperand<A>::type, vecreal> \
+  operator op (const vecexpr<A> & a, const nr_double_t d) { \
+    return vecbinary<func, typename vecoperand<A>::type, vecreal> \
+      (a.self (), d); \
+  } \
+  template <class B> \
+  inline vecbinary<func, veccomplex, typename vecoperand<B>::type> \
+  operator op (const nr_complex_t z, const vecexpr<B> & b) { \
+    return vecbinary<func, veccomplex, typename vecoperand<B>::type> \
+      (z, b.self ()); \
+  } \
+  template <class B> \
+  inline vecbinary<func, vecreal, typename vecoperand<B>::type> \
+  operator op (const nr_double_t d, const vecexpr<B> & b) { \
+    return vecbinary<func, vecreal, typename vecoperand<B>::type> \
+      (d, b.self ()); \
+  }
+
+VECEXPR_OPERATOR (+, vecadd)
+VECEXPR_OPERATOR (-, vecsub)
+VECEXPR_OPERATOR (*, vecmul)
+VECEXPR_OPERATOR (/, vecdiv)
+
+#undef VECEXPR_OPERATOR
+
+template <class A>
+inline vecnegate<typename vecoperand<A>::type>
+operator - (const vecexpr<A> & a) {
+  return vecnegate<typename vecoperand<A>::type> (a.self ());
+}
 
 } // namespace qucs
 
@@ -0,0 +1,143 @@
+/*
+ * Adaptive.cpp - Unit test for adaptive frequency sweeps
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <vector>
+
+#include "qucs_typedefs.h"
+#include "complex.h"
+#include "object.h"
+#include "vector.h"
+#include "strlist.h"
+#include "dataset.h"
+#include "sweep.h"
+#include "analysis.h"
+#include "adaptive.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+// response of a resonant circuit
+static nr_complex_t response (nr_double_t f) {
+  nr_complex_t s = nr_complex_t (0, f / 1e9);
+  return 1.0 / (s * s + 0.1 * s + 1.0);
+}
+
+// solves a single frequency like the AC analysis does
+static void solve (qucs::analysis & a, nr_double_t f, int & count) {
+  qucs::dataset * data = a.getData ();
+  qucs::vector * d, * v;
+  if ((d = data->findDependency ("acfrequency")) == NULL) {
+    d = new qucs::vector ("acfrequency");
+    data->addDependency (d);
+  }
+  d->add (f);
+  if ((v = data->findVariable ("out.v")) == NULL) {
+    v = new qucs::vector ("out.v");
+    qucs::strlist * deps = new qucs::strlist ();
+    deps->add ("acfrequency");
+    v->setDependencies (deps);
+    data->addVariable (v);
+  }
+  v->add (response (f));
+  count++;
+}
+
+// runs an adaptive sweep over the given frequencies
+static void sweep (qucs::analysis & a, const std::vector<nr_double_t> & f,
+		   int & count) {
+  qucs::lstsweep swp ("acfrequency");
+  swp.create (f.size ());
+  for (size_t i = 0; i < f.size (); i++) swp.set (i, f[i]);
+
+  // the frequencies are saved before the sweep
+  qucs::vector * d = new qucs::vector ("acfrequency");
+  for (nr_double_t x : f) d->add (x);
+  a.getData()->addDependency (d);
+
+  a.addProperty ("AdaptTol", 1e-6);
+  a.setProgress (false);
+  a.solveAdaptive (&swp, [&a, &count] (nr_double_t x) {
+      solve (a, x, count);
+    });
+}
+
+// the sampler resolves a resonance with few samples
+TEST (adaptive, sampler) {
+  int points = 1001;
+  std::vector<nr_double_t> grid (points);
+  for (int i = 0; i < points; i++) grid[i] = 0.5e9 + 1e6 * i;
+  qucs::adaptive fit (grid, 1e-6);
+  std::vector<int> next;
+  std::vector<nr_complex_t> row (1);
+  while (fit.select (next) > 0) {
+    for (int i : next) {
+      row[0] = response (grid[i]);
+      fit.setSample (i, row);
+    }
+  }
+  EXPECT_LT (fit.getSamples (), points / 4);
+  for (int i = 0; i < points; i++) {
+    fit.interpolate (i, row);
+    EXPECT_NEAR (0.0, abs (row[0] - response (grid[i])), 1e-4);
+  }
+}
+
+// the interpolated values are saved for all frequencies
+TEST (adaptive, sweep) {
+  int points = 1001, count = 0;
+  std::vector<nr_double_t> f (points);
+  for (int i = 0; i < points; i++) f[i] = 0.5e9 + 1e6 * i;
+  qucs::analysis a;
+  a.setData (new qucs::dataset ());
+  sweep (a, f, count);
+
+  qucs::dataset * data = a.getData ();
+  EXPECT_LT (count, points / 4);
+  ASSERT_NE (nullptr, data->findDependency ("acfrequency"));
+  EXPECT_EQ (points, data->findDependency("acfrequency")->getSize ());
+  qucs::vector * v = data->findVariable ("out.v");
+  ASSERT_NE (nullptr, v);
+  ASSERT_EQ (points, v->getSize ());
+  for (int i = 0; i < points; i++)
+    EXPECT_NEAR (0.0, abs (v->get (i) - response (f[i])), 1e-4);
+  delete data;
+}
+
+// a sweep out of order is solved at all points, each saved once
+TEST (adaptive, fallback) {
+  int points = 50, count = 0;
+  std::vector<nr_double_t> f (points);
+  for (int i = 0; i < points; i++) f[i] = 1e9 + 1e7 * ((i * 7) % points);
+  qucs::analysis a;
+  a.setData (new qucs::dataset ());
+  sweep (a, f, count);
+
+  qucs::dataset * data = a.getData ();
+  EXPECT_EQ (points, count);
+  ASSERT_NE (nullptr, data->findDependency ("acfrequency"));
+  EXPECT_EQ (points, data->findDependency("acfrequency")->getSize ());
+  qucs::vector * v = data->findVariable ("out.v");
+  ASSERT_NE (nullptr, v);
+  ASSERT_EQ (points, v->getSize ());
+  for (int i = 0; i < points; i++)
+    EXPECT_EQ (response (f[i]), v->get (i));
+  delete data;
+}
@@ -20,6 +20,10 @@
  *
  */
 
+#include <thread>
+#include <vector>
+#include <algorithm>
+
 #include "qucs_typedefs.h"
 #include "object.h"
 #include "vector.h"
@@ -44,3 +48,72 @@ TEST (fourier, fft) {
     else
       EXPECT_EQ ( 0 , vdif.get(k).real() );
 }
+
+TEST (fourier, dft_any_length) {
+  // compare against the defining sum for lengths with factors 2, 3,
+  // 5 and prime lengths handled by the convolution
+  int lens[] = { 6, 7, 12, 15, 31, 100 };
+  for (int l = 0; l < 6; l++) {
+    int n = lens[l];
+    qucs::vector vec = qucs::vector (n);
+    for (int k = 0; k < n; k++)
+      vec.set (nr_complex_t (cos (0.3 * k * k), sin (1.7 * k)), k);
+
+    qucs::vector vdft = qucs::fourier::dft_1d (vec);
+    for (int j = 0; j < n; j++) {
+      nr_complex_t sum = 0;
+      for (int k = 0; k < n; k++)
+	sum += vec.get (k) * std::polar (1.0, -2 * M_PI * j * k / n);
+      EXPECT_NEAR (0, std::abs (sum - vdft.get (j)), 1e-12);
+    }
+
+    // inverse gives back the original values
+    qucs::vector vinv = qucs::fourier::idft_1d (vdft);
+    for (int k = 0; k < n; k++)
+      EXPECT_NEAR (0, std::abs (vinv.get (k) - vec.get (k)), 1e-13);
+  }
+}
+
+TEST (fourier, dft_real) {
+  // real valued data yields a conjugate symmetric spectrum, the half
+  // sized transformation of length 7 uses the convolution
+  int lens[] = { 10, 14 };
+  for (int l = 0; l < 2; l++) {
+    int n = lens[l];
+    qucs::vector vec = qucs::vector (n);
+    for (int k = 0; k < n; k++)
+      vec.set (1.0 / (k + 1), k);
+
+    qucs::vector vdft = qucs::fourier::dft_1d (vec);
+    for (int j = 0; j < n; j++) {
+      nr_complex_t sum = 0;
+      for (int k = 0; k < n; k++)
+	sum += vec.get (k) * std::polar (1.0, -2 * M_PI * j * k / n);
+      EXPECT_NEAR (0, std::abs (sum - vdft.get (j)), 1e-13);
+    }
+  }
+}
+
+TEST (fourier, threads) {
+  // plans are created and used by several threads at once
+  int lens[] = { 37, 41, 90, 97, 210, 251 };
+  std::vector<std::thread> threads;
+  std::vector<nr_double_t> err (8, 0.0);
+  for (int t = 0; t < 8; t++) {
+    threads.push_back (std::thread ([t, &lens, &err] () {
+      for (int l = 0; l < 6; l++) {
+	int n = lens[(l + t) % 6];
+	std::vector<nr_complex_t> x (n), y;
+	for (int k = 0; k < n; k++)
+	  x[k] = nr_complex_t (cos (0.3 * k * t), sin (1.7 * k));
+	y = x;
+	qucs::fourier::_fft_1d ((nr_double_t *) &y[0], n, 1);
+	qucs::fourier::_fft_1d ((nr_double_t *) &y[0], n, -1);
+	for (int k = 0; k < n; k++)
+	  err[t] = std::max (err[t], std::abs (y[k] / (nr_double_t) n - x[k]));
+      }
+    }));
+  }
+  for (int t = 0; t < 8; t++) threads[t].join ();
+  for (int t = 0; t < 8; t++) EXPECT_NEAR (0, err[t], 1e-12);
+}
@@ -0,0 +1,113 @@
+/*
+ * HarmonicBalance.cpp - Unit test for the harmonic balance solvers
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "qucs_typedefs.h"
+#include "complex.h"
+#include "object.h"
+#include "vector.h"
+#include "dataset.h"
+#include "netdefs.h"
+#include "components.h"
+#include "net.h"
+#include "tvector.h"
+#include "tmatrix.h"
+#include "tspmatrix.h"
+#include "analysis.h"
+#include "hbsolver.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+// assigns the properties not given to their default values
+static void defaults (qucs::object * o, struct define_t * def) {
+  struct property_t * props[] = { def->required, def->optional };
+  for (struct property_t * p : props) {
+    for (int i = 0; PROP_IS_PROP (p[i]); i++) {
+      if (o->hasProperty (p[i].key)) continue;
+      if (PROP_IS_VAL (p[i]))
+	o->addProperty (p[i].key, p[i].defaultval.d, true);
+      else
+	o->addProperty (p[i].key, p[i].defaultval.s, true);
+    }
+  }
+}
+
+// adds a two-terminal circuit to the netlist
+static void insert (qucs::net * subnet, qucs::circuit * c,
+		    struct define_t * def, const char * name,
+		    const char * n1, const char * n2) {
+  c->setName (name);
+  c->setNonLinear (def->nonlinear != 0);
+  c->setNode (0, n1);
+  c->setNode (1, n2);
+  defaults (c, def);
+  subnet->insertCircuit (c);
+}
+
+/* solves a diode rectifier driven by a sinusoidal source with the
+   given linear solver and returns the spectrum of the output voltage */
+static qucs::vector rectifier (const char * solver) {
+  qucs::net * subnet = new qucs::net ("subnet");
+  qucs::circuit * c;
+
+  c = new vac ();
+  c->addProperty ("U", 2.0);
+  c->addProperty ("f", 1e9);
+  insert (subnet, c, vac::definition (), "V1", "in", "gnd");
+  c = new resistor ();
+  c->addProperty ("R", 50.0);
+  insert (subnet, c, resistor::definition (), "R1", "in", "out");
+  c = new resistor ();
+  c->addProperty ("R", 200.0);
+  insert (subnet, c, resistor::definition (), "R2", "out", "gnd");
+  c = new diode ();
+  insert (subnet, c, diode::definition (), "D1", "gnd", "out");
+
+  qucs::hbsolver hb;
+  hb.setName ("HB1");
+  hb.addProperty ("n", 2.0);
+  hb.addProperty ("f", 1e9);
+  hb.addProperty ("Solver", solver);
+  defaults (&hb, qucs::hbsolver::definition ());
+  hb.setNet (subnet);
+  hb.setData (new qucs::dataset ());
+  hb.solve ();
+
+  qucs::vector * v = hb.getData()->findVariable ("out.Vb");
+  qucs::vector res = v ? *v : qucs::vector ();
+  delete hb.getData ();
+  delete subnet;
+  return res;
+}
+
+// the matrix-free balancing solves the same equations
+TEST (hbsolver, gmres_crout) {
+  qucs::vector crout = rectifier ("CroutLU");
+  qucs::vector gmres = rectifier ("GMRES");
+  ASSERT_GT (crout.getSize (), 2);
+  ASSERT_EQ (crout.getSize (), gmres.getSize ());
+  // the diode rectifies and creates harmonics
+  EXPECT_GT (abs (crout.get (0)), 1e-3);
+  EXPECT_GT (abs (crout.get (2)), 1e-4);
+  for (int i = 0; i < crout.getSize (); i++)
+    EXPECT_NEAR (0.0, abs (gmres.get (i) - crout.get (i)),
+		 1e-6 * abs (crout.get (1)));
+}
@@ -0,0 +1,129 @@
+/*
+ * History.cpp - Unit test for history class
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "qucs_typedefs.h"
+#include "history.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+// fills a time history 0, 1, 2, ... and a value history 10 times the time
+static void fill (qucs::history & t, qucs::history & v, int from, int to) {
+  for (int i = from; i < to; i++) {
+    t.push_back (i);
+    v.push_back (10.0 * i);
+  }
+}
+
+// old values are dropped while the ring of values wraps around
+TEST (history, wraparound) {
+  qucs::history t, v;
+  t.self ();
+  v.apply (t);
+  v.setAge (3.5);
+  fill (t, v, 0, 100);
+
+  EXPECT_EQ (100u, v.size ());
+  EXPECT_EQ (99.0, v.last ());
+  // two values older than the age are kept
+  EXPECT_EQ (94.0, v.first ());
+  for (int i = 94; i < 100; i++) {
+    EXPECT_EQ (10.0 * i, v.getValfromidx (i));
+    EXPECT_EQ (10.0 * i, v.nearest (i, false));
+  }
+  // dropped values
+  EXPECT_EQ (0.0, v.getValfromidx (93));
+}
+
+// the ring grows while its values wrap around
+TEST (history, grow) {
+  qucs::history t, v;
+  t.self ();
+  v.apply (t);
+  v.setAge (3.5);
+  fill (t, v, 0, 40);
+  v.setAge (30);
+  fill (t, v, 40, 80);
+
+  EXPECT_EQ (48.0, v.first ());
+  for (int i = 48; i < 80; i++)
+    EXPECT_EQ (10.0 * i, v.getValfromidx (i));
+}
+
+// lookups moving backwards and forwards through the history
+TEST (history, seek) {
+  qucs::history t, v;
+  t.self ();
+  v.apply (t);
+  v.setAge (10.5);
+  fill (t, v, 0, 100);
+
+  EXPECT_EQ (990.0, v.nearest (99, false));
+  // backwards, nearest value on either side
+  EXPECT_EQ (950.0, v.nearest (95.2, false));
+  EXPECT_EQ (920.0, v.nearest (91.6, false));
+  // forwards from there
+  EXPECT_EQ (930.0, v.nearest (92.9, false));
+  EXPECT_EQ (970.0, v.nearest (96.9, false));
+  // beyond both ends
+  EXPECT_EQ (870.0, v.nearest (10, false));
+  EXPECT_EQ (990.0, v.nearest (120, false));
+  // a spline through linear data is linear
+  EXPECT_NEAR (955.0, v.nearest (95.5), 1e-9);
+  EXPECT_NEAR (912.5, v.nearest (91.25), 1e-9);
+  EXPECT_NEAR (971.0, v.nearest (97.1), 1e-9);
+}
+
+// truncation and dropping of values kept across the wrap point
+TEST (history, truncate) {
+  qucs::history t, v;
+  t.self ();
+  v.apply (t);
+  v.setAge (3.5);
+  fill (t, v, 0, 100);
+
+  // the values 94 ... 96 are kept, stored at the end and at the start
+  // of the ring
+  v.truncate (96.5);
+  EXPECT_EQ (97u, v.size ());
+  EXPECT_EQ (96.0, v.last ());
+  EXPECT_EQ (94.0, v.first ());
+  EXPECT_EQ (960.0, v.nearest (96.4, false));
+  EXPECT_EQ (0.0, v.getValfromidx (97));
+
+  // continue after the truncation
+  t.push_back (96.75);
+  v.push_back (1.0);
+  EXPECT_EQ (98u, v.size ());
+  EXPECT_EQ (1.0, v.nearest (96.75, false));
+  EXPECT_EQ (960.0, v.nearest (96.1, false));
+
+  // dropping moves the oldest value past the wrap point
+  fill (t, v, 97, 110);
+  EXPECT_EQ (104.0, v.first ());
+  for (int i = 104; i < 110; i++)
+    EXPECT_EQ (10.0 * i, v.nearest (i, false));
+
+  // truncating everything but the oldest kept values
+  v.truncate (104);
+  EXPECT_EQ (104.0, v.last ());
+  EXPECT_EQ (1040.0, v.nearest (105, false));
+}
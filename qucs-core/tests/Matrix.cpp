@@ -23,6 +23,8 @@
 #include "qucs_typedefs.h"
 #include "real.h"
 #include "complex.h"
+#include "object.h"
+#include "vector.h"
 #include "matrix.h"
 
 #include "gtest/gtest.h"  // Google Test
@@ -32,3 +34,22 @@ TEST (matrix, getCols) {
     EXPECT_EQ ( 3 , data.getCols() );
 }
 
+
+TEST (matrix, stoz) {
+    qucs::matrix s (2);
+    s.set (0, 0, nr_complex_t (0.1, 0.2));
+    s.set (0, 1, nr_complex_t (0.7, -0.1));
+    s.set (1, 0, nr_complex_t (0.7, -0.1));
+    s.set (1, 1, nr_complex_t (-0.3, 0.05));
+    qucs::vector z0 (2);
+    z0.set (50.0, 0);
+    z0.set (75.0, 1);
+    qucs::matrix d = qucs::ztos (qucs::stoz (s, z0), z0) - s;
+    for (int r = 0; r < 2; r++)
+      for (int c = 0; c < 2; c++)
+        EXPECT_NEAR ( 0.0 , abs (d.get (r, c)), 1e-12 );
+    d = qucs::ytos (qucs::stoy (s, z0), z0) - s;
+    for (int r = 0; r < 2; r++)
+      for (int c = 0; c < 2; c++)
+        EXPECT_NEAR ( 0.0 , abs (d.get (r, c)), 1e-12 );
+}
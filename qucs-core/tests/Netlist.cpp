@@ -0,0 +1,186 @@
+/*
+ * Netlist.cpp - Unit test for the netlist scanner and parser
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+#include "qucs_typedefs.h"
+#include "equation.h"
+#include "check_netlist.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+static const char * netlist =
+  "# Qucs netlist\n"
+  "Vac:V1 in gnd U=\"2 V\" f=\"1 GHz\"\n"
+  "R:R1 in out R=\"50 Ohm\" \\\n"
+  "  Temp=\"26.85\"\n"
+  ".Def:Sub a b\n"
+  "R:R2 a b R=\"100\"\n"
+  ".Def:End\n"
+  "SPfile:X1 out gnd File=\"{/tmp/x.s2p}\"\n"
+  "Eqn:Eqn1 y=\"2.5k*x+j3\" Export=\"yes\"\n"
+  ".DC:DC1 Temp=\"26.85\"";
+
+// prints the parsed definitions in a line based format
+static void print (std::string & s, struct definition_t * root) {
+  char buf[64];
+  for (struct definition_t * def = root; def != NULL; def = def->next) {
+    snprintf (buf, sizeof (buf), "%d ", def->line);
+    s += buf;
+    s += def->type;
+    s += ':';
+    s += def->instance;
+    for (struct node_t * n = def->nodes; n != NULL; n = n->next) {
+      s += ' ';
+      s += n->node;
+    }
+    for (struct pair_t * p = def->pairs; p != NULL; p = p->next) {
+      struct value_t * v = p->value;
+      s += ' ';
+      s += p->key;
+      s += '=';
+      if (v->ident) {
+	s += v->ident;
+      } else {
+	snprintf (buf, sizeof (buf), "%g", v->value);
+	s += buf;
+      }
+      if (v->scale) s += std::string (" ") + v->scale;
+      if (v->unit) s += std::string (" ") + v->unit;
+    }
+    qucs::eqn::node * next;
+    for (qucs::eqn::node * e = (qucs::eqn::node *) def->eqns; e != NULL; e = next) {
+      s += ' ';
+      s += e->toString ();
+      next = e->getNext ();
+      delete e;
+    }
+    s += '\n';
+    if (def->sub) {
+      print (s, def->sub);
+      s += "End\n";
+    }
+  }
+}
+
+// scans and parses the given text from a regular file
+static std::string parse (const char * text, int * status) {
+  char name[] = "/tmp/qucs-netlistXXXXXX";
+  int fd = mkstemp (name);
+  FILE * f = fdopen (fd, "w+");
+  fputs (text, f);
+  rewind (f);
+  netlist_lex_file (f);
+  *status = netlist_parse ();
+  std::string s;
+  print (s, definition_root);
+  netlist_destroy ();
+  fclose (f);
+  unlink (name);
+  return s;
+}
+
+// scans and parses the given text from a pipe
+static std::string parse_pipe (const char * text, int * status) {
+  int fd[2];
+  if (pipe (fd) != 0) return "";
+  ssize_t len = write (fd[1], text, strlen (text));
+  close (fd[1]);
+  FILE * f = fdopen (fd[0], "r");
+  netlist_lex_file (f);
+  *status = len >= 0 ? netlist_parse () : -1;
+  std::string s;
+  print (s, definition_root);
+  netlist_destroy ();
+  fclose (f);
+  return s;
+}
+
+TEST (netlist, parse) {
+  int status;
+  std::string s = parse ((std::string (netlist) + "\n").c_str (), &status);
+  EXPECT_EQ (0, status);
+  EXPECT_EQ ("3 Vac:V1 in gnd U=2 V f=1 GHz\n"
+	     "5 R:R1 in out R=50 Ohm Temp=26.85\n"
+	     "6 Def:Sub a b\n"
+	     "7 R:R2 a b R=100\n"
+	     "End\n"
+	     "9 SPfile:X1 out gnd File=/tmp/x.s2p\n"
+	     "10 Eqn:Eqn1 y = ((2500*x)+(0+j3)) Export = yes\n"
+	     "11 DC:DC1 Temp=26.85\n", s);
+}
+
+// the last line does not need a newline
+TEST (netlist, no_newline) {
+  int status;
+  std::string s = parse ((std::string (netlist) + "\n").c_str (), &status);
+  EXPECT_EQ (0, status);
+  EXPECT_EQ (s, parse (netlist, &status));
+  EXPECT_EQ (0, status);
+  EXPECT_EQ (s, parse ((std::string (netlist) + "\r\n").c_str (), &status));
+  EXPECT_EQ (0, status);
+  EXPECT_EQ ("3 R:R1 a b R=50\n",
+	     parse ("# comment\nR:R1 a b R=\"50\"\n# no newline", &status));
+  EXPECT_EQ (0, status);
+}
+
+// mapped files and streams give the same result
+TEST (netlist, pipe) {
+  int status;
+  std::string s = parse (netlist, &status);
+  EXPECT_EQ (0, status);
+  EXPECT_EQ (s, parse_pipe (netlist, &status));
+  EXPECT_EQ (0, status);
+}
+
+TEST (netlist, empty) {
+  int status;
+  EXPECT_EQ ("", parse ("", &status));
+  EXPECT_EQ (0, status);
+  EXPECT_EQ (NULL, definition_root);
+  EXPECT_EQ ("", parse ("\n", &status));
+  EXPECT_EQ (0, status);
+  EXPECT_EQ ("", parse_pipe ("", &status));
+  EXPECT_EQ (0, status);
+}
+
+// the scanner recovers after a syntax error
+TEST (netlist, error) {
+  int status;
+  parse ("R:R1 a b R=\"50\n", &status);
+  EXPECT_NE (0, status);
+  EXPECT_EQ ("2 R:R1 a b R=50\n", parse ("R:R1 a b R=\"50\"", &status));
+  EXPECT_EQ (0, status);
+}
+
+// the mapped file ends exactly at a page boundary
+TEST (netlist, page) {
+  int status;
+  std::string s = "R:R1 a b R=\"50\"\n#";
+  s.resize (sysconf (_SC_PAGESIZE), 'x');
+  EXPECT_EQ ("2 R:R1 a b R=50\n", parse (s.c_str (), &status));
+  EXPECT_EQ (0, status);
+}
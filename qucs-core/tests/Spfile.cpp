@@ -0,0 +1,133 @@
+/*
+ * Spfile.cpp - Unit test for the shared touchstone file data
+ *
+ * Copyright (C) 2026 Qucs Team
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <unistd.h>
+
+#include "qucs_typedefs.h"
+#include "complex.h"
+#include "object.h"
+#include "vector.h"
+#include "matrix.h"
+#include "matvec.h"
+#include "dataset.h"
+#include "poly.h"
+#include "spline.h"
+#include "interpolator.h"
+#include "spfile.h"
+
+#include "gtest/gtest.h"  // Google Test
+
+// writes a touchstone file with the given number of ports and points
+static std::string touchstone (int ports, int points) {
+  char name[] = "/tmp/qucs-spfileXXXXXX";
+  int fd = mkstemp (name);
+  FILE * f = fdopen (fd, "w");
+  fprintf (f, "# Hz S RI R 50\n");
+  for (int k = 0; k < points; k++) {
+    nr_double_t x = 1e9 + 0.5e9 * k;
+    fprintf (f, "%g", x);
+    for (int i = 0; i < ports * ports; i++)
+      fprintf (f, " %.12g %.12g", 0.1 * (i + 1) * std::cos (k * (i + 1.0)),
+	       -0.2 * std::sin (k * k + i + 0.5));
+    fprintf (f, "\n");
+  }
+  fclose (f);
+  return name;
+}
+
+/* compares the interpolation of the shared model against interpolators
+   for the single entries as each instance used to have them, the
+   results must not differ in any bit */
+static void compare (int ports, int points, int it, int dt) {
+  std::string file = touchstone (ports, points);
+  spfile sp;
+  sp.interpolType = it;
+  sp.dataType = dt;
+  sp.loadModel (file.c_str ());
+  ASSERT_NE (nullptr, sp.model);
+  ASSERT_EQ (ports, sp.nPorts);
+
+  qucs::dataset * d = qucs::dataset::load_touchstone (file.c_str ());
+  ASSERT_NE (nullptr, d);
+  qucs::vector * freq = d->findDependency ("frequency");
+  spfile_vector entry[4];
+  for (int r = 0; r < ports; r++) {
+    for (int c = 0; c < ports; c++) {
+      char * n = qucs::matvec::createMatrixString ("S", r, c);
+      qucs::vector * v = d->findVariable (n);
+      ASSERT_NE (nullptr, v);
+      entry[r * ports + c].prepare (v, freq, false, it, dt);
+    }
+  }
+
+  // inside, on and beyond the given frequencies
+  for (nr_double_t f = 0.5e9; f < 1e9 + 0.5e9 * points; f += 0.125e9) {
+    qucs::matrix s = sp.getInterpolMatrixS (f);
+    for (int r = 0; r < ports; r++)
+      for (int c = 0; c < ports; c++) {
+	nr_complex_t ref = entry[r * ports + c].interpolate (f);
+	EXPECT_EQ (ref, s (r, c));
+      }
+  }
+  sp.releaseModel ();
+  delete d;
+  unlink (file.c_str ());
+}
+
+TEST (spfile, linear) {
+  compare (2, 7, INTERPOL_LINEAR, DATA_RECTANGULAR);
+  compare (2, 7, INTERPOL_LINEAR, DATA_POLAR);
+}
+
+TEST (spfile, cubic) {
+  compare (2, 7, INTERPOL_CUBIC, DATA_RECTANGULAR);
+  compare (2, 7, INTERPOL_CUBIC, DATA_POLAR);
+}
+
+// two points keep the chosen interpolation
+TEST (spfile, two_points) {
+  compare (1, 2, INTERPOL_LINEAR, DATA_RECTANGULAR);
+  compare (1, 2, INTERPOL_CUBIC, DATA_RECTANGULAR);
+  compare (1, 2, INTERPOL_CUBIC, DATA_POLAR);
+}
+
+// instances with the same file and settings share the data
+TEST (spfile, shared) {
+  std::string file = touchstone (2, 5);
+  spfile a, b, c;
+  a.interpolType = b.interpolType = INTERPOL_CUBIC;
+  c.interpolType = INTERPOL_LINEAR;
+  a.dataType = b.dataType = c.dataType = DATA_RECTANGULAR;
+  a.loadModel (file.c_str ());
+  b.loadModel (file.c_str ());
+  c.loadModel (file.c_str ());
+  EXPECT_EQ (a.model, b.model);
+  EXPECT_NE (a.model, c.model);
+  a.releaseModel ();
+  b.releaseModel ();
+  c.releaseModel ();
+  unlink (file.c_str ());
+}
@@ -33,3 +33,42 @@ TEST (vector, sum) {
     vec.set(1, k);
   EXPECT_EQ ( 3.0 , qucs::sum(vec) );
 }
+
+TEST (vector, expression) {
+  qucs::vector a = qucs::vector(4), b = qucs::vector(2);
+  for (int k = 0; k < a.getSize(); k++)
+    a.set(k, k);
+  b.set(1, 0);
+  b.set(2, 1);
+  // b is repeated along a, a appears on both sides of the assignment
+  a = 2 * a + b / 2.0 - a;
+  EXPECT_EQ ( 4 , a.getSize() );
+  EXPECT_EQ ( 0.5 , real (a.get(0)) );
+  EXPECT_EQ ( 2.0 , real (a.get(1)) );
+  EXPECT_EQ ( 2.5 , real (a.get(2)) );
+  EXPECT_EQ ( 4.0 , real (a.get(3)) );
+}
+
+TEST (vector, simd) {
+  qucs::vector a = qucs::vector(101), b = qucs::vector(101);
+  for (int k = 0; k < a.getSize(); k++) {
+    a.set(nr_complex_t (std::cos (k), std::sin (3.0 * k) - 0.5), k);
+    b.set(nr_complex_t (1.0 + k, std::cos (0.1 * k)), k);
+  }
+  bool on = qucs::simd::enabled ();
+  qucs::simd::enable (false);
+  qucs::vector p = a * b, q = a / b, y = abs (a), z = sqrt (a);
+  qucs::vector m = norm (a);
+  qucs::simd::enable (true);
+  qucs::vector s = a * b, t = a / b, v = abs (a), w = sqrt (a);
+  qucs::vector n = norm (a);
+  qucs::simd::enable (on);
+  for (int k = 0; k < a.getSize(); k++) {
+    EXPECT_EQ ( p.get(k) , s.get(k) );
+    // the odd size leaves the last norm to the scalar code
+    EXPECT_EQ ( real (m.get(k)) , real (n.get(k)) );
+    EXPECT_NEAR ( 0.0 , abs (q.get(k) - t.get(k)), 1e-15 * abs (q.get(k)) );
+    EXPECT_NEAR ( 0.0 , abs (y.get(k) - v.get(k)), 1e-15 * abs (y.get(k)) );
+    EXPECT_NEAR ( 0.0 , abs (z.get(k) - w.get(k)), 1e-15 * abs (z.get(k)) );
+  }
+}
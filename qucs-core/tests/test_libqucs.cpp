@@ -115,3 +115,265 @@ TEST (tridiag, solve_s_cyc) {
     EXPECT_NEAR (x[i], b[i],tol);
   }
 }
+
+// --------------------
+
+#include "tmatrix.h"
+#include "tspmatrix.h"
+#include "eqnsys.h"
+
+TEST (eqnsys, solve_sparse_lu) {
+/* same system as above, but with a zero at the first diagonal in
+   order to enforce row pivoting
+  A[0][0] = 0
+  x = np.linalg.solve(A,b)
+  [ 4.79166667 -0.25 -3.29166667 -3.33333333  0.625]
+*/
+  int n = 5;
+  std::vector<nr_double_t> x (n);
+  x[0] = 4.79166667;
+  x[1] = -0.25;
+  x[2] = -3.29166667;
+  x[3] = -3.33333333;
+  x[4] = 0.625;
+
+  qucs::tmatrix<nr_double_t> A (n);
+  qucs::tvector<nr_double_t> b (n);
+  qucs::tvector<nr_double_t> s (n);
+  for (int i = 0; i < n; i++) {
+    A (i, i) = -2.;
+    if (i > 0) A (i, i - 1) = 1.;
+    if (i < n - 1) A (i, i + 1) = 1.;
+    b (i) = i + 1.;
+  }
+  A (0, 0) = 0.;
+  A (0, n - 1) = A (n - 1, 0) = 2.;
+
+  qucs::tspmatrix<nr_double_t> As (A);
+  qucs::eqnsys<nr_double_t> eqns;
+  eqns.setAlgo (ALGO_SPARSE_LU_DECOMPOSITION);
+  eqns.passEquationSys (&As, &s, &b);
+  eqns.solve ();
+
+  for (int i = 0; i < n; i++) {
+    EXPECT_NEAR (x[i], s (i), tol);
+  }
+}
+
+// --------------------
+
+#include <cstdio>
+#include "vector.h"
+#include "strlist.h"
+#include "dataset.h"
+
+TEST (dataset, binary_roundtrip) {
+  qucs::dataset * d = new qucs::dataset ();
+  qucs::vector * f = new qucs::vector ("frequency");
+  for (int i = 0; i < 4; i++) f->add (1e9 * (i + 1) / 3.);
+  d->addDependency (f);
+  qucs::vector * v = new qucs::vector ("S[1,1]");
+  for (int i = 0; i < 4; i++) v->add (nr_complex_t (i / 3., -i / 7.));
+  v->setDependencies (new qucs::strlist ());
+  v->getDependencies ()->add ("frequency");
+  d->addVariable (v);
+
+  // the binary format keeps the values bit-exact
+  const char * file = "binary_roundtrip.dat";
+  d->setFile (file);
+  d->setBinary (1);
+  d->print ();
+  qucs::dataset * e = qucs::dataset::load (file);
+  std::remove (file);
+
+  ASSERT_TRUE (e != NULL);
+  EXPECT_TRUE (e->isBinary ());
+  qucs::vector * g = e->findDependency ("frequency");
+  qucs::vector * w = e->findVariable ("S[1,1]");
+  ASSERT_TRUE (g != NULL && w != NULL);
+  ASSERT_EQ (4, g->getSize ());
+  ASSERT_EQ (4, w->getSize ());
+  EXPECT_STREQ ("frequency", w->getDependencies ()->get (0));
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ (f->get (i), g->get (i));
+    EXPECT_EQ (v->get (i), w->get (i));
+  }
+  delete d;
+  delete e;
+}
+
+TEST (dataset, stream_roundtrip) {
+  qucs::dataset * d = new qucs::dataset ();
+  const char * file = "stream_roundtrip.dat";
+  d->setFile (file);
+  d->setBinary (1);
+  d->setStream (8);
+  qucs::vector * t = new qucs::vector ("time");
+  d->addDependency (t);
+  qucs::vector * v = new qucs::vector ("V1.Vt");
+  v->setDependencies (new qucs::strlist ());
+  v->getDependencies ()->add ("time");
+  d->addVariable (v);
+
+  // streamed values are dropped from memory
+  for (int i = 0; i < 20; i++) {
+    t->add (i * 1e-9);
+    v->add (nr_complex_t (i / 3., i % 2 ? -i / 7. : 0));
+    d->streamData ();
+  }
+  EXPECT_TRUE (d->isStreaming ());
+  EXPECT_EQ (4, t->getSize ());
+
+  // the file can be read while being written
+  qucs::dataset * p = qucs::dataset::load (file);
+  ASSERT_TRUE (p != NULL);
+  EXPECT_EQ (16, p->findVariable ("V1.Vt")->getSize ());
+  delete p;
+
+  // and can be restored into memory
+  d->restoreStream ();
+  ASSERT_EQ (20, t->getSize ());
+  EXPECT_EQ (nr_complex_t (1 / 3., -1 / 7.), v->get (1));
+  t->add (20e-9);
+  v->add (nr_complex_t (20 / 3., 0));
+  d->print ();
+  EXPECT_FALSE (d->isStreaming ());
+
+  qucs::dataset * e = qucs::dataset::load (file);
+  std::remove (file);
+  ASSERT_TRUE (e != NULL);
+  qucs::vector * w = e->findVariable ("V1.Vt");
+  ASSERT_TRUE (w != NULL);
+  ASSERT_EQ (21, w->getSize ());
+  ASSERT_EQ (21, e->findDependency ("time")->getSize ());
+  for (int i = 0; i < 21; i++)
+    EXPECT_EQ (v->get (i), w->get (i));
+  delete d;
+  delete e;
+}
+
+// --------------------
+
+#include <cstring>
+#include "equation.h"
+#include "bytecode.h"
+
+using namespace qucs::eqn;
+
+static node * eqnRef (const char * n) {
+  reference * r = new reference ();
+  r->n = strdup (n);
+  return r;
+}
+
+static node * eqnNum (nr_double_t d) {
+  constant * c = new constant (TAG_DOUBLE);
+  c->d = d;
+  return c;
+}
+
+static node * eqnApp (const char * f, node * a, node * b = NULL) {
+  application * app = new application (f, b ? 2 : 1);
+  app->args = a;
+  a->setNext (b);
+  return app;
+}
+
+TEST (bytecode, compile_derivative) {
+  // I = Is * (exp (V / Vt) - 1) + x * V, x = sqr (V)
+  checker ck;
+  assignment * v = (assignment *) ck.addDouble ("#voltage", "D.V1", 0);
+  ck.addDouble ("#param", "Is", 1e-14);
+  ck.addDouble ("#param", "Vt", 0.025);
+  assignment * x = new assignment ();
+  x->result = strdup ("x");
+  x->body = eqnApp ("sqr", eqnRef ("D.V1"));
+  ck.addEquation (x);
+  assignment * i = new assignment ();
+  i->result = strdup ("D.I1");
+  i->body = eqnApp ("+",
+    eqnApp ("*", eqnRef ("Is"),
+	    eqnApp ("-", eqnApp ("exp", eqnApp ("/", eqnRef ("D.V1"),
+						eqnRef ("Vt"))), eqnNum (1))),
+    eqnApp ("*", eqnRef ("x"), eqnRef ("D.V1")));
+  ck.addEquation (i);
+  ck.setEquations (ck.getEquations ());
+  ck.collectDependencies ();
+  for (node * e = ck.getEquations (); e; e = e->getNext ()) e->evalType ();
+  assignment * g = (assignment *) i->differentiate ((char *) "D.V1");
+  ck.addEquation (g);
+  g->evalType ();
+  for (node * e = ck.getEquations (); e; e = e->getNext ())
+    if (((assignment *) e)->body->getTag () == CONSTANT) e->evaluate ();
+
+  bytecode code;
+  int rv = code.addInput (v);
+  int ri = code.compile (i);
+  int rg = code.compile (g);
+  ASSERT_GE (ri, 0);
+  ASSERT_GE (rg, 0);
+
+  for (nr_double_t V = -1; V < 1; V += 0.1) {
+    v->getResult()->d = V;
+    x->evaluate ();
+    i->evaluate ();
+    g->evaluate ();
+    code.set (rv, V);
+    code.evaluate ();
+    EXPECT_NEAR (i->getResultDouble (), code.get (ri),
+		 1e-12 * fabs (i->getResultDouble ()));
+    EXPECT_NEAR (g->getResultDouble (), code.get (rg),
+		 1e-12 * fabs (g->getResultDouble ()));
+  }
+}
+
+TEST (checker, symbol_table) {
+  checker ck;
+  ck.addDouble ("#param", "a", 1);
+  ck.addDouble ("#param", "b", 2);
+  node * c = ck.createDouble ("#param", "c", 3);
+  ck.appendEquation (c);
+  EXPECT_TRUE (ck.containsVariable ("a"));
+  EXPECT_FALSE (ck.containsVariable ("d"));
+  EXPECT_EQ (c, ck.findEquation ("c"));
+  // prepended equations shadow, appended ones do not
+  node * a = ck.addDouble ("#param", "a", 4);
+  ck.appendEquation (ck.createDouble ("#param", "b", 5));
+  EXPECT_EQ (a, ck.findEquation ("a"));
+  ck.setDouble ("b", 6);
+  ck.dropEquation (a);
+  delete a;
+  for (node * e = ck.getEquations (); e; e = e->getNext ()) {
+    e->evalType ();
+    e->evaluate ();
+  }
+  EXPECT_EQ (1, ck.getDouble ("a"));
+  EXPECT_EQ (6, ck.getDouble ("b"));
+  ((assignment *) c)->rename ((char *) "e");
+  EXPECT_EQ (NULL, ck.findEquation ("c"));
+  EXPECT_EQ (c, ck.findEquation ("e"));
+}
+
+TEST (checker, rename) {
+  checker ck;
+  node * b = ck.addDouble ("#param", "b", 1);
+  node * a = ck.addDouble ("#param", "a", 2);
+  node * s = ck.createDouble ("#param", "b", 3);
+  ck.appendEquation (s);
+  EXPECT_EQ (a, ck.findEquation ("a"));
+  EXPECT_EQ (b, ck.findEquation ("b"));
+  // the shadowed equation becomes visible under the former name
+  ((assignment *) b)->rename ((char *) "c");
+  EXPECT_EQ (b, ck.findEquation ("c"));
+  EXPECT_EQ (s, ck.findEquation ("b"));
+  // renaming onto an existing name shadows the later equation
+  ((assignment *) a)->rename ((char *) "b");
+  EXPECT_EQ (NULL, ck.findEquation ("a"));
+  EXPECT_EQ (a, ck.findEquation ("b"));
+  // equations renamed before being added
+  assignment * d = (assignment *) ck.createDouble ("#param", "x", 4);
+  d->rename ((char *) "d");
+  ck.addEquation (d);
+  EXPECT_EQ (d, ck.findEquation ("d"));
+  EXPECT_FALSE (ck.containsVariable ("x"));
+}
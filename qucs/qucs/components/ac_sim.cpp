@@ -55,6 +55,19 @@ AC_Sim::AC_Sim()
   Props.append(new Property("Noise", "no", false,
 			QObject::tr("calculate noise voltages")+
 			" [yes, no]"));
+  Props.append(new Property("Solver", "CroutLU", false,
+			QObject::tr("method for solving the circuit matrix")+
+			" [CroutLU, DoolittleLU, HouseholderQR, HouseholderLQ, GolubSVD, SparseLU]"));
+  Props.append(new Property("Workers", "1", false,
+			QObject::tr("number of processes solving frequency points (0 = all processors)")));
+  Props.append(new Property("NoiseOutputs", "all", false,
+			QObject::tr("noise outputs (probes = only the voltage probes)")+
+			" [all, probes]"));
+  Props.append(new Property("Adaptive", "no", false,
+			QObject::tr("solve only where needed and interpolate the rest")+
+			" [yes, no]"));
+  Props.append(new Property("AdaptTol", "1e-3", false,
+			QObject::tr("relative tolerance of the adaptive interpolation")));
 }
 
 AC_Sim::~AC_Sim()
@@ -64,7 +64,9 @@ DC_Sim::DC_Sim()
 	" [none, gMinStepping, SteepestDescent, LineSearch, Attenuation, SourceStepping]"));
   Props.append(new Property("Solver", "CroutLU", false,
 	QObject::tr("method for solving the circuit matrix")+
-	" [CroutLU, DoolittleLU, HouseholderQR, HouseholderLQ, GolubSVD]"));
+	" [CroutLU, DoolittleLU, HouseholderQR, HouseholderLQ, GolubSVD, SparseLU]"));
+  Props.append(new Property("Threads", "1", false,
+	QObject::tr("number of threads evaluating devices (0 = all processors)")));
 }
 
 DC_Sim::~DC_Sim()
@@ -65,13 +65,15 @@ ETR_Sim::ETR_Sim()
 	QObject::tr("overestimation of local truncation error")));
   Props.append(new Property("Solver", "CroutLU", false,
 	QObject::tr("method for solving the circuit matrix")+
-	" [CroutLU, DoolittleLU, HouseholderQR, HouseholderLQ, GolubSVD]"));
+	" [CroutLU, DoolittleLU, HouseholderQR, HouseholderLQ, GolubSVD, SparseLU]"));
   Props.append(new Property("relaxTSR", "no", false,
 	QObject::tr("relax time step raster")+" [no, yes]"));
   Props.append(new Property("initialDC", "yes", false,
 	QObject::tr("perform an initial DC analysis")+" [yes, no]"));
   Props.append(new Property("MaxStep", "0", false,
 	QObject::tr("maximum step size in seconds")));
+  Props.append(new Property("Threads", "1", false,
+	QObject::tr("number of threads evaluating devices (0 = all processors)")));
 }
 
 ETR_Sim::~ETR_Sim()
@@ -50,6 +50,9 @@ HB_Sim::HB_Sim()
 		QObject::tr("relative tolerance for convergence")));
   Props.append(new Property("MaxIter", "150", false,
 		QObject::tr("maximum number of iterations until error")));
+  Props.append(new Property("Solver", "CroutLU", false,
+		QObject::tr("method for solving the circuit matrix")+
+		" [CroutLU, SparseLU, GMRES]"));
 }
 
 HB_Sim::~HB_Sim()
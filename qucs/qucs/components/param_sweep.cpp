@@ -51,6 +51,11 @@ Param_Sweep::Param_Sweep()
 		QObject::tr("stop value for sweep")));
   Props.append(new Property("Points", "20", true,
 		QObject::tr("number of simulation steps")));
+  Props.append(new Property("Workers", "1", false,
+		QObject::tr("number of processes solving sweep points (0 = all processors)")));
+  Props.append(new Property("Continuation", "none", false,
+		QObject::tr("start each point from the previous solutions")+
+		" [none, previous, extrapolate]"));
 }
 
 Param_Sweep::~Param_Sweep()
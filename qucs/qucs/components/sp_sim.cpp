@@ -64,6 +64,13 @@ SP_Sim::SP_Sim()
   Props.append(new Property("saveAll", "no", false,
 	QObject::tr("save subcircuit characteristic values into dataset")+
 	" [yes, no]"));
+  Props.append(new Property("Workers", "1", false,
+	QObject::tr("number of processes solving frequency points (0 = all processors)")));
+  Props.append(new Property("Adaptive", "no", false,
+	QObject::tr("solve only where needed and interpolate the rest")+
+	" [yes, no]"));
+  Props.append(new Property("AdaptTol", "1e-3", false,
+	QObject::tr("relative tolerance of the adaptive interpolation")));
 }
 
 SP_Sim::~SP_Sim()
@@ -0,0 +1,408 @@
+/***************************************************************************
+                             datasetindex.cpp
+                            ------------------
+    begin                : Sat Oct 17 2026
+    copyright            : (C) 2026 by Qucs Team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+
+#include "datasetindex.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+// number of dataset files kept in the cache
+#define MAX_CACHED_DATASETS 8
+
+QHash<QString, QSharedPointer<DatasetIndex> > DatasetIndex::Cache;
+QStringList DatasetIndex::Recent;
+
+DatasetIndex::DatasetIndex(const QString& fileName)
+  : FileName(fileName), FileSize(0), Binary(false), Open(false), DataStart(0)
+{
+}
+
+/*!
+   Returns the index of the dataset file. The index is taken from the
+   cache unless the file has been modified since it was built. Returns
+   a null pointer if the file cannot be read or is not complete.
+*/
+QSharedPointer<DatasetIndex> DatasetIndex::get(const QString& fileName)
+{
+  QFileInfo Info(fileName);
+  QSharedPointer<DatasetIndex> Index = Cache.value(fileName);
+  Recent.removeAll(fileName);
+  if(Index)
+    if((Index->Modified != Info.lastModified()) ||
+       (Index->FileSize != Info.size())) {
+      Cache.remove(fileName);
+      Index.clear();
+    }
+
+  if(!Index) {
+    Index = QSharedPointer<DatasetIndex>(new DatasetIndex(fileName));
+    Index->Modified = Info.lastModified();
+    Index->FileSize = Info.size();
+    if(!Index->build())
+      return QSharedPointer<DatasetIndex>();
+
+    // keep the cache small, graphs still hold their indices
+    while(Recent.count() >= MAX_CACHED_DATASETS)
+      Cache.remove(Recent.takeFirst());
+    Cache.insert(fileName, Index);
+  }
+  Recent.append(fileName);
+  return Index;
+}
+
+// Removes all indices from the cache.
+void DatasetIndex::clear()
+{
+  Cache.clear();
+  Recent.clear();
+}
+
+// Returns the variable with the given name or NULL if there is none.
+const DatasetVar* DatasetIndex::find(const QString& Name) const
+{
+  QHash<QString, DatasetVar>::const_iterator it = Vars.find(Name);
+  if(it == Vars.end())  return 0;
+  return &it.value();
+}
+
+/*!
+   Returns the variable with the given name having its values parsed.
+   Returns NULL if there is no such variable or it cannot be parsed.
+*/
+const DatasetVar* DatasetIndex::values(const QString& Name)
+{
+  QHash<QString, DatasetVar>::iterator it = Vars.find(Name);
+  if(it == Vars.end())  return 0;
+  DatasetVar& Var = it.value();
+  if(!Var.Parsed) {
+    if(!(Binary ? parseBinary(Var) : parseText(Var)))  return 0;
+    Var.Parsed = true;
+  }
+  return &Var;
+}
+
+// Reads the given part of the dataset file.
+QByteArray DatasetIndex::read(qint64 Begin, qint64 End) const
+{
+  QFile file(FileName);
+  if(!file.open(QIODevice::ReadOnly) || !file.seek(Begin))
+    return QByteArray();
+  return file.read(End - Begin);
+}
+
+// Returns the values of a variable of a text dataset as they are.
+QByteArray DatasetIndex::text(const QString& Name) const
+{
+  const DatasetVar *Var = find(Name);
+  if(Binary || !Var)  return QByteArray();
+  return read(Var->Begin, Var->End);
+}
+
+// Scans the dataset file.
+bool DatasetIndex::build()
+{
+  QFile file(FileName);
+  if(!file.open(QIODevice::ReadOnly))  return false;
+
+  Binary = (file.peek(21) == "<Qucs Binary Dataset ");
+  qint64 Size = file.size();
+  bool Result;
+  uchar *Map = file.map(0, Size);
+  if(Map) {
+    Result = Binary ? buildBinary(Map, Size)
+                    : buildText((const char*)Map, Size);
+    file.unmap(Map);
+  }
+  else {
+    QByteArray Content = file.readAll();
+    Result = Binary ? buildBinary((const uchar*)Content.constData(),
+                                  Content.size())
+                    : buildText(Content.constData(), Content.size());
+  }
+  file.close();
+  return Result;
+}
+
+// Creates a variable which has not been located yet.
+static DatasetVar newDatasetVar(bool isIndep, const QStringList& Deps)
+{
+  DatasetVar Var;
+  Var.isIndep = isIndep;
+  Var.Deps = Deps;
+  Var.count = -1;
+  Var.Begin = Var.End = 0;
+  Var.Parsed = false;
+  return Var;
+}
+
+/*!
+   Looks for the variables in a text dataset. Their values are placed
+   between the <indep name count> or <dep name dependencies> tag and
+   the corresponding closing tag.
+*/
+bool DatasetIndex::buildText(const char *Start, qint64 Size)
+{
+  // the dataset must be complete
+  const char *End = Start + Size;
+  while((End > Start) && (*(End-1) <= ' '))  End--;
+  if((End == Start) || (*(End-1) != '>'))  return false;
+
+  QString Last;
+  const char *p = Start;
+  while((p = (const char*)memchr(p, '<', End-p))) {
+    const char *q = (const char*)memchr(p, '>', End-p);
+    if(!q)  return false;   // file corrupt
+    if(*(p+1) == '/') {
+      if(!Last.isEmpty())  Vars[Last].End = p - Start;
+      Last = QString();
+    }
+    else {
+      QStringList Words =
+        QString::fromLatin1(p+1, q-p-1).split(' ', QString::SkipEmptyParts);
+      bool isIndep = !Words.isEmpty() && (Words.at(0) == "indep");
+      if((Words.count() >= 2) && (isIndep || (Words.at(0) == "dep"))) {
+        Last = Words.at(1);
+        if(Vars.contains(Last))
+          Last = QString();   // only the first one counts
+        else {
+          DatasetVar Var = newDatasetVar(isIndep,
+                                         isIndep ? QStringList() : Words.mid(2));
+          if(isIndep) {
+            bool ok;
+            Var.count = Words.value(2).toInt(&ok);
+            if(!ok)  return false;
+          }
+          Var.Begin = q+1 - Start;
+          Var.End = Var.Begin;
+          Vars.insert(Last, Var);
+        }
+      }
+    }
+    p = q+1;
+  }
+  return true;
+}
+
+/*!
+   Parses the values of a variable of a text dataset. Complex values
+   are given as "re+jim" or "re-jim".
+*/
+bool DatasetIndex::parseText(DatasetVar& Var) const
+{
+  QByteArray Content = read(Var.Begin, Var.End);
+  if(Content.size() != Var.End - Var.Begin)  return false;
+
+  /* WORK-AROUND: A bug in SCIM (libscim) which Qt is linked to causes
+     to change the locale to the default. */
+  setlocale (LC_NUMERIC, "C");
+
+  char *pPos = Content.data(), *pEnd;   // terminated by the QByteArray
+  double x, y;
+  Var.Values.clear();
+  for(;;) {
+    while((*pPos) && (*pPos <= ' '))  pPos++; // find start of next number
+    if(!*pPos)  break;
+    x = strtod(pPos, &pEnd);  // real part
+    if(pEnd == pPos)  return false;
+    pPos = pEnd;
+    y = 0.0;
+    if(*pEnd > ' ') {  // is there an imaginary part ?
+      if(((*pEnd != '+') && (*pEnd != '-')) || (*(pEnd+1) != 'j'))
+        return false;
+      pPos = pEnd + 1;
+      *pPos = *pEnd;  // overwrite 'j' with sign
+      y = strtod(pPos, &pEnd); // imaginary part
+      if(pEnd == pPos)  return false;
+      pPos = pEnd;
+    }
+    Var.Values.append(x);
+    Var.Values.append(y);
+  }
+  if(Var.count < 0)  Var.count = Var.Values.size() / 2;
+  return true;
+}
+
+// Splits the tag of a binary dataset into its words.
+static QStringList binaryWords(const char *Start, const char *End)
+{
+  QString Line = QString::fromLatin1(Start, End-Start);
+  if(!Line.startsWith('<') || !Line.endsWith('>'))  return QStringList();
+  return Line.mid(1, Line.length()-2).split(' ');
+}
+
+/*!
+   Handles a declaration of a variable in a binary dataset. Returns false
+   if the tag is none. A repeated declaration updates the variable.
+*/
+static bool declareBinaryVar(const QStringList& Words,
+                             QHash<QString, DatasetVar>& Vars)
+{
+  bool isIndep = (Words.value(0) == "indep");
+  if((Words.count() < 2) || (!isIndep && (Words.at(0) != "dep")))
+    return false;
+  if(isIndep && (Words.count() > 3))  return false;
+
+  QStringList Deps = isIndep ? QStringList() : Words.mid(2);
+  if(!Vars.contains(Words.at(1)))
+    Vars.insert(Words.at(1), newDatasetVar(isIndep, Deps));
+  DatasetVar& Var = Vars[Words.at(1)];
+  Var.isIndep = isIndep;
+  Var.Deps = Deps;
+  return true;
+}
+
+// Adds a block of values to the variable of a binary dataset.
+static void addBinaryBlock(DatasetVar& Var, qint64 Offset, int count,
+                           bool isComplex)
+{
+  DatasetBlock Block = { Offset, count, isComplex };
+  Var.Blocks.append(Block);
+  Var.count = (Var.count < 0 ? 0 : Var.count) + count;
+}
+
+/*!
+   Looks for the variables in a binary dataset. The header lists the
+   variables using the tags of the text format, each followed by a
+   <block offset count type> tag which locates its values in the data
+   section. Datasets streamed by the simulator instead consist of records
+   behind the header, each starting at an 8 byte boundary with a tag.
+   These are declarations of variables or <chunk name count type> tags
+   followed by the next values of a variable. While the simulation runs
+   the last record may be incomplete.
+*/
+bool DatasetIndex::buildBinary(const uchar *Map, qint64 Size)
+{
+  const char *Start = (const char*)Map, *End = Start + Size;
+  const char *pLine = (const char*)memchr(Start, '\n', Size); // version
+  QString Last;
+  int Stream = 0;   // 1 = open, 2 = done
+  QStringList Words;
+
+  DataStart = -1;
+  while(pLine && (++pLine < End)) {
+    const char *pEnd = (const char*)memchr(pLine, '\n', End-pLine);
+    if(!pEnd)  return false;
+    if((pEnd-pLine == 6) && !strncmp(pLine, "<data>", 6)) {
+      DataStart = ((pEnd+1 - Start) + 7) & ~qint64(7);
+      break;
+    }
+    Words = binaryWords(pLine, pEnd);
+    pLine = pEnd;
+    if(Words.isEmpty())  return false;
+    if((Words.at(0) == "stream") && (Words.count() == 2)) {
+      Stream = (Words.at(1) == "done") ? 2 : 1;
+    }
+    else if((Words.at(0) == "block") && (Words.count() == 4)) {
+      if(!Vars.contains(Last))  return false;
+      addBinaryBlock(Vars[Last], Words.at(1).toLongLong(),
+                     Words.at(2).toInt(), Words.at(3) == "complex");
+      Last = QString();
+    }
+    else if(declareBinaryVar(Words, Vars))
+      Last = Words.at(1);
+    else  return false;
+  }
+  if(DataStart < 0)  return false;
+  qint64 DataSize = Size - DataStart;
+
+  // go through the records of a streamed dataset
+  qint64 Pos = DataStart;
+  Open = (Stream == 1);
+  while(Stream && (Pos < Size)) {
+    const char *pRec = Start + Pos;
+    const char *pEnd = (const char*)memchr(pRec, '\n', End-pRec);
+    if(!pEnd) {   // incomplete record
+      if(Stream == 2)  return false;
+      break;
+    }
+    Words = binaryWords(pRec, pEnd);
+    if(Words.isEmpty())  return false;
+    Pos = ((pEnd+1 - Start) + 7) & ~qint64(7);
+
+    if((Words.at(0) == "chunk") && (Words.count() == 4)) {
+      if(!Vars.contains(Words.at(1)))  return false;
+      int count = Words.at(2).toInt();
+      bool isComplex = (Words.at(3) == "complex");
+      qint64 Length = qint64(count) * (isComplex ? 16 : 8);
+      if(Pos + Length > Size) {   // incomplete record
+        if(Stream == 2)  return false;
+        break;
+      }
+      addBinaryBlock(Vars[Words.at(1)], Pos - DataStart, count, isComplex);
+      Pos += Length;
+    }
+    else if(!declareBinaryVar(Words, Vars))  return false;
+  }
+
+  // check the location of the values
+  foreach(const DatasetVar& Var, Vars)
+    foreach(const DatasetBlock& Block, Var.Blocks)
+      if((Block.count < 0) || (Block.Offset < 0) ||
+         (Block.Offset + qint64(Block.count) * (Block.isComplex ? 16 : 8)
+          > DataSize))
+        return false;   // file corrupt
+  return true;
+}
+
+// The values of binary datasets are little-endian doubles.
+static inline double binaryDouble(const uchar *p)
+{
+  quint64 u = qFromLittleEndian<quint64>(p);
+  double d;
+  memcpy(&d, &u, sizeof(d));
+  return d;
+}
+
+// Reads the values of a variable of a binary dataset.
+bool DatasetIndex::parseBinary(DatasetVar& Var) const
+{
+  QFile file(FileName);
+  if(!file.open(QIODevice::ReadOnly))  return false;
+
+  Var.Values.clear();
+  Var.Values.reserve(2 * qMax(Var.count, 0));
+  foreach(const DatasetBlock& Block, Var.Blocks) {
+    qint64 Length = qint64(Block.count) * (Block.isComplex ? 16 : 8);
+    uchar *Map = file.map(DataStart + Block.Offset, Length);
+    QByteArray Content;
+    const uchar *q = Map;
+    if(!Map) {
+      if(!file.seek(DataStart + Block.Offset))  return false;
+      Content = file.read(Length);
+      if(Content.size() != Length)  return false;
+      q = (const uchar*)Content.constData();
+    }
+    for(int z=0; z<Block.count; z++) {
+      Var.Values.append(binaryDouble(q));
+      q += 8;
+      if(Block.isComplex) {
+        Var.Values.append(binaryDouble(q));
+        q += 8;
+      }
+      else  Var.Values.append(0.0);
+    }
+    if(Map)  file.unmap(Map);
+  }
+  return true;
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+                              datasetindex.h
+                             ----------------
+    begin                : Sat Oct 17 2026
+    copyright            : (C) 2026 by Qucs Team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef DATASETINDEX_H
+#define DATASETINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QSharedPointer>
+
+// Location of some values of a variable in a binary dataset.
+struct DatasetBlock {
+  qint64 Offset;   // relative to the data section
+  int count;
+  bool isComplex;
+};
+
+// A variable of a dataset as found by the index.
+struct DatasetVar {
+  bool isIndep;
+  QStringList Deps;
+  int count;       // number of values or -1 if unknown yet
+  qint64 Begin;    // text datasets: location of the values in the file
+  qint64 End;
+  QList<DatasetBlock> Blocks;   // binary datasets
+  bool Parsed;
+  QVector<double> Values;       // real and imaginary parts alternately
+};
+
+/*!
+  \class DatasetIndex
+  \brief The DatasetIndex class locates the variables of a dataset file.
+
+  The index is built by a single scan of the file. The values of a
+  variable are parsed once when they are needed first. All graphs share
+  the indices which are kept in a small cache and rebuilt as soon as the
+  file has been modified.
+*/
+class DatasetIndex {
+public:
+  static QSharedPointer<DatasetIndex> get(const QString& fileName);
+  static void clear();
+
+  const DatasetVar* find(const QString& Name) const;
+  const DatasetVar* values(const QString& Name);
+  QByteArray text(const QString& Name) const;
+  bool isBinary() const { return Binary; }
+  bool isOpen() const { return Open; }
+
+private:
+  DatasetIndex(const QString& fileName);
+  bool build();
+  QByteArray read(qint64, qint64) const;
+  bool buildText(const char*, qint64);
+  bool buildBinary(const uchar*, qint64);
+  bool parseText(DatasetVar&) const;
+  bool parseBinary(DatasetVar&) const;
+
+  QString FileName;
+  QDateTime Modified;
+  qint64 FileSize;
+  bool Binary;
+  bool Open;          // streamed binary dataset still being written
+  qint64 DataStart;   // binary datasets: position of the data section
+  QHash<QString, DatasetVar> Vars;
+
+  static QHash<QString, QSharedPointer<DatasetIndex> > Cache;
+  static QStringList Recent;
+};
+
+#endif
@@ -29,7 +29,9 @@
 #endif
 #include <stdlib.h>
 #include <cmath>
+#include <algorithm>
 #include <float.h>
+#include <limits.h>
 #if HAVE_IEEEFP_H
 # include <ieeefp.h>
 #endif
@@ -42,6 +44,7 @@
 
 #include "rect3ddiagram.h"
 #include "misc.h"
+#include "datasetindex.h"
 
 #include <QTextStream>
 #include <QMessageBox>
@@ -516,6 +519,17 @@ void Diagram::calcData(Graph *g)
   double Dummy = 0.0;  // not used
   double *py = &Dummy;
 
+  Axis *pa;
+  if(g->yAxisNo == 0)  pa = &yAxis;
+  else  pa = &zAxis;
+
+  // Lines of much more points than pixels are drawn by the first, least,
+  // greatest and last point of each pixel column only.
+  QVector<int> Bounds, Idx;
+  if(g->Style >= GRAPHSTYLE_SOLID)  if(g->Style <= GRAPHSTYLE_LONGDASH)
+    if(calcColumns(g, pa, Bounds))
+      Size = ((2*(4*Bounds.size()) + 1) * g->countY) + 10;
+
   g->resizeScrPoints(Size);
   auto p = g->begin();
   auto p_end = g->begin();
@@ -524,30 +538,39 @@ void Diagram::calcData(Graph *g)
   ++p;
   assert(p!=g->end());
 
-  Axis *pa;
-  if(g->yAxisNo == 0)  pa = &yAxis;
-  else  pa = &zAxis;
-
   switch(g->Style) {
     case GRAPHSTYLE_SOLID: // ***** solid line ****************************
     case GRAPHSTYLE_DASH:
     case GRAPHSTYLE_DOT:
     case GRAPHSTYLE_LONGDASH:
 
-      for(i=g->countY; i>0; i--) {  // every branch of curves
+      for(i=0; i<g->countY; i++) {  // every branch of curves
 	px = g->axis(0)->Points;
-	calcCoordinateP(px, pz, py, p, pa);
-	++px;
-	pz += 2;
-	++p;
-	for(z=g->axis(0)->count-1; z>0; z--) {  // every point
-	  FIT_MEMORY_SIZE;  // need to enlarge memory block ?
+	if(!Bounds.isEmpty()) {  // decimated line ?
+	  g->Pyramid.select(i, Bounds, Idx);
+	  pz = g->cPointsY + 2*g->axis(0)->count*i;
+	  for(z=0; z<Idx.size(); z++) {  // every selected point
+	    FIT_MEMORY_SIZE;  // need to enlarge memory block ?
+	    calcCoordinateP(px+Idx.at(z), pz+2*Idx.at(z), py, p, pa);
+	    ++p;
+	    if(z > 0)  if(Counter >= 2)   // clipping only if an axis is manual
+	      clip(p);
+	  }
+	}
+	else {
 	  calcCoordinateP(px, pz, py, p, pa);
 	  ++px;
 	  pz += 2;
 	  ++p;
-	  if(Counter >= 2)   // clipping only if an axis is manual
-	    clip(p);
+	  for(z=g->axis(0)->count-1; z>0; z--) {  // every point
+	    FIT_MEMORY_SIZE;  // need to enlarge memory block ?
+	    calcCoordinateP(px, pz, py, p, pa);
+	    ++px;
+	    pz += 2;
+	    ++p;
+	    if(Counter >= 2)   // clipping only if an axis is manual
+	      clip(p);
+	  }
 	}
 	if((p-3)->isStrokeEnd() && !(p-3)->isBranchEnd())
 	  p -= 3;  // no single point after "no stroke"
@@ -589,6 +612,44 @@ for(int zz=0; zz<60; zz+=2)
   // unreachable
 }
 
+// ------------------------------------------------------------
+/*!
+   Divides the points of a graph into the pixel columns of a rectangular
+   diagram. "Bounds" gets the index of the first point of each column,
+   the columns also take the points just outside of the diagram. Returns
+   false if the graph should be drawn point by point.
+*/
+bool Diagram::calcColumns(Graph *g, Axis const *pa, QVector<int>& Bounds)
+{
+  Bounds.clear();
+  if(Name != "Rect")  return false;
+  if(g->numAxes() != 1)  return false;
+  int Count = g->count(0);
+  if(Count <= 4*x2)  return false;   // not worth it
+  if(!(xAxis.up > xAxis.low))  return false;
+  if(xAxis.log)  if(!(xAxis.low > 0.0))  return false;
+
+  double *px = g->axis(0)->Points;
+  if(!g->Pyramid.isBuilt(g->cPointsY, Count, g->countY, pa->log))
+    if(!g->Pyramid.build(px, g->cPointsY, Count, g->countY, pa->log))
+      return false;   // independent values not ascending
+
+  double *pEnd = px + Count;
+  Bounds.reserve(x2+3);
+  Bounds.append(0);
+  for(int c=0; c<=x2; c++) {  // left border of each pixel column
+    double x, f = double(c) / double(x2);
+    if(xAxis.log)  x = xAxis.low * pow(xAxis.up / xAxis.low, f);
+    else  x = xAxis.low + (xAxis.up - xAxis.low) * f;
+    int n = std::lower_bound(px, pEnd, x) - px;
+    if(c == 0)  n = std::max(n-1, 0);         // point left of the diagram
+    else if(c == x2)  n = std::min(n+1, Count);  // point right of it
+    Bounds.append(n);
+  }
+  Bounds.append(Count);
+  return true;
+}
+
 // -------------------------------------------------------
 void Diagram::Bounding(int& _x1, int& _y1, int& _x2, int& _y2)
 {
@@ -783,6 +844,7 @@ void Diagram::updateGraphData()
     else if(pg->cPointsY) {
       delete[] pg->cPointsY;
       pg->cPointsY = 0;
+      pg->Pyramid.clear();
     }
   }
 
@@ -835,6 +897,7 @@ int Graph::loadDatFile(const QString& fileName)
   g->countY = 0;
   g->mutable_axes().clear(); // HACK
   if(g->cPointsY) { delete[] g->cPointsY;  g->cPointsY = 0; }
+  g->Pyramid.clear();
   if(Variable.isEmpty()) return 0;
 
 #if 0 // FIXME encapsulation. implement digital waves later.
@@ -844,67 +907,25 @@ int Graph::loadDatFile(const QString& fileName)
 #endif
 
 
-  if(!file.open(QIODevice::ReadOnly))  return 0;
-
-  // *****************************************************************
-  // To strongly speed up the file read operation the whole file is
-  // read into the memory in one piece.
-  QByteArray FileContent;
-  FileContent = file.readAll();
-  file.close();
-  char *FileString = FileContent.data();
-  if(!FileString)  return 0;
-  char *pPos = FileString+FileContent.size()-1;
-  if(*pPos > ' ')  if(*pPos != '>')  return 0;
-  *pPos = 0;
+  // all graphs share a single index of the dataset
+  QSharedPointer<DatasetIndex> Data = DatasetIndex::get(file.fileName());
+  if(!Data)  return 0;
+  const DatasetVar *pVar = Data->find(Variable);
+  if(!pVar)  return 0;   // data not found
 
-
-  // *****************************************************************
-  // look for variable name in data file  ****************************
-  bool isIndep = false;
-  Variable = "dep "+Variable+" ";
-  // "pFile" is used through-out the whole function and must NOT used
-  // for other purposes!
-  char *pFile = strstr(FileString, Variable.toLatin1());
-  while(pFile) {
-    if(*(pFile-1) == '<')     // is dependent variable ?
-      break;
-    else if(strncmp(pFile-3, "<in", 3) == 0) {  // is independent variable ?
-      isIndep = true;
-      break;
-    }
-    pFile = strstr(pFile+4, Variable.toLatin1());
-  }
-
-  if(!pFile)  return 0;   // data not found
-
-  QString Line, tmp;
-  pFile += Variable.length();
-  pPos = strchr(pFile, '>');
-  if(!pPos)  return 0;   // file corrupt
-  *pPos = 0;
-  Line = QString(pFile);
-  *pPos = '>';
-  pFile = pPos+1;
-  if(!isIndep) {
-    pos = 0;
-    tmp = Line.section(' ', pos, pos);
-    while(!tmp.isEmpty()) {
-      g->mutable_axes().push_back(new DataX(tmp));  // name of independet variable
-      pos++;
-      tmp = Line.section(' ', pos, pos);
-    }
-  }
+  // digital variables (e.g. 100ZX0) are taken from the file as they are
+  bool isDigital = (Variable.right(2) == ".X") && !Data->isBinary();
+  if(!isDigital)
+    if(!(pVar = Data->values(Variable)))  return 0;   // file corrupt
+  int available = isDigital ? INT_MAX : pVar->Values.size() / 2;
 
   // *****************************************************************
   // get independent variable ****************************************
-  bool ok=true;
   double *p;
   int counting = 0;
-  if(isIndep) {    // create independent variable by myself ?
-    counting = Line.toInt(&ok);  // get number of values
+  if(pVar->isIndep) {    // create independent variable by myself ?
+    counting = (pVar->count < 0) ? available : pVar->count;
     g->mutable_axes().push_back(new DataX("number", 0, counting));
-    if(!ok)  return 0;
 
     p = new double[counting];  // memory of new independent variable
     g->countY = 1;
@@ -915,27 +936,17 @@ int Graph::loadDatFile(const QString& fileName)
     Axis->max(double(counting));
   }
   else {  // ...................................
+    if(pVar->Deps.isEmpty())  return 0;
+    foreach(const QString& Dep, pVar->Deps)
+      g->mutable_axes().push_back(new DataX(Dep));  // name of independet variable
+
     // get independent variables from data file
     g->countY = 1;
-#if 0 // FIXME: we do not have a Name.
-    DataX *bLast = 0;
-    if(Name == "Rect3D")  bLast = g->axis(1);  // y axis for Rect3D
-#endif
-
-#if 0 // FIXME: this is about diagram. do after load.
-    double min_tmp = xAxis.min, max_tmp = xAxis.max;
-#endif
+    // a running simulation provides a single axis step by step
+    int Limit = (Data->isOpen() && (g->numAxes() == 1)) ? available : -1;
     DataX const *pD;
     for(int ii= g->numAxes(); (pD = g->axis(--ii)); ) {
-#if 0 // FIXME: this is about diagram. do after load.
-      pa = &xAxis;
-      if(pD == g->axis(0)) {
-        xAxis.min = min_tmp;    // only count first independent variable
-        xAxis.max = max_tmp;
-      }
-      else if(pD == bLast)  pa = &yAxis;   // y axis for Rect3D
-#endif
-      counting = loadIndepVarData(pD->Var, FileString, mutable_axis(ii));
+      counting = loadIndepVarData(*Data, pD->Var, mutable_axis(ii), Limit);
       if(counting <= 0)  return 0;
 
       g->countY *= counting;
@@ -947,70 +958,34 @@ int Graph::loadDatFile(const QString& fileName)
   // *****************************************************************
   // get dependent variables *****************************************
   counting  *= g->countY;
+  if(counting > available)  return 0;
+
+if(!isDigital) {
+
   p = new double[2*counting]; // memory for dependent variables
   g->cPointsY = p;
-#if 0 // FIXME: what does this do?!
-  if(g->yAxisNo == 0)  pa = &yAxis;   // for which axis
-  else  pa = &zAxis;
-  (pa->numGraphs)++;    // count graphs
-#endif
+  memcpy(p, pVar->Values.constData(), 2*counting*sizeof(double));
 
-  char *pEnd;
   double x, y;
-  pPos = pFile;
-
-if(Variable.right(3) != ".X ") { // not "digital"
-
   for(int z=counting; z>0; z--) {
-    pEnd = 0;
-    while((*pPos) && (*pPos <= ' '))  pPos++; // find start of next number
-    x = strtod(pPos, &pEnd);  // real part
-    pPos = pEnd + 1;
-    if(*pEnd < ' ')   // is there an imaginary part ?
-      y = 0.0;
-    else {
-      if(((*pEnd != '+') && (*pEnd != '-')) || (*pPos != 'j')) {
-        delete[] g->cPointsY;  g->cPointsY = 0;
-        return 0;
-      }
-      *pPos = *pEnd;  // overwrite 'j' with sign
-      pEnd = 0;
-      y = strtod(pPos, &pEnd); // imaginary part
-      *pPos = 'j';   // write back old character
-      pPos = pEnd;
-    }
-    *(p++) = x;
-    *(p++) = y;
-#if 0 // FIXME there is no Name here.
-    if(Name[0] != 'C')
-#endif
-	 {
-      if(fabs(y) >= 1e-250) x = sqrt(x*x+y*y);
-      if(std::isfinite(x)) {
-			auto Axis = g->mutable_axes().back();
-			Axis->min(x);
-			Axis->max(x);
-      }
-    }
-
-#if 0 // this is not location curce code.
-    else {   // location curve needs different treatment
-      if(std::isfinite(x)) {
-        if(x > xAxis.max) xAxis.max = x;
-        if(x < xAxis.min) xAxis.min = x;
-      }
-      if(std::isfinite(y)) {
-        if(y > pa->max) pa->max = y;
-        if(y < pa->min) pa->min = y;
-      }
+    x = *(p++);
+    y = *(p++);
+    if(fabs(y) >= 1e-250) x = sqrt(x*x+y*y);
+    if(std::isfinite(x)) {
+      auto Axis = g->mutable_axes().back();
+      Axis->min(x);
+      Axis->max(x);
     }
-#endif
   }
 
 } else {  // of "if not digital"
 
+  QByteArray Content = Data->text(Variable);
+  char *pPos = Content.data();   // terminated by the QByteArray
+  p = new double[2*counting]; // memory for dependent variables
+  g->cPointsY = p;
   char *pc = (char*)p;
-  pEnd = pc + 2*(counting-1)*sizeof(double);
+  char *pEnd = pc + 2*(counting-1)*sizeof(double);
   // for digital variables (e.g. 100ZX0):
   for(int z=counting; z>0; z--) {
 
@@ -1041,91 +1016,30 @@ if(Variable.right(3) != ".X ") { // not "digital"
 }
 
 /*!
-   Reads the data of an independent variable. Returns the number of points.
+   Reads the data of an independent variable. At most "Limit" values are
+   taken unless it is negative. Returns the number of points.
 */
-int Graph::loadIndepVarData(const QString& Variable,
-			      char *FileString, DataX* pD)
+int Graph::loadIndepVarData(DatasetIndex& Data, const QString& Variable,
+			      DataX* pD, int Limit)
 {
-  bool isIndep = false;
-  QString Line, tmp;
-
-  /* WORK-AROUND: A bug in SCIM (libscim) which Qt is linked to causes
-     to change the locale to the default. */
-  setlocale (LC_NUMERIC, "C");
+  const DatasetVar *pVar = Data.values(Variable);
+  if(!pVar)  return -1;   // data not found
 
-  Line = "dep "+Variable+" ";
-  // "pFile" is used through-out the whole function and must NOT used
-  // for other purposes!
-  char *pFile = strstr(FileString, Line.toLatin1());
-  while(pFile) {
-    if(*(pFile-1) == '<')     // is dependent variable ?
-      break;
-    else if(strncmp(pFile-3, "<in", 3) == 0) {  // is independent variable ?
-      isIndep = true;
-      break;
-    }
-    pFile = strstr(pFile+4, Line.toLatin1());
+  int n = pVar->count;  // number of values
+  if(!pVar->isIndep) {     // dependent variable can also be used...
+    if(pVar->Deps.count() != 1)  return -1; // ...if only one dependency
+    const DatasetVar *pIndep = Data.find(pVar->Deps.first());
+    if(!pIndep || !pIndep->isIndep)  return -1;
+    n = pIndep->count;
   }
-
-  if(!pFile)  return -1;   // data not found
-
-  pFile += Line.length();
-  char *pPos = strchr(pFile, '>');
-  if(!pPos)  return -1;   // file corrupt
-  *pPos = 0;
-  Line = QString(pFile);
-  *pPos = '>';
-  pFile = pPos+1;
-  char *pEnd;
-  if(!isIndep) {           // dependent variable can also be used...
-    if(Line.indexOf(' ') >= 0)  return -1; // ...if only one dependency
-    Line = "<indep "+Line+" ";
-    pPos = strstr(FileString, Line.toLatin1());
-    if(!pPos)  return -1;
-    pPos += Line.length();
-    pEnd = strchr(pPos, '>');
-    if(!pEnd)  return -1;   // file corrupt
-    *pEnd = 0;
-    Line = QString(pPos);
-    *pEnd = '>';
-  }
-
-
-  bool ok;
-  int n = Line.toInt(&ok);  // number of values
-  if(!ok)  return -1;
+  if((Limit >= 0) && (n > Limit))  n = Limit;
+  if((n <= 0) || (2*n > pVar->Values.size()))  return -1;
 
   double *p = new double[n];     // memory for new independent variable
-//  DataX *pD = pg->mutable_axes().back();
   pD->Points = p;
   pD->count  = n;
-
-
-  double x;
-  pPos = pFile;
-  // find first position containing no whitespace
-  while((*pPos) && (*pPos <= ' '))  pPos++;
-
-  for(int z=0; z<n; z++) {
-    pEnd = 0;
-    x = strtod(pPos, &pEnd);  // real part
-    if(pPos == pEnd) {
-      delete[] pD->Points;  pD->Points = 0;
-      return -1;
-    }
-    
-    *(p++) = x;
-#if 0 // this is not location curve code
-    if(Name[0] != 'C')   // not for location curves
-      if(std::isfinite(x)) {
-        if(x > pa->max) pa->max = x;
-        if(x < pa->min) pa->min = x;
-      }
-#endif
-    
-    pPos = pEnd;
-    while((*pPos) && (*pPos <= ' '))  pPos++;  // find start of next number
-  }
+  const double *q = pVar->Values.constData();
+  for(int z=0; z<n; z++, q += 2)  *(p++) = *q;   // real parts only
 
   return n;   // return number of independent data
 }
@@ -142,6 +142,7 @@ protected:
   void rectClip(Graph::iterator &) const;
 
   virtual void calcData(Graph*);
+  bool calcColumns(Graph*, Axis const*, QVector<int>&);
 
 private:
   int Bounding_x1, Bounding_x2, Bounding_y1, Bounding_y2;
@@ -46,6 +46,7 @@
 #include <QHeaderView>
 #include <QDir>
 #include <QDebug>
+#include <QMap>
 
 
 #define CROSS3D_SIZE   30
@@ -741,6 +742,51 @@ DiagramDialog::~DiagramDialog()
   delete Validator;
 }
 
+// --------------------------------------------------------------------------
+// Reads a dataset in order to scan its tags. Binary datasets are only read
+// up to the end of their header which lists all the variables. Streamed
+// binary datasets declare the variables within the data section instead,
+// where only the tags of the records are read. Later declarations of a
+// variable replace earlier ones.
+static QByteArray readDatasetTags(QFile& file)
+{
+  if(file.peek(21) != "<Qucs Binary Dataset ")
+    return file.readAll();
+
+  QByteArray Header;
+  while(!file.atEnd()) {
+    QByteArray Line = file.readLine();
+    if(Line == "<data>\n")  break;
+    Header += Line;
+  }
+  if(!Header.contains("\n<stream "))
+    return Header;
+
+  QList<QByteArray> Names;
+  QMap<QByteArray, QByteArray> Tags;
+  qint64 Pos = file.pos();
+  while(file.seek((Pos + 7) & ~qint64(7)) && !file.atEnd()) {
+    QByteArray Line = file.readLine();
+    if(!Line.endsWith('\n'))  break;   // still being written
+    Pos = file.pos();
+    QList<QByteArray> Words = Line.trimmed().split(' ');
+    if(Words.count() < 2)  break;
+    if(Words.at(0) == "<chunk") {
+      if(Words.count() != 4)  break;
+      Pos += Words.at(2).toLongLong() *
+        (Words.at(3) == "complex>" ? 16 : 8);
+      continue;
+    }
+    QByteArray Name = Words.at(1);
+    if(Name.endsWith('>'))  Name.chop(1);
+    if(!Tags.contains(Name))  Names.append(Name);
+    Tags[Name] = Line;
+  }
+  foreach(const QByteArray& Name, Names)
+    Header += Tags[Name];
+  return Header;
+}
+
 // --------------------------------------------------------------------------
 void DiagramDialog::slotReadVars(int)
 {
@@ -756,7 +802,7 @@ void DiagramDialog::slotReadVars(int)
   int varNumber = 0;
   // reading the file as a whole improves speed very much, also using
   // a QByteArray rather than a QString
-  QByteArray FileString = file.readAll();
+  QByteArray FileString = readDatasetTags(file);
   file.close();
 
   // make sure sorting is disabled before inserting items
@@ -1535,7 +1581,7 @@ void DiagramDialog::addvar(QString a)
   //int varNumber = 0;
   // reading the file as a whole improves speed very much, also using
   // a QByteArray rather than a QString
-  QByteArray FileString = file.readAll();
+  QByteArray FileString = readDatasetTags(file);
   file.close();
 
   
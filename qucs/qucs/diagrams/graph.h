@@ -21,6 +21,7 @@
 
 #include "marker.h"
 #include "element.h"
+#include "graphpyramid.h"
 
 #include <cmath>
 #include <QColor>
@@ -53,6 +54,7 @@ inline graphstyle_t toGraphStyle(int x){
 
 class Diagram;
 class ViewPainter;
+class DatasetIndex;
 
 
 struct DataX {
@@ -123,7 +125,8 @@ public:
   typedef container::const_iterator const_iterator;
 
   int loadDatFile(const QString& filename);
-  int loadIndepVarData(const QString&, char* datfilecontent, DataX* where);
+  int loadIndepVarData(DatasetIndex&, const QString&, DataX* where,
+                       int Limit=-1);
 
   void    paint(ViewPainter*, int, int);
   void    paintLines(ViewPainter*, int, int);
@@ -161,6 +164,7 @@ public:
   graphstyle_t Style;
   QList<Marker *> Markers;
   double *gy;
+  GraphPyramid Pyramid;  // extreme values of cPointsY for drawing
 
   // for tabular diagram
   int  Precision;   // number of digits to show
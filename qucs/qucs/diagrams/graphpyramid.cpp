@@ -0,0 +1,186 @@
+/***************************************************************************
+                             graphpyramid.cpp
+                            ------------------
+    begin                : Sat Oct 17 2026
+    copyright            : (C) 2026 by Qucs Team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+#include <cmath>
+#include <algorithm>
+
+#include "graphpyramid.h"
+
+// number of samples in the blocks of the lowest level
+#define BLOCK_SIZE 8
+
+GraphPyramid::GraphPyramid()
+  : Data(0), Count(0), Branches(0), Magnitude(false), Valid(false)
+{
+}
+
+// ------------------------------------------------------------
+void GraphPyramid::clear()
+{
+  Levels.clear();
+  Data = 0;
+  Count = Branches = 0;
+  Valid = false;
+}
+
+// ------------------------------------------------------------
+// Checks whether the pyramid has been built for the given data.
+bool GraphPyramid::isBuilt(const double *Y, int Count_, int Branches_,
+                           bool Magnitude_) const
+{
+  return Valid && (Data == Y) && (Count == Count_) &&
+         (Branches == Branches_) && (Magnitude == Magnitude_);
+}
+
+// ------------------------------------------------------------
+/*!
+   Builds the pyramid of "Branches" branches of "Count" complex values
+   each. The values are real numbers or magnitudes as drawn by the
+   rectangular diagram. Returns false if the independent values "X" are
+   not ascending, then the pyramid cannot be used.
+*/
+bool GraphPyramid::build(const double *X, const double *Y, int Count_,
+                         int Branches_, bool Magnitude_)
+{
+  clear();
+  for(int i=1; i<Count_; i++)
+    if(!(X[i] >= X[i-1]))  return false;
+
+  Data = Y;
+  Count = Count_;
+  Branches = Branches_;
+  Magnitude = Magnitude_;
+
+  // lowest level: extreme values of each block of samples
+  int Nodes = Count / BLOCK_SIZE;
+  if(Nodes < 1)  return false;
+  QVector<int> Level(2*Branches*Nodes);
+  int *p = Level.data();
+  for(int b=0; b<Branches; b++) {
+    const double *py = Data + 2*Count*b;
+    for(int n=0; n<Nodes; n++, p+=2) {
+      int iMin, iMax, i = n*BLOCK_SIZE;
+      double vMin, vMax;
+      iMin = iMax = i;
+      vMin = vMax = value(py, i);
+      for(i++; i<(n+1)*BLOCK_SIZE; i++) {
+        double v = value(py, i);
+        if(v < vMin || std::isnan(vMin)) { vMin = v; iMin = i; }
+        if(v > vMax || std::isnan(vMax)) { vMax = v; iMax = i; }
+      }
+      p[0] = iMin;
+      p[1] = iMax;
+    }
+  }
+  Levels.append(Level);
+
+  // higher levels: combine two blocks of the level below
+  for(int Size=2*BLOCK_SIZE; (Nodes = Count / Size) >= 1; Size *= 2) {
+    const QVector<int>& Below = Levels.last();
+    int Lower = Count / (Size/2);
+    Level = QVector<int>(2*Branches*Nodes);
+    p = Level.data();
+    for(int b=0; b<Branches; b++) {
+      const double *py = Data + 2*Count*b;
+      const int *q = Below.constData() + 2*b*Lower;
+      for(int n=0; n<Nodes; n++, p+=2, q+=4) {
+        double a = value(py, q[0]), c = value(py, q[2]);
+        p[0] = (c < a || std::isnan(a)) ? q[2] : q[0];
+        a = value(py, q[1]);
+        c = value(py, q[3]);
+        p[1] = (c > a || std::isnan(a)) ? q[3] : q[1];
+      }
+    }
+    Levels.append(Level);
+  }
+
+  Valid = true;
+  return true;
+}
+
+// ------------------------------------------------------------
+// Returns the value of the i-th sample as drawn in the diagram.
+double GraphPyramid::value(const double *Y, int i) const
+{
+  const double *p = Y + 2*i;
+  if(Magnitude || (fabs(p[1]) > 1e-250))
+    return sqrt(p[0]*p[0] + p[1]*p[1]);
+  return p[0];
+}
+
+// ------------------------------------------------------------
+// Finds the least and the greatest value in the samples [Begin, End).
+void GraphPyramid::extremes(int Branch, int Begin, int End,
+                            int& iMin, int& iMax) const
+{
+  const double *py = Data + 2*Count*Branch;
+  double vMin, vMax;
+  iMin = iMax = Begin;
+  vMin = vMax = value(py, Begin);
+
+  for(int i=Begin; i<End; ) {
+    int Lo = i, Hi = i, Size = 1;
+    if((i % BLOCK_SIZE) == 0 && i+BLOCK_SIZE <= End) {
+      // take the largest block starting here and fitting into the range
+      int k = 0;
+      Size = BLOCK_SIZE;
+      while(k+1 < Levels.size() && (i % (2*Size)) == 0 && i+2*Size <= End) {
+        Size *= 2;
+        k++;
+      }
+      const int *q = Levels.at(k).constData() +
+                     2*(Branch*(Count / Size) + i / Size);
+      Lo = q[0];
+      Hi = q[1];
+    }
+    double v = value(py, Lo);
+    if(v < vMin || std::isnan(vMin)) { vMin = v; iMin = Lo; }
+    v = value(py, Hi);
+    if(v > vMax || std::isnan(vMax)) { vMax = v; iMax = Hi; }
+    i += Size;
+  }
+}
+
+// ------------------------------------------------------------
+/*!
+   Puts the indices of the samples to draw for a branch into "Idx". The
+   samples are divided into columns by "Bounds" which holds ascending
+   indices; the column j consists of the samples [Bounds[j], Bounds[j+1]).
+   Of each column the first, the least, the greatest and the last sample
+   are taken in ascending order.
+*/
+void GraphPyramid::select(int Branch, const QVector<int>& Bounds,
+                          QVector<int>& Idx) const
+{
+  Idx.resize(0);
+  int Last = -1;
+  for(int j=0; j+1<Bounds.size(); j++) {
+    int Begin = Bounds.at(j), End = Bounds.at(j+1);
+    if(Begin >= End)  continue;
+
+    int s[4];
+    s[0] = Begin;
+    s[3] = End-1;
+    extremes(Branch, Begin, End, s[1], s[2]);
+    std::sort(s, s+4);
+    for(int k=0; k<4; k++)
+      if(s[k] > Last)
+        Idx.append(Last = s[k]);
+  }
+}
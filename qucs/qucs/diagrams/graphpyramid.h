@@ -0,0 +1,55 @@
+/***************************************************************************
+                              graphpyramid.h
+                             ----------------
+    begin                : Sat Oct 17 2026
+    copyright            : (C) 2026 by Qucs Team
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef GRAPHPYRAMID_H
+#define GRAPHPYRAMID_H
+
+#include <QVector>
+
+/*!
+  \class GraphPyramid
+  \brief The GraphPyramid class finds the extreme values of graph data.
+
+  The samples of every branch of a graph are divided into blocks whose
+  sizes are powers of two. For each block the positions of the least
+  and the greatest value are kept, so the extreme values of any range
+  of samples are found by looking at a few blocks only. This allows to
+  reduce the data to four samples per pixel column (first, least,
+  greatest and last) which draw the same picture as all samples.
+*/
+class GraphPyramid {
+public:
+  GraphPyramid();
+
+  void clear();
+  bool isBuilt(const double *Y, int Count, int Branches, bool Magnitude) const;
+  bool build(const double *X, const double *Y, int Count, int Branches,
+             bool Magnitude);
+  void select(int Branch, const QVector<int>& Bounds, QVector<int>& Idx) const;
+
+private:
+  double value(const double *Y, int i) const;
+  void extremes(int Branch, int Begin, int End, int& iMin, int& iMax) const;
+
+  const double *Data;
+  int  Count;
+  int  Branches;
+  bool Magnitude;
+  bool Valid;
+  QVector<QVector<int> > Levels;  // per level and branch: least, greatest
+};
+
+#endif